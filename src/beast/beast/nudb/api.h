@@ -102,6 +102,18 @@ struct api
         return nudb::visit<Codec>(
             path, BufferSize, f);
     }
+
+    template <class Function>
+    static
+    bool
+    visit(
+        path_type const& path,
+        Codec const& codec,
+        Function&& f)
+    {
+        return nudb::visit(
+            path, BufferSize, codec, f);
+    }
 };
 
 } // nudb
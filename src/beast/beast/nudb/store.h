@@ -133,9 +133,11 @@ private:
             path_type const& dp_, path_type const& kp_,
                 path_type const& lp_,
                     detail::key_file_header const& kh_,
-                        std::size_t arena_alloc_size);
+                        std::size_t arena_alloc_size,
+                            Codec const& codec_);
     };
 
+    Codec codec_;                   // Copied into each open state
     bool open_ = false;
 
     // VFALCO Unfortunately boost::optional doesn't support
@@ -165,6 +167,17 @@ private:
 
 public:
     store() = default;
+
+    /** Create a store which applies the given codec.
+
+        The codec is copied into the state of every subsequent open.
+    */
+    explicit
+    store (Codec const& codec)
+        : codec_ (codec)
+    {
+    }
+
     store (store const&) = delete;
     store& operator= (store const&) = delete;
 
@@ -191,6 +204,13 @@ public:
         return open_;
     }
 
+    /** Returns the codec applied to value data. */
+    Codec const&
+    codec() const
+    {
+        return codec_;
+    }
+
     path_type const&
     dat_path() const
     {
@@ -310,7 +330,8 @@ store<Hasher, Codec, File>::state::state (
         path_type const& dp_, path_type const& kp_,
             path_type const& lp_,
                 detail::key_file_header const& kh_,
-                    std::size_t arena_alloc_size)
+                    std::size_t arena_alloc_size,
+                        Codec const& codec_)
     : df (std::move(df_))
     , kf (std::move(kf_))
     , lf (std::move(lf_))
@@ -321,6 +342,7 @@ store<Hasher, Codec, File>::state::state (
     , p1 (kh_.key_size, arena_alloc_size)
     , c0 (kh_.key_size, kh_.block_size)
     , c1 (kh_.key_size, kh_.block_size)
+    , codec (codec_)
     , kh (kh_)
 {
 }
@@ -378,7 +400,7 @@ store<Hasher, Codec, File>::open (
     auto s = std::make_unique<state>(
         std::move(df), std::move(kf), std::move(lf),
             dat_path, key_path, log_path, kh,
-                arena_alloc_size);
+                arena_alloc_size, codec_);
     thresh_ = std::max<std::size_t>(65536UL,
         kh.load_factor * kh.capacity);
     frac_ = thresh_ / 2;
@@ -48,6 +48,7 @@ bool
 visit(
     path_type const& path,
     std::size_t read_size,
+    Codec const& codec,
     Function&& f)
 {
     using namespace detail;
@@ -57,7 +58,6 @@ visit(
     dat_file_header dh;
     read (df, dh);
     verify (dh);
-    Codec codec;
     // Iterate Data File
     bulk_reader<File> r(
         df, dat_file_header::size,
@@ -105,6 +105,17 @@ visit(
     return true;
 }
 
+/** Visit each key/data pair using a default constructed Codec. */
+template <class Codec, class Function>
+bool
+visit(
+    path_type const& path,
+    std::size_t read_size,
+    Function&& f)
+{
+    return visit(path, read_size, Codec{}, f);
+}
+
 } // nudb
 } // beast
 
@@ -20,7 +20,9 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/ParallelFor.h>
 #include <ripple/basics/seconds_clock.h>
+#include <vector>
 
 namespace ripple {
 
@@ -31,16 +33,35 @@ TaggedCache <uint256, AcceptedLedger> AcceptedLedger::s_cache (
     "AcceptedLedger", 4, 60, get_seconds_clock (),
         deprecatedLogs().journal("TaggedCache"));
 
+// Each thread helping to build the ledger gets at least this many transactions
+static std::size_t const itemsPerThread = 32;
+
 AcceptedLedger::AcceptedLedger (Ledger::ref ledger) : mLedger (ledger)
 {
     SHAMap& txSet = *ledger->peekTransactionMap ();
 
+    std::vector<std::shared_ptr<SHAMapItem>> items;
     for (std::shared_ptr<SHAMapItem> item = txSet.peekFirstItem (); item;
          item = txSet.peekNextItem (item->getTag ()))
     {
-        SerialIter sit (item->slice());
-        insert (std::make_shared<AcceptedLedgerTx> (ledger, std::ref (sit)));
+        items.push_back (item);
     }
+
+    // Deserializing the transaction and metadata only reads the item
+    // and the ledger, so it is spread across the shared pool. The
+    // results are inserted in map order afterwards.
+    std::vector<AcceptedLedgerTx::pointer> txns (items.size ());
+
+    parallel_for (items.size (), itemsPerThread,
+        [&](std::size_t i)
+        {
+            SerialIter sit (items[i]->slice());
+            txns[i] = std::make_shared<AcceptedLedgerTx> (
+                ledger, std::ref (sit));
+        });
+
+    for (auto const& txn : txns)
+        insert (txn);
 }
 
 AcceptedLedger::pointer AcceptedLedger::makeAcceptedLedger (Ledger::ref ledger)
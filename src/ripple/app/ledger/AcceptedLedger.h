@@ -79,6 +79,11 @@ public:
         return s_cache.getHitRate ();
     }
 
+    static TaggedCache <uint256, AcceptedLedger>& getCache ()
+    {
+        return s_cache;
+    }
+
     AcceptedLedgerTx::pointer getTxn (int) const;
 
 private:
@@ -38,7 +38,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger, SerialIter& sit)
         ledger->getLedgerSeq (), mRawMeta);
     mAffected = mMeta->getAffectedAccounts ();
     mResult =   mMeta->getResultTER ();
-    buildJson ();
 }
 
 AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
@@ -49,7 +48,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
     , mAffected (met->getAffectedAccounts ())
 {
     mResult = mMeta->getResultTER ();
-    buildJson ();
 }
 
 AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
@@ -59,7 +57,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
     , mResult (result)
     , mAffected (txn->getMentionedAccounts ())
 {
-    buildJson ();
 }
 
 std::string AcceptedLedgerTx::getEscMeta () const
@@ -68,7 +65,13 @@ std::string AcceptedLedgerTx::getEscMeta () const
     return sqlEscape (mRawMeta);
 }
 
-void AcceptedLedgerTx::buildJson ()
+Json::Value AcceptedLedgerTx::getJson () const
+{
+    std::call_once (mJsonBuilt, &AcceptedLedgerTx::buildJson, this);
+    return mJson;
+}
+
+void AcceptedLedgerTx::buildJson () const
 {
     mJson = Json::objectValue;
     mJson[jss::transaction] = mTxn->getJson (0);
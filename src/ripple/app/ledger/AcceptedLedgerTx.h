@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_ACCEPTEDLEDGERTX_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <mutex>
 
 namespace ripple {
 
@@ -94,11 +95,19 @@ public:
         return mMeta ? mMeta->getIndex () : 0;
     }
     std::string getEscMeta () const;
-    Json::Value getJson () const
+    Blob const& getRawMeta () const
     {
-        return mJson;
+        return mRawMeta;
     }
 
+    /** Returns the transaction in JSON form.
+
+        The JSON is rendered on the first call and cached. Only stream
+        subscribers and logging need it, so most transactions never pay
+        for it. Safe to call concurrently.
+    */
+    Json::Value getJson () const;
+
 private:
     Ledger::pointer                 mLedger;
     STTx::pointer  mTxn;
@@ -106,9 +115,10 @@ private:
     TER                             mResult;
     std::vector <RippleAddress>     mAffected;
     Blob        mRawMeta;
-    Json::Value                     mJson;
+    mutable std::once_flag          mJsonBuilt;
+    mutable Json::Value             mJson;
 
-    void buildJson ();
+    void buildJson () const;
 };
 
 } // ripple
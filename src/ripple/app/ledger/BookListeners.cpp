@@ -20,7 +20,6 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/misc/NetworkOPs.h>
-#include <ripple/json/to_string.h>
 
 namespace ripple {
 
@@ -36,9 +35,9 @@ void BookListeners::removeSubscriber (std::uint64_t seq)
     mListeners.erase (seq);
 }
 
-void BookListeners::publish (Json::Value const& jvObj)
+std::size_t BookListeners::publish (StreamMessage& message)
 {
-    std::string sObj = to_string (jvObj);
+    std::size_t notified = 0;
 
     ScopedLockType sl (mLock);
     NetworkOPs::SubMapType::const_iterator it = mListeners.begin ();
@@ -49,12 +48,27 @@ void BookListeners::publish (Json::Value const& jvObj)
 
         if (p)
         {
-            p->send (jvObj, sObj, true);
+            message.send (*p, true);
+            ++notified;
             ++it;
         }
         else
             it = mListeners.erase (it);
     }
+
+    return notified;
+}
+
+void BookListeners::getSubscribers (
+    hash_map <std::uint64_t, InfoSub::pointer>& subscribers)
+{
+    ScopedLockType sl (mLock);
+
+    for (auto const& listener : mListeners)
+    {
+        if (auto p = listener.second.lock ())
+            subscribers.emplace (listener.first, std::move (p));
+    }
 }
 
 } // ripple
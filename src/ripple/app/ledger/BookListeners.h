@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_BOOKLISTENERS_H_INCLUDED
 
 #include <ripple/net/InfoSub.h>
+#include <ripple/net/StreamMessage.h>
 #include <memory>
 
 namespace ripple {
@@ -35,7 +36,13 @@ public:
 
     void addSubscriber (InfoSub::ref sub);
     void removeSubscriber (std::uint64_t sub);
-    void publish (Json::Value const& jvObj);
+
+    /** Send to every subscriber, returning how many were sent to. */
+    std::size_t publish (StreamMessage& message);
+
+    /** Add the live subscribers to a map keyed by sequence. */
+    void getSubscribers (
+        hash_map <std::uint64_t, InfoSub::pointer>& subscribers);
 
 private:
     using LockType = RippleRecursiveMutex;
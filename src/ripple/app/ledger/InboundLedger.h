@@ -127,16 +127,18 @@ private:
     int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
 
     bool takeHeader (std::string const& data);
-    bool takeTxNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
-                     SHAMapAddNode&);
+    bool takeTxNode (const std::vector<SHAMapNodeID>& IDs,
+        const std::vector<std::shared_ptr<SHAMapTreeNode>>& nodes,
+            SHAMapAddNode&);
     bool takeTxRootNode (Blob const& data, SHAMapAddNode&);
 
     // VFALCO TODO Rename to receiveAccountStateNode
     //             Don't use acronyms, but if we are going to use them at least
     //             capitalize them correctly.
     //
-    bool takeAsNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
-                     SHAMapAddNode&);
+    bool takeAsNode (const std::vector<SHAMapNodeID>& IDs,
+        const std::vector<std::shared_ptr<SHAMapTreeNode>>& nodes,
+            SHAMapAddNode&);
     bool takeAsRootNode (Blob const& data, SHAMapAddNode&);
 
 private:
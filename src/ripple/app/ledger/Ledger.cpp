@@ -21,7 +21,10 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
 #include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OrderBookDB.h>
@@ -540,30 +543,14 @@ Ledger::getHash()
     return mHash;
 }
 
-bool Ledger::saveValidatedLedger (bool current)
+bool Ledger::saveValidatedLedger (bool current, bool synchronous)
 {
-    // TODO(tom): Fix this hard-coded SQL!
     WriteLog (lsTRACE, Ledger)
         << "saveValidatedLedger "
         << (current ? "" : "fromAcquire ") << getLedgerSeq ();
-    static boost::format deleteLedger (
-        "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1 (
-        "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2 (
-        "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans (
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
-    static boost::format transExists (
-        "SELECT Status FROM Transactions WHERE TransID = '%s';");
-    static boost::format updateTx (
-        "UPDATE Transactions SET LedgerSeq = %u, Status = '%c', TxnMeta = %s "
-        "WHERE TransID = '%s';");
-    static boost::format addLedger (
-        "INSERT OR REPLACE INTO Ledgers "
-        "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,"
-        "CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash) VALUES "
-        "('%s','%u','%s','%s','%u','%u','%d','%u','%s','%s');");
+
+    LedgerCloseProfiler::ScopedPhase phase (getApp().getLedgerCloseProfiler (),
+        getLedgerSeq (), LedgerCloseProfiler::save);
 
     if (!getAccountHash ().isNonZero ())
     {
@@ -607,101 +594,58 @@ bool Ledger::saveValidatedLedger (bool current)
         return false;
     }
 
+    LedgerSQLRows rows;
+    rows.seq = seq_;
+    rows.hash = to_string (getHash ());
+    rows.parentHash = to_string (mParentHash);
+    rows.totalCoins = beast::lexicalCastThrow <std::string> (mTotCoins);
+    rows.closeTime = mCloseTime;
+    rows.parentCloseTime = mParentCloseTime;
+    rows.closeResolution = mCloseResolution;
+    rows.closeFlags = mCloseFlags;
+    rows.accountHash = to_string (mAccountHash);
+    rows.transHash = to_string (mTransHash);
+
+    rows.transactions.reserve (aLedger->getMap ().size ());
+    for (auto const& vt : aLedger->getMap ())
     {
-        auto db = getApp().getLedgerDB ().checkoutDb();
-        *db << boost::str (deleteLedger % seq_);
-    }
-
-    {
-        auto db = getApp().getTxnDB ().checkoutDb ();
-
-        soci::transaction tr(*db);
-
-        *db << boost::str (deleteTrans1 % getLedgerSeq ());
-        *db << boost::str (deleteTrans2 % getLedgerSeq ());
-
-        std::string const ledgerSeq (std::to_string (getLedgerSeq ()));
-
-        for (auto const& vt : aLedger->getMap ())
-        {
-            uint256 transactionID = vt.second->getTransactionID ();
-
-            getApp().getMasterTransaction ().inLedger (
-                transactionID, getLedgerSeq ());
-
-            std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
-
-            *db << boost::str (deleteAcctTrans % transactionID);
-
-            auto const& accts = vt.second->getAffected ();
-
-            if (!accts.empty ())
-            {
-                std::string sql ("INSERT INTO AccountTransactions "
-                                 "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
-
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
-
-                bool first = true;
-                for (auto const& it : accts)
-                {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += it.humanAccountID ();
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
-                }
-                sql += ";";
-                if (ShouldLog (lsTRACE, Ledger))
-                {
-                    WriteLog (lsTRACE, Ledger) << "ActTx: " << sql;
-                }
-                *db << sql;
-            }
-            else
-                WriteLog (lsWARNING, Ledger)
-                    << "Transaction in ledger " << seq_
-                    << " affects no accounts";
-
-            *db <<
-               (STTx::getMetaSQLInsertReplaceHeader () +
-                vt.second->getTxn ()->getMetaSQL (
-                    getLedgerSeq (), vt.second->getEscMeta ()) + ";");
-        }
-
-        tr.commit ();
-    }
+        auto const& txn = *vt.second->getTxn ();
+        uint256 transactionID = vt.second->getTransactionID ();
+
+        getApp().getMasterTransaction ().inLedger (
+            transactionID, getLedgerSeq ());
+
+        LedgerSQLRows::Transaction tx;
+        tx.id = to_string (transactionID);
+        tx.account = txn.getSourceAccount ().humanAccountID ();
+        tx.sequence = txn.getSequence ();
+        tx.txnSeq = vt.second->getTxnSeq ();
+        tx.meta = vt.second->getRawMeta ();
+
+        auto const format =
+            TxFormats::getInstance ().findByType (txn.getTxnType ());
+        assert (format != nullptr);
+        if (format)
+            tx.type = format->getName ();
+
+        Serializer s;
+        txn.add (s);
+        tx.raw = std::move (s.modData ());
+
+        auto const& accts = vt.second->getAffected ();
+        if (accts.empty ())
+            WriteLog (lsWARNING, Ledger)
+                << "Transaction in ledger " << seq_
+                << " affects no accounts";
+        tx.affected.reserve (accts.size ());
+        for (auto const& it : accts)
+            tx.affected.push_back (it.humanAccountID ());
 
-    {
-        auto db (getApp().getLedgerDB ().checkoutDb ());
-
-        // TODO(tom): ARG!
-        *db << boost::str (addLedger %
-                           to_string (getHash ()) % seq_ % to_string (mParentHash) %
-                           beast::lexicalCastThrow <std::string> (mTotCoins) % mCloseTime %
-                           mParentCloseTime % mCloseResolution % mCloseFlags %
-                           to_string (mAccountHash) % to_string (mTransHash));
+        rows.transactions.push_back (std::move (tx));
     }
 
-    // Clients can now trust the database for
-    // information about this ledger sequence.
-    getApp().pendingSaves().erase(getLedgerSeq());
-    return true;
+    return getApp().getLedgerSQLWriter ().write (
+        std::move (rows), synchronous);
 }
 
 /*
@@ -829,55 +773,19 @@ Ledger::pointer Ledger::loadByHash (uint256 const& ledgerHash)
 
 uint256 Ledger::getHashByIndex (std::uint32_t ledgerIndex)
 {
-    uint256 ret;
-
-    std::string sql =
-        "SELECT LedgerHash FROM Ledgers INDEXED BY SeqLedger WHERE LedgerSeq='";
-    sql.append (beast::lexicalCastThrow <std::string> (ledgerIndex));
-    sql.append ("';");
-
-    std::string hash;
-    {
-        auto db = getApp().getLedgerDB ().checkoutDb ();
-
-        boost::optional<std::string> lh;
-        *db << sql,
-                soci::into (lh);
-
-        if (!db->got_data () || !lh)
-            return ret;
-
-        hash = *lh;
-        if (hash.empty ())
-            return ret;
-    }
-
-    ret.SetHexExact (hash);
-    return ret;
+    return getApp().getLedgerHashIndex ().getHash (ledgerIndex);
 }
 
 bool Ledger::getHashesByIndex (
     std::uint32_t ledgerIndex, uint256& ledgerHash, uint256& parentHash)
 {
-    auto db = getApp().getLedgerDB ().checkoutDb ();
-
-    boost::optional <std::string> lhO, phO;
-
-    *db << "SELECT LedgerHash,PrevHash FROM Ledgers "
-            "INDEXED BY SeqLedger Where LedgerSeq = :ls;",
-            soci::into (lhO),
-            soci::into (phO),
-            soci::use (ledgerIndex);
-
-    if (!lhO || !phO)
+    if (! getApp().getLedgerHashIndex ().getHashes (
+            ledgerIndex, ledgerHash, parentHash))
     {
         WriteLog (lsTRACE, Ledger) << "Don't have ledger " << ledgerIndex;
         return false;
     }
 
-    ledgerHash.SetHexExact (*lhO);
-    parentHash.SetHexExact (*phO);
-
     return true;
 }
 
@@ -886,35 +794,15 @@ Ledger::getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq)
 {
     std::map< std::uint32_t, std::pair<uint256, uint256> > ret;
 
-    std::string sql =
-        "SELECT LedgerSeq,LedgerHash,PrevHash FROM Ledgers WHERE LedgerSeq >= ";
-    sql.append (beast::lexicalCastThrow <std::string> (minSeq));
-    sql.append (" AND LedgerSeq <= ");
-    sql.append (beast::lexicalCastThrow <std::string> (maxSeq));
-    sql.append (";");
-
-    auto db = getApp().getLedgerDB ().checkoutDb ();
-
-    std::uint64_t ls;
-    std::string lh;
-    boost::optional<std::string> ph;
-    soci::statement st =
-        (db->prepare << sql,
-         soci::into (ls),
-         soci::into (lh),
-         soci::into (ph));
-
-    st.execute ();
-    while (st.fetch ())
+    auto const& index = getApp().getLedgerHashIndex ();
+    for (std::uint64_t seq = minSeq; seq <= maxSeq; ++seq)
     {
-        std::pair<uint256, uint256>& hashes =
-                ret[rangeCheckedCast<std::uint32_t>(ls)];
-        hashes.first.SetHexExact (lh);
-        hashes.second.SetHexExact (ph.value_or (""));
-        if (!ph)
+        std::pair<uint256, uint256> hashes;
+        if (index.getHashes (static_cast<std::uint32_t> (seq),
+                hashes.first, hashes.second))
         {
-            WriteLog (lsWARNING, Ledger)
-                << "Null prev hash for ledger seq: " << ls;
+            ret.emplace_hint (ret.end (),
+                static_cast<std::uint32_t> (seq), hashes);
         }
     }
 
@@ -1242,7 +1130,7 @@ bool Ledger::pendSaveValidated (bool isSynchronous, bool isCurrent)
 
     if (isSynchronous)
     {
-        return saveValidatedLedger(isCurrent);
+        return saveValidatedLedger(isCurrent, true);
     }
     else if (isCurrent)
     {
@@ -420,6 +420,7 @@ public:
 
     static Ledger::pointer loadByHash (uint256 const& ledgerHash);
 
+    // These read the LedgerHashIndex, which mirrors the Ledgers table
     static uint256 getHashByIndex (std::uint32_t index);
 
     static bool getHashesByIndex (
@@ -431,9 +432,9 @@ public:
 protected:
     void saveValidatedLedgerAsync(Job&, bool current)
     {
-        saveValidatedLedger(current);
+        saveValidatedLedger(current, false);
     }
-    bool saveValidatedLedger (bool current);
+    bool saveValidatedLedger (bool current, bool synchronous);
 
 private:
     // ledger close flags
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERCLOSEPROFILER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERCLOSEPROFILER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <beast/insight/Collector.h>
+#include <beast/insight/Event.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Records how long each phase of closing a ledger takes.
+
+    A record is started when consensus accepts a ledger. The phases
+    that follow, some of which run later on other threads (publishing
+    and saving happen once the ledger is validated), are charged to
+    the record with the same sequence. Phases reported for a ledger
+    that has no record, for example one acquired from the network,
+    are ignored.
+
+    The most recent records are kept for the ledger_close_profile RPC
+    command, and every phase is also reported to insight as an event.
+*/
+class LedgerCloseProfiler
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using duration = std::chrono::microseconds;
+
+    enum Phase
+    {
+        establish,      // From close until consensus was reached
+        apply,          // Applying the consensus set to the closed ledger
+        flush,          // Writing dirty SHAMap nodes to the NodeStore
+        accept,         // Setting the close time and storing the ledger
+        validate,       // Building, signing and sending our validation
+        openLedger,     // Building the next open ledger
+        publish,        // Publishing to subscribers once validated
+        orderBook,      // OrderBookDB::processTxn, part of publish
+        save,           // Saving the validated ledger to SQL
+
+        phaseCount
+    };
+
+    struct Record
+    {
+        LedgerIndex seq = 0;
+        std::array <duration, phaseCount> phases;
+        std::size_t transactions = 0;
+        std::size_t nodes = 0;
+        std::size_t subscribers = 0;
+
+        Record ()
+        {
+            phases.fill (duration::zero ());
+        }
+    };
+
+    /** Charges the time spent in its scope to a phase. */
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase (LedgerCloseProfiler& profiler,
+                LedgerIndex seq, Phase phase)
+            : profiler_ (profiler)
+            , seq_ (seq)
+            , phase_ (phase)
+            , start_ (clock_type::now ())
+        {
+        }
+
+        ScopedPhase (ScopedPhase const&) = delete;
+        ScopedPhase& operator= (ScopedPhase const&) = delete;
+
+        ~ScopedPhase ()
+        {
+            profiler_.addPhase (seq_, phase_,
+                std::chrono::duration_cast <duration> (
+                    clock_type::now () - start_));
+        }
+
+    private:
+        LedgerCloseProfiler& profiler_;
+        LedgerIndex seq_;
+        Phase phase_;
+        clock_type::time_point start_;
+    };
+
+    static std::size_t const defaultHistory = 256;
+
+    explicit
+    LedgerCloseProfiler (beast::insight::Collector::ptr const& collector,
+        std::size_t history = defaultHistory);
+
+    LedgerCloseProfiler (LedgerCloseProfiler const&) = delete;
+    LedgerCloseProfiler& operator= (LedgerCloseProfiler const&) = delete;
+
+    /** Returns the name of a phase, as it appears in reports. */
+    static
+    char const*
+    getName (Phase phase);
+
+    /** Start the record for a ledger.
+
+        Once the history is full the oldest record is discarded. If a
+        record already exists for the ledger it is started over.
+    */
+    void
+    begin (LedgerIndex seq);
+
+    /** Add time spent in a phase to a ledger's record. */
+    void
+    addPhase (LedgerIndex seq, Phase phase, duration elapsed);
+
+    /** Add to the number of transactions applied to a ledger. */
+    void
+    addTransactions (LedgerIndex seq, std::size_t count);
+
+    /** Add to the number of SHAMap nodes flushed for a ledger. */
+    void
+    addNodes (LedgerIndex seq, std::size_t count);
+
+    /** Add to the number of subscriber messages sent for a ledger. */
+    void
+    addSubscribers (LedgerIndex seq, std::size_t count);
+
+    /** Returns up to `limit` records, the most recent first. */
+    std::vector <Record>
+    getHistory (std::size_t limit) const;
+
+    /** Returns up to `limit` records, the most recent first. */
+    Json::Value
+    getJson (std::size_t limit) const;
+
+private:
+    Record*
+    find (LedgerIndex seq);
+
+    std::size_t const history_;
+    std::array <beast::insight::Event, phaseCount> events_;
+
+    std::mutex mutable mutex_;
+    std::deque <Record> records_;
+};
+
+} // ripple
+
+#endif
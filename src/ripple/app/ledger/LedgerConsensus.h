@@ -26,6 +26,7 @@
 #include <ripple/app/misc/FeeVote.h>
 #include <ripple/app/tx/InboundTransactions.h>
 #include <ripple/app/tx/LocalTxs.h>
+#include <ripple/basics/ParallelFor.h>
 #include <ripple/json/json_value.h>
 #include <ripple/overlay/Peer.h>
 #include <ripple/protocol/RippleLedgerHash.h>
@@ -73,7 +74,29 @@ make_LedgerConsensus (
     LedgerHash const & prevLCLHash, Ledger::ref previousLedger,
         std::uint32_t closeTime, FeeVote& feeVote);
 
-void
+/** Deserialize and signature check a set of candidate transactions.
+
+    None of this work depends on ledger state, so it is spread across the
+    pool before the ordered, state-dependent apply. The results are in the
+    same order as the input; a null entry means the item could not be
+    deserialized.
+
+    Signatures are only checked if the HashRouter does not already know
+    the transaction to be good. The outcome is cached in the STTx and the
+    HashRouter so that the engine does not check it again.
+
+    @param allowMultiSign Passed to STTx::checkSign, must match the engine.
+*/
+std::vector<STTx::pointer>
+preprocessTransactions (
+    std::vector<std::shared_ptr<SHAMapItem>> const& items,
+    bool allowMultiSign, ParallelPool& pool);
+
+/** Apply a set of transactions to a ledger.
+
+    @return The number of transactions that were applied successfully.
+*/
+std::size_t
 applyTransactions(std::shared_ptr<SHAMap> const& set, Ledger::ref applyLedger,
                   Ledger::ref checkLedger,
                   CanonicalTXSet& retriableTransactions, bool openLgr);
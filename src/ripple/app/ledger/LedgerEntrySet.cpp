@@ -66,10 +66,193 @@ LedgerEntrySet::LedgerEntrySet (Ledger::ref ledger,
 {
 }
 
+//------------------------------------------------------------------------------
+
+struct LedgerEntrySet::Entries::Layer
+{
+    map_type entries;
+    std::shared_ptr<Layer const> next;
+    int depth;
+
+    Layer (map_type&& entries_, std::shared_ptr<Layer const> next_)
+        : entries (std::move (entries_))
+        , next (std::move (next_))
+        , depth (next ? next->depth + 1 : 1)
+    {
+    }
+};
+
+LedgerEntrySet::Entries::Entries (Entries const& other)
+{
+    other.freeze ();
+    frozen_ = other.frozen_;
+}
+
+LedgerEntrySet::Entries::iterator
+LedgerEntrySet::Entries::find (uint256 const& key)
+{
+    auto it = map_.find (key);
+
+    if (it == map_.end ())
+    {
+        auto const item = findFrozen (key);
+
+        if (! item)
+            return map_.end ();
+
+        it = map_.emplace (key, *item).first;
+    }
+
+    if (it->second.mAction == taaNONE)
+        return map_.end ();
+
+    return it;
+}
+
+LedgerEntrySet::Item const*
+LedgerEntrySet::Entries::peek (uint256 const& key) const
+{
+    auto const it = map_.find (key);
+    auto const item = (it != map_.end ()) ? &it->second : findFrozen (key);
+
+    if (item && item->mAction == taaNONE)
+        return nullptr;
+
+    return item;
+}
+
+void LedgerEntrySet::Entries::insert (uint256 const& key, Item const& item)
+{
+    auto const result = map_.emplace (key, item);
+
+    if (! result.second)
+        result.first->second = item;
+}
+
+void LedgerEntrySet::Entries::erase (iterator it)
+{
+    auto const item = findFrozen (it->first);
+
+    // A frozen copy of the item must stay hidden
+    if (item && item->mAction != taaNONE)
+        it->second = Item (SLE::pointer (), taaNONE, it->second.mSeq);
+    else
+        map_.erase (it);
+}
+
+uint256 LedgerEntrySet::Entries::nextLive (uint256 const& uHash) const
+{
+    uint256 next;
+
+    // A live key is seen by at least the layer holding its
+    // current item, so the earliest over all layers is the answer.
+    auto search = [&](map_type const& entries)
+    {
+        for (auto it = entries.upper_bound (uHash);
+            it != entries.end (); ++it)
+        {
+            if (next.isNonZero () && (it->first >= next))
+                return;
+
+            auto const item = peek (it->first);
+
+            if (item && (item->mAction != taaDELETE))
+            {
+                next = it->first;
+                return;
+            }
+        }
+    };
+
+    search (map_);
+
+    for (auto layer = frozen_.get (); layer; layer = layer->next.get ())
+        search (layer->entries);
+
+    return next;
+}
+
+LedgerEntrySet::Entries::map_type&
+LedgerEntrySet::Entries::flatten () const
+{
+    if (frozen_)
+    {
+        // The private map shadows every frozen layer,
+        // and each layer shadows the ones below it.
+        for (auto layer = frozen_.get (); layer; layer = layer->next.get ())
+            map_.insert (layer->entries.begin (), layer->entries.end ());
+
+        frozen_.reset ();
+
+        for (auto it = map_.begin (); it != map_.end ();)
+        {
+            if (it->second.mAction == taaNONE)
+                it = map_.erase (it);
+            else
+                ++it;
+        }
+    }
+
+    return map_;
+}
+
+void LedgerEntrySet::Entries::swap (Entries& other)
+{
+    map_.swap (other.map_);
+    frozen_.swap (other.frozen_);
+}
+
+LedgerEntrySet::Item const*
+LedgerEntrySet::Entries::findFrozen (uint256 const& key) const
+{
+    for (auto layer = frozen_.get (); layer; layer = layer->next.get ())
+    {
+        auto const it = layer->entries.find (key);
+
+        if (it != layer->entries.end ())
+            return &it->second;
+    }
+
+    return nullptr;
+}
+
+void LedgerEntrySet::Entries::freeze () const
+{
+    if (map_.empty ())
+        return;
+
+    auto layer = std::make_shared<Layer const> (std::move (map_), frozen_);
+    map_.clear ();
+
+    if (layer->depth > maxDepth)
+    {
+        // Merge the chain so lookups stay cheap. Nothing lies
+        // below the merged layer, so erased items can be dropped.
+        map_type merged;
+
+        for (auto l = layer.get (); l; l = l->next.get ())
+            merged.insert (l->entries.begin (), l->entries.end ());
+
+        for (auto it = merged.begin (); it != merged.end ();)
+        {
+            if (it->second.mAction == taaNONE)
+                it = merged.erase (it);
+            else
+                ++it;
+        }
+
+        layer = std::make_shared<Layer const> (std::move (merged), nullptr);
+    }
+
+    frozen_ = std::move (layer);
+}
+
+//------------------------------------------------------------------------------
+
 void LedgerEntrySet::apply()
 {
     // Write back the account states
-    for (auto const& item : mEntries)
+    for (auto const& item : mEntries.flatten ())
     {
         // VFALCO TODO rvalue move the mEntry, make
         //             sure the mNodes is not used after
@@ -191,7 +374,7 @@ void LedgerEntrySet::entryCache (SLE::ref sle)
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), Item (sle, taaCACHED, mSeq)));
+        mEntries.insert (sle->getIndex (), Item (sle, taaCACHED, mSeq));
         return;
     }
 
@@ -216,7 +399,7 @@ void LedgerEntrySet::entryCreate (SLE::ref sle)
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), Item (sle, taaCREATE, mSeq)));
+        mEntries.insert (sle->getIndex (), Item (sle, taaCREATE, mSeq));
         return;
     }
 
@@ -254,7 +437,7 @@ void LedgerEntrySet::entryModify (SLE::ref sle)
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), Item (sle, taaMODIFY, mSeq)));
+        mEntries.insert (sle->getIndex (), Item (sle, taaMODIFY, mSeq));
         return;
     }
 
@@ -291,7 +474,7 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
     if (it == mEntries.end ())
     {
         assert (false); // deleting an entry not cached?
-        mEntries.insert (std::make_pair (sle->getIndex (), Item (sle, taaDELETE, mSeq)));
+        mEntries.insert (sle->getIndex (), Item (sle, taaDELETE, mSeq));
         return;
     }
 
@@ -325,7 +508,9 @@ Json::Value LedgerEntrySet::getJson (int) const
 
     Json::Value nodes (Json::arrayValue);
 
-    for (auto it = mEntries.begin (), end = mEntries.end (); it != end; ++it)
+    auto const& entries = mEntries.flatten ();
+
+    for (auto it = entries.begin (), end = entries.end (); it != end; ++it)
     {
         Json::Value entry (Json::objectValue);
         entry[jss::node] = to_string (it->first);
@@ -505,7 +690,7 @@ void LedgerEntrySet::calcRawMeta (Serializer& s, TER result, std::uint32_t index
     // Entries modified only as a result of building the transaction metadata
     NodeToLedgerEntry newMod;
 
-    for (auto& it : mEntries)
+    for (auto& it : mEntries.flatten ())
     {
         auto type = &sfGeneric;
 
@@ -1079,23 +1264,22 @@ uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
 {
     // find next node in ledger that isn't deleted by LES
     uint256 ledgerNext = uHash;
-    std::map<uint256, Item>::const_iterator it;
+    Item const* item;
 
     do
     {
         ledgerNext = mLedger->getNextLedgerIndex (ledgerNext);
-        it  = mEntries.find (ledgerNext);
+        item = mEntries.peek (ledgerNext);
     }
-    while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
+    while (item && (item->mAction == taaDELETE));
 
     // find next node in LES that isn't deleted
-    for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
-    {
-        // node found in LES, node found in ledger, return earliest
-        if (it->second.mAction != taaDELETE)
-            return (ledgerNext.isNonZero () && (ledgerNext < it->first)) ?
-                    ledgerNext : it->first;
-    }
+    auto const next = mEntries.nextLive (uHash);
+
+    // node found in LES, node found in ledger, return earliest
+    if (next.isNonZero ())
+        return (ledgerNext.isNonZero () && (ledgerNext < next)) ?
+                ledgerNext : next;
 
     // nothing next in LES, return next ledger node
     return ledgerNext;
@@ -23,6 +23,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/DeferredCredits.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/protocol/STLedgerEntry.h>
 #include <beast/utility/noexcept.h>
 #include <boost/optional.hpp>
@@ -70,7 +71,7 @@ class LedgerEntrySet
 {
 private:
     using NodeToLedgerEntry =
-        hash_map<uint256, SLE::pointer>;
+        flat_hash_map<uint256, SLE::pointer>;
 
     enum Action
     {
@@ -96,9 +97,67 @@ private:
         }
     };
 
+    // The entries, as a private map layered over a chain of frozen
+    // maps shared with related sets. Copying a set freezes the source's
+    // private map instead of duplicating it, so a checkpoint costs O(1)
+    // no matter how many entries have been touched. An item found in a
+    // frozen layer is pulled into the private map unchanged; its
+    // sequence number then makes getEntry copy the SLE on first read.
+    class Entries
+    {
+    public:
+        using map_type = std::map<uint256, Item>;
+        using iterator = map_type::iterator;
+
+        Entries() = default;
+        Entries& operator= (Entries const&) = delete;
+
+        // Freezes the private map of other, which is otherwise unchanged.
+        Entries (Entries const& other);
+
+        // Returns end() if the key is absent or was erased.
+        iterator find (uint256 const& key);
+
+        iterator end ()
+        {
+            return map_.end ();
+        }
+
+        // Find without pulling the item into the private map.
+        Item const* peek (uint256 const& key) const;
+
+        // Insert or replace.
+        void insert (uint256 const& key, Item const& item);
+
+        void erase (iterator it);
+
+        // The first key after uHash whose item is not deleted, or zero.
+        uint256 nextLive (uint256 const& uHash) const;
+
+        // Merges the frozen layers so every item is in the private map.
+        map_type& flatten () const;
+
+        void swap (Entries& other);
+
+    private:
+        struct Layer;
+
+        // Layers deeper than this are merged into one when frozen
+        static int const maxDepth = 8;
+
+        Item const* findFrozen (uint256 const& key) const;
+
+        void freeze () const;
+
+        // The private map. An erased item whose key is still in a
+        // frozen layer is kept as taaNONE until the next flatten.
+        mutable map_type map_;
+        mutable std::shared_ptr<Layer const> frozen_;
+    };
+
     Ledger::pointer mLedger;
     // Implementation requires an ordered container
-    std::map<uint256, Item> mEntries;
+    Entries mEntries;
     boost::optional<DeferredCredits> mDeferredCredits;
     TransactionMetaSet mSet;
     TransactionEngineParams mParams = tapNONE;
@@ -112,6 +171,12 @@ public:
         Effects:
             The copy is identical except that
             the sequence number is one higher.
+            The entries are shared with the original
+            rather than copied, so this is cheap even
+            when the original holds many entries.
+        Thread safety:
+            The original is modified internally, it
+            must not be in use by another thread.
     */
     LedgerEntrySet (LedgerEntrySet const&);
 
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/Protocol.h>
+#include <beast/utility/Journal.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class DatabaseCon;
+
+/** Maps ledger sequence numbers to ledger hashes without SQL.
+
+    The index mirrors the LedgerHash and PrevHash columns of the Ledgers
+    table. It is a dense array of fixed size slots, one per sequence
+    number, in a memory mapped file, so a lookup is a single offset
+    calculation. Slots for ledgers the server does not have are zero,
+    and the file stays sparse where history is missing.
+
+    The file is marked dirty while it is open. If the server stops
+    without closing it, or the file is missing, open() reports that the
+    index must be rebuilt from the Ledgers table.
+*/
+class LedgerHashIndex
+{
+public:
+    /** The file grows by this many slots at a time. */
+    static std::size_t const growBy = 65536;
+
+    explicit
+    LedgerHashIndex (beast::Journal journal);
+
+    ~LedgerHashIndex ();
+
+    LedgerHashIndex (LedgerHashIndex const&) = delete;
+    LedgerHashIndex& operator= (LedgerHashIndex const&) = delete;
+
+    /** Open the index file, creating it if needed.
+
+        @param path The file, or empty to keep the index in memory.
+        @return `false` if the index is empty and must be rebuilt.
+    */
+    bool
+    open (boost::filesystem::path const& path);
+
+    /** Flush the index and mark the file clean. */
+    void
+    close ();
+
+    /** Remove every entry. */
+    void
+    clear ();
+
+    /** Record a ledger written to the Ledgers table.
+
+        The parent hash is checked against the neighbouring entries.
+        A mismatch is logged; like the table, the index keeps both.
+    */
+    void
+    insert (LedgerIndex seq, uint256 const& hash,
+        uint256 const& parentHash);
+
+    /** Remove the entries for every ledger before `seq`. */
+    void
+    eraseBefore (LedgerIndex seq);
+
+    /** Returns the hash of a ledger, or zero if it is not indexed. */
+    uint256
+    getHash (LedgerIndex seq) const;
+
+    /** Retrieve the hash and parent hash of a ledger.
+
+        @return `false` if the ledger is not indexed.
+    */
+    bool
+    getHashes (LedgerIndex seq, uint256& hash, uint256& parentHash) const;
+
+private:
+    struct Header;
+
+    void
+    reset ();
+
+    void
+    grow (LedgerIndex seq);
+
+    void
+    map (std::size_t size);
+
+    Header&
+    header () const;
+
+    std::uint8_t*
+    slot (LedgerIndex seq) const;
+
+    beast::Journal j_;
+    boost::filesystem::path path_;
+
+    std::mutex mutable mutex_;
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    std::vector <std::uint8_t> memory_;
+    std::uint8_t* data_ = nullptr;
+    std::size_t slots_ = 0;
+};
+
+/** Refill the index from the Ledgers table. */
+void
+rebuildLedgerHashIndex (LedgerHashIndex& index, DatabaseCon& ledgerDB);
+
+} // ripple
+
+#endif
@@ -49,6 +49,13 @@ public:
         return m_ledgers_by_hash.getHitRate ();
     }
 
+    /** Get the ledgers_by_hash cache size and hit and miss counts */
+    void getCacheStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) const
+    {
+        m_ledgers_by_hash.getStats (size, hits, misses);
+    }
+
     /** Get a ledger given its squence number
         @param ledgerIndex The sequence number of the desired ledger
     */
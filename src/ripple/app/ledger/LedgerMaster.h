@@ -129,6 +129,8 @@ public:
     virtual void tune (int size, int age) = 0;
     virtual void sweep () = 0;
     virtual float getCacheHitRate () = 0;
+    virtual void getCacheStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) = 0;
     virtual void addValidateCallback (callback& c) = 0;
 
     virtual void checkAccept (Ledger::ref ledger) = 0;
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSQLWRITER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSQLWRITER_H_INCLUDED
+
+#include <ripple/app/ledger/PendingSaves.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/protocol/Protocol.h>
+#include <beast/utility/Journal.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class DatabaseCon;
+
+/** The SQL rows describing one fully-validated ledger.
+
+    Everything the Ledgers, Transactions and AccountTransactions
+    tables need is captured up front so that the rows can be written
+    later, without touching the ledger or its SHAMaps.
+*/
+struct LedgerSQLRows
+{
+    struct Transaction
+    {
+        std::string id;
+        std::string type;
+        std::string account;
+        std::uint32_t sequence = 0;
+        std::uint32_t txnSeq = 0;
+        Blob raw;
+        Blob meta;
+
+        /** The human readable IDs of every affected account. */
+        std::vector <std::string> affected;
+    };
+
+    LedgerIndex seq = 0;
+    std::string hash;
+    std::string parentHash;
+    std::string totalCoins;
+    std::uint32_t closeTime = 0;
+    std::uint32_t parentCloseTime = 0;
+    int closeResolution = 0;
+    std::uint32_t closeFlags = 0;
+    std::string accountHash;
+    std::string transHash;
+
+    std::vector <Transaction> transactions;
+};
+
+/** Write the rows for a batch of ledgers.
+
+    All the transaction rows go into the transaction database in a
+    single SQL transaction using prepared statements. The Ledgers rows
+    are removed before, and inserted after, the transaction rows so a
+    client never sees a ledger whose transactions are incomplete.
+
+    Only one database is checked out at a time.
+*/
+void
+saveLedgerRows (DatabaseCon& ledgerDB, DatabaseCon& txnDB,
+    std::vector <LedgerSQLRows> const& ledgers);
+
+/** Writes validated ledgers to SQL, batching concurrent requests.
+
+    Callers hand over the rows for one ledger. If no write is in progress
+    the caller becomes the writer and keeps writing until the queue is
+    empty, taking up to `maxBatch` ledgers per SQL transaction. Otherwise
+    the rows are queued for the active writer, which lets a burst of
+    saves (for example, while backfilling history) share transactions.
+
+    A ledger is removed from PendingSaves as soon as the batch holding
+    it commits, so clients observe the same per-ledger semantics as when
+    each ledger was written on its own. A ledger whose batch fails is
+    retried on its own. If that fails too, it is removed from
+    PendingSaves and handed to the failure handler, so that it can be
+    saved again later.
+*/
+class LedgerSQLWriter
+{
+public:
+    using Store = std::function <
+        void (std::vector <LedgerSQLRows> const&)>;
+
+    using Failed = std::function <void (LedgerSQLRows const&)>;
+
+    static std::size_t const defaultMaxBatch = 256;
+
+    /** Create a writer.
+
+        @param store Writes one batch, throwing on failure.
+        @param failed Called without the lock held for each ledger
+                      that could not be written.
+    */
+    LedgerSQLWriter (PendingSaves& pendingSaves, Store store, Failed failed,
+        beast::Journal journal, std::size_t maxBatch = defaultMaxBatch);
+
+    LedgerSQLWriter (LedgerSQLWriter const&) = delete;
+    LedgerSQLWriter& operator= (LedgerSQLWriter const&) = delete;
+
+    /** Write, or arrange to write, the rows for one ledger.
+
+        @param synchronous If `true`, does not return until the
+                           rows are written or have failed.
+        @return `false` if a synchronous write failed.
+    */
+    bool
+    write (LedgerSQLRows rows, bool synchronous);
+
+    /** Returns the number of ledgers waiting for a writer. */
+    std::size_t
+    size () const;
+
+private:
+    struct Pending
+    {
+        std::uint64_t ticket;
+        bool synchronous;
+        LedgerSQLRows rows;
+    };
+
+    void
+    drain (std::unique_lock <std::mutex>& lock);
+
+    bool
+    store (std::vector <LedgerSQLRows> const& batch);
+
+    void
+    fail (LedgerSQLRows const& rows);
+
+    PendingSaves& pendingSaves_;
+    Store store_;
+    Failed failed_;
+    beast::Journal j_;
+    std::size_t const maxBatch_;
+
+    std::mutex mutable mutex_;
+    std::condition_variable cond_;
+    std::deque <Pending> queue_;
+    bool writing_ = false;
+    std::uint64_t nextTicket_ = 0;
+    std::uint64_t written_ = 0;
+    std::set <std::uint64_t> failedTickets_;
+};
+
+} // ripple
+
+#endif
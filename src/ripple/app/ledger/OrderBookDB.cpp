@@ -222,12 +222,22 @@ BookListeners::pointer OrderBookDB::getBookListeners (Book const& book)
     return ret;
 }
 
+void OrderBookDB::getSubscribers (
+    hash_map <std::uint64_t, InfoSub::pointer>& subscribers)
+{
+    ScopedLockType sl (mLock);
+
+    for (auto const& listeners : mListeners)
+        listeners.second->getSubscribers (subscribers);
+}
+
 // Based on the meta, send the meta to the streams that are listening.
 // We need to determine which streams a given meta effects.
-void OrderBookDB::processTxn (
-    Ledger::ref ledger, const AcceptedLedgerTx& alTx, Json::Value const& jvObj)
+std::size_t OrderBookDB::processTxn (
+    Ledger::ref ledger, const AcceptedLedgerTx& alTx, StreamMessage& message)
 {
     ScopedLockType sl (mLock);
+    std::size_t notified = 0;
 
     if (alTx.getResult () == tesSUCCESS)
     {
@@ -264,7 +274,7 @@ void OrderBookDB::processTxn (
                                  data->getFieldAmount (sfTakerPays).issue()});
 
                             if (listeners)
-                                listeners->publish (jvObj);
+                                notified += listeners->publish (message);
                         }
                     }
                 }
@@ -276,6 +286,8 @@ void OrderBookDB::processTxn (
             }
         }
     }
+
+    return notified;
 }
 
 } // ripple
@@ -51,10 +51,15 @@ public:
     BookListeners::pointer getBookListeners (Book const&);
     BookListeners::pointer makeBookListeners (Book const&);
 
-    // see if this txn effects any orderbook
-    void processTxn (
+    /** Add the live subscribers to every book to a map keyed by sequence. */
+    void getSubscribers (
+        hash_map <std::uint64_t, InfoSub::pointer>& subscribers);
+
+    // see if this txn effects any orderbook, returns the
+    // number of subscribers notified
+    std::size_t processTxn (
         Ledger::ref ledger, const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+        StreamMessage& message);
 
     using IssueToOrderBook = hash_map <Issue, OrderBook::List>;
 
@@ -799,7 +799,8 @@ bool InboundLedger::takeHeader (std::string const& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector<std::shared_ptr<SHAMapTreeNode>>& nodes,
+        SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -816,7 +817,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     }
 
     auto nodeIDit = nodeIDs.cbegin ();
-    auto nodeDatait = data.begin ();
+    auto nodeit = nodes.begin ();
     TransactionStateSF tFilter;
 
     while (nodeIDit != nodeIDs.cend ())
@@ -824,20 +825,20 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
         if (nodeIDit->isRoot ())
         {
             san += mLedger->peekTransactionMap ()->addRootNode (
-                mLedger->getTransHash (), *nodeDatait, snfWIRE, &tFilter);
+                mLedger->getTransHash (), *nodeit, &tFilter);
             if (!san.isGood())
                 return false;
         }
         else
         {
             san +=  mLedger->peekTransactionMap ()->addKnownNode (
-                *nodeIDit, *nodeDatait, &tFilter);
+                *nodeIDit, *nodeit, &tFilter);
             if (!san.isGood())
                 return false;
         }
 
         ++nodeIDit;
-        ++nodeDatait;
+        ++nodeit;
     }
 
     if (!mLedger->peekTransactionMap ()->isSynching ())
@@ -859,7 +860,8 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector<std::shared_ptr<SHAMapTreeNode>>& nodes,
+        SHAMapAddNode& san)
 {
     if (m_journal.trace) m_journal.trace <<
         "got ASdata (" << nodeIDs.size () << ") acquiring ledger " << mHash;
@@ -883,7 +885,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
     }
 
     auto nodeIDit = nodeIDs.cbegin ();
-    auto nodeDatait = data.begin ();
+    auto nodeit = nodes.begin ();
     AccountStateSF tFilter;
 
     while (nodeIDit != nodeIDs.cend ())
@@ -891,7 +893,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         if (nodeIDit->isRoot ())
         {
             san += mLedger->peekAccountStateMap ()->addRootNode (
-                mLedger->getAccountHash (), *nodeDatait, snfWIRE, &tFilter);
+                mLedger->getAccountHash (), *nodeit, &tFilter);
             if (!san.isGood ())
             {
                 if (m_journal.warning) m_journal.warning <<
@@ -902,7 +904,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san += mLedger->peekAccountStateMap ()->addKnownNode (
-                *nodeIDit, *nodeDatait, &tFilter);
+                *nodeIDit, *nodeit, &tFilter);
             if (!san.isGood ())
             {
                 if (m_journal.warning) m_journal.warning <<
@@ -912,7 +914,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         }
 
         ++nodeIDit;
-        ++nodeDatait;
+        ++nodeit;
     }
 
     if (!mLedger->peekAccountStateMap ()->isSynching ())
@@ -1043,10 +1045,10 @@ bool InboundLedger::gotData (std::weak_ptr<Peer> peer,
 int InboundLedger::processData (std::shared_ptr<Peer> peer,
     protocol::TMLedgerData& packet)
 {
-    ScopedLockType sl (mLock);
-
     if (packet.type () == protocol::liBASE)
     {
+        ScopedLockType sl (mLock);
+
         if (packet.nodes_size () < 1)
         {
             if (m_journal.warning) m_journal.warning <<
@@ -1128,17 +1130,22 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 node.nodedata ().end ()));
         }
 
+        // Parse and hash the nodes before taking any lock
+        auto const nodes = SHAMap::makeNodes (nodeData, snfWIRE);
+
+        ScopedLockType sl (mLock);
+
         SHAMapAddNode ret;
 
         if (packet.type () == protocol::liTX_NODE)
         {
-            takeTxNode (nodeIDs, nodeData, ret);
+            takeTxNode (nodeIDs, nodes, ret);
             if (m_journal.debug) m_journal.debug <<
                 "Ledger TX node stats: " << ret.get();
         }
         else
         {
-            takeAsNode (nodeIDs, nodeData, ret);
+            takeAsNode (nodeIDs, nodes, ret);
             if (m_journal.debug) m_journal.debug <<
                 "Ledger AS node stats: " << ret.get();
         }
@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace ripple {
+
+LedgerCloseProfiler::LedgerCloseProfiler (
+        beast::insight::Collector::ptr const& collector, std::size_t history)
+    : history_ (std::max <std::size_t> (history, 1))
+{
+    for (int i = 0; i < phaseCount; ++i)
+        events_[i] = collector->make_event (getName (static_cast <Phase> (i)));
+}
+
+char const*
+LedgerCloseProfiler::getName (Phase phase)
+{
+    switch (phase)
+    {
+    case establish:     return "establish";
+    case apply:         return "apply";
+    case flush:         return "flush";
+    case accept:        return "accept";
+    case validate:      return "validate";
+    case openLedger:    return "open_ledger";
+    case publish:       return "publish";
+    case orderBook:     return "order_book";
+    case save:          return "save";
+    default:
+        break;
+    };
+
+    return "unknown";
+}
+
+void
+LedgerCloseProfiler::begin (LedgerIndex seq)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (auto record = find (seq))
+    {
+        *record = Record ();
+        record->seq = seq;
+        return;
+    }
+
+    if (records_.size () >= history_)
+        records_.pop_front ();
+
+    records_.emplace_back ();
+    records_.back ().seq = seq;
+}
+
+void
+LedgerCloseProfiler::addPhase (
+    LedgerIndex seq, Phase phase, duration elapsed)
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+
+        auto record = find (seq);
+        if (! record)
+            return;
+        record->phases[phase] += elapsed;
+    }
+
+    events_[phase].notify (elapsed);
+}
+
+void
+LedgerCloseProfiler::addTransactions (LedgerIndex seq, std::size_t count)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (auto record = find (seq))
+        record->transactions += count;
+}
+
+void
+LedgerCloseProfiler::addNodes (LedgerIndex seq, std::size_t count)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (auto record = find (seq))
+        record->nodes += count;
+}
+
+void
+LedgerCloseProfiler::addSubscribers (LedgerIndex seq, std::size_t count)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (auto record = find (seq))
+        record->subscribers += count;
+}
+
+std::vector <LedgerCloseProfiler::Record>
+LedgerCloseProfiler::getHistory (std::size_t limit) const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    limit = std::min (limit, records_.size ());
+    return std::vector <Record> (records_.rbegin (),
+        records_.rbegin () + limit);
+}
+
+Json::Value
+LedgerCloseProfiler::getJson (std::size_t limit) const
+{
+    Json::Value ret (Json::objectValue);
+    Json::Value& ledgers = (ret[jss::ledgers] = Json::arrayValue);
+
+    for (auto const& record : getHistory (limit))
+    {
+        Json::Value& entry = ledgers.append (Json::objectValue);
+        entry[jss::ledger_index] = record.seq;
+        entry[jss::transactions_applied] =
+            static_cast <Json::UInt> (record.transactions);
+        entry[jss::nodes_flushed] =
+            static_cast <Json::UInt> (record.nodes);
+        entry[jss::subscribers_notified] =
+            static_cast <Json::UInt> (record.subscribers);
+
+        Json::Value& phases = (entry[jss::phases] = Json::objectValue);
+        for (int i = 0; i < phaseCount; ++i)
+            phases[getName (static_cast <Phase> (i))] =
+                static_cast <Json::UInt> (record.phases[i].count ());
+    }
+
+    return ret;
+}
+
+LedgerCloseProfiler::Record*
+LedgerCloseProfiler::find (LedgerIndex seq)
+{
+    // Lookups are nearly always for one of the newest ledgers
+    for (auto iter = records_.rbegin (); iter != records_.rend (); ++iter)
+    {
+        if (iter->seq == seq)
+            return &*iter;
+    }
+
+    return nullptr;
+}
+
+} // ripple
@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/LedgerConsensus.h>
 #include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
@@ -33,6 +34,7 @@
 #include <ripple/app/tx/TransactionAcquire.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/ParallelFor.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/LoadFeeTrack.h>
@@ -936,36 +938,60 @@ private:
 
         // Build the new last closed ledger
         auto newLCL = std::make_shared<Ledger> (false, *mPreviousLedger);
+        auto const newSeq = newLCL->getLedgerSeq ();
 
-        // Set up to write SHAMap changes to our database,
-        //   perform updates, extract changes
-        WriteLog (lsDEBUG, LedgerConsensus)
-            << "Applying consensus set transactions to the"
-            << " last closed ledger";
-        applyTransactions (set, newLCL, newLCL, retriableTransactions, false);
-        newLCL->updateSkipList ();
-        newLCL->setClosed ();
-
-        int asf = newLCL->peekAccountStateMap ()->flushDirty (
-            hotACCOUNT_NODE, newLCL->getLedgerSeq());
-        int tmf = newLCL->peekTransactionMap ()->flushDirty (
-            hotTRANSACTION_NODE, newLCL->getLedgerSeq());
-        WriteLog (lsDEBUG, LedgerConsensus) << "Flushed " << asf << " accounts and " <<
-            tmf << " transaction nodes";
-
-        // Accept ledger
-        newLCL->setAccepted (closeTime, mCloseResolution, closeTimeCorrect);
-
-        // And stash the ledger in the ledger master
-        if (getApp().getLedgerMaster().storeLedger (newLCL))
-            WriteLog (lsDEBUG, LedgerConsensus)
-                << "Consensus built ledger we already had";
-        else if (getApp().getInboundLedgers().find (newLCL->getHash()))
+        auto& profiler = getApp().getLedgerCloseProfiler ();
+        profiler.begin (newSeq);
+        profiler.addPhase (newSeq, LedgerCloseProfiler::establish,
+            std::chrono::milliseconds (mCurrentMSeconds));
+
+        {
+            LedgerCloseProfiler::ScopedPhase phase (
+                profiler, newSeq, LedgerCloseProfiler::apply);
+
+            // Set up to write SHAMap changes to our database,
+            //   perform updates, extract changes
             WriteLog (lsDEBUG, LedgerConsensus)
-                << "Consensus built ledger we were acquiring";
-        else
+                << "Applying consensus set transactions to the"
+                << " last closed ledger";
+            profiler.addTransactions (newSeq, applyTransactions (
+                set, newLCL, newLCL, retriableTransactions, false));
+            newLCL->updateSkipList ();
+            newLCL->setClosed ();
+        }
+
+        {
+            LedgerCloseProfiler::ScopedPhase phase (
+                profiler, newSeq, LedgerCloseProfiler::flush);
+
+            int asf = newLCL->peekAccountStateMap ()->flushDirty (
+                hotACCOUNT_NODE, newSeq);
+            int tmf = newLCL->peekTransactionMap ()->flushDirty (
+                hotTRANSACTION_NODE, newSeq);
             WriteLog (lsDEBUG, LedgerConsensus)
-                << "Consensus built new ledger";
+                << "Flushed " << asf << " accounts and "
+                << tmf << " transaction nodes";
+            profiler.addNodes (newSeq, asf + tmf);
+        }
+
+        {
+            LedgerCloseProfiler::ScopedPhase phase (
+                profiler, newSeq, LedgerCloseProfiler::accept);
+
+            // Accept ledger
+            newLCL->setAccepted (closeTime, mCloseResolution, closeTimeCorrect);
+
+            // And stash the ledger in the ledger master
+            if (getApp().getLedgerMaster().storeLedger (newLCL))
+                WriteLog (lsDEBUG, LedgerConsensus)
+                    << "Consensus built ledger we already had";
+            else if (getApp().getInboundLedgers().find (newLCL->getHash()))
+                WriteLog (lsDEBUG, LedgerConsensus)
+                    << "Consensus built ledger we were acquiring";
+            else
+                WriteLog (lsDEBUG, LedgerConsensus)
+                    << "Consensus built new ledger";
+        }
 
         WriteLog (lsDEBUG, LedgerConsensus)
             << "Report: NewL  = " << newLCL->getHash ()
@@ -976,6 +1002,9 @@ private:
 
         if (mValidating && !mConsensusFail)
         {
+            LedgerCloseProfiler::ScopedPhase phase (
+                profiler, newSeq, LedgerCloseProfiler::validate);
+
             // Build validation
             uint256 signingHash;
             STValidation::pointer v =
@@ -1014,6 +1043,9 @@ private:
         // See if we can accept a ledger as fully-validated
         getApp().getLedgerMaster().consensusBuilt (newLCL);
 
+        LedgerCloseProfiler::ScopedPhase openPhase (
+            profiler, newSeq, LedgerCloseProfiler::openLedger);
+
         // Build new open ledger
         auto newOL = std::make_shared<Ledger> (true, *newLCL);
 
@@ -1838,6 +1870,44 @@ int applyTransaction (TransactionEngine& engine
     }
 }
 
+// Each pool thread gets at least this many candidates
+static std::size_t const preprocessItemsPerThread = 32;
+
+std::vector<STTx::pointer>
+preprocessTransactions (
+    std::vector<std::shared_ptr<SHAMapItem>> const& items,
+    bool allowMultiSign, ParallelPool& pool)
+{
+    std::vector<STTx::pointer> result (items.size ());
+
+    pool.parallel_for (items.size (), preprocessItemsPerThread,
+        [&](std::size_t i)
+        {
+            try
+            {
+                SerialIter sit (items[i]->slice());
+                auto txn = std::make_shared<STTx>(sit);
+
+                auto& router = getApp().getHashRouter ();
+                auto const id = txn->getTransactionID ();
+
+                if ((router.getFlags (id) & SF_SIGGOOD) != SF_SIGGOOD &&
+                    txn->checkSign (allowMultiSign))
+                {
+                    router.setFlag (id, SF_SIGGOOD);
+                }
+
+                result[i] = std::move (txn);
+            }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+            }
+        });
+
+    return result;
+}
+
 /** Apply a set of transactions to a ledger
 
   @param set                   The set of transactions to apply
@@ -1849,41 +1919,59 @@ int applyTransaction (TransactionEngine& engine
   @param retriableTransactions collect failed transactions in this set
   @param openLgr               true if applyLedger is open, else false.
 */
-void applyTransactions (std::shared_ptr<SHAMap> const& set,
+std::size_t applyTransactions (std::shared_ptr<SHAMap> const& set,
     Ledger::ref applyLedger, Ledger::ref checkLedger,
     CanonicalTXSet& retriableTransactions, bool openLgr)
 {
     TransactionEngine engine (applyLedger);
+    std::size_t applied = 0;
 
     if (set)
     {
+        std::vector<std::shared_ptr<SHAMapItem>> candidates;
+
         for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem (); !!item;
             item = set->peekNextItem (item->getTag ()))
         {
             // If the checkLedger doesn't have the transaction
             if (!checkLedger->hasTransaction (item->getTag ()))
+                candidates.push_back (item);
+        }
+
+        auto const txns = preprocessTransactions (candidates,
+            engine.enableMultiSign (), ParallelPool::instance ());
+
+        for (std::size_t i = 0; i < candidates.size (); ++i)
+        {
+            // Then try to apply the transaction to applyLedger
+            WriteLog (lsDEBUG, LedgerConsensus) <<
+                "Processing candidate transaction: " << candidates[i]->getTag ();
+
+            if (! txns[i])
+                continue;
+
+            try
             {
-                // Then try to apply the transaction to applyLedger
-                WriteLog (lsDEBUG, LedgerConsensus) <<
-                    "Processing candidate transaction: " << item->getTag ();
-                try
+                switch (applyTransaction (engine, txns[i], openLgr, true))
                 {
-                    SerialIter sit (item->slice());
-                    STTx::pointer txn
-                        = std::make_shared<STTx>(sit);
-                    if (applyTransaction (engine, txn,
-                              openLgr, true) == LedgerConsensusImp::resultRetry)
-                    {
-                        // On failure, stash the failed transaction for
-                        // later retry.
-                        retriableTransactions.push_back (txn);
-                    }
-                }
-                catch (...)
-                {
-                    WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+                case LedgerConsensusImp::resultSuccess:
+                    ++applied;
+                    break;
+
+                case LedgerConsensusImp::resultRetry:
+                    // On failure, stash the failed transaction for
+                    // later retry.
+                    retriableTransactions.push_back (txns[i]);
+                    break;
+
+                default:
+                    break;
                 }
             }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+            }
         }
     }
 
@@ -1909,6 +1997,7 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
                 case LedgerConsensusImp::resultSuccess:
                     it = retriableTransactions.erase (it);
                     ++changes;
+                    ++applied;
                     break;
 
                 case LedgerConsensusImp::resultFail:
@@ -1932,7 +2021,7 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
 
         // A non-retry pass made no changes
         if (!changes && !certainRetry)
-            return;
+            return applied;
 
         // Stop retriable passes
         if ((!changes) || (pass >= LEDGER_RETRY_PASSES))
@@ -1942,6 +2031,8 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
     // If there are any transactions left, we must have
     // tried them in at least one final pass
     assert (retriableTransactions.empty() || !certainRetry);
+
+    return applied;
 }
 
 } // ripple
@@ -0,0 +1,342 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace ripple {
+
+// Each slot holds the ledger hash followed by the parent hash
+static std::size_t const slotSize = 64;
+
+static std::uint32_t const currentVersion = 1;
+
+static char const magic[8] = { 'R', 'L', 'H', 'A', 'S', 'H', 'I', 'X' };
+
+struct LedgerHashIndex::Header
+{
+    char magic[8];
+    std::uint32_t version;
+
+    // Set only while the file is closed
+    std::uint32_t clean;
+
+    // No ledger before this one is indexed
+    std::uint32_t first;
+
+    char reserved[44];
+};
+
+static
+bool
+isZero (std::uint8_t const* p)
+{
+    return std::all_of (p, p + uint256::bytes,
+        [](std::uint8_t b) { return b == 0; });
+}
+
+LedgerHashIndex::LedgerHashIndex (beast::Journal journal)
+    : j_ (journal)
+{
+}
+
+LedgerHashIndex::~LedgerHashIndex ()
+{
+    close ();
+}
+
+bool
+LedgerHashIndex::open (boost::filesystem::path const& path)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    path_ = path;
+    bool trusted = false;
+
+    if (! path_.empty ())
+    {
+        boost::system::error_code ec;
+        auto const size = boost::filesystem::file_size (path_, ec);
+
+        if (! ec && size >= sizeof (Header) &&
+            (size - sizeof (Header)) % slotSize == 0)
+        {
+            map (size);
+            auto const& h = header ();
+            trusted =
+                std::equal (magic, magic + sizeof (magic), h.magic) &&
+                h.version == currentVersion &&
+                h.clean != 0;
+        }
+    }
+
+    if (! trusted)
+        reset ();
+
+    header ().clean = 0;
+    if (! path_.empty ())
+        region_.flush (0, sizeof (Header));
+
+    if (j_.info) j_.info <<
+        (trusted ? "Opened " : "Created ") << path_ <<
+        " with room for " << slots_ << " ledgers";
+
+    return trusted;
+}
+
+void
+LedgerHashIndex::close ()
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (! data_)
+        return;
+
+    header ().clean = 1;
+    if (! path_.empty ())
+        region_.flush ();
+
+    boost::interprocess::mapped_region ().swap (region_);
+    boost::interprocess::file_mapping ().swap (file_);
+    memory_.clear ();
+    data_ = nullptr;
+    slots_ = 0;
+}
+
+void
+LedgerHashIndex::clear ()
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    reset ();
+}
+
+void
+LedgerHashIndex::insert (LedgerIndex seq, uint256 const& hash,
+    uint256 const& parentHash)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (! data_)
+        return;
+
+    grow (seq);
+
+    if (seq > 0)
+    {
+        auto const prev = slot (seq - 1);
+        if (! isZero (prev) && uint256::fromVoid (prev) != parentHash)
+        {
+            if (j_.warning) j_.warning <<
+                "Ledger " << seq << " parent " << parentHash <<
+                " does not match " << uint256::fromVoid (prev);
+        }
+    }
+
+    if (seq + 1 < slots_)
+    {
+        auto const next = slot (seq + 1);
+        if (! isZero (next) &&
+            uint256::fromVoid (next + uint256::bytes) != hash)
+        {
+            if (j_.warning) j_.warning <<
+                "Ledger " << seq << " hash " << hash <<
+                " does not match parent of " << (seq + 1);
+        }
+    }
+
+    auto const p = slot (seq);
+    std::memcpy (p, hash.data (), uint256::bytes);
+    std::memcpy (p + uint256::bytes, parentHash.data (), uint256::bytes);
+
+    auto& h = header ();
+    h.first = std::min (h.first, seq);
+}
+
+void
+LedgerHashIndex::eraseBefore (LedgerIndex seq)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (! data_)
+        return;
+
+    auto& h = header ();
+    if (h.first >= seq)
+        return;
+
+    auto const end = std::min <std::size_t> (seq, slots_);
+    if (h.first < end)
+        std::memset (slot (h.first), 0, (end - h.first) * slotSize);
+    h.first = seq;
+}
+
+uint256
+LedgerHashIndex::getHash (LedgerIndex seq) const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (seq >= slots_)
+        return zero;
+
+    return uint256::fromVoid (slot (seq));
+}
+
+bool
+LedgerHashIndex::getHashes (LedgerIndex seq,
+    uint256& hash, uint256& parentHash) const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (seq >= slots_)
+        return false;
+
+    auto const p = slot (seq);
+    if (isZero (p))
+        return false;
+
+    hash = uint256::fromVoid (p);
+    parentHash = uint256::fromVoid (p + uint256::bytes);
+    return true;
+}
+
+void
+LedgerHashIndex::reset ()
+{
+    static_assert (sizeof (Header) == slotSize,
+        "The slots must stay aligned");
+
+    auto const size = sizeof (Header) + growBy * slotSize;
+
+    if (path_.empty ())
+    {
+        memory_.assign (size, 0);
+        data_ = memory_.data ();
+        slots_ = growBy;
+    }
+    else
+    {
+        // Unmap before truncating so no stale view survives
+        boost::interprocess::mapped_region ().swap (region_);
+        boost::interprocess::file_mapping ().swap (file_);
+        data_ = nullptr;
+        slots_ = 0;
+
+        std::ofstream (path_.string (), std::ios::binary | std::ios::trunc);
+        map (size);
+    }
+
+    auto& h = header ();
+    std::copy (magic, magic + sizeof (magic), h.magic);
+    h.version = currentVersion;
+    h.clean = 0;
+    h.first = std::numeric_limits <std::uint32_t>::max ();
+}
+
+void
+LedgerHashIndex::grow (LedgerIndex seq)
+{
+    if (seq < slots_)
+        return;
+
+    auto const slots = (seq / growBy + 1) * growBy;
+    auto const size = sizeof (Header) + slots * slotSize;
+
+    if (path_.empty ())
+    {
+        memory_.resize (size, 0);
+        data_ = memory_.data ();
+        slots_ = slots;
+    }
+    else
+    {
+        map (size);
+    }
+}
+
+void
+LedgerHashIndex::map (std::size_t size)
+{
+    using namespace boost::interprocess;
+
+    boost::interprocess::mapped_region ().swap (region_);
+
+    // The new space reads as zero and takes no disk until written
+    if (boost::filesystem::file_size (path_) != size)
+        boost::filesystem::resize_file (path_, size);
+
+    file_mapping (path_.string ().c_str (), read_write).swap (file_);
+    mapped_region (file_, read_write).swap (region_);
+
+    data_ = static_cast <std::uint8_t*> (region_.get_address ());
+    slots_ = (size - sizeof (Header)) / slotSize;
+}
+
+LedgerHashIndex::Header&
+LedgerHashIndex::header () const
+{
+    return *reinterpret_cast <Header*> (data_);
+}
+
+std::uint8_t*
+LedgerHashIndex::slot (LedgerIndex seq) const
+{
+    return data_ + sizeof (Header) + std::size_t (seq) * slotSize;
+}
+
+//------------------------------------------------------------------------------
+
+void
+rebuildLedgerHashIndex (LedgerHashIndex& index, DatabaseCon& ledgerDB)
+{
+    index.clear ();
+
+    auto db = ledgerDB.checkoutDb ();
+
+    std::uint64_t seq;
+    std::string hash;
+    boost::optional <std::string> parentHash;
+    soci::statement st = (db->prepare <<
+        "SELECT LedgerSeq,LedgerHash,PrevHash FROM Ledgers "
+        "ORDER BY LedgerSeq;",
+        soci::into (seq),
+        soci::into (hash),
+        soci::into (parentHash));
+
+    st.execute ();
+    while (st.fetch ())
+    {
+        uint256 h;
+        uint256 ph;
+        h.SetHexExact (hash);
+        if (parentHash)
+            ph.SetHexExact (*parentHash);
+        index.insert (rangeCheckedCast <LedgerIndex> (seq), h, ph);
+    }
+}
+
+} // ripple
@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
 #include <ripple/app/ledger/LedgerHistory.h>
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/ledger/PendingSaves.h>
@@ -950,6 +951,15 @@ public:
         // Try to get the hash of a ledger we need to fetch for history
         boost::optional<LedgerHash> ret;
 
+        // A ledger we have records the hash of its parent
+        {
+            LedgerHash hash;
+            LedgerHash parentHash;
+            if (getApp().getLedgerHashIndex ().getHashes (
+                    index + 1, hash, parentHash))
+                return parentHash;
+        }
+
         if (mHistLedger && (mHistLedger->getLedgerSeq() >= index))
         {
             ret = hashOfSeq(*mHistLedger, index,
@@ -1402,7 +1412,11 @@ public:
     // VFALCO NOTE This should return boost::optional<uint256>
     uint256 walkHashBySeq (std::uint32_t index)
     {
-        uint256 ledgerHash;
+        // Ledgers we have saved need no walk
+        uint256 ledgerHash = Ledger::getHashByIndex (index);
+        if (ledgerHash.isNonZero ())
+            return ledgerHash;
+
         Ledger::pointer referenceLedger;
 
         referenceLedger = mValidLedger.get ();
@@ -1559,6 +1573,12 @@ public:
         return mLedgerHistory.getCacheHitRate ();
     }
 
+    void getCacheStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) override
+    {
+        mLedgerHistory.getCacheStats (size, hits, misses);
+    }
+
     void addValidateCallback (callback& c)
     {
         mOnValidate.push_back (c);
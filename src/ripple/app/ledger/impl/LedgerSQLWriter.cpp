@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/STTx.h>
+#include <algorithm>
+
+namespace ripple {
+
+// soci's blob only grows on write, so empty it before reuse
+static
+void
+assign (soci::blob& to, Blob const& from)
+{
+    to.trim (0);
+    convert (from, to);
+}
+
+void
+saveLedgerRows (DatabaseCon& ledgerDB, DatabaseCon& txnDB,
+    std::vector <LedgerSQLRows> const& ledgers)
+{
+    if (ledgers.empty ())
+        return;
+
+    {
+        auto db = ledgerDB.checkoutDb ();
+        soci::transaction tr (*db);
+
+        LedgerIndex seq;
+        soci::statement deleteLedger = (db->prepare <<
+            "DELETE FROM Ledgers WHERE LedgerSeq = :seq;",
+            soci::use (seq));
+
+        for (auto const& ledger : ledgers)
+        {
+            seq = ledger.seq;
+            deleteLedger.execute (true);
+        }
+
+        tr.commit ();
+    }
+
+    {
+        auto db = txnDB.checkoutDb ();
+        soci::transaction tr (*db);
+
+        LedgerIndex seq;
+        std::string id;
+        std::string type;
+        std::string account;
+        std::string affected;
+        std::uint32_t sequence;
+        std::uint32_t txnSeq;
+        std::string const status (1, TXN_SQL_VALIDATED);
+        soci::blob raw (*db);
+        soci::blob meta (*db);
+
+        soci::statement deleteTrans = (db->prepare <<
+            "DELETE FROM Transactions WHERE LedgerSeq = :seq;",
+            soci::use (seq));
+        soci::statement deleteAcctTransBySeq = (db->prepare <<
+            "DELETE FROM AccountTransactions WHERE LedgerSeq = :seq;",
+            soci::use (seq));
+        soci::statement deleteAcctTrans = (db->prepare <<
+            "DELETE FROM AccountTransactions WHERE TransID = :id;",
+            soci::use (id));
+        soci::statement addAcctTrans = (db->prepare <<
+            "INSERT INTO AccountTransactions "
+            "(TransID, Account, LedgerSeq, TxnSeq) VALUES "
+            "(:id, :account, :seq, :txnSeq);",
+            soci::use (id), soci::use (affected),
+            soci::use (seq), soci::use (txnSeq));
+        soci::statement addTrans = (db->prepare <<
+            "INSERT OR REPLACE INTO Transactions "
+            "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, Status, "
+            "RawTxn, TxnMeta) VALUES "
+            "(:id, :type, :account, :sequence, :seq, :status, :raw, :meta);",
+            soci::use (id), soci::use (type), soci::use (account),
+            soci::use (sequence), soci::use (seq), soci::use (status),
+            soci::use (raw), soci::use (meta));
+
+        for (auto const& ledger : ledgers)
+        {
+            seq = ledger.seq;
+            deleteTrans.execute (true);
+            deleteAcctTransBySeq.execute (true);
+
+            for (auto const& tx : ledger.transactions)
+            {
+                id = tx.id;
+                deleteAcctTrans.execute (true);
+
+                txnSeq = tx.txnSeq;
+                for (auto const& a : tx.affected)
+                {
+                    affected = a;
+                    addAcctTrans.execute (true);
+                }
+
+                type = tx.type;
+                account = tx.account;
+                sequence = tx.sequence;
+                assign (raw, tx.raw);
+                assign (meta, tx.meta);
+                addTrans.execute (true);
+            }
+        }
+
+        tr.commit ();
+    }
+
+    {
+        auto db = ledgerDB.checkoutDb ();
+        soci::transaction tr (*db);
+
+        LedgerSQLRows row;
+        soci::statement addLedger = (db->prepare <<
+            "INSERT OR REPLACE INTO Ledgers "
+            "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,"
+            "PrevClosingTime,CloseTimeRes,CloseFlags,AccountSetHash,"
+            "TransSetHash) VALUES "
+            "(:hash,:seq,:prev,:coins,:close,:prevClose,:res,:flags,"
+            ":accountHash,:transHash);",
+            soci::use (row.hash), soci::use (row.seq),
+            soci::use (row.parentHash), soci::use (row.totalCoins),
+            soci::use (row.closeTime), soci::use (row.parentCloseTime),
+            soci::use (row.closeResolution), soci::use (row.closeFlags),
+            soci::use (row.accountHash), soci::use (row.transHash));
+
+        for (auto const& ledger : ledgers)
+        {
+            row.hash = ledger.hash;
+            row.seq = ledger.seq;
+            row.parentHash = ledger.parentHash;
+            row.totalCoins = ledger.totalCoins;
+            row.closeTime = ledger.closeTime;
+            row.parentCloseTime = ledger.parentCloseTime;
+            row.closeResolution = ledger.closeResolution;
+            row.closeFlags = ledger.closeFlags;
+            row.accountHash = ledger.accountHash;
+            row.transHash = ledger.transHash;
+            addLedger.execute (true);
+        }
+
+        tr.commit ();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+LedgerSQLWriter::LedgerSQLWriter (PendingSaves& pendingSaves,
+        Store store, Failed failed, beast::Journal journal,
+            std::size_t maxBatch)
+    : pendingSaves_ (pendingSaves)
+    , store_ (std::move (store))
+    , failed_ (std::move (failed))
+    , j_ (journal)
+    , maxBatch_ (std::max <std::size_t> (maxBatch, 1))
+{
+}
+
+bool
+LedgerSQLWriter::write (LedgerSQLRows rows, bool synchronous)
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+
+    auto const ticket = ++nextTicket_;
+    queue_.push_back ({ticket, synchronous, std::move (rows)});
+
+    if (! writing_)
+        drain (lock);
+    else if (! synchronous)
+        return true;
+
+    cond_.wait (lock, [&] { return written_ >= ticket; });
+    return failedTickets_.erase (ticket) == 0;
+}
+
+std::size_t
+LedgerSQLWriter::size () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return queue_.size ();
+}
+
+void
+LedgerSQLWriter::drain (std::unique_lock <std::mutex>& lock)
+{
+    writing_ = true;
+
+    while (! queue_.empty ())
+    {
+        auto const count = std::min (queue_.size (), maxBatch_);
+
+        std::vector <LedgerSQLRows> batch;
+        std::vector <std::uint64_t> tickets;
+        std::vector <bool> synchronous;
+        batch.reserve (count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& pending = queue_.front ();
+            tickets.push_back (pending.ticket);
+            synchronous.push_back (pending.synchronous);
+            batch.push_back (std::move (pending.rows));
+            queue_.pop_front ();
+        }
+
+        lock.unlock ();
+
+        std::vector <bool> saved (count, true);
+        if (! store (batch))
+        {
+            if (count == 1)
+            {
+                saved[0] = false;
+                fail (batch[0]);
+            }
+            else
+            {
+                // Don't let one bad ledger hold back the others
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    std::vector <LedgerSQLRows> single;
+                    single.push_back (std::move (batch[i]));
+                    saved[i] = store (single);
+                    if (! saved[i])
+                        fail (single[0]);
+                }
+            }
+        }
+
+        lock.lock ();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (synchronous[i] && ! saved[i])
+                failedTickets_.insert (tickets[i]);
+        }
+
+        written_ = tickets.back ();
+        cond_.notify_all ();
+    }
+
+    writing_ = false;
+}
+
+bool
+LedgerSQLWriter::store (std::vector <LedgerSQLRows> const& batch)
+{
+    try
+    {
+        store_ (batch);
+    }
+    catch (std::exception const& e)
+    {
+        if (j_.error) j_.error <<
+            "Failed to save " << batch.size () << " ledger(s) starting at " <<
+            batch.front ().seq << ": " << e.what ();
+        return false;
+    }
+
+    // Clients can now trust the database for
+    // information about these ledger sequences.
+    for (auto const& rows : batch)
+        pendingSaves_.erase (rows.seq);
+
+    if (j_.trace) j_.trace <<
+        "Saved " << batch.size () << " ledger(s) starting at " <<
+        batch.front ().seq;
+    return true;
+}
+
+void
+LedgerSQLWriter::fail (LedgerSQLRows const& rows)
+{
+    // Let a later attempt save this ledger sequence again
+    pendingSaves_.erase (rows.seq);
+
+    if (failed_)
+        failed_ (rows);
+}
+
+} // ripple
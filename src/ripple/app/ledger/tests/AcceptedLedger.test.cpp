@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/test/jtx.h>
+#include <beast/http/rfc2616.h>
+#include <beast/unit_test/suite.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class AcceptedLedgerTestBase : public beast::unit_test::suite
+{
+public:
+    // Funds the accounts and gives each of them some gateway USD
+    static
+    std::vector<jtx::Account>
+    setup (jtx::Env& env, jtx::Account const& gw, std::size_t n)
+    {
+        using namespace jtx;
+        auto const USD = gw["USD"];
+        env.fund (XRP (1000000), gw);
+
+        std::vector<Account> accounts;
+        accounts.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            accounts.emplace_back ("al" + std::to_string (i));
+            env.fund (XRP (1000000), accounts.back ());
+            env.trust (USD (1000000), accounts.back ());
+            env (pay (gw, accounts.back (), USD (100000)));
+        }
+        return accounts;
+    }
+
+    // Applies txs transactions to a new ledger and closes it. One in
+    // four is an offer that is not self funded, so rendering its JSON
+    // has to look up the owner's balance.
+    Ledger::pointer
+    closeLedger (jtx::Env& env, jtx::Account const& gw,
+        std::vector<jtx::Account> const& accounts, std::size_t txs)
+    {
+        using namespace jtx;
+        auto const USD = gw["USD"];
+
+        env.ledger = std::make_shared<Ledger> (false, *env.ledger);
+
+        // The Env applies to an open ledger, whose map holds no
+        // metadata, so apply the way a closing ledger does. One
+        // engine numbers the transactions within the ledger.
+        TransactionEngine engine (env.ledger, tx_enable_test);
+        for (std::size_t i = 0; i < txs; ++i)
+        {
+            auto const& from = accounts[i % accounts.size ()];
+            auto const& to = accounts[(i + 1) % accounts.size ()];
+            auto const jt = (i % 4 == 0)
+                ? env.jt (offer (from, XRP (10), USD (1)))
+                : env.jt (pay (from, to, XRP (1)));
+            STTx const stx (parse (jt.jv));
+            expect (engine.applyTransaction (
+                stx, tapNONE).first == tesSUCCESS);
+        }
+
+        auto const closed = env.ledger;
+        closed->setClosed ();
+        closed->getHash ();
+
+        // Later transactions go to the ledger after this one
+        env.ledger = std::make_shared<Ledger> (false, *closed);
+        return closed;
+    }
+};
+
+class AcceptedLedger_test : public AcceptedLedgerTestBase
+{
+public:
+    void
+    testBuild (std::size_t txs)
+    {
+        testcase ("build " + std::to_string (txs));
+
+        using namespace jtx;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 10);
+        auto const ledger = closeLedger (env, gw, accounts, txs);
+
+        auto const al = AcceptedLedger::makeAcceptedLedger (ledger);
+        expect (al->getTxnCount () == static_cast<int> (txs));
+        expect (al->getLedgerSeq () == ledger->getLedgerSeq ());
+        expect (AcceptedLedger::makeAcceptedLedger (ledger) == al);
+
+        // The map is ordered by the index within the ledger
+        int expected = 0;
+        for (auto const& entry : al->getMap ())
+        {
+            auto const& txn = entry.second;
+            expect (entry.first == expected++);
+            expect (txn->getIndex () == entry.first);
+            expect (txn->isApplied ());
+            expect (txn->getResult () == tesSUCCESS);
+            expect (! txn->getAffected ().empty ());
+            expect (ledger->hasTransaction (txn->getTransactionID ()));
+        }
+
+        // JSON is rendered on demand, and only once
+        auto const txn = al->getTxn (0);
+        expect (txn != nullptr);
+        if (! txn)
+            return;
+        auto const json = txn->getJson ();
+        expect (json.isMember (jss::transaction));
+        expect (json.isMember (jss::meta));
+        expect (json.isMember (jss::raw_meta));
+        expect (json.isMember (jss::result));
+        expect (json.isMember (jss::affected));
+        expect (json[jss::transaction].isMember (jss::owner_funds));
+        expect (txn->getJson () == json);
+    }
+
+    void
+    run () override
+    {
+        // Small ledgers are built on the calling thread
+        testBuild (8);
+        testBuild (200);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AcceptedLedger,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Times makeAcceptedLedger on large ledgers. "with subscribers" also
+// renders the JSON of every transaction, which is what every ledger
+// paid for before the JSON was built on demand.
+//
+// Arguments: txs=<transactions per ledger>,ledgers=<ledgers to time>
+//
+class AcceptedLedger_timing_test : public AcceptedLedgerTestBase
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    void
+    run () override
+    {
+        std::size_t txs = 2000;
+        std::size_t ledgers = 3;
+        for (auto const& kv : beast::rfc2616::split (
+            arg ().begin (), arg ().end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                continue;
+            auto const key = kv.substr (0, pos);
+            auto const value = kv.substr (pos + 1);
+            if (key == "txs")
+                txs = std::stoul (value);
+            else if (key == "ledgers")
+                ledgers = std::stoul (value);
+        }
+
+        using namespace jtx;
+        using namespace std::chrono;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 50);
+
+        log << txs << " transactions per ledger, " <<
+            std::thread::hardware_concurrency () << " cores";
+
+        for (std::size_t n = 0; n < ledgers; ++n)
+        {
+            auto const ledger = closeLedger (env, gw, accounts, txs);
+
+            auto const start = clock_type::now ();
+            auto const al = AcceptedLedger::makeAcceptedLedger (ledger);
+            auto const built = clock_type::now ();
+            std::size_t rendered = 0;
+            for (auto const& entry : al->getMap ())
+                rendered += entry.second->getJson ().size ();
+            auto const done = clock_type::now ();
+
+            expect (al->getTxnCount () == static_cast<int> (txs));
+            expect (rendered != 0);
+
+            auto const build = duration_cast<microseconds> (built - start);
+            auto const all = duration_cast<microseconds> (done - start);
+
+            std::stringstream ss;
+            ss << "ledger " << ledger->getLedgerSeq () << ":" <<
+                " without subscribers " << std::setw (8) <<
+                    build.count () / 1000 << " ms" <<
+                " (" << build.count () / txs << " us/tx)," <<
+                " with subscribers " << std::setw (8) <<
+                    all.count () / 1000 << " ms" <<
+                " (" << all.count () / txs << " us/tx)";
+            log << ss.str ();
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(AcceptedLedger_timing,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/insight/NullCollector.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class LedgerCloseProfiler_test : public beast::unit_test::suite
+{
+public:
+    using duration = LedgerCloseProfiler::duration;
+
+    void
+    testRecords ()
+    {
+        testcase ("records");
+
+        LedgerCloseProfiler profiler (beast::insight::NullCollector::New ());
+
+        profiler.begin (10);
+        profiler.addPhase (10, LedgerCloseProfiler::apply, duration (5));
+        profiler.addPhase (10, LedgerCloseProfiler::apply, duration (7));
+        profiler.addPhase (10, LedgerCloseProfiler::flush, duration (3));
+        profiler.addTransactions (10, 4);
+        profiler.addNodes (10, 20);
+        profiler.addSubscribers (10, 2);
+        profiler.addSubscribers (10, 1);
+
+        // Ledgers we did not close ourselves are not recorded
+        profiler.addPhase (11, LedgerCloseProfiler::save, duration (100));
+        profiler.addNodes (11, 1);
+
+        auto const history = profiler.getHistory (16);
+        expect (history.size () == 1);
+        if (history.size () != 1)
+            return;
+
+        auto const& record = history.front ();
+        expect (record.seq == 10);
+        expect (record.phases[LedgerCloseProfiler::apply] == duration (12));
+        expect (record.phases[LedgerCloseProfiler::flush] == duration (3));
+        expect (record.phases[LedgerCloseProfiler::save] == duration (0));
+        expect (record.transactions == 4);
+        expect (record.nodes == 20);
+        expect (record.subscribers == 3);
+
+        // Starting a record again discards what it held
+        profiler.begin (10);
+        expect (profiler.getHistory (16).front ().nodes == 0);
+    }
+
+    void
+    testHistory ()
+    {
+        testcase ("history");
+
+        LedgerCloseProfiler profiler (
+            beast::insight::NullCollector::New (), 4);
+
+        for (LedgerIndex seq = 1; seq <= 10; ++seq)
+        {
+            profiler.begin (seq);
+            profiler.addTransactions (seq, seq);
+        }
+
+        auto history = profiler.getHistory (100);
+        expect (history.size () == 4);
+        for (std::size_t i = 0; i < history.size (); ++i)
+        {
+            expect (history[i].seq == 10 - i);
+            expect (history[i].transactions == 10 - i);
+        }
+
+        history = profiler.getHistory (2);
+        expect (history.size () == 2);
+        expect (history.back ().seq == 9);
+
+        // The oldest ledgers are gone
+        profiler.addNodes (6, 1);
+        for (auto const& record : profiler.getHistory (100))
+            expect (record.nodes == 0);
+    }
+
+    void
+    testJson ()
+    {
+        testcase ("json");
+
+        LedgerCloseProfiler profiler (beast::insight::NullCollector::New ());
+
+        profiler.begin (5);
+        profiler.addPhase (5, LedgerCloseProfiler::publish, duration (42));
+        profiler.addTransactions (5, 3);
+        profiler.begin (6);
+
+        auto const json = profiler.getJson (1);
+        expect (json[jss::ledgers].size () == 1);
+
+        auto const& entry = json[jss::ledgers][0u];
+        expect (entry[jss::ledger_index].asUInt () == 6);
+        expect (entry[jss::transactions_applied].asUInt () == 0);
+        expect (entry[jss::phases].size () == LedgerCloseProfiler::phaseCount);
+        expect (entry[jss::phases]["open_ledger"].asUInt () == 0);
+
+        auto const both = profiler.getJson (2);
+        expect (both[jss::ledgers].size () == 2);
+
+        auto const& older = both[jss::ledgers][1u];
+        expect (older[jss::ledger_index].asUInt () == 5);
+        expect (older[jss::transactions_applied].asUInt () == 3);
+        expect (older[jss::phases]["publish"].asUInt () == 42);
+    }
+
+    void
+    run ()
+    {
+        testRecords ();
+        testHistory ();
+        testJson ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerCloseProfiler,app,ripple);
+
+} // ripple
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/tests/common_ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/IHashRouter.h>
+#include <ripple/basics/ParallelFor.h>
+#include <ripple/basics/Log.h>
+
+namespace ripple {
+namespace test {
+
+class LedgerConsensus_test : public beast::unit_test::suite
+{
+    // Enough transactions that the set is shared with the pool
+    static std::size_t const accountCount = 80;
+
+    std::uint64_t const xrp = std::mega::num;
+
+    struct Fixture
+    {
+        Ledger::pointer LCL;
+        std::shared_ptr<SHAMap> set;
+        std::vector<uint256> good;
+        uint256 badSignature;
+        uint256 unparseable;
+    };
+
+    static
+    void
+    add (SHAMap& set, STTx const& tx)
+    {
+        set.addItem (SHAMapItem (
+            tx.getTransactionID (), tx.getSerializer ()), true, false);
+    }
+
+    static
+    std::vector<std::shared_ptr<SHAMapItem>>
+    items (SHAMap& set)
+    {
+        std::vector<std::shared_ptr<SHAMapItem>> result;
+        for (auto item = set.peekFirstItem (); item;
+                item = set.peekNextItem (item->getTag ()))
+            result.push_back (item);
+        return result;
+    }
+
+    // Funds accounts that each pay the master once, plus one payment whose
+    // signature belongs to a different transaction and one truncated blob
+    Fixture
+    makeFixture ()
+    {
+        auto master = createAccount ("masterpassphrase", KeyType::secp256k1);
+
+        Fixture fixture;
+        Ledger::pointer ledger;
+        std::tie (fixture.LCL, ledger) =
+            createGenesisLedger (100000000 * xrp, master);
+
+        std::vector<TestAccount> accounts;
+        for (std::size_t i = 0; i < accountCount; ++i)
+            accounts.push_back (createAndFundAccount (master,
+                "pp" + std::to_string (i), KeyType::secp256k1,
+                1000 * xrp, ledger));
+        auto bad = createAndFundAccount (master, "badsig",
+            KeyType::secp256k1, 1000 * xrp, ledger);
+        close_and_advance (ledger, fixture.LCL);
+
+        fixture.set = std::make_shared<SHAMap> (SHAMapType::TRANSACTION,
+            getApp().family(), deprecatedLogs().journal("SHAMap"));
+
+        for (auto& account : accounts)
+        {
+            auto const tx = getPaymentTx (account, master, xrp);
+            add (*fixture.set, tx);
+            fixture.good.push_back (tx.getTransactionID ());
+        }
+
+        auto tx = getPaymentTx (bad, master, xrp);
+        auto const other = getPaymentTx (accounts.front (), master, xrp);
+        tx.setFieldVL (sfTxnSignature, other.getFieldVL (sfTxnSignature));
+        add (*fixture.set, tx);
+        fixture.badSignature = tx.getTransactionID ();
+
+        auto const data = other.getSerializer ().peekData ();
+        fixture.unparseable.SetHex (
+            "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF");
+        fixture.set->addItem (SHAMapItem (fixture.unparseable,
+            Blob (data.begin (), data.begin () + data.size () / 2)),
+                true, false);
+
+        return fixture;
+    }
+
+    void
+    testPreprocess ()
+    {
+        testcase ("preprocess");
+
+        auto const fixture = makeFixture ();
+        auto const candidates = items (*fixture.set);
+
+        ParallelPool serial (0);
+        ParallelPool parallel (3);
+        auto const expected =
+            preprocessTransactions (candidates, false, serial);
+        auto const actual =
+            preprocessTransactions (candidates, false, parallel);
+
+        expect (expected.size () == candidates.size ());
+        expect (actual.size () == candidates.size ());
+
+        std::size_t parsed = 0;
+        for (std::size_t i = 0; i < candidates.size (); ++i)
+        {
+            auto const tag = candidates[i]->getTag ();
+            if (tag == fixture.unparseable)
+            {
+                expect (! expected[i], "Should not parse");
+                expect (! actual[i], "Should not parse");
+                continue;
+            }
+            if (! expect (expected[i] && actual[i], "Should parse"))
+                continue;
+            ++parsed;
+            expect (expected[i]->getTransactionID () == tag);
+            expect (actual[i]->getTransactionID () == tag);
+        }
+        expect (parsed == accountCount + 1);
+
+        auto& router = getApp().getHashRouter ();
+        for (auto const& id : fixture.good)
+            expect ((router.getFlags (id) & SF_SIGGOOD) == SF_SIGGOOD,
+                "Good signature should be cached");
+        expect ((router.getFlags (fixture.badSignature) & SF_SIGGOOD) == 0,
+            "Bad signature should not be cached");
+    }
+
+    // The whole set against the same items applied one by one, where
+    // each is parsed on the calling thread as it is applied
+    void
+    testApply ()
+    {
+        testcase ("apply");
+
+        auto const fixture = makeFixture ();
+
+        auto batched = std::make_shared<Ledger> (false, *fixture.LCL);
+        CanonicalTXSet retriable (fixture.set->getHash ());
+        auto const applied = applyTransactions (
+            fixture.set, batched, batched, retriable, false);
+
+        auto serial = std::make_shared<Ledger> (false, *fixture.LCL);
+        std::size_t serialApplied = 0;
+        for (auto const& item : items (*fixture.set))
+        {
+            auto single = std::make_shared<SHAMap> (SHAMapType::TRANSACTION,
+                getApp().family(), deprecatedLogs().journal("SHAMap"));
+            single->addItem (*item, true, false);
+            CanonicalTXSet singleRetriable (single->getHash ());
+            serialApplied += applyTransactions (
+                single, serial, serial, singleRetriable, false);
+        }
+
+        expect (applied == accountCount, "Should apply the good payments");
+        expect (applied == serialApplied);
+        expect (batched->peekAccountStateMap ()->getHash () ==
+            serial->peekAccountStateMap ()->getHash (),
+                "State should match the serial apply");
+        // Each serial call numbers its transactions from zero, so the
+        // metadata differs. Compare which transactions were applied.
+        for (auto const& id : fixture.good)
+            expect (batched->hasTransaction (id) &&
+                serial->hasTransaction (id),
+                    "Transactions should match the serial apply");
+        expect (! batched->hasTransaction (fixture.badSignature));
+        expect (! batched->hasTransaction (fixture.unparseable));
+    }
+
+public:
+    void run ()
+    {
+        testPreprocess ();
+        testApply ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerConsensus,ripple_app,ripple);
+
+} // test
+} // ripple
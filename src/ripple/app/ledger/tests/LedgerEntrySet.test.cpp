@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/tests/common_ledger.h>
+#include <ripple/app/paths/RippleCalc.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class LedgerEntrySet_test : public beast::unit_test::suite
+{
+    Ledger::pointer ledger_;
+    ripple::Account gwAcc_;
+    ripple::Account aliceAcc_;
+    ripple::Currency usd_;
+
+    void setup ()
+    {
+        auto const keyType = KeyType::ed25519;
+        std::uint64_t const xrp = std::mega::num;
+
+        auto master = createAccount ("masterpassphrase", keyType);
+
+        Ledger::pointer LCL;
+        std::tie (LCL, ledger_) = createGenesisLedger (100000 * xrp, master);
+
+        auto accounts =
+            createAndFundAccountsWithFlags (master,
+                                            {"alice", "gw"},
+                                            keyType,
+                                            10000 * xrp,
+                                            ledger_,
+                                            LCL,
+                                            asfDefaultRipple);
+        auto& gw = accounts["gw"];
+        auto& alice = accounts["alice"];
+
+        close_and_advance (ledger_, LCL);
+
+        trust (alice, gw, "USD", 1000, ledger_);
+        pay (gw, alice, "USD", "50", ledger_);
+
+        close_and_advance (ledger_, LCL);
+
+        gwAcc_ = gw.pk.getAccountID ();
+        aliceAcc_ = alice.pk.getAccountID ();
+        usd_ = to_currency ("USD");
+    }
+
+    STAmount held (LedgerEntrySet& les)
+    {
+        return les.accountHolds (aliceAcc_, usd_, gwAcc_, fhIGNORE_FREEZE);
+    }
+
+    // Read a set through a copy so the set itself is left untouched
+    STAmount heldIn (LedgerEntrySet const& les)
+    {
+        LedgerEntrySet view (les);
+        return held (view);
+    }
+
+    STAmount usd (int value)
+    {
+        return STAmount (Issue (usd_, gwAcc_), value);
+    }
+
+    void testCheckpoint ()
+    {
+        testcase ("checkpoint");
+
+        LedgerEntrySet les (ledger_, tapNONE);
+        STAmount const start = held (les);
+
+        les.accountSend (gwAcc_, aliceAcc_, usd (10));
+        expect (held (les) == start + usd (10));
+
+        // Each retry starts over from the checkpoint, as RippleCalc does
+        LedgerEntrySet const checkpoint (les);
+        for (int i = 1; i <= 3; ++i)
+        {
+            reconstruct (les, checkpoint);
+            expect (held (les) == start + usd (10));
+
+            les.accountSend (gwAcc_, aliceAcc_, usd (i));
+            expect (held (les) == start + usd (10 + i));
+        }
+
+        expect (heldIn (checkpoint) == start + usd (10));
+    }
+
+    void testChain ()
+    {
+        testcase ("chain");
+
+        // Deep enough that the frozen layers get merged
+        int const depth = 20;
+
+        std::vector <std::unique_ptr <LedgerEntrySet>> chain;
+        chain.emplace_back (new LedgerEntrySet (ledger_, tapNONE));
+        STAmount const start = held (*chain.back ());
+
+        for (int i = 1; i <= depth; ++i)
+        {
+            chain.emplace_back (new LedgerEntrySet (*chain.back ()));
+            chain.back ()->accountSend (gwAcc_, aliceAcc_, usd (1));
+        }
+
+        for (int i = 0; i <= depth; ++i)
+            expect (heldIn (*chain[i]) == start + usd (i));
+
+        // Swapping exchanges whole views
+        chain.front ()->swapWith (*chain.back ());
+        expect (heldIn (*chain.front ()) == start + usd (depth));
+        expect (heldIn (*chain.back ()) == start);
+    }
+
+    void testErase ()
+    {
+        testcase ("erase");
+
+        uint256 first;
+        first.SetHex (
+            "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF00");
+        uint256 second = first;
+        ++second;
+        uint256 before = first;
+        --before;
+
+        LedgerEntrySet les (ledger_, tapNONE);
+        les.entryCreate (std::make_shared <SLE> (ltACCOUNT_ROOT, first));
+        les.entryCreate (std::make_shared <SLE> (ltACCOUNT_ROOT, second));
+        expect (les.getNextLedgerIndex (before) == first);
+
+        // Deleting a created entry drops it, even though
+        // the set it was copied from still holds it.
+        LedgerEntrySet copy (les);
+        copy.entryDelete (copy.entryCache (ltACCOUNT_ROOT, first));
+        expect (! copy.entryCache (ltACCOUNT_ROOT, first));
+        expect (copy.getNextLedgerIndex (before) == second);
+
+        copy.entryDelete (copy.entryCache (ltACCOUNT_ROOT, second));
+        expect (copy.getNextLedgerIndex (before) ==
+            ledger_->getNextLedgerIndex (second));
+
+        // Recreating after the delete is allowed
+        copy.entryCreate (std::make_shared <SLE> (ltACCOUNT_ROOT, first));
+        expect (copy.getNextLedgerIndex (before) == first);
+
+        LedgerEntrySet other (les);
+        expect (other.entryCache (ltACCOUNT_ROOT, first) != nullptr);
+        expect (other.entryCache (ltACCOUNT_ROOT, second) != nullptr);
+        expect (other.getNextLedgerIndex (before) == first);
+    }
+
+public:
+    void run ()
+    {
+        setup ();
+        testCheckpoint ();
+        testChain ();
+        testErase ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (LedgerEntrySet, ledger, ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures a payment that RippleCalc spreads over six paths,
+// each crossing two books with many offers at staggered qualities.
+class LedgerEntrySet_timing_test : public beast::unit_test::suite
+{
+public:
+    void
+    run ()
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        auto const keyType = KeyType::ed25519;
+        std::uint64_t const xrp = std::mega::num;
+
+        std::vector <std::string> const currencies {
+            "AUD", "CAD", "CHF", "GBP", "JPY", "NZD" };
+        int const offersPerBook = 50;
+        int const iterations = 20;
+
+        auto master = createAccount ("masterpassphrase", keyType);
+
+        Ledger::pointer LCL;
+        Ledger::pointer ledger;
+        std::tie (LCL, ledger) = createGenesisLedger (1000000 * xrp, master);
+
+        std::vector <std::string> names {"snd", "rcv", "gw"};
+        for (std::size_t i = 0; i < currencies.size (); ++i)
+            names.push_back ("mm" + std::to_string (i));
+
+        auto accounts =
+            createAndFundAccountsWithFlags (master,
+                                            names,
+                                            keyType,
+                                            10000 * xrp,
+                                            ledger,
+                                            LCL,
+                                            asfDefaultRipple);
+        auto& gw = accounts["gw"];
+        auto& snd = accounts["snd"];
+        auto& rcv = accounts["rcv"];
+
+        close_and_advance (ledger, LCL);
+
+        double const bookSize = 10.0 * offersPerBook;
+
+        trust (snd, gw, "USD", 100 * bookSize, ledger);
+        trust (rcv, gw, "EUR", 100 * bookSize, ledger);
+        pay (gw, snd, "USD", std::to_string (10 * bookSize), ledger);
+
+        STPathSet paths;
+        ripple::Account const gwAcc (gw.pk.getAccountID ());
+
+        for (std::size_t i = 0; i < currencies.size (); ++i)
+        {
+            auto& mm = accounts["mm" + std::to_string (i)];
+            auto const& cur = currencies[i];
+
+            trust (mm, gw, "USD", 100 * bookSize, ledger);
+            trust (mm, gw, cur, 100 * bookSize, ledger);
+            trust (mm, gw, "EUR", 100 * bookSize, ledger);
+            pay (gw, mm, cur, std::to_string (2 * bookSize), ledger);
+            pay (gw, mm, "EUR", std::to_string (2 * bookSize), ledger);
+
+            // Qualities interleave across the paths,
+            // so the best path changes from pass to pass.
+            for (int k = 0; k < offersPerBook; ++k)
+            {
+                double const rate =
+                    1.0 - 0.0005 * (k * currencies.size () + i);
+                createOffer (mm,
+                    Amount (10, "USD", gw),
+                    Amount (10 * rate, cur, gw), ledger);
+                createOffer (mm,
+                    Amount (10, cur, gw),
+                    Amount (10, "EUR", gw), ledger);
+            }
+
+            STPath path;
+            path.emplace_back (STPathElement::typeCurrency |
+                STPathElement::typeIssuer, xrpAccount (),
+                    to_currency (cur), gwAcc);
+            path.emplace_back (STPathElement::typeCurrency |
+                STPathElement::typeIssuer, xrpAccount (),
+                    to_currency ("EUR"), gwAcc);
+            paths.push_back (path);
+        }
+
+        close_and_advance (ledger, LCL);
+
+        // Takes about half of the liquidity on every path
+        STAmount const maxIn (Issue (to_currency ("USD"), gwAcc),
+            static_cast <std::uint64_t> (10 * bookSize));
+        STAmount const deliver (Issue (to_currency ("EUR"), gwAcc),
+            static_cast <std::uint64_t> (bookSize * currencies.size () / 2));
+
+        path::RippleCalc::Input input;
+        input.partialPaymentAllowed = true;
+        input.defaultPathsAllowed = false;
+
+        clock_type::duration total {};
+        std::size_t entries = 0;
+
+        for (int n = 0; n < iterations; ++n)
+        {
+            LedgerEntrySet les (ledger, tapNONE);
+
+            auto const start = clock_type::now ();
+            auto const output = path::RippleCalc::rippleCalculate (les,
+                maxIn, deliver, rcv.pk.getAccountID (),
+                    snd.pk.getAccountID (), paths, &input);
+            total += clock_type::now () - start;
+
+            expect (output.result () == tesSUCCESS);
+            expect (output.actualAmountOut == deliver);
+            entries = les.getJson (0)[jss::nodes].size ();
+        }
+
+        log <<
+            currencies.size () << " paths, " << offersPerBook <<
+            " offers per book: " << std::chrono::duration_cast <
+                std::chrono::microseconds> (total).count () / iterations <<
+            "us per payment, " << entries << " entries touched";
+
+        // The cost of one checkpoint of a set that has touched them all
+        {
+            LedgerEntrySet les (ledger, tapNONE);
+            path::RippleCalc::rippleCalculate (les, maxIn, deliver,
+                rcv.pk.getAccountID (), snd.pk.getAccountID (),
+                    paths, &input);
+
+            int const copies = 10000;
+            auto const start = clock_type::now ();
+            for (int n = 0; n < copies; ++n)
+            {
+                LedgerEntrySet checkpoint (les);
+                reconstruct (les, checkpoint);
+            }
+            auto const elapsed = clock_type::now () - start;
+
+            log <<
+                "checkpoint and restore: " << std::chrono::duration_cast <
+                    std::chrono::nanoseconds> (elapsed).count () / copies <<
+                "ns";
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL (LedgerEntrySet_timing, ledger, ripple);
+
+}  // test
+}  // ripple
@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ripple {
+
+class LedgerHashIndex_test : public beast::unit_test::suite
+{
+public:
+    // Made up hashes that chain: the parent of n is hashOf (n - 1)
+    static
+    uint256
+    hashOf (LedgerIndex seq)
+    {
+        uint256 h;
+        h.SetHex (std::to_string (seq) + "abc");
+        return h;
+    }
+
+    static
+    void
+    insert (LedgerHashIndex& index, LedgerIndex seq)
+    {
+        index.insert (seq, hashOf (seq), hashOf (seq - 1));
+    }
+
+    bool
+    has (LedgerHashIndex const& index, LedgerIndex seq)
+    {
+        uint256 hash;
+        uint256 parentHash;
+        if (! index.getHashes (seq, hash, parentHash))
+            return false;
+        return hash == hashOf (seq) && parentHash == hashOf (seq - 1) &&
+            index.getHash (seq) == hash;
+    }
+
+    void
+    testLookup (boost::filesystem::path const& path)
+    {
+        testcase (path.empty () ? "lookup in memory" : "lookup in a file");
+
+        LedgerHashIndex index ((beast::Journal ()));
+        expect (! index.open (path));
+
+        for (LedgerIndex seq = 100; seq < 200; ++seq)
+            insert (index, seq);
+
+        // Far enough out to make the index grow
+        auto const far = 3 * LedgerHashIndex::growBy + 7;
+        insert (index, far);
+
+        bool ok = true;
+        for (LedgerIndex seq = 100; seq < 200; ++seq)
+            ok = ok && has (index, seq);
+        expect (ok);
+        expect (has (index, far));
+
+        uint256 hash;
+        uint256 parentHash;
+        expect (index.getHash (99).isZero ());
+        expect (! index.getHashes (99, hash, parentHash));
+        expect (index.getHash (far + 1).isZero ());
+        expect (index.getHash (far * 4).isZero ());
+
+        index.eraseBefore (150);
+        expect (! has (index, 149));
+        expect (has (index, 150));
+        expect (has (index, far));
+
+        index.clear ();
+        expect (! has (index, 150));
+        expect (! has (index, far));
+    }
+
+    void
+    testReopen (boost::filesystem::path const& path,
+        boost::filesystem::path const& crashed)
+    {
+        testcase ("reopen");
+
+        {
+            LedgerHashIndex index ((beast::Journal ()));
+            expect (! index.open (path));
+            for (LedgerIndex seq = 2; seq < 1000; ++seq)
+                insert (index, seq);
+        }
+
+        // A clean close keeps the contents
+        {
+            LedgerHashIndex index ((beast::Journal ()));
+            expect (index.open (path));
+            expect (has (index, 2));
+            expect (has (index, 999));
+            expect (! has (index, 1000));
+
+            // While open the file is marked dirty, so a copy taken now
+            // looks like the file left behind by a crash
+            boost::filesystem::copy_file (path, crashed);
+        }
+
+        {
+            LedgerHashIndex index ((beast::Journal ()));
+            expect (! index.open (crashed));
+            expect (! has (index, 2));
+        }
+
+        // A file from something else is replaced
+        {
+            std::ofstream (path.string (), std::ios::trunc) << "not an index";
+            LedgerHashIndex index ((beast::Journal ()));
+            expect (! index.open (path));
+            expect (! has (index, 2));
+        }
+    }
+
+    void
+    testRebuild ()
+    {
+        testcase ("rebuild");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon ledgerDB (setup, "ledger.db",
+            LedgerDBInit, LedgerDBCount);
+
+        {
+            auto db = ledgerDB.checkoutDb ();
+            for (LedgerIndex seq = 10; seq < 20; ++seq)
+            {
+                auto const hash = to_string (hashOf (seq));
+                auto const parentHash = to_string (hashOf (seq - 1));
+                *db << "INSERT INTO Ledgers (LedgerHash,LedgerSeq,PrevHash) "
+                    "VALUES (:hash,:seq,:prev);",
+                    soci::use (hash), soci::use (seq),
+                    soci::use (parentHash);
+            }
+        }
+
+        LedgerHashIndex index ((beast::Journal ()));
+        index.open ({});
+        insert (index, 5);
+        rebuildLedgerHashIndex (index, ledgerDB);
+
+        expect (! has (index, 5));
+        expect (! has (index, 9));
+        bool ok = true;
+        for (LedgerIndex seq = 10; seq < 20; ++seq)
+            ok = ok && has (index, seq);
+        expect (ok);
+        expect (! has (index, 20));
+    }
+
+    void
+    run () override
+    {
+        beast::UnitTestUtilities::TempDirectory dir ("ledger_hashes");
+        boost::filesystem::path const path (
+            dir.getFullPathName ().toStdString ());
+        boost::filesystem::create_directories (path);
+
+        testLookup ({});
+        testLookup (path / "ledger_hashes.idx");
+        testReopen (path / "reopen.idx", path / "crashed.idx");
+        testRebuild ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerHashIndex,app,ripple);
+
+} // ripple
@@ -0,0 +1,380 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <beast/unit_test/suite.h>
+#include <beast/cxx14/memory.h>  // <memory>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace ripple {
+
+namespace detail {
+
+// Builds the rows for a made up ledger
+static
+LedgerSQLRows
+makeLedgerRows (LedgerIndex seq, std::size_t txCount)
+{
+    auto hex = [](std::uint64_t v)
+    {
+        std::string s (64, '0');
+        auto const h = strHex (v);
+        std::copy (h.begin (), h.end (), s.end () - h.size ());
+        return s;
+    };
+
+    LedgerSQLRows rows;
+    rows.seq = seq;
+    rows.hash = hex ((std::uint64_t (seq) << 1) | 1);
+    rows.parentHash = hex (((std::uint64_t (seq) - 1) << 1) | 1);
+    rows.totalCoins = "99999999999999990";
+    rows.closeTime = 10 * seq;
+    rows.parentCloseTime = 10 * (seq - 1);
+    rows.closeResolution = 30;
+    rows.accountHash = hex (seq + 2);
+    rows.transHash = hex (seq + 3);
+
+    for (std::size_t i = 0; i < txCount; ++i)
+    {
+        LedgerSQLRows::Transaction tx;
+        tx.id = hex ((std::uint64_t (seq) << 20) + i);
+        tx.type = "Payment";
+        tx.account = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        tx.sequence = static_cast <std::uint32_t> (i + 1);
+        tx.txnSeq = static_cast <std::uint32_t> (i);
+        tx.raw.assign (120 + i % 8, static_cast <unsigned char> (i));
+        tx.meta.assign (300 - i % 8, static_cast <unsigned char> (seq));
+        tx.affected.push_back (tx.account);
+        tx.affected.push_back ("rPMh7Pi9ct699iZUTWaytJUoHcJ7cgyziK");
+        rows.transactions.push_back (std::move (tx));
+    }
+    return rows;
+}
+
+// A ledger and transaction database pair
+struct TestDatabases
+{
+    std::unique_ptr <DatabaseCon> ledgerDB;
+    std::unique_ptr <DatabaseCon> txnDB;
+
+    // Leave `dataDir` empty for temporary databases
+    explicit
+    TestDatabases (boost::filesystem::path const& dataDir = {})
+    {
+        DatabaseCon::Setup setup;
+        setup.standAlone = dataDir.empty ();
+        setup.dataDir = dataDir;
+        txnDB = std::make_unique <DatabaseCon> (setup, "transaction.db",
+            TxnDBInit, TxnDBCount);
+        ledgerDB = std::make_unique <DatabaseCon> (setup, "ledger.db",
+            LedgerDBInit, LedgerDBCount);
+    }
+
+    void
+    save (std::vector <LedgerSQLRows> const& ledgers)
+    {
+        saveLedgerRows (*ledgerDB, *txnDB, ledgers);
+    }
+
+    int
+    count (DatabaseCon& con, std::string const& sql)
+    {
+        auto db = con.checkoutDb ();
+        int n = 0;
+        *db << sql, soci::into (n);
+        return n;
+    }
+};
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+class LedgerSQLWriter_test : public beast::unit_test::suite
+{
+public:
+    void
+    testSaveRows ()
+    {
+        testcase ("save rows");
+
+        using detail::makeLedgerRows;
+        detail::TestDatabases dbs;
+
+        dbs.save ({makeLedgerRows (2, 3), makeLedgerRows (3, 5)});
+
+        expect (dbs.count (*dbs.ledgerDB,
+            "SELECT COUNT(*) FROM Ledgers;") == 2);
+        expect (dbs.count (*dbs.txnDB,
+            "SELECT COUNT(*) FROM Transactions;") == 8);
+        expect (dbs.count (*dbs.txnDB,
+            "SELECT COUNT(*) FROM AccountTransactions;") == 16);
+        expect (dbs.count (*dbs.txnDB,
+            "SELECT COUNT(*) FROM Transactions "
+            "WHERE Status = 'V' AND LedgerSeq = 3;") == 5);
+
+        // Saving a ledger again replaces its rows
+        dbs.save ({makeLedgerRows (3, 2)});
+        expect (dbs.count (*dbs.ledgerDB,
+            "SELECT COUNT(*) FROM Ledgers WHERE LedgerSeq = 3;") == 1);
+        expect (dbs.count (*dbs.txnDB,
+            "SELECT COUNT(*) FROM Transactions WHERE LedgerSeq = 3;") == 2);
+        expect (dbs.count (*dbs.txnDB,
+            "SELECT COUNT(*) FROM AccountTransactions "
+            "WHERE LedgerSeq = 3;") == 4);
+
+        // Blobs of varying sizes round trip
+        auto const expected = makeLedgerRows (2, 3);
+        auto db = dbs.txnDB->checkoutDb ();
+        soci::blob raw (*db);
+        soci::blob meta (*db);
+        std::string id;
+        soci::statement st = (db->prepare <<
+            "SELECT TransID, RawTxn, TxnMeta FROM Transactions "
+            "WHERE LedgerSeq = 2 ORDER BY FromSeq;",
+            soci::into (id), soci::into (raw), soci::into (meta));
+        st.execute ();
+        std::size_t i = 0;
+        while (st.fetch ())
+        {
+            Blob b;
+            convert (raw, b);
+            expect (b == expected.transactions[i].raw);
+            convert (meta, b);
+            expect (b == expected.transactions[i].meta);
+            expect (id == expected.transactions[i].id);
+            ++i;
+        }
+        expect (i == 3);
+    }
+
+    void
+    testPendingSaves ()
+    {
+        testcase ("pending saves");
+
+        using detail::makeLedgerRows;
+        PendingSaves pending;
+        LedgerIndex failSeq = 0;
+        std::vector <std::size_t> batches;
+        std::vector <LedgerIndex> failed;
+        LedgerSQLWriter writer (pending,
+            [&](std::vector <LedgerSQLRows> const& ledgers)
+            {
+                batches.push_back (ledgers.size ());
+                for (auto const& rows : ledgers)
+                    if (rows.seq == failSeq)
+                        throw std::runtime_error ("failed");
+            },
+            [&](LedgerSQLRows const& rows)
+            {
+                // A failed ledger must be free to be saved again
+                expect (pending.getSnapshot ().count (rows.seq) == 0);
+                failed.push_back (rows.seq);
+            }, beast::Journal ());
+
+        pending.insert (5);
+        expect (writer.write (makeLedgerRows (5, 1), true));
+        expect (pending.getSnapshot ().empty ());
+
+        failSeq = 6;
+        pending.insert (6);
+        expect (! writer.write (makeLedgerRows (6, 1), true));
+        expect (pending.getSnapshot ().empty ());
+        expect (failed == std::vector <LedgerIndex> ({6}));
+
+        failSeq = 7;
+        pending.insert (7);
+        expect (writer.write (makeLedgerRows (7, 1), false));
+        expect (pending.getSnapshot ().empty ());
+        expect (failed == std::vector <LedgerIndex> ({6, 7}));
+
+        // The failed ledger can be pended and saved again
+        failSeq = 0;
+        expect (pending.insert (7));
+        expect (writer.write (makeLedgerRows (7, 1), false));
+        expect (pending.getSnapshot ().empty ());
+        expect (writer.size () == 0);
+        expect (batches.size () == 4);
+        expect (failed.size () == 2);
+    }
+
+    void
+    testBatching ()
+    {
+        testcase ("batching");
+
+        using detail::makeLedgerRows;
+        PendingSaves pending;
+        std::mutex m;
+        std::condition_variable cv;
+        bool blocked = false;
+        bool release = false;
+        LedgerIndex failSeq = 13;
+        std::vector <std::size_t> batches;
+        std::vector <LedgerIndex> failed;
+
+        LedgerSQLWriter writer (pending,
+            [&](std::vector <LedgerSQLRows> const& ledgers)
+            {
+                std::unique_lock <std::mutex> lock (m);
+                batches.push_back (ledgers.size ());
+                if (batches.size () == 1)
+                {
+                    blocked = true;
+                    cv.notify_all ();
+                    cv.wait (lock, [&] { return release; });
+                }
+                for (auto const& rows : ledgers)
+                    if (rows.seq == failSeq)
+                        throw std::runtime_error ("failed");
+            },
+            [&](LedgerSQLRows const& rows)
+            {
+                failed.push_back (rows.seq);
+            }, beast::Journal (), 4);
+
+        for (LedgerIndex seq = 10; seq < 20; ++seq)
+            pending.insert (seq);
+
+        // The first save becomes the writer and blocks
+        std::thread writerThread ([&]
+        {
+            writer.write (makeLedgerRows (10, 1), false);
+        });
+        {
+            std::unique_lock <std::mutex> lock (m);
+            cv.wait (lock, [&] { return blocked; });
+        }
+
+        // Everything else queues up behind it
+        for (LedgerIndex seq = 11; seq < 19; ++seq)
+            expect (writer.write (makeLedgerRows (seq, 1), false));
+        expect (writer.size () == 8);
+
+        bool syncResult = true;
+        std::thread syncThread ([&]
+        {
+            syncResult = writer.write (makeLedgerRows (19, 1), true);
+        });
+        while (writer.size () != 9)
+            std::this_thread::yield ();
+
+        {
+            std::lock_guard <std::mutex> lock (m);
+            release = true;
+            cv.notify_all ();
+        }
+        writerThread.join ();
+        syncThread.join ();
+
+        expect (syncResult);
+        expect (writer.size () == 0);
+
+        // 10, then 11-14 (fails and is retried one by one), 15-18, 19
+        std::vector <std::size_t> const expected ({1, 4, 1, 1, 1, 1, 4, 1});
+        expect (batches == expected);
+
+        // The ledger that failed on its own was handed back, not left
+        // pending
+        expect (pending.getSnapshot ().empty ());
+        expect (failed == std::vector <LedgerIndex> ({13}));
+    }
+
+    void
+    run ()
+    {
+        testSaveRows ();
+        testPendingSaves ();
+        testBatching ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerSQLWriter,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures how quickly a backlog of validated ledgers reaches SQL
+class LedgerSQLWriter_timing_test : public beast::unit_test::suite
+{
+public:
+    void
+    testBackfill (std::size_t batchSize)
+    {
+        using namespace boost::filesystem;
+        using clock_type = std::chrono::steady_clock;
+
+        std::size_t const ledgerCount = 2048;
+        std::size_t const txPerLedger = 20;
+
+        auto const dir = temp_directory_path () / unique_path ();
+        create_directory (dir);
+
+        {
+            detail::TestDatabases dbs (dir);
+
+            std::vector <LedgerSQLRows> batch;
+            auto const start = clock_type::now ();
+            for (LedgerIndex seq = 2; seq < ledgerCount + 2; ++seq)
+            {
+                batch.push_back (detail::makeLedgerRows (seq, txPerLedger));
+                if (batch.size () == batchSize)
+                {
+                    dbs.save (batch);
+                    batch.clear ();
+                }
+            }
+            dbs.save (batch);
+            auto const elapsed = std::chrono::duration_cast <
+                std::chrono::milliseconds> (clock_type::now () - start);
+
+            log <<
+                "batch " << batchSize << ": " <<
+                ledgerCount * 1000 / std::max <std::int64_t> (
+                    elapsed.count (), 1) << " ledgers/s (" <<
+                elapsed.count () << "ms for " << ledgerCount <<
+                " ledgers of " << txPerLedger << " transactions)";
+        }
+
+        remove_all (dir);
+        pass ();
+    }
+
+    void
+    run ()
+    {
+        testBackfill (1);
+        testBackfill (16);
+        testBackfill (256);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerSQLWriter_timing,app,ripple);
+
+} // ripple
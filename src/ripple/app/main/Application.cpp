@@ -28,12 +28,16 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <ripple/app/ledger/LedgerSQLWriter.h>
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/main/LocalCredentials.h>
 #include <ripple/app/main/NodeStoreScheduler.h>
 #include <ripple/app/misc/AmendmentTable.h>
+#include <ripple/app/misc/CacheBudget.h>
 #include <ripple/app/misc/IHashRouter.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/SHAMapStore.h>
@@ -113,13 +117,15 @@ private:
     TreeNodeCache treecache_;
     FullBelowCache fullbelow_;
     NodeStore::Database& db_;
+    bool cacheObjects_ = true;
 
 public:
     AppFamily (AppFamily const&) = delete;
     AppFamily& operator= (AppFamily const&) = delete;
 
     AppFamily (NodeStore::Database& db,
-            CollectorManager& collectorManager)
+            CollectorManager& collectorManager,
+                Section const& nodeDatabase)
         : treecache_ ("TreeNodeCache", 65536, 60, get_seconds_clock(),
             deprecatedLogs().journal("TaggedCache"))
         , fullbelow_ ("full_below", get_seconds_clock(),
@@ -127,6 +133,7 @@ public:
                 fullBelowTargetSize, fullBelowExpirationSeconds)
         , db_ (db)
     {
+        get_if_exists (nodeDatabase, "shamap_object_cache", cacheObjects_);
     }
 
     FullBelowCache&
@@ -165,6 +172,12 @@ public:
         return db_;
     }
 
+    bool
+    cache_objects() const override
+    {
+        return cacheObjects_;
+    }
+
     void
     missing_node (std::uint32_t refNum) override
     {
@@ -259,6 +272,8 @@ public:
     std::unique_ptr <SHAMapStore> m_shaMapStore;
     std::unique_ptr <NodeStore::Database> m_nodeStore;
     PendingSaves pendingSaves_;
+    LedgerHashIndex ledgerHashIndex_;
+    LedgerSQLWriter ledgerSQLWriter_;
 
     // These are not Stoppable-derived
     NodeCache m_tempNodeCache;
@@ -266,6 +281,8 @@ public:
     detail::AppFamily family_;
     SLECache m_sleCache;
     LocalCredentials m_localCredentials;
+    LedgerCloseProfiler ledgerCloseProfiler_;
+    CacheBudget m_cacheBudget;
 
     std::unique_ptr <Resource::Manager> m_resourceManager;
 
@@ -334,17 +351,48 @@ public:
 
         , m_nodeStore (m_shaMapStore->makeDatabase ("NodeStore.main", 4))
 
+        , ledgerHashIndex_ (m_logs.journal ("Ledger"))
+
+        , ledgerSQLWriter_ (pendingSaves_,
+            [this](std::vector <LedgerSQLRows> const& ledgers)
+            {
+                saveLedgerRows (getLedgerDB (), getTxnDB (), ledgers);
+
+                // Keep the index in step with the Ledgers table
+                for (auto const& ledger : ledgers)
+                {
+                    uint256 hash;
+                    uint256 parentHash;
+                    hash.SetHexExact (ledger.hash);
+                    parentHash.SetHexExact (ledger.parentHash);
+                    ledgerHashIndex_.insert (ledger.seq, hash, parentHash);
+                }
+            },
+            [this](LedgerSQLRows const& ledger)
+            {
+                uint256 hash;
+                hash.SetHexExact (ledger.hash);
+                getLedgerMaster ().failedSave (ledger.seq, hash);
+            }, m_logs.journal ("Ledger"))
+
         , m_tempNodeCache ("NodeCache", 16384, 90, get_seconds_clock (),
             m_logs.journal("TaggedCache"))
 
         , m_collectorManager (CollectorManager::New (
             getConfig().section (SECTION_INSIGHT), m_logs.journal("Collector")))
 
-        , family_ (*m_nodeStore, *m_collectorManager)
+        , family_ (*m_nodeStore, *m_collectorManager,
+            getConfig ()[ConfigSection::nodeDatabase ()])
 
         , m_sleCache ("LedgerEntryCache", 4096, 120, get_seconds_clock (),
             m_logs.journal("TaggedCache"))
 
+        , ledgerCloseProfiler_ (m_collectorManager->group ("ledger_close"))
+
+        , m_cacheBudget (setup_CacheBudget (
+            getConfig ().section ("cache_budget")),
+                m_logs.journal ("CacheBudget"))
+
         , m_resourceManager (Resource::make_Manager (
             m_collectorManager->collector(), m_logs.journal("Resource")))
 
@@ -406,9 +454,10 @@ public:
 
         , mFeeTrack (LoadFeeTrack::New (m_logs.journal("LoadManager")))
 
-        , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime ()))
+        , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime (),
+            get_seconds_clock ()))
 
-        , mValidations (make_Validations ())
+        , mValidations (make_Validations (getConfig ().VALIDATION_HISTORY))
 
         , m_loadManager (make_LoadManager (*this, m_logs.journal("LoadManager")))
 
@@ -598,6 +647,26 @@ public:
         return pendingSaves_;
     }
 
+    LedgerSQLWriter& getLedgerSQLWriter () override
+    {
+        return ledgerSQLWriter_;
+    }
+
+    LedgerHashIndex& getLedgerHashIndex () override
+    {
+        return ledgerHashIndex_;
+    }
+
+    LedgerCloseProfiler& getLedgerCloseProfiler () override
+    {
+        return ledgerCloseProfiler_;
+    }
+
+    CacheBudget& getCacheBudget () override
+    {
+        return m_cacheBudget;
+    }
+
     Overlay& overlay ()
     {
         return *m_overlay;
@@ -656,6 +725,22 @@ public:
             mWalletDB.get () != nullptr;
     }
 
+    // The index lives next to ledger.db, and is temporary when it is
+    void openLedgerHashIndex ()
+    {
+        auto const setup = setup_DatabaseCon (getConfig ());
+
+        boost::filesystem::path path;
+        if (! setup.useTempFiles ())
+            path = setup.dataDir / "ledger_hashes.idx";
+
+        if (! ledgerHashIndex_.open (path))
+        {
+            m_journal.info << "Rebuilding the ledger hash index";
+            rebuildLedgerHashIndex (ledgerHashIndex_, getLedgerDB ());
+        }
+    }
+
     void signalled(const boost::system::error_code& ec, int signal_number)
     {
         if (ec == boost::asio::error::operation_aborted)
@@ -729,6 +814,8 @@ public:
         if (!getConfig ().RUN_STANDALONE)
             updateTables ();
 
+        openLedgerHashIndex ();
+
         m_amendmentTable->addInitial (
             getConfig ().section (SECTION_AMENDMENTS));
         initializePathfinding ();
@@ -783,12 +870,7 @@ public:
             getUNL ().nodeBootstrap ();
 
         mValidations->tune (getConfig ().getSize (siValidationsSize), getConfig ().getSize (siValidationsAge));
-        m_nodeStore->tune (getConfig ().getSize (siNodeCacheSize), getConfig ().getSize (siNodeCacheAge));
-        m_ledgerMaster->tune (getConfig ().getSize (siLedgerSize), getConfig ().getSize (siLedgerAge));
-        m_sleCache.setTargetSize (getConfig ().getSize (siSLECacheSize));
-        m_sleCache.setTargetAge (getConfig ().getSize (siSLECacheAge));
-        family().treecache().setTargetSize (getConfig ().getSize (siTreeCacheSize));
-        family().treecache().setTargetAge (getConfig ().getSize (siTreeCacheAge));
+        addBudgetedCaches ();
 
         //----------------------------------------------------------------------
         //
@@ -1012,12 +1094,15 @@ public:
         family().treecache().sweep();
         getOPs().sweepFetchPack();
 
+        m_cacheBudget.rebalance ();
+
         // VFALCO NOTE does the call to sweep() happen on another thread?
         m_sweepTimer.setExpiration (getConfig ().getSize (siSweepInterval));
     }
 
 
 private:
+    void addBudgetedCaches ();
     void updateTables ();
     void startNewLedger ();
     Ledger::pointer getLastFullLedger();
@@ -1507,6 +1592,78 @@ static void addTxnSeqField ()
     tr.commit ();
 }
 
+// The caches start at the sizes [node_size] gives them, and the budget
+// moves memory between them as they are swept
+void ApplicationImp::addBudgetedCaches ()
+{
+    Config const& config = getConfig ();
+
+    m_cacheBudget.add ("treenode", family().treecache(), treeNodeEntryBytes,
+        config.getSize (siTreeCacheSize), config.getSize (siTreeCacheAge));
+
+    m_cacheBudget.add ("SLE", m_sleCache, sleEntryBytes,
+        config.getSize (siSLECacheSize), config.getSize (siSLECacheAge));
+
+    {
+        CacheBudget::Source source;
+        source.name = "node";
+        source.entryBytes = nodeObjectEntryBytes;
+        source.size = config.getSize (siNodeCacheSize);
+        source.age = config.getSize (siNodeCacheAge);
+        source.stats = [this](std::size_t& size,
+            std::uint64_t& hits, std::uint64_t& misses)
+        {
+            m_nodeStore->getCacheStats (size, hits, misses);
+        };
+        source.tune = [this](int size, int age)
+        {
+            m_nodeStore->tune (size, age);
+        };
+        m_cacheBudget.add (std::move (source));
+    }
+
+    {
+        CacheBudget::Source source;
+        source.name = "ledger";
+        source.entryBytes = ledgerEntryBytes;
+        source.size = config.getSize (siLedgerSize);
+        source.age = config.getSize (siLedgerAge);
+        source.stats = [this](std::size_t& size,
+            std::uint64_t& hits, std::uint64_t& misses)
+        {
+            m_ledgerMaster->getCacheStats (size, hits, misses);
+        };
+        source.tune = [this](int size, int age)
+        {
+            m_ledgerMaster->tune (size, age);
+        };
+        m_cacheBudget.add (std::move (source));
+    }
+
+    // These have no [node_size] entry and start where they were built
+    auto& txCache = m_txMaster.getCache ();
+    m_cacheBudget.add ("transaction", txCache, transactionEntryBytes,
+        txCache.getTargetSize (), static_cast <int> (txCache.getTargetAge ()));
+
+    auto& alCache = AcceptedLedger::getCache ();
+    m_cacheBudget.add ("AL", alCache, acceptedLedgerEntryBytes,
+        alCache.getTargetSize (), static_cast <int> (alCache.getTargetAge ()));
+
+    // Shrinking the full below cache makes syncs walk trees again,
+    // so it is reported but keeps its size
+    {
+        CacheBudget::Source source;
+        source.name = "fullbelow";
+        source.entryBytes = fullBelowEntryBytes;
+        source.stats = [this](std::size_t& size,
+            std::uint64_t& hits, std::uint64_t& misses)
+        {
+            family().fullbelow().getStats (size, hits, misses);
+        };
+        m_cacheBudget.add (std::move (source));
+    }
+}
+
 void ApplicationImp::updateTables ()
 {
     if (getConfig ().section (ConfigSection::nodeDatabase ()).empty ())
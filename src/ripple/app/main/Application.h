@@ -39,6 +39,7 @@ namespace RPC { class Manager; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
 class AmendmentTable;
+class CacheBudget;
 class CollectorManager;
 namespace shamap {
 class Family;
@@ -51,7 +52,10 @@ class UniqueNodeList;
 class JobQueue;
 class InboundLedgers;
 class InboundTransactions;
+class LedgerCloseProfiler;
+class LedgerHashIndex;
 class LedgerMaster;
+class LedgerSQLWriter;
 class LoadManager;
 class NetworkOPs;
 class OrderBookDB;
@@ -116,6 +120,10 @@ public:
     virtual PathRequests&           getPathRequests () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
     virtual PendingSaves&           pendingSaves() = 0;
+    virtual LedgerSQLWriter&        getLedgerSQLWriter () = 0;
+    virtual LedgerHashIndex&        getLedgerHashIndex () = 0;
+    virtual LedgerCloseProfiler&    getLedgerCloseProfiler () = 0;
+    virtual CacheBudget&            getCacheBudget () = 0;
     virtual DatabaseCon& getTxnDB () = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
 
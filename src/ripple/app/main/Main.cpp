@@ -128,6 +128,7 @@ void printHelp (const po::options_description& desc)
            "     json <method> <json>\n"
            "     ledger [<id>|current|closed|validated] [full]\n"
            "     ledger_accept\n"
+           "     ledger_close_profile [<limit>]\n"
            "     ledger_closed\n"
            "     ledger_current\n"
            "     ledger_request <ledger>\n"
@@ -137,6 +138,7 @@ void printHelp (const po::options_description& desc)
            "     random\n"
            "     ripple ...\n"
            "     ripple_path_find <json> [<ledger>]\n"
+           "     send_queues\n"
            "     version\n"
            "     server_info\n"
            "     sign\n"
@@ -28,6 +28,19 @@ enum
     ,fullBelowExpirationSeconds = 600
 };
 
+// Estimated bytes held by one entry of each cache sharing the
+// memory budget, including the cache's own bookkeeping
+enum
+{
+     treeNodeEntryBytes = 512
+    ,nodeObjectEntryBytes = 384
+    ,sleEntryBytes = 512
+    ,transactionEntryBytes = 1024
+    ,acceptedLedgerEntryBytes = 65536
+    ,ledgerEntryBytes = 4096
+    ,fullBelowEntryBytes = 64
+};
+
 }
 
 #endif
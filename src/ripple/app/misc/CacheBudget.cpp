@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/CacheBudget.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace ripple {
+
+// Bounds on a target, relative to the configured size and age
+static int const shrinkLimit = 4;
+static int const growLimit = 4;
+
+// Share of the distance to its goal a target moves in one rebalance
+static int const smoothing = 4;
+
+CacheBudget::CacheBudget (Setup const& setup, beast::Journal journal)
+    : setup_ (setup)
+    , journal_ (journal)
+{
+}
+
+void
+CacheBudget::add (Source source)
+{
+    Item item;
+    item.targetSize = source.size;
+    item.targetAge = source.age;
+    source.stats (item.entries, item.hits, item.misses);
+
+    if (source.tune)
+        source.tune (item.targetSize, item.targetAge);
+
+    item.source = std::move (source);
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    items_.push_back (std::move (item));
+}
+
+std::size_t
+CacheBudget::getBudget () const
+{
+    if (setup_.budgetBytes != 0)
+        return setup_.budgetBytes;
+
+    std::size_t budget = 0;
+    for (auto const& item : items_)
+    {
+        if (item.source.tune)
+            budget += item.source.size * item.source.entryBytes;
+    }
+    return budget;
+}
+
+void
+CacheBudget::rebalance ()
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    ++rebalances_;
+
+    for (auto& item : items_)
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        item.source.stats (item.entries, hits, misses);
+
+        // The counts restart if a cache's statistics are cleared
+        item.recentHits = hits >= item.hits ? hits - item.hits : hits;
+        item.recentMisses =
+            misses >= item.misses ? misses - item.misses : misses;
+        item.hits = hits;
+        item.misses = misses;
+    }
+
+    if (! setup_.adaptive)
+        return;
+
+    // Weigh each cache's configured memory by the share of its recent
+    // lookups that missed. An idle cache weighs half its configured
+    // memory and a cache that missed every lookup one and a half.
+    std::vector <double> weights (items_.size (), 0.0);
+    double total = 0.0;
+
+    for (std::size_t i = 0; i < items_.size (); ++i)
+    {
+        Item const& item = items_[i];
+        if (! item.source.tune || item.source.size <= 0 ||
+                item.source.entryBytes == 0)
+            continue;
+
+        std::uint64_t const lookups = item.recentHits + item.recentMisses;
+        double const missRatio = lookups == 0 ? 0.0 :
+            static_cast <double> (item.recentMisses) / lookups;
+
+        weights[i] = static_cast <double> (item.source.size) *
+            item.source.entryBytes * (0.5 + missRatio);
+        total += weights[i];
+    }
+
+    if (total <= 0.0)
+        return;
+
+    double const budget = static_cast <double> (getBudget ());
+
+    for (std::size_t i = 0; i < items_.size (); ++i)
+    {
+        if (weights[i] == 0.0)
+            continue;
+
+        Item& item = items_[i];
+        Source const& source = item.source;
+
+        std::int64_t goal = static_cast <std::int64_t> (
+            budget * weights[i] / total / source.entryBytes);
+
+        // Misses in a cache with room to spare are not for lack of memory
+        if (goal > item.targetSize &&
+                item.entries < static_cast <std::size_t> (item.targetSize / 2))
+            goal = item.targetSize;
+
+        goal = std::max <std::int64_t> (goal,
+            std::max (1, source.size / shrinkLimit));
+        goal = std::min <std::int64_t> (goal,
+            static_cast <std::int64_t> (source.size) * growLimit);
+
+        int const size = static_cast <int> (
+            (item.targetSize * std::int64_t (smoothing - 1) + goal) /
+                smoothing);
+
+        // Age follows size, so a larger cache also keeps entries longer
+        std::int64_t age =
+            static_cast <std::int64_t> (source.age) * size / source.size;
+        age = std::max <std::int64_t> (age,
+            std::max (1, source.age / shrinkLimit));
+        age = std::min <std::int64_t> (age,
+            static_cast <std::int64_t> (source.age) * growLimit);
+
+        if (size == item.targetSize && age == item.targetAge)
+            continue;
+
+        if (journal_.debug) journal_.debug <<
+            source.name << " target " << item.targetSize << " -> " << size <<
+                " entries, " << item.targetAge << " -> " << age << " seconds";
+
+        item.targetSize = size;
+        item.targetAge = static_cast <int> (age);
+        source.tune (item.targetSize, item.targetAge);
+    }
+}
+
+Json::Value
+CacheBudget::getJson () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    Json::Value ret (Json::objectValue);
+    Json::Value& caches = ret[jss::caches] = Json::objectValue;
+    std::size_t bytes = 0;
+
+    for (auto const& item : items_)
+    {
+        std::uint64_t const lookups = item.recentHits + item.recentMisses;
+        std::size_t const used = item.entries * item.source.entryBytes;
+        bytes += used;
+
+        Json::Value& cache = caches[item.source.name] = Json::objectValue;
+        cache[jss::entries] = static_cast <Json::UInt> (item.entries);
+        cache[jss::entry_bytes] =
+            static_cast <Json::UInt> (item.source.entryBytes);
+        cache[jss::bytes] = static_cast <Json::UInt> (used);
+        cache[jss::target_size] = item.targetSize;
+        cache[jss::target_age] = item.targetAge;
+        cache[jss::hits] = static_cast <Json::UInt> (item.recentHits);
+        cache[jss::misses] = static_cast <Json::UInt> (item.recentMisses);
+        cache[jss::hit_rate] = lookups == 0 ? 0.0 :
+            static_cast <double> (item.recentHits) / lookups;
+        if (! item.source.tune)
+            cache[jss::adaptive] = false;
+    }
+
+    ret[jss::adaptive] = setup_.adaptive;
+    ret[jss::budget] = static_cast <Json::UInt> (getBudget ());
+    ret[jss::bytes] = static_cast <Json::UInt> (bytes);
+    ret[jss::rebalances] = static_cast <Json::UInt> (rebalances_);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+CacheBudget::Setup
+setup_CacheBudget (Section const& section)
+{
+    CacheBudget::Setup setup;
+
+    get_if_exists (section, "adaptive", setup.adaptive);
+
+    std::size_t megabytes = 0;
+    if (get_if_exists (section, "budget_mb", megabytes))
+        setup.budgetBytes = megabytes * 1024 * 1024;
+
+    return setup;
+}
+
+} // ripple
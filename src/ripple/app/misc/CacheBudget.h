@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_CACHEBUDGET_H_INCLUDED
+#define RIPPLE_APP_MISC_CACHEBUDGET_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/json/json_value.h>
+#include <beast/utility/Journal.h>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Shares one memory budget between the server's caches.
+
+    Each cache starts at the target size and age the [node_size] tables
+    give it. On every sweep the budget looks at how many lookups each
+    cache missed since the previous sweep and moves memory towards the
+    caches that miss the most for the memory they hold. A cache that is
+    not filling its target does not grow, since more room would not turn
+    its misses into hits. Targets stay between a quarter of and four
+    times the configured size, and move a quarter of the way towards
+    their goal each time so a single busy interval does not flush a cache.
+
+    Memory is estimated from the number of entries and a fixed cost per
+    entry given when the cache is added.
+*/
+class CacheBudget
+{
+public:
+    struct Setup
+    {
+        /** Rebalance targets. When false the caches are only reported. */
+        bool adaptive = true;
+
+        /** Budget in bytes. Zero uses the total of the configured sizes. */
+        std::size_t budgetBytes = 0;
+    };
+
+    /** What the budget needs to know about one cache. */
+    struct Source
+    {
+        std::string name;
+
+        /** Estimated bytes held by one entry. */
+        std::size_t entryBytes = 0;
+
+        /** Configured target size and age, in entries and seconds. */
+        int size = 0;
+        int age = 0;
+
+        /** Return the entry count and the lifetime hit and miss counts. */
+        std::function <void (std::size_t&,
+            std::uint64_t&, std::uint64_t&)> stats;
+
+        /** Set the target size and age. Empty if the cache is fixed. */
+        std::function <void (int, int)> tune;
+    };
+
+    CacheBudget (Setup const& setup, beast::Journal journal);
+
+    CacheBudget (CacheBudget const&) = delete;
+    CacheBudget& operator= (CacheBudget const&) = delete;
+
+    /** Add a cache. Its configured target is applied. */
+    void
+    add (Source source);
+
+    /** Add a TaggedCache or KeyCache. */
+    template <class Cache>
+    void
+    add (std::string const& name, Cache& cache,
+        std::size_t entryBytes, int size, int age)
+    {
+        Source source;
+        source.name = name;
+        source.entryBytes = entryBytes;
+        source.size = size;
+        source.age = age;
+        source.stats = [&cache](std::size_t& entries,
+            std::uint64_t& hits, std::uint64_t& misses)
+        {
+            cache.getStats (entries, hits, misses);
+        };
+        source.tune = [&cache](int targetSize, int targetAge)
+        {
+            cache.setTargetSize (targetSize);
+            cache.setTargetAge (targetAge);
+        };
+        add (std::move (source));
+    }
+
+    /** Sample every cache and move memory between them. */
+    void
+    rebalance ();
+
+    /** The budget, and each cache's size, target and recent hit rate. */
+    Json::Value
+    getJson () const;
+
+private:
+    struct Item
+    {
+        Source source;
+
+        int targetSize;
+        int targetAge;
+
+        std::size_t entries = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+
+        // Lookups since the previous rebalance
+        std::uint64_t recentHits = 0;
+        std::uint64_t recentMisses = 0;
+    };
+
+    std::size_t
+    getBudget () const;
+
+    Setup const setup_;
+    beast::Journal journal_;
+
+    std::mutex mutable mutex_;
+    std::vector <Item> items_;
+    std::uint64_t rebalances_ = 0;
+};
+
+/** Build CacheBudget::Setup from a config section. */
+CacheBudget::Setup
+setup_CacheBudget (Section const& section);
+
+} // ripple
+
+#endif
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/FetchPackStore.h>
+#include <ripple/protocol/JsonFields.h>
+#include <lz4/lib/lz4.h>
+#include <algorithm>
+
+namespace ripple {
+
+FetchPackStore::FetchPackStore (Setup const& setup)
+    : setup_ (setup)
+{
+}
+
+bool
+FetchPackStore::contains (uint256 const& haveLedger) const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return entries_.find (haveLedger) != entries_.end ();
+}
+
+void
+FetchPackStore::insert (uint256 const& haveLedger, std::string const& objects)
+{
+    if (objects.empty () || objects.size () > LZ4_MAX_INPUT_SIZE)
+        return;
+
+    // Compress before taking the lock
+    std::string data;
+    data.resize (LZ4_compressBound (static_cast<int> (objects.size ())));
+    int const n = LZ4_compress_default (objects.data (), &data[0],
+        static_cast<int> (objects.size ()), static_cast<int> (data.size ()));
+    if (n <= 0)
+        return;
+    data.resize (n);
+    data.shrink_to_fit ();
+
+    if (data.size () > setup_.cacheBytes)
+        return;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    auto iter = entries_.find (haveLedger);
+    if (iter != entries_.end ())
+    {
+        bytes_ -= iter->second.data.size ();
+        lru_.erase (iter->second.lru);
+        entries_.erase (iter);
+    }
+
+    lru_.push_front (haveLedger);
+    Entry& e = entries_[haveLedger];
+    e.data = std::move (data);
+    e.size = objects.size ();
+    e.lru = lru_.begin ();
+    bytes_ += e.data.size ();
+    ++stored_;
+
+    evict ();
+}
+
+bool
+FetchPackStore::fetch (uint256 const& haveLedger, std::string& objects)
+{
+    std::string data;
+    std::size_t size;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto const iter = entries_.find (haveLedger);
+        if (iter == entries_.end ())
+        {
+            ++misses_;
+            return false;
+        }
+
+        ++hits_;
+        lru_.splice (lru_.begin (), lru_, iter->second.lru);
+        data = iter->second.data;
+        size = iter->second.size;
+    }
+
+    objects.resize (size);
+    return LZ4_decompress_safe (data.data (), &objects[0],
+        static_cast<int> (data.size ()), static_cast<int> (size)) ==
+            static_cast<int> (size);
+}
+
+void
+FetchPackStore::evict ()
+{
+    while (bytes_ > setup_.cacheBytes && ! lru_.empty ())
+    {
+        auto const iter = entries_.find (lru_.back ());
+        bytes_ -= iter->second.data.size ();
+        entries_.erase (iter);
+        lru_.pop_back ();
+        ++evicted_;
+    }
+}
+
+Json::Value
+FetchPackStore::getJson () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    Json::Value ret (Json::objectValue);
+    ret[jss::entries] = static_cast<Json::UInt> (entries_.size ());
+    ret[jss::bytes] = static_cast<Json::UInt> (bytes_);
+    ret[jss::hits] = static_cast<Json::UInt> (hits_);
+    ret[jss::misses] = static_cast<Json::UInt> (misses_);
+    ret[jss::hit_rate] = hits_ * (100.0 /
+        std::max<double> (1.0, hits_ + misses_));
+    ret[jss::stored] = static_cast<Json::UInt> (stored_);
+    ret[jss::evicted] = static_cast<Json::UInt> (evicted_);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+FetchPackStore::Setup
+setup_FetchPackStore (Section const& section)
+{
+    FetchPackStore::Setup setup;
+    get_if_exists (section, "precompute", setup.precompute);
+
+    std::size_t megabytes;
+    if (get_if_exists (section, "cache_mb", megabytes))
+        setup.cacheBytes = megabytes * 1024 * 1024;
+
+    return setup;
+}
+
+} // ripple
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_FETCHPACKSTORE_H_INCLUDED
+#define RIPPLE_APP_MISC_FETCHPACKSTORE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/json/json_value.h>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+/** Fetch packs kept for reuse, compressed.
+
+    A fetch pack answers a peer that holds a ledger and wants its
+    predecessors. Building one walks the state map differences and
+    reads every node from the NodeStore, and peers catching up through
+    the same ledgers ask for the same packs. The store keeps each pack
+    as the lz4 compressed objects of a TMGetObjectByHash, keyed by the
+    hash of the ledger the peer holds, and evicts the least recently
+    used packs when over its byte budget.
+*/
+class FetchPackStore
+{
+public:
+    struct Setup
+    {
+        /** Build packs for newly validated ledgers in the background. */
+        bool precompute = false;
+
+        /** Budget for the compressed packs, in bytes. Zero disables. */
+        std::size_t cacheBytes = 32 * 1024 * 1024;
+    };
+
+    FetchPackStore (Setup const& setup);
+
+    FetchPackStore (FetchPackStore const&) = delete;
+    FetchPackStore& operator= (FetchPackStore const&) = delete;
+
+    Setup const&
+    setup () const
+    {
+        return setup_;
+    }
+
+    /** Returns `true` if a pack for the ledger is stored. */
+    bool
+    contains (uint256 const& haveLedger) const;
+
+    /** Store the serialized objects of a pack, replacing any older one.
+        A pack larger than the whole budget is not stored.
+    */
+    void
+    insert (uint256 const& haveLedger, std::string const& objects);
+
+    /** Retrieve the serialized objects of a pack.
+        @return `true` on a hit. Hits and misses are counted.
+    */
+    bool
+    fetch (uint256 const& haveLedger, std::string& objects);
+
+    /** Counters and sizes for get_counts. */
+    Json::Value
+    getJson () const;
+
+private:
+    struct Entry
+    {
+        std::string data;
+        std::size_t size;
+        std::list<uint256>::iterator lru;
+    };
+
+    void
+    evict ();
+
+    Setup const setup_;
+
+    std::mutex mutable mutex_;
+
+    hash_map<uint256, Entry> entries_;
+
+    // Most recently used at the front
+    std::list<uint256> lru_;
+
+    std::size_t bytes_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    std::uint64_t stored_ = 0;
+    std::uint64_t evicted_ = 0;
+};
+
+/** Build FetchPackStore::Setup from a config section. */
+FetchPackStore::Setup
+setup_FetchPackStore (Section const& section);
+
+} // ripple
+
+#endif
@@ -19,80 +19,184 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/misc/IHashRouter.h>
-#include <ripple/basics/CountedObject.h>
-#include <ripple/basics/UnorderedContainers.h>
-#include <ripple/basics/UptimeTimer.h>
-#include <map>
+#include <ripple/basics/flat_hash_map.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
-// VFALCO TODO Inline the function definitions
+/*  The table is split into shards, each with its own lock, so relays of
+    different hashes rarely contend. Each shard is a flat_hash_map of
+    inline entries. Expiration uses a time wheel with one bucket per
+    second of the hold time, instead of a map of lists.
+*/
 class HashRouter : public IHashRouter
 {
 private:
-    /** An entry in the routing table.
+    /** A set of peer IDs, stored inline when small.
     */
-    class Entry : public CountedObject <Entry>
+    class PeerSet
     {
-    public:
-        static char const* getCountedObjectName () { return "HashRouterEntry"; }
+    private:
+        static std::size_t const inlineSize = 6;
 
-        Entry ()
-            : mFlags (0)
+        std::uint32_t mSize = 0;
+        std::array <PeerShortID, inlineSize> mInline;
+        std::vector <PeerShortID> mOverflow;
+
+    public:
+        bool count (PeerShortID peer) const
         {
+            auto const last = mInline.begin () +
+                std::min <std::size_t> (mSize, inlineSize);
+            if (std::find (mInline.begin (), last, peer) != last)
+                return true;
+            return std::find (mOverflow.begin (), mOverflow.end (), peer) !=
+                mOverflow.end ();
         }
 
-        std::set <PeerShortID> const& peekPeers () const
+        void insert (PeerShortID peer)
         {
-            return mPeers;
+            if (count (peer))
+                return;
+            if (mSize < inlineSize)
+                mInline[mSize] = peer;
+            else
+                mOverflow.push_back (peer);
+            ++mSize;
         }
 
-        void addPeer (PeerShortID peer)
+        void clear ()
         {
-            if (peer != 0)
-                mPeers.insert (peer);
+            mSize = 0;
+            mOverflow.clear ();
         }
 
-        bool hasPeer (PeerShortID peer) const
+        /** Exchange the contents with a std::set. */
+        void swap (std::set <PeerShortID>& other)
         {
-            return mPeers.count (peer) > 0;
+            std::set <PeerShortID> mine;
+            for (std::size_t i = 0; i < std::min <std::size_t> (
+                    mSize, inlineSize); ++i)
+                mine.insert (mInline[i]);
+            mine.insert (mOverflow.begin (), mOverflow.end ());
+
+            clear ();
+            for (auto const peer : other)
+                insert (peer);
+
+            other.swap (mine);
         }
+    };
 
-        int getFlags (void) const
+    /** An entry in the routing table.
+    */
+    class Entry
+    {
+    public:
+        // When the entry was created, in seconds of the router's clock
+        int created = 0;
+
+        int flags = 0;
+
+        PeerSet peers;
+
+        void addPeer (PeerShortID peer)
         {
-            return mFlags;
+            if (peer != 0)
+                peers.insert (peer);
         }
+    };
+
+    /** A slice of the routing table with its own lock.
+    */
+    class Shard
+    {
+    private:
+        flat_hash_map <uint256, Entry> mEntries;
+
+        // The keys created in each second, indexed by time modulo size
+        std::vector <std::vector <uint256>> mWheel;
+
+        // Every bucket for times before this has been expired
+        int mExpired = 0;
 
-        bool hasFlag (int mask) const
+        // Removes the entry for key if it was created at or before expireTime
+        void erase (uint256 const& key, int expireTime)
         {
-            return (mFlags & mask) != 0;
+            auto const iter = mEntries.find (key);
+            if (iter != mEntries.end () && iter->second.created <= expireTime)
+                mEntries.erase (iter);
         }
 
-        void setFlag (int flagsToSet)
+        void expire (int now, int holdTime)
         {
-            mFlags |= flagsToSet;
+            // Entries created at or before this time have expired
+            int const expireTime = now - holdTime;
+
+            // After a long idle period, one turn of the wheel covers it all
+            if (mExpired <= expireTime - static_cast <int> (mWheel.size ()))
+                mExpired = expireTime - static_cast <int> (mWheel.size ()) + 1;
+
+            for (; mExpired <= expireTime; ++mExpired)
+            {
+                auto& bucket = mWheel[mExpired % mWheel.size ()];
+                for (auto const& key : bucket)
+                    erase (key, expireTime);
+                bucket.clear ();
+            }
         }
 
-        void clearFlag (int flagsToClear)
+    public:
+        std::mutex mutex;
+
+        explicit Shard (int holdTime)
+            : mEntries (initialCapacity)
+            , mWheel (holdTime + 1)
         {
-            mFlags &= ~flagsToClear;
         }
 
-        void swapSet (std::set <PeerShortID>& other)
+        Entry& findCreate (uint256 const& key, int holdTime,
+            clock_type& clock, bool& created)
         {
-            mPeers.swap (other);
-        }
+            auto const iter = mEntries.find (key);
 
-    private:
-        int mFlags;
-        std::set <PeerShortID> mPeers;
+            if (iter != mEntries.end ())
+            {
+                created = false;
+                return iter->second;
+            }
+
+            created = true;
+
+            int const now = static_cast <int> (
+                std::chrono::duration_cast <std::chrono::seconds> (
+                    clock.now ().time_since_epoch ()).count ());
+            expire (now, holdTime);
+
+            // Expiring may have moved entries, so look up the slot again
+            Entry& e = mEntries[key];
+            e.created = now;
+            e.flags = 0;
+
+            mWheel[now % mWheel.size ()].push_back (key);
+            return e;
+        }
     };
 
 public:
-    explicit HashRouter (int holdTime)
-        : mHoldTime (holdTime)
+    HashRouter (int holdTime, clock_type& clock)
+        : mHoldTime (std::max (holdTime, 1))
+        , mClock (clock)
     {
+        for (auto& shard : mShards)
+            shard.reset (new Shard (mHoldTime));
     }
 
     bool addSuppression (uint256 const& index);
@@ -106,105 +210,81 @@ public:
     bool swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag);
 
 private:
-    Entry getEntry (uint256 const& );
-
-    Entry& findCreateEntry (uint256 const& , bool& created);
-
-    using MutexType = std::mutex;
-    using ScopedLockType = std::lock_guard <MutexType>;
-    MutexType mMutex;
+    using ScopedLockType = std::lock_guard <std::mutex>;
 
-    // Stores all suppressed hashes and their expiration time
-    hash_map <uint256, Entry> mSuppressionMap;
+    static int const shardBits = 5;
 
-    // Stores all expiration times and the hashes indexed for them
-    std::map< int, std::list<uint256> > mSuppressionTimes;
+    static std::size_t const shardCount = std::size_t (1) << shardBits;
 
-    int mHoldTime;
-};
-
-//------------------------------------------------------------------------------
+    static std::size_t const initialCapacity = 256;
 
-HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& created)
-{
-    hash_map<uint256, Entry>::iterator fit = mSuppressionMap.find (index);
-
-    if (fit != mSuppressionMap.end ())
+    // Use the secret keyed hash, so peers can't aim keys at one shard.
+    // The shard's map uses the low bits of the same hash, so take the
+    // high bits here.
+    Shard& getShard (uint256 const& index)
     {
-        created = false;
-        return fit->second;
+        auto const h = hardened_uint_hash () (index);
+        return *mShards[h >> (
+            std::numeric_limits <std::size_t>::digits - shardBits)];
     }
 
-    created = true;
+    int const mHoldTime;
 
-    int now = UptimeTimer::getInstance ().getElapsedSeconds ();
-    int expireTime = now - mHoldTime;
+    clock_type& mClock;
 
-    // See if any supressions need to be expired
-    std::map< int, std::list<uint256> >::iterator it = mSuppressionTimes.begin ();
-
-    if ((it != mSuppressionTimes.end ()) && (it->first <= expireTime))
-    {
-        for(auto const& lit : it->second)
-            mSuppressionMap.erase (lit);
-        mSuppressionTimes.erase (it);
-    }
+    std::array <std::unique_ptr <Shard>, shardCount> mShards;
+};
 
-    mSuppressionTimes[now].push_back (index);
-    return mSuppressionMap.emplace (index, Entry ()).first->second;
-}
+//------------------------------------------------------------------------------
 
 bool HashRouter::addSuppression (uint256 const& index)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    findCreateEntry (index, created);
+    shard.findCreate (index, mHoldTime, mClock, created);
     return created;
 }
 
-HashRouter::Entry HashRouter::getEntry (uint256 const& index)
-{
-    ScopedLockType lock (mMutex);
-
-    bool created;
-    return findCreateEntry (index, created);
-}
-
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    findCreateEntry (index, created).addPeer (peer);
+    shard.findCreate (index, mHoldTime, mClock, created).addPeer (peer);
     return created;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int& flags)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreate (index, mHoldTime, mClock, created);
     s.addPeer (peer);
-    flags = s.getFlags ();
+    flags = s.flags;
     return created;
 }
 
 int HashRouter::getFlags (uint256 const& index)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    return findCreateEntry (index, created).getFlags ();
+    return shard.findCreate (index, mHoldTime, mClock, created).flags;
 }
 
 bool HashRouter::addSuppressionFlags (uint256 const& index, int flag)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    findCreateEntry (index, created).setFlag (flag);
+    shard.findCreate (index, mHoldTime, mClock, created).flags |= flag;
     return created;
 }
 
@@ -217,37 +297,39 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
     // return: true = changed, false = unchanged
     assert (flag != 0);
 
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreate (index, mHoldTime, mClock, created);
 
-    if ((s.getFlags () & flag) == flag)
+    if ((s.flags & flag) == flag)
         return false;
 
-    s.setFlag (flag);
+    s.flags |= flag;
     return true;
 }
 
 bool HashRouter::swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag)
 {
-    ScopedLockType lock (mMutex);
+    Shard& shard = getShard (index);
+    ScopedLockType lock (shard.mutex);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreate (index, mHoldTime, mClock, created);
 
-    if ((s.getFlags () & flag) == flag)
+    if ((s.flags & flag) == flag)
         return false;
 
-    s.swapSet (peers);
-    s.setFlag (flag);
+    s.peers.swap (peers);
+    s.flags |= flag;
 
     return true;
 }
 
-IHashRouter* IHashRouter::New (int holdTime)
+IHashRouter* IHashRouter::New (int holdTime, clock_type& clock)
 {
-    return new HashRouter (holdTime);
+    return new HashRouter (holdTime, clock);
 }
 
 } // ripple
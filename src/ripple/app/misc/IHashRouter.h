@@ -21,6 +21,8 @@
 #define RIPPLE_APP_MISC_IHASHROUTER_H_INCLUDED
 
 #include <ripple/basics/base_uint.h>
+#include <beast/chrono/abstract_clock.h>
+#include <chrono>
 #include <cstdint>
 #include <set>
 
@@ -48,6 +50,8 @@ public:
     // The type here *MUST* match the type of Peer::id_t
     using PeerShortID = std::uint32_t;
 
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
     // VFALCO NOTE this preferred alternative to default parameters makes
     //         behavior clear.
     //
@@ -56,8 +60,11 @@ public:
         return 300;
     }
 
+    /** Create a router whose entries expire holdTime seconds after they
+        are created, as measured by clock.
+    */
     // VFALCO TODO rename the parameter to entryHoldTimeInSeconds
-    static IHashRouter* New (int holdTime);
+    static IHashRouter* New (int holdTime, clock_type& clock);
 
     virtual ~IHashRouter () { }
 
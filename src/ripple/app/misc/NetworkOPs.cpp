@@ -23,9 +23,11 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/FeeVote.h>
+#include <ripple/app/misc/FetchPackStore.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/ledger/LedgerCloseProfiler.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
@@ -34,6 +36,7 @@
 #include <ripple/app/main/LocalCredentials.h>
 #include <ripple/app/misc/IHashRouter.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/StreamFormat.h>
 #include <ripple/app/misc/Validations.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/app/misc/UniqueNodeList.h>
@@ -49,6 +52,7 @@
 #include <ripple/crypto/RandomNumbers.h>
 #include <ripple/crypto/RFC1751.h>
 #include <ripple/json/to_string.h>
+#include <ripple/net/StreamMessage.h>
 #include <ripple/overlay/ClusterNodeStatus.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/predicates.h>
@@ -137,6 +141,9 @@ public:
         , mFetchPack ("FetchPack", 65536, 45, clock,
             deprecatedLogs().journal("TaggedCache"))
         , mFetchSeq (0)
+        , mFetchPackStore (setup_FetchPackStore (
+            getConfig().section ("fetch_packs")))
+        , mFetchPackQueued (false)
         , mLastLoadBase (256)
         , mLastLoadFactor (256)
         , m_job_queue (job_queue)
@@ -349,6 +356,7 @@ public:
     bool getFetchPack (uint256 const& hash, Blob& data) override;
     int getFetchSize () override;
     void sweepFetchPack () override;
+    Json::Value getFetchPackStoreJson () const override;
 
     // Network state machine.
 
@@ -426,6 +434,7 @@ public:
     Json::Value getServerInfo (bool human, bool admin) override;
     void clearLedgerFetch () override;
     Json::Value getLedgerFetchInfo () override;
+    Json::Value getSendQueues () override;
     std::uint32_t acceptLedger () override;
     Proposals & peekStoredProposals () override
     {
@@ -555,22 +564,29 @@ private:
 
     void setMode (OperatingMode);
 
-    Json::Value transJson (
-        const STTx& stTxn, TER terResult, bool bValidated,
-        Ledger::ref lpCurrent);
     bool haveConsensusObject ();
 
     Json::Value pubBootstrapAccountInfo (
         Ledger::ref lpAccepted, RippleAddress const& naAccountID);
 
-    void pubValidatedTransaction (
-        Ledger::ref alAccepted, const AcceptedLedgerTx& alTransaction);
-    void pubAccountTransaction (
+    // These return the number of subscribers notified
+    std::size_t pubValidatedTransaction (
+        Ledger::ref alAccepted, const AcceptedLedgerTx& alTransaction,
+        LedgerCloseProfiler::duration& orderBookTime);
+    std::size_t pubAccountTransaction (
         Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction,
         bool isAccepted);
 
     void pubServer ();
 
+    // Fetch packs
+    void buildFetchPack (Ledger::pointer haveLedger,
+        Ledger::pointer wantLedger, protocol::TMGetObjectByHash& reply,
+            std::uint32_t uUptime);
+    void storeFetchPack (uint256 const& haveLedgerHash,
+        protocol::TMGetObjectByHash const& reply);
+    void precomputeFetchPack (Job&, Ledger::pointer haveLedger);
+
     std::string getHostId (bool forAdmin);
 
 private:
@@ -637,6 +653,10 @@ private:
     TaggedCache<uint256, Blob>  mFetchPack;
     std::uint32_t mFetchSeq;
 
+    // Fetch packs we built, for the peers that ask for them next
+    FetchPackStore mFetchPackStore;
+    std::atomic<bool> mFetchPackQueued;
+
     std::uint32_t mLastLoadBase;
     std::uint32_t mLastLoadFactor;
 
@@ -1801,17 +1821,15 @@ void NetworkOPsImp::pubServer ()
 
     if (!mSubServer.empty ())
     {
-        Json::Value jvObj (Json::objectValue);
-
-        jvObj [jss::type]          = "serverStatus";
-        jvObj [jss::server_status] = strOperatingMode ();
-        jvObj [jss::load_base]     =
+        auto const status = strOperatingMode ();
+        auto const loadBase =
                 (mLastLoadBase = getApp().getFeeTrack ().getLoadBase ());
-        jvObj [jss::load_factor]   =
+        auto const loadFactor =
                 (mLastLoadFactor = getApp().getFeeTrack ().getLoadFactor ());
 
-        std::string sObj = to_string (jvObj);
-
+        StreamMessage message (
+            [&] { return serverStatusJson (status, loadBase, loadFactor); },
+            [&] { return serverStatusBinary (status, loadBase, loadFactor); });
 
         for (auto i = mSubServer.begin (); i != mSubServer.end (); )
         {
@@ -1822,7 +1840,7 @@ void NetworkOPsImp::pubServer ()
             //             sending of JSON data.
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                message.send (*p, true);
                 ++i;
             }
             else
@@ -2223,8 +2241,20 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //      info[jss::consensus] = mConsensus->getJson();
 
     if (admin)
+    {
         info[jss::load] = m_job_queue.getJson ();
 
+        Json::Value const queues = getSendQueues ();
+        Json::Value& summary = (info[jss::send_queues] = Json::objectValue);
+        Json::UInt total = 0;
+        for (auto const& queue : queues)
+            total += queue[jss::queued_bytes].asUInt ();
+        summary[jss::subscribers] = queues.size ();
+        summary[jss::queued_bytes] = total;
+        summary[jss::largest_queued_bytes] = queues.empty () ?
+            0 : queues[0u][jss::queued_bytes].asUInt ();
+    }
+
     if (!human)
     {
         info[jss::load_base] = getApp().getFeeTrack ().getLoadBase ();
@@ -2334,6 +2364,58 @@ Json::Value NetworkOPsImp::getLedgerFetchInfo ()
     return getApp().getInboundLedgers().getInfo();
 }
 
+Json::Value NetworkOPsImp::getSendQueues ()
+{
+    hash_map <std::uint64_t, InfoSub::pointer> subscribers;
+
+    {
+        ScopedLockType sl (mSubLock);
+
+        auto add = [&subscribers](SubMapType const& map)
+        {
+            for (auto const& sub : map)
+            {
+                if (auto p = sub.second.lock ())
+                    subscribers.emplace (sub.first, std::move (p));
+            }
+        };
+
+        for (auto const& account : mSubAccount)
+            add (account.second);
+        for (auto const& account : mSubRTAccount)
+            add (account.second);
+        add (mSubLedger);
+        add (mSubServer);
+        add (mSubTransactions);
+        add (mSubRTTransactions);
+    }
+
+    getApp().getOrderBookDB().getSubscribers (subscribers);
+
+    // Queried without mSubLock, since each queue has its own lock
+    std::vector <Json::Value> queues;
+    for (auto const& sub : subscribers)
+    {
+        Json::Value queue = sub.second->getSendQueueJson ();
+        if (queue.isNull ())
+            continue;
+        queue[jss::subscriber] = std::to_string (sub.first);
+        queues.push_back (std::move (queue));
+    }
+
+    std::sort (queues.begin (), queues.end (),
+        [](Json::Value const& lhs, Json::Value const& rhs)
+        {
+            return lhs[jss::queued_bytes].asUInt () >
+                rhs[jss::queued_bytes].asUInt ();
+        });
+
+    Json::Value ret (Json::arrayValue);
+    for (auto const& queue : queues)
+        ret.append (queue);
+    return ret;
+}
+
 //
 // Monitoring: publisher side
 //
@@ -2357,11 +2439,15 @@ Json::Value NetworkOPsImp::pubBootstrapAccountInfo (
 void NetworkOPsImp::pubProposedTransaction (
     Ledger::ref lpCurrent, STTx::ref stTxn, TER terResult)
 {
-    Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
 
     {
         ScopedLockType sl (mSubLock);
 
+        StreamMessage message (
+            [&] { return transactionJson (alt, false, lpCurrent); },
+            [&] { return transactionBinary (alt, false, lpCurrent); });
+
         auto it = mSubRTTransactions.begin ();
         while (it != mSubRTTransactions.end ())
         {
@@ -2369,7 +2455,7 @@ void NetworkOPsImp::pubProposedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                message.send (*p, true);
                 ++it;
             }
             else
@@ -2378,8 +2464,8 @@ void NetworkOPsImp::pubProposedTransaction (
             }
         }
     }
-    AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
-    m_journal.trace << "pubProposed: " << alt.getJson ();
+    if (m_journal.trace)
+        m_journal.trace << "pubProposed: " << alt.getJson ();
     pubAccountTransaction (lpCurrent, alt, false);
 }
 
@@ -2388,6 +2474,11 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     // Ledgers are published only when they acquire sufficient validations
     // Holes are filled across connection loss or other catastrophe
 
+    auto& profiler = getApp().getLedgerCloseProfiler ();
+    LedgerCloseProfiler::ScopedPhase phase (
+        profiler, accepted->getLedgerSeq (), LedgerCloseProfiler::publish);
+    std::size_t notified = 0;
+
     auto alpAccepted = AcceptedLedger::makeAcceptedLedger (accepted);
     Ledger::ref lpAccepted = alpAccepted->getLedger ();
 
@@ -2396,35 +2487,35 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
 
         if (!mSubLedger.empty ())
         {
-            Json::Value jvObj (Json::objectValue);
-
-            jvObj[jss::type] = "ledgerClosed";
-            jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
-            jvObj[jss::ledger_hash] = to_string (lpAccepted->getHash ());
-            jvObj[jss::ledger_time]
-                    = Json::Value::UInt (lpAccepted->getCloseTimeNC ());
-
-            jvObj[jss::fee_ref]
-                    = Json::UInt (lpAccepted->getReferenceFeeUnits ());
-            jvObj[jss::fee_base] = Json::UInt (lpAccepted->getBaseFee ());
-            jvObj[jss::reserve_base] = Json::UInt (lpAccepted->getReserve (0));
-            jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->getReserveInc ());
-
-            jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
+            auto const txnCount = alpAccepted->getTxnCount ();
+            std::string validatedLedgers;
 
             if (mMode >= omSYNCING)
             {
-                jvObj[jss::validated_ledgers]
+                validatedLedgers
                         = getApp().getLedgerMaster ().getCompleteLedgers ();
             }
 
+            StreamMessage message (
+                [&]
+                {
+                    return ledgerClosedJson (
+                        lpAccepted, txnCount, validatedLedgers);
+                },
+                [&]
+                {
+                    return ledgerClosedBinary (
+                        lpAccepted, txnCount, validatedLedgers);
+                });
+
             auto it = mSubLedger.begin ();
             while (it != mSubLedger.end ())
             {
                 InfoSub::pointer p = it->second.lock ();
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    message.send (*p, true);
+                    ++notified;
                     ++it;
                 }
                 else
@@ -2434,10 +2525,29 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     }
 
     // Don't lock since pubAcceptedTransaction is locking.
+    auto orderBookTime = LedgerCloseProfiler::duration::zero ();
     for (auto const& vt : alpAccepted->getMap ())
     {
-        m_journal.trace << "pubAccepted: " << vt.second->getJson ();
-        pubValidatedTransaction (lpAccepted, *vt.second);
+        if (m_journal.trace)
+            m_journal.trace << "pubAccepted: " << vt.second->getJson ();
+        notified += pubValidatedTransaction (
+            lpAccepted, *vt.second, orderBookTime);
+    }
+
+    profiler.addPhase (lpAccepted->getLedgerSeq (),
+        LedgerCloseProfiler::orderBook, orderBookTime);
+    profiler.addSubscribers (lpAccepted->getLedgerSeq (), notified);
+
+    // Peers catching up ask for packs keyed by a recent validated ledger,
+    // to get the ledgers before it. At most one build is queued, so a
+    // ledger published while one is pending gets no pack in advance.
+    if (mFetchPackStore.setup ().precompute &&
+        mFetchPackStore.setup ().cacheBytes != 0 &&
+        !mFetchPackQueued.exchange (true))
+    {
+        m_job_queue.addJob (jtPACK, "precomputeFetchPack",
+            std::bind (&NetworkOPsImp::precomputeFetchPack, this,
+                std::placeholders::_1, lpAccepted));
     }
 }
 
@@ -2452,69 +2562,17 @@ void NetworkOPsImp::reportFeeChange ()
         std::bind (&NetworkOPsImp::pubServer, this));
 }
 
-// This routine should only be used to publish accepted or validated
-// transactions.
-Json::Value NetworkOPsImp::transJson(
-    const STTx& stTxn, TER terResult, bool bValidated,
-    Ledger::ref lpCurrent)
-{
-    Json::Value jvObj (Json::objectValue);
-    std::string sToken;
-    std::string sHuman;
-
-    transResultInfo (terResult, sToken, sHuman);
-
-    jvObj[jss::type]           = "transaction";
-    jvObj[jss::transaction]    = stTxn.getJson (0);
-
-    if (bValidated)
-    {
-        jvObj[jss::ledger_index]           = lpCurrent->getLedgerSeq ();
-        jvObj[jss::ledger_hash]            = to_string (lpCurrent->getHash ());
-        jvObj[jss::transaction][jss::date]  = lpCurrent->getCloseTimeNC ();
-        jvObj[jss::validated]              = true;
-
-        // WRITEME: Put the account next seq here
-
-    }
-    else
-    {
-        jvObj[jss::validated]              = false;
-        jvObj[jss::ledger_current_index]   = lpCurrent->getLedgerSeq ();
-    }
-
-    jvObj[jss::status]                 = bValidated ? "closed" : "proposed";
-    jvObj[jss::engine_result]          = sToken;
-    jvObj[jss::engine_result_code]     = terResult;
-    jvObj[jss::engine_result_message]  = sHuman;
-
-    if (stTxn.getTxnType() == ttOFFER_CREATE)
-    {
-        auto const account (stTxn.getSourceAccount ().getAccountID ());
-        auto const amount (stTxn.getFieldAmount (sfTakerGets));
-
-        // If the offer create is not self funded then add the owner balance
-        if (account != amount.issue ().account)
-        {
-            // VFALCO Why are we doing this hack?
-            LedgerEntrySet les (lpCurrent, tapNONE, true);
-            auto const ownerFunds = funds(
-                les,account, amount, fhIGNORE_FREEZE);
-            jvObj[jss::transaction][jss::owner_funds] = ownerFunds.getText ();
-        }
-    }
-
-    return jvObj;
-}
-
-void NetworkOPsImp::pubValidatedTransaction (
-    Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
+std::size_t NetworkOPsImp::pubValidatedTransaction (
+    Ledger::ref alAccepted, const AcceptedLedgerTx& alTx,
+    LedgerCloseProfiler::duration& orderBookTime)
 {
-    Json::Value jvObj = transJson (
-        *alTx.getTxn (), alTx.getResult (), true, alAccepted);
-    jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
+    // Rendered only if someone is listening, and only in the
+    // formats they asked for.
+    StreamMessage message (
+        [&] { return transactionJson (alTx, true, alAccepted); },
+        [&] { return transactionBinary (alTx, true, alAccepted); });
 
-    std::string sObj = to_string (jvObj);
+    std::size_t notified = 0;
 
     {
         ScopedLockType sl (mSubLock);
@@ -2526,7 +2584,8 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                message.send (*p, true);
+                ++notified;
                 ++it;
             }
             else
@@ -2541,18 +2600,26 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                message.send (*p, true);
+                ++notified;
                 ++it;
             }
             else
                 it = mSubRTTransactions.erase (it);
         }
     }
-    getApp().getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
-    pubAccountTransaction (alAccepted, alTx, true);
+
+    using namespace std::chrono;
+    auto const start = LedgerCloseProfiler::clock_type::now ();
+    notified += getApp().getOrderBookDB ().processTxn (
+        alAccepted, alTx, message);
+    orderBookTime += duration_cast <LedgerCloseProfiler::duration> (
+        LedgerCloseProfiler::clock_type::now () - start);
+
+    return notified + pubAccountTransaction (alAccepted, alTx, true);
 }
 
-void NetworkOPsImp::pubAccountTransaction (
+std::size_t NetworkOPsImp::pubAccountTransaction (
     Ledger::ref lpCurrent, const AcceptedLedgerTx& alTx, bool bAccepted)
 {
     hash_set<InfoSub::pointer>  notify;
@@ -2562,7 +2629,7 @@ void NetworkOPsImp::pubAccountTransaction (
     {
         ScopedLockType sl (mSubLock);
 
-        if (!bAccepted && mSubRTAccount.empty ()) return;
+        if (!bAccepted && mSubRTAccount.empty ()) return 0;
 
         if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
         {
@@ -2620,19 +2687,17 @@ void NetworkOPsImp::pubAccountTransaction (
 
     if (!notify.empty ())
     {
-        Json::Value jvObj = transJson (
-            *alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
-
-        if (alTx.isApplied ())
-            jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
-
-        std::string sObj = to_string (jvObj);
+        StreamMessage message (
+            [&] { return transactionJson (alTx, bAccepted, lpCurrent); },
+            [&] { return transactionBinary (alTx, bAccepted, lpCurrent); });
 
         for (InfoSub::ref isrListener : notify)
         {
-            isrListener->send (jvObj, sObj, true);
+            message.send (*isrListener, true);
         }
     }
+
+    return notify.size ();
 }
 
 //
@@ -3272,6 +3337,19 @@ static void fpAppender (
     newObj.set_data (&blob[0], blob.size ());
 }
 
+// Sends a stored or freshly built pack as the answer to a request
+static void sendFetchPack (Peer& peer,
+    protocol::TMGetObjectByHash const& request,
+        protocol::TMGetObjectByHash& reply)
+{
+    if (request.has_seq ())
+        reply.set_seq (request.seq ());
+
+    reply.set_ledgerhash (request.ledgerhash ());
+
+    peer.send (std::make_shared<Message> (reply, protocol::mtGET_OBJECTS));
+}
+
 void NetworkOPsImp::makeFetchPack (
     Job&, std::weak_ptr<Peer> wPeer,
     std::shared_ptr<protocol::TMGetObjectByHash> request,
@@ -3283,6 +3361,28 @@ void NetworkOPsImp::makeFetchPack (
         return;
     }
 
+    // A stored pack costs no NodeStore reads, so it is sent even when
+    // we are too busy to build one.
+    if (mFetchPackStore.setup ().cacheBytes != 0)
+    {
+        std::string objects;
+        protocol::TMGetObjectByHash reply;
+
+        if (mFetchPackStore.fetch (haveLedgerHash, objects) &&
+            reply.ParseFromString (objects))
+        {
+            Peer::ptr peer = wPeer.lock ();
+
+            if (peer)
+            {
+                m_journal.debug << "Sending stored fetch pack with " <<
+                    reply.objects ().size () << " nodes";
+                sendFetchPack (*peer, *request, reply);
+            }
+            return;
+        }
+    }
+
     if (getApp().getFeeTrack ().isLoadedLocal () ||
         (m_ledgerMaster.getValidatedLedgerAge() > 40))
     {
@@ -3336,60 +3436,12 @@ void NetworkOPsImp::makeFetchPack (
     try
     {
         protocol::TMGetObjectByHash reply;
-        reply.set_query (false);
-
-        if (request->has_seq ())
-            reply.set_seq (request->seq ());
-
-        reply.set_ledgerhash (request->ledgerhash ());
-        reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
-
-        // Building a fetch pack:
-        //  1. Add the header for the requested ledger.
-        //  2. Add the nodes for the AccountStateMap of that ledger.
-        //  3. If there are transactions, add the nodes for the
-        //     transactions of the ledger.
-        //  4. If the FetchPack now contains greater than or equal to
-        //     256 entries then stop.
-        //  5. If not very much time has elapsed, then loop back and repeat
-        //     the same process adding the previous ledger to the FetchPack.
-        do
-        {
-            std::uint32_t lSeq = wantLedger->getLedgerSeq ();
-
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
-            Serializer s (256);
-            s.add32 (HashPrefix::ledgerMaster);
-            wantLedger->addRaw (s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
-
-            wantLedger->peekAccountStateMap ()->getFetchPack
-                (haveLedger->peekAccountStateMap ().get (), true, 16384,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (wantLedger->getTransHash ().isNonZero ())
-                wantLedger->peekTransactionMap ()->getFetchPack (
-                    nullptr, true, 512,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (reply.objects ().size () >= 512)
-                break;
-
-            // move may save a ref/unref
-            haveLedger = std::move (wantLedger);
-            wantLedger = getLedgerByHash (haveLedger->getParentHash ());
-        }
-        while (wantLedger &&
-               UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
+        buildFetchPack (haveLedger, wantLedger, reply, uUptime);
+        storeFetchPack (haveLedgerHash, reply);
 
         m_journal.info
             << "Built fetch pack with " << reply.objects ().size () << " nodes";
-        auto msg = std::make_shared<Message> (reply, protocol::mtGET_OBJECTS);
-        peer->send (msg);
+        sendFetchPack (*peer, *request, reply);
     }
     catch (...)
     {
@@ -3397,6 +3449,98 @@ void NetworkOPsImp::makeFetchPack (
     }
 }
 
+void NetworkOPsImp::buildFetchPack (Ledger::pointer haveLedger,
+    Ledger::pointer wantLedger, protocol::TMGetObjectByHash& reply,
+        std::uint32_t uUptime)
+{
+    reply.set_query (false);
+    reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+
+    // Building a fetch pack:
+    //  1. Add the header for the requested ledger.
+    //  2. Add the nodes for the AccountStateMap of that ledger.
+    //  3. If there are transactions, add the nodes for the
+    //     transactions of the ledger.
+    //  4. If the FetchPack now contains greater than or equal to
+    //     256 entries then stop.
+    //  5. If not very much time has elapsed, then loop back and repeat
+    //     the same process adding the previous ledger to the FetchPack.
+    do
+    {
+        std::uint32_t lSeq = wantLedger->getLedgerSeq ();
+
+        protocol::TMIndexedObject& newObj = *reply.add_objects ();
+        newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
+        Serializer s (256);
+        s.add32 (HashPrefix::ledgerMaster);
+        wantLedger->addRaw (s);
+        newObj.set_data (s.getDataPtr (), s.getLength ());
+        newObj.set_ledgerseq (lSeq);
+
+        wantLedger->peekAccountStateMap ()->getFetchPack
+            (haveLedger->peekAccountStateMap ().get (), true, 16384,
+                std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
+                           std::placeholders::_2));
+
+        if (wantLedger->getTransHash ().isNonZero ())
+            wantLedger->peekTransactionMap ()->getFetchPack (
+                nullptr, true, 512,
+                std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
+                           std::placeholders::_2));
+
+        if (reply.objects ().size () >= 512)
+            break;
+
+        // move may save a ref/unref
+        haveLedger = std::move (wantLedger);
+        wantLedger = getLedgerByHash (haveLedger->getParentHash ());
+    }
+    while (wantLedger &&
+           UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
+}
+
+void NetworkOPsImp::storeFetchPack (uint256 const& haveLedgerHash,
+    protocol::TMGetObjectByHash const& reply)
+{
+    if (mFetchPackStore.setup ().cacheBytes == 0)
+        return;
+
+    // Called before the request's sequence and ledger hash are set,
+    // so the stored pack answers any request for the same ledger.
+    mFetchPackStore.insert (haveLedgerHash, reply.SerializeAsString ());
+}
+
+void NetworkOPsImp::precomputeFetchPack (Job&, Ledger::pointer haveLedger)
+{
+    mFetchPackQueued = false;
+
+    if (mFetchPackStore.contains (haveLedger->getHash ()) ||
+        getApp().getFeeTrack ().isLoadedLocal ())
+        return;
+
+    Ledger::pointer wantLedger = getLedgerByHash (haveLedger->getParentHash ());
+
+    if (!wantLedger)
+        return;
+
+    try
+    {
+        protocol::TMGetObjectByHash reply;
+        buildFetchPack (haveLedger, wantLedger, reply,
+            UptimeTimer::getInstance ().getElapsedSeconds ());
+        storeFetchPack (haveLedger->getHash (), reply);
+
+        m_journal.debug
+            << "Precomputed fetch pack for ledger "
+            << haveLedger->getLedgerSeq () << " with "
+            << reply.objects ().size () << " nodes";
+    }
+    catch (...)
+    {
+        m_journal.warning << "Exception precomputing fetch pack";
+    }
+}
+
 void NetworkOPsImp::sweepFetchPack ()
 {
     mFetchPack.sweep ();
@@ -3439,6 +3583,11 @@ int NetworkOPsImp::getFetchSize ()
     return mFetchPack.getCacheSize ();
 }
 
+Json::Value NetworkOPsImp::getFetchPackStoreJson () const
+{
+    return mFetchPackStore.getJson ();
+}
+
 void NetworkOPsImp::gotFetchPack (bool progress, std::uint32_t seq)
 {
 
@@ -236,6 +236,9 @@ public:
     virtual int getFetchSize () = 0;
     virtual void sweepFetchPack () = 0;
 
+    /** Counters of the store of built fetch packs. */
+    virtual Json::Value getFetchPackStoreJson () const = 0;
+
     // network state machine
     virtual void endConsensus (bool correctLCL) = 0;
     virtual void setStandAlone () = 0;
@@ -262,6 +265,9 @@ public:
     virtual void clearLedgerFetch () = 0;
     virtual Json::Value getLedgerFetchInfo () = 0;
 
+    /** Returns the outbound queues of the subscribers, largest first. */
+    virtual Json::Value getSendQueues () = 0;
+
     /** Accepts the current transaction tree, return the new ledger's sequence
 
         This API is only used via RPC with the server in STANDALONE mode and
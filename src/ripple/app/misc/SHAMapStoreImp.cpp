@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 
 #include <ripple/app/misc/SHAMapStoreImp.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/core/ConfigSections.h>
@@ -582,6 +583,7 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
     clearSql (*ledgerDb_, lastRotated,
         "SELECT MIN(LedgerSeq) FROM Ledgers;",
         "DELETE FROM Ledgers WHERE LedgerSeq < %u;");
+    getApp().getLedgerHashIndex ().eraseBefore (lastRotated);
     if (health())
         return;
 
@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/StreamFormat.h>
+#include <ripple/app/ledger/LedgerEntrySet.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/Serializer.h>
+
+namespace ripple {
+
+// This routine should only be used to publish accepted or validated
+// transactions.
+Json::Value
+transactionJson (AcceptedLedgerTx const& alTx, bool validated,
+    Ledger::ref ledger)
+{
+    auto const& stTxn = *alTx.getTxn ();
+    auto const terResult = alTx.getResult ();
+
+    Json::Value jvObj (Json::objectValue);
+    std::string sToken;
+    std::string sHuman;
+
+    transResultInfo (terResult, sToken, sHuman);
+
+    jvObj[jss::type]           = "transaction";
+    jvObj[jss::transaction]    = stTxn.getJson (0);
+
+    if (validated)
+    {
+        jvObj[jss::ledger_index]           = ledger->getLedgerSeq ();
+        jvObj[jss::ledger_hash]            = to_string (ledger->getHash ());
+        jvObj[jss::transaction][jss::date]  = ledger->getCloseTimeNC ();
+        jvObj[jss::validated]              = true;
+
+        // WRITEME: Put the account next seq here
+
+    }
+    else
+    {
+        jvObj[jss::validated]              = false;
+        jvObj[jss::ledger_current_index]   = ledger->getLedgerSeq ();
+    }
+
+    jvObj[jss::status]                 = validated ? "closed" : "proposed";
+    jvObj[jss::engine_result]          = sToken;
+    jvObj[jss::engine_result_code]     = terResult;
+    jvObj[jss::engine_result_message]  = sHuman;
+
+    if (stTxn.getTxnType() == ttOFFER_CREATE)
+    {
+        auto const account (stTxn.getSourceAccount ().getAccountID ());
+        auto const amount (stTxn.getFieldAmount (sfTakerGets));
+
+        // If the offer create is not self funded then add the owner balance
+        if (account != amount.issue ().account)
+        {
+            // VFALCO Why are we doing this hack?
+            LedgerEntrySet les (ledger, tapNONE, true);
+            auto const ownerFunds = funds(
+                les,account, amount, fhIGNORE_FREEZE);
+            jvObj[jss::transaction][jss::owner_funds] = ownerFunds.getText ();
+        }
+    }
+
+    if (alTx.isApplied ())
+        jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
+
+    return jvObj;
+}
+
+std::string
+transactionBinary (AcceptedLedgerTx const& alTx, bool validated,
+    Ledger::ref ledger)
+{
+    Serializer s;
+
+    s.add8 (bmtTRANSACTION);
+    s.add8 ((validated ? bmfVALIDATED : 0) |
+        (alTx.isApplied () ? bmfMETA : 0));
+    s.add32 (ledger->getLedgerSeq ());
+
+    if (validated)
+    {
+        s.add32 (ledger->getCloseTimeNC ());
+        s.add256 (ledger->getHash ());
+    }
+    else
+    {
+        s.add32 (0);
+    }
+
+    s.add32 (static_cast <std::uint32_t> (alTx.getResult ()));
+    s.addVL (alTx.getTxn ()->getSerializer ().peekData ());
+
+    if (alTx.isApplied ())
+    {
+        // Transactions read from a ledger keep their metadata as it was
+        // stored, so it is only serialized again if it was built here.
+        if (! alTx.getRawMeta ().empty ())
+            s.addVL (alTx.getRawMeta ());
+        else
+            s.addVL (alTx.getMeta ()->getAsObject ().getSerializer ().peekData ());
+    }
+
+    return s.getString ();
+}
+
+Json::Value
+ledgerClosedJson (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers)
+{
+    Json::Value jvObj (Json::objectValue);
+
+    jvObj[jss::type] = "ledgerClosed";
+    jvObj[jss::ledger_index] = ledger->getLedgerSeq ();
+    jvObj[jss::ledger_hash] = to_string (ledger->getHash ());
+    jvObj[jss::ledger_time]
+            = Json::Value::UInt (ledger->getCloseTimeNC ());
+
+    jvObj[jss::fee_ref]
+            = Json::UInt (ledger->getReferenceFeeUnits ());
+    jvObj[jss::fee_base] = Json::UInt (ledger->getBaseFee ());
+    jvObj[jss::reserve_base] = Json::UInt (ledger->getReserve (0));
+    jvObj[jss::reserve_inc] = Json::UInt (ledger->getReserveInc ());
+
+    jvObj[jss::txn_count] = Json::UInt (txnCount);
+
+    if (! validatedLedgers.empty ())
+        jvObj[jss::validated_ledgers] = validatedLedgers;
+
+    return jvObj;
+}
+
+std::string
+ledgerClosedBinary (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers)
+{
+    Serializer s (128);
+
+    s.add8 (bmtLEDGER_CLOSED);
+    s.add32 (ledger->getLedgerSeq ());
+    s.add256 (ledger->getHash ());
+    s.add32 (ledger->getCloseTimeNC ());
+    s.add32 (ledger->getReferenceFeeUnits ());
+    s.add64 (ledger->getBaseFee ());
+    s.add64 (ledger->getReserve (0));
+    s.add64 (ledger->getReserveInc ());
+    s.add32 (txnCount);
+    s.addVL (validatedLedgers.data (), validatedLedgers.size ());
+
+    return s.getString ();
+}
+
+Json::Value
+serverStatusJson (std::string const& status,
+    std::uint32_t loadBase, std::uint32_t loadFactor)
+{
+    Json::Value jvObj (Json::objectValue);
+
+    jvObj [jss::type]          = "serverStatus";
+    jvObj [jss::server_status] = status;
+    jvObj [jss::load_base]     = loadBase;
+    jvObj [jss::load_factor]   = loadFactor;
+
+    return jvObj;
+}
+
+std::string
+serverStatusBinary (std::string const& status,
+    std::uint32_t loadBase, std::uint32_t loadFactor)
+{
+    Serializer s (32);
+
+    s.add8 (bmtSERVER_STATUS);
+    s.add32 (loadBase);
+    s.add32 (loadFactor);
+    s.addVL (status.data (), status.size ());
+
+    return s.getString ();
+}
+
+} // ripple
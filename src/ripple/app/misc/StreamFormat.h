@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_STREAMFORMAT_H_INCLUDED
+#define RIPPLE_APP_MISC_STREAMFORMAT_H_INCLUDED
+
+#include <ripple/app/ledger/AcceptedLedgerTx.h>
+#include <ripple/json/json_value.h>
+#include <cstdint>
+#include <string>
+
+namespace ripple {
+
+/** The messages NetworkOPs publishes to subscription streams.
+
+    Each message has a JSON form, sent as text, and a compact binary
+    form for subscribers that asked for `binary: true`. The binary form
+    carries the canonical serialized transaction and metadata instead
+    of rendering them, and puts every integer in big endian order, as
+    Serializer does.
+
+    Every binary message starts with its BinaryMessageType:
+
+    transaction:
+        u8      bmtTRANSACTION
+        u8      flags (bmfVALIDATED, bmfMETA)
+        u32     ledger index, the current ledger if not validated
+        u32     ledger close time, if validated, else 0
+        u256    ledger hash, if validated
+        i32     engine result (TER)
+        VL      serialized transaction
+        VL      serialized metadata, if bmfMETA
+
+    ledgerClosed:
+        u8      bmtLEDGER_CLOSED
+        u32     ledger index
+        u256    ledger hash
+        u32     ledger close time
+        u32     reference fee units
+        u64     base fee
+        u64     reserve base
+        u64     reserve increment
+        u32     transaction count
+        VL      validated ledgers, may be empty
+
+    serverStatus:
+        u8      bmtSERVER_STATUS
+        u32     load base
+        u32     load factor
+        VL      server status
+
+    The binary transaction message does not carry `owner_funds`.
+*/
+enum BinaryMessageType : std::uint8_t
+{
+    bmtTRANSACTION      = 1,
+    bmtLEDGER_CLOSED    = 2,
+    bmtSERVER_STATUS    = 3
+};
+
+enum BinaryMessageFlags : std::uint8_t
+{
+    bmfVALIDATED        = 0x01,
+    bmfMETA             = 0x02
+};
+
+/** A transaction, with its metadata if it was applied. */
+Json::Value
+transactionJson (AcceptedLedgerTx const& alTx, bool validated,
+    Ledger::ref ledger);
+
+std::string
+transactionBinary (AcceptedLedgerTx const& alTx, bool validated,
+    Ledger::ref ledger);
+
+/** A validated ledger.
+
+    @param validatedLedgers Omitted from the JSON if empty.
+*/
+Json::Value
+ledgerClosedJson (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers);
+
+std::string
+ledgerClosedBinary (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers);
+
+/** A change in the server's operating mode or load. */
+Json::Value
+serverStatusJson (std::string const& status,
+    std::uint32_t loadBase, std::uint32_t loadFactor);
+
+std::string
+serverStatusBinary (std::string const& status,
+    std::uint32_t loadBase, std::uint32_t loadFactor);
+
+} // ripple
+
+#endif
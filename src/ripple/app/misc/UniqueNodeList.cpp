@@ -97,12 +97,7 @@ static
 std::string
 encodeCredential (AnyPublicKey const& pk, unsigned char type)
 {
-    Blob buffer;
-    buffer.reserve(1 + pk.size());
-    buffer.push_back (type);
-    auto const data = pk.data();
-    buffer.insert (buffer.end(), data, data + pk.size());
-    return Base58::encodeWithCheck (buffer);
+    return Base58::encodeWithCheck (type, pk.data(), pk.size());
 }
 
 template <size_t I, class String>
@@ -29,7 +29,10 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/basics/seconds_clock.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/SociDB.h>
 #include <beast/cxx14/memory.h> // <memory>
+#include <chrono>
+#include <limits>
 #include <mutex>
 #include <thread>
 
@@ -41,13 +44,21 @@ private:
     using LockType = std::mutex;
     using ScopedLockType = std::lock_guard <LockType>;
     using ScopedUnlockType = beast::GenericScopedUnlock <LockType>;
+    using clock_type = std::chrono::steady_clock;
     std::mutex mutable mLock;
 
+    // Stale validations are written in groups of at least this many,
+    // unless the last write was longer ago than writeInterval.
+    static std::size_t const writeBatch = 256;
+    static std::chrono::seconds const writeInterval;
+
     TaggedCache<uint256, ValidationSet> mValidations;
     ValidationSet mCurrentValidations;
     ValidationVector mStaleValidations;
 
+    std::uint32_t const mHistory;
     bool mWriting;
+    clock_type::time_point mLastWrite;
 
 private:
     std::shared_ptr<ValidationSet> findCreateSet (uint256 const& ledgerHash)
@@ -69,12 +80,15 @@ private:
     }
 
 public:
-    ValidationsImp ()
+    explicit
+    ValidationsImp (std::uint32_t history)
         : mValidations ("Validations", 128, 600, get_seconds_clock (),
             deprecatedLogs().journal("TaggedCache"))
+        , mHistory (history)
         , mWriting (false)
+        , mLastWrite (clock_type::now ())
     {
-        mStaleValidations.reserve (512);
+        mStaleValidations.reserve (writeBatch);
     }
 
 private:
@@ -401,21 +415,17 @@ private:
 
     void flush ()
     {
-        bool anyNew = false;
-
         WriteLog (lsINFO, Validations) << "Flushing validations";
         ScopedLockType sl (mLock);
         for (auto& it: mCurrentValidations)
         {
             if (it.second)
                 mStaleValidations.push_back (it.second);
-
-            anyNew = true;
         }
         mCurrentValidations.clear ();
 
-        if (anyNew)
-            condWrite ();
+        if (!mStaleValidations.empty ())
+            condWrite (true);
 
         while (mWriting)
         {
@@ -426,11 +436,24 @@ private:
         WriteLog (lsDEBUG, Validations) << "Validations flushed";
     }
 
-    void condWrite ()
+    // Called with the lock held. Unless forced, waits until a batch's
+    // worth of validations is stale or writeInterval has passed, so that
+    // each SQL transaction carries many rows.
+    void condWrite (bool force = false)
     {
         if (mWriting)
             return;
 
+        if (mHistory == 0)
+        {
+            mStaleValidations.clear ();
+            return;
+        }
+
+        if (!force && mStaleValidations.size () < writeBatch &&
+                clock_type::now () < mLastWrite + writeInterval)
+            return;
+
         mWriting = true;
         getApp().getJobQueue ().addJob (jtWRITE, "Validations::doWrite",
                                        std::bind (&ValidationsImp::doWrite,
@@ -440,8 +463,6 @@ private:
     void doWrite (Job&)
     {
         LoadEvent::autoptr event (getApp().getJobQueue ().getLoadEventAP (jtDISK, "ValidationWrite"));
-        boost::format insVal ("INSERT INTO Validations "
-                              "(LedgerHash,NodePubKey,SignTime,RawData) VALUES ('%s','%s','%u',%s);");
 
         ScopedLockType sl (mLock);
         assert (mWriting);
@@ -449,31 +470,16 @@ private:
         while (!mStaleValidations.empty ())
         {
             ValidationVector vector;
-            vector.reserve (512);
+            vector.reserve (writeBatch);
             mStaleValidations.swap (vector);
 
             {
                 ScopedUnlockType sul (mLock);
-                {
-                    auto db = getApp().getLedgerDB ().checkoutDb ();
-
-                    Serializer s (1024);
-                    soci::transaction tr(*db);
-                    for (auto it: vector)
-                    {
-                        s.erase ();
-                        it->add (s);
-                        *db << boost::str (
-                            insVal % to_string (it->getLedgerHash ()) %
-                            it->getSignerPublic ().humanNodePublic () %
-                            it->getSignTime () % sqlEscape (s.peekData ()));
-                    }
-
-                    tr.commit ();
-                }
+                saveValidations (getApp().getLedgerDB (), vector, mHistory);
             }
         }
 
+        mLastWrite = clock_type::now ();
         mWriting = false;
     }
 
@@ -484,9 +490,57 @@ private:
     }
 };
 
-std::unique_ptr <Validations> make_Validations ()
+std::chrono::seconds const ValidationsImp::writeInterval (15);
+
+std::unique_ptr <Validations> make_Validations (std::uint32_t history)
+{
+    return std::make_unique <ValidationsImp> (history);
+}
+
+void
+saveValidations (DatabaseCon& ledgerDB, ValidationVector const& validations,
+    std::uint32_t keep)
 {
-    return std::make_unique <ValidationsImp> ();
+    if (validations.empty ())
+        return;
+
+    auto db = ledgerDB.checkoutDb ();
+    soci::transaction tr (*db);
+
+    std::string ledgerHash;
+    std::string nodePubKey;
+    std::uint32_t signTime;
+    soci::blob rawData (*db);
+    soci::statement insert = (db->prepare <<
+        "INSERT INTO Validations "
+        "(LedgerHash,NodePubKey,SignTime,RawData) VALUES "
+        "(:hash,:key,:time,:raw);",
+        soci::use (ledgerHash), soci::use (nodePubKey),
+        soci::use (signTime), soci::use (rawData));
+
+    Serializer s (1024);
+    for (auto const& val : validations)
+    {
+        s.erase ();
+        val->add (s);
+        ledgerHash = to_string (val->getLedgerHash ());
+        nodePubKey = val->getSignerPublic ().humanNodePublic ();
+        signTime = val->getSignTime ();
+        // soci's blob only grows on write, so empty it before reuse
+        rawData.trim (0);
+        convert (s.peekData (), rawData);
+        insert.execute (true);
+    }
+
+    // Rows are numbered in the order they were written
+    if (keep != std::numeric_limits <std::uint32_t>::max ())
+    {
+        *db << "DELETE FROM Validations WHERE rowid <= "
+            "(SELECT MAX(rowid) FROM Validations) - :keep;",
+            soci::use (keep);
+    }
+
+    tr.commit ();
 }
 
 } // ripple
@@ -22,10 +22,13 @@
 
 #include <ripple/protocol/STValidation.h>
 #include <beast/cxx14/memory.h> // <memory>
+#include <cstdint>
 #include <vector>
 
 namespace ripple {
 
+class DatabaseCon;
+
 // VFALCO TODO rename and move these type aliases into the Validations interface
 
 // nodes validating and highest node ID validating
@@ -79,7 +82,25 @@ public:
     virtual void sweep () = 0;
 };
 
-std::unique_ptr <Validations> make_Validations ();
+/** Create the validations collection.
+
+    Trusted validations are written to the Validations table once they
+    are no longer current.
+
+    @param history The number of rows to keep in the Validations table.
+                   Zero writes nothing.
+*/
+std::unique_ptr <Validations> make_Validations (std::uint32_t history);
+
+/** Write validations to the Validations table.
+
+    The rows go in one SQL transaction through a single prepared
+    statement, with the serialized validation bound as a blob. Afterwards
+    only the `keep` most recently written rows are retained.
+*/
+void
+saveValidations (DatabaseCon& ledgerDB, ValidationVector const& validations,
+    std::uint32_t keep);
 
 } // ripple
 
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/CacheBudget.h>
+#include <ripple/basics/KeyCache.h>
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/chrono/manual_clock.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class CacheBudget_test : public beast::unit_test::suite
+{
+public:
+    using Cache = TaggedCache <int, std::string>;
+    using Keys = KeyCache <int>;
+
+    beast::manual_clock <std::chrono::steady_clock> clock_;
+    beast::Journal const j_;
+
+    // Fill a cache and look up keys until the given share of lookups missed
+    static
+    void
+    exercise (Cache& cache, int entries, int lookups, int misses)
+    {
+        for (int i = 0; i < entries; ++i)
+            cache.insert (i, "value");
+        for (int i = 0; i < lookups; ++i)
+            cache.fetch (i < misses ? -1 - i : i % entries);
+    }
+
+    void
+    testBalanced ()
+    {
+        testcase ("balanced");
+
+        Cache a ("a", 0, 0, clock_, j_);
+        Cache b ("b", 0, 0, clock_, j_);
+
+        CacheBudget budget (CacheBudget::Setup (), j_);
+        budget.add ("a", a, 100, 1000, 60);
+        budget.add ("b", b, 200, 500, 30);
+
+        expect (a.getTargetSize () == 1000 && a.getTargetAge () == 60,
+            "Should apply the configured target");
+
+        exercise (a, 1000, 100, 20);
+        exercise (b, 500, 100, 20);
+        budget.rebalance ();
+
+        expect (a.getTargetSize () == 1000, "Should keep its size");
+        expect (b.getTargetSize () == 500, "Should keep its size");
+        expect (b.getTargetAge () == 30, "Should keep its age");
+    }
+
+    void
+    testShift ()
+    {
+        testcase ("shift");
+
+        Cache busy ("busy", 0, 0, clock_, j_);
+        Keys idle ("idle", clock_);
+
+        CacheBudget budget (CacheBudget::Setup (), j_);
+        budget.add ("busy", busy, 100, 1000, 60);
+        budget.add ("idle", idle, 100, 1000, 60);
+
+        int lastBusy = 1000;
+        for (int round = 0; round < 20; ++round)
+        {
+            exercise (busy, busy.getTargetSize (), 100, 90);
+            budget.rebalance ();
+            expect (busy.getTargetSize () >= lastBusy, "Should not shrink");
+            lastBusy = busy.getTargetSize ();
+        }
+
+        expect (busy.getTargetSize () > 1000, "Busy cache should grow");
+        expect (busy.getTargetSize () <= 4000, "Growth should be bounded");
+        expect (busy.getTargetAge () > 60, "Age should follow size");
+
+        Json::Value const counts = budget.getJson ();
+        Json::Value const& idleJson = counts[jss::caches]["idle"];
+        expect (idleJson[jss::target_size].asInt () < 1000,
+            "Idle cache should shrink");
+        expect (idleJson[jss::target_size].asInt () >= 250,
+            "Shrinking should be bounded");
+        expect (counts[jss::budget].asUInt () == 200000,
+            "Budget should default to the configured total");
+
+        std::size_t const targets =
+            (busy.getTargetSize () + idleJson[jss::target_size].asUInt ()) * 100;
+        expect (targets <= 200000 + 200, "Should stay within the budget");
+    }
+
+    void
+    testRoomToSpare ()
+    {
+        testcase ("room to spare");
+
+        Cache sparse ("sparse", 0, 0, clock_, j_);
+        Cache full ("full", 0, 0, clock_, j_);
+
+        CacheBudget budget (CacheBudget::Setup (), j_);
+        budget.add ("sparse", sparse, 100, 1000, 60);
+        budget.add ("full", full, 100, 1000, 60);
+
+        for (int round = 0; round < 5; ++round)
+        {
+            // Every lookup misses, but the cache is nearly empty
+            exercise (sparse, 10, 100, 100);
+            exercise (full, 1000, 100, 10);
+            budget.rebalance ();
+        }
+
+        expect (sparse.getTargetSize () == 1000,
+            "A cache with room should not grow");
+    }
+
+    void
+    testFixed ()
+    {
+        testcase ("fixed and disabled");
+
+        Cache a ("a", 0, 0, clock_, j_);
+        Keys fixed ("fixed", clock_, 77, 11);
+
+        CacheBudget::Source source;
+        source.name = "fixed";
+        source.entryBytes = 10;
+        source.stats = [&fixed](std::size_t& size,
+            std::uint64_t& hits, std::uint64_t& misses)
+        {
+            fixed.getStats (size, hits, misses);
+        };
+
+        CacheBudget::Setup setup;
+        setup.adaptive = false;
+        CacheBudget budget (setup, j_);
+        budget.add ("a", a, 100, 1000, 60);
+        budget.add (std::move (source));
+
+        fixed.insert (1);
+        fixed.touch_if_exists (1);
+        fixed.touch_if_exists (2);
+
+        exercise (a, 1000, 100, 90);
+        budget.rebalance ();
+        budget.rebalance ();
+        expect (a.getTargetSize () == 1000, "Should not rebalance");
+
+        exercise (a, 1000, 100, 90);
+        fixed.touch_if_exists (1);
+        budget.rebalance ();
+
+        Json::Value const counts = budget.getJson ();
+        expect (! counts[jss::adaptive].asBool (), "Should be disabled");
+        expect (counts[jss::rebalances].asUInt () == 3, "Should count");
+
+        Json::Value const& a_ = counts[jss::caches]["a"];
+        expect (a_[jss::hits].asUInt () == 10, "Should count recent hits");
+        expect (a_[jss::misses].asUInt () == 90, "Should count recent misses");
+        expect (a_[jss::entries].asUInt () == 1000, "Should count entries");
+        expect (a_[jss::bytes].asUInt () == 100000, "Should estimate bytes");
+
+        Json::Value const& fixed_ = counts[jss::caches]["fixed"];
+        expect (! fixed_[jss::adaptive].asBool (), "Should be fixed");
+        expect (fixed_[jss::hits].asUInt () == 1, "Should count recent hits");
+        expect (fixed_[jss::entries].asUInt () == 1, "Should count entries");
+    }
+
+    void
+    testSetup ()
+    {
+        testcase ("setup");
+
+        {
+            Section section;
+            auto const setup = setup_CacheBudget (section);
+            expect (setup.adaptive, "Should default to adaptive");
+            expect (setup.budgetBytes == 0, "Should default to configured");
+        }
+        {
+            Section section;
+            section.set ("adaptive", "0");
+            section.set ("budget_mb", "512");
+            auto const setup = setup_CacheBudget (section);
+            expect (! setup.adaptive, "Should be disabled");
+            expect (setup.budgetBytes == 512 * 1024 * 1024, "Should be set");
+        }
+    }
+
+    void
+    run ()
+    {
+        clock_.set (0);
+
+        testBalanced ();
+        testShift ();
+        testRoomToSpare ();
+        testFixed ();
+        testSetup ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CacheBudget,app,ripple);
+
+}
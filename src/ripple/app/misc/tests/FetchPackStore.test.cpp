@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/FetchPackStore.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/unit_test/suite.h>
+#include <random>
+#include <string>
+
+namespace ripple {
+
+class FetchPackStore_test : public beast::unit_test::suite
+{
+public:
+    static
+    uint256
+    key (int i)
+    {
+        uint256 k;
+        k = i + 1;
+        return k;
+    }
+
+    // Mostly repetitive, like serialized nodes, but distinct per seed
+    static
+    std::string
+    pack (int seed, std::size_t size)
+    {
+        std::string s (size, 'x');
+        for (std::size_t i = 0; i < size; i += 64)
+            s[i] = static_cast<char> (seed + i / 64);
+        return s;
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        FetchPackStore store ({});
+        std::string out;
+
+        expect (! store.fetch (key (1), out));
+        expect (! store.contains (key (1)));
+
+        auto const p = pack (1, 100000);
+        store.insert (key (1), p);
+        expect (store.contains (key (1)));
+        expect (store.fetch (key (1), out));
+        expect (out == p);
+
+        // Replacing keeps one entry
+        auto const q = pack (2, 5000);
+        store.insert (key (1), q);
+        expect (store.fetch (key (1), out));
+        expect (out == q);
+
+        // Empty packs are not stored
+        store.insert (key (2), std::string ());
+        expect (! store.contains (key (2)));
+
+        auto const json = store.getJson ();
+        expect (json[jss::entries].asUInt () == 1);
+        expect (json[jss::hits].asUInt () == 2);
+        expect (json[jss::misses].asUInt () == 1);
+        expect (json[jss::stored].asUInt () == 2);
+        expect (json[jss::bytes].asUInt () < q.size ());
+    }
+
+    void
+    testEviction ()
+    {
+        testcase ("eviction");
+
+        // Measure one compressed pack, then allow room for three
+        std::size_t each;
+        {
+            FetchPackStore store ({});
+            store.insert (key (0), pack (0, 20000));
+            each = store.getJson ()[jss::bytes].asUInt ();
+        }
+
+        FetchPackStore::Setup setup;
+        setup.cacheBytes = 3 * each + each / 2;
+        FetchPackStore store (setup);
+        std::string out;
+
+        for (int i = 0; i < 3; ++i)
+            store.insert (key (i), pack (i, 20000));
+
+        // Touching the oldest makes the second the least recently used
+        expect (store.fetch (key (0), out));
+        store.insert (key (3), pack (3, 20000));
+
+        expect (store.contains (key (0)));
+        expect (! store.contains (key (1)));
+        expect (store.contains (key (2)));
+        expect (store.contains (key (3)));
+
+        auto const json = store.getJson ();
+        expect (json[jss::entries].asUInt () == 3);
+        expect (json[jss::evicted].asUInt () == 1);
+        expect (json[jss::bytes].asUInt () <= setup.cacheBytes);
+
+        // A pack that stays larger than the whole budget is refused
+        std::minstd_rand gen;
+        std::string big (setup.cacheBytes * 2, 0);
+        for (auto& c : big)
+            c = static_cast<char> (gen ());
+        store.insert (key (4), big);
+        expect (! store.contains (key (4)));
+        expect (store.contains (key (0)));
+    }
+
+    void
+    testDisabled ()
+    {
+        testcase ("disabled");
+
+        FetchPackStore::Setup setup;
+        setup.cacheBytes = 0;
+        FetchPackStore store (setup);
+        store.insert (key (1), pack (1, 1000));
+        expect (! store.contains (key (1)));
+    }
+
+    void
+    testSetup ()
+    {
+        testcase ("setup");
+
+        {
+            auto const setup = setup_FetchPackStore (Section ());
+            expect (! setup.precompute);
+            expect (setup.cacheBytes == 32 * 1024 * 1024);
+        }
+        {
+            Section section;
+            section.set ("precompute", "1");
+            section.set ("cache_mb", "8");
+            auto const setup = setup_FetchPackStore (section);
+            expect (setup.precompute);
+            expect (setup.cacheBytes == 8 * 1024 * 1024);
+        }
+    }
+
+    void
+    run ()
+    {
+        testRoundTrip ();
+        testEviction ();
+        testDisabled ();
+        testSetup ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPackStore,app,ripple);
+
+} // ripple
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/IHashRouter.h>
+#include <ripple/basics/seconds_clock.h>
+#include <beast/chrono/manual_clock.h>
+#include <beast/random/xor_shift_engine.h>
+#include <beast/unit_test/suite.h>
+#include <beast/unit_test/thread.h>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace ripple {
+
+class HashRouter_test : public beast::unit_test::suite
+{
+public:
+    template <class Generator>
+    static
+    uint256
+    randomKey (Generator& g)
+    {
+        uint256 key;
+        auto const p = reinterpret_cast <std::uint64_t*> (key.begin ());
+        for (int i = 0; i < 4; ++i)
+            p[i] = g ();
+        return key;
+    }
+
+    void
+    testFlags ()
+    {
+        testcase ("flags");
+
+        std::unique_ptr <IHashRouter> router (IHashRouter::New (300, get_seconds_clock ()));
+        beast::xor_shift_engine g (1);
+        uint256 const key = randomKey (g);
+
+        expect (router->getFlags (key) == 0);
+        expect (! router->addSuppression (key));
+        expect (router->setFlag (key, SF_SIGGOOD));
+        expect (! router->setFlag (key, SF_SIGGOOD));
+        expect (! router->addSuppressionFlags (key, SF_TRUSTED));
+        expect (router->getFlags (key) == (SF_SIGGOOD | SF_TRUSTED));
+
+        uint256 const other = randomKey (g);
+        expect (router->addSuppressionFlags (other, SF_BAD));
+        int flags = 0;
+        expect (! router->addSuppressionPeer (other, 7, flags));
+        expect (flags == SF_BAD);
+    }
+
+    void
+    testPeers ()
+    {
+        testcase ("peers");
+
+        std::unique_ptr <IHashRouter> router (IHashRouter::New (300, get_seconds_clock ()));
+        beast::xor_shift_engine g (2);
+        uint256 const key = randomKey (g);
+
+        // More peers than are stored inline
+        expect (router->addSuppressionPeer (key, 1));
+        for (IHashRouter::PeerShortID id = 1; id <= 20; ++id)
+            expect (! router->addSuppressionPeer (key, id));
+        expect (! router->addSuppressionPeer (key, 5));
+        expect (! router->addSuppressionPeer (key, 0));
+
+        std::set <IHashRouter::PeerShortID> peers;
+        expect (router->swapSet (key, peers, SF_RELAYED));
+        expect (peers.size () == 20);
+        expect (peers.count (0) == 0);
+        expect (peers.count (20) == 1);
+
+        // Already relayed
+        std::set <IHashRouter::PeerShortID> again;
+        expect (! router->swapSet (key, again, SF_RELAYED));
+        expect (again.empty ());
+    }
+
+    void
+    testExpiration ()
+    {
+        testcase ("expiration");
+
+        int const holdTime = 5;
+        beast::manual_clock <std::chrono::steady_clock> clock;
+        std::unique_ptr <IHashRouter> router (
+            IHashRouter::New (holdTime, clock));
+        beast::xor_shift_engine g (3);
+
+        uint256 const key = randomKey (g);
+        expect (router->addSuppression (key));
+        router->setFlag (key, SF_BAD);
+
+        clock.advance (std::chrono::seconds (holdTime - 1));
+        for (int i = 0; i < 1000; ++i)
+            router->addSuppression (randomKey (g));
+        expect (router->getFlags (key) == SF_BAD, "expired early");
+
+        clock.advance (std::chrono::seconds (2));
+        // Creating entries expires the old ones in each part of the table
+        for (int i = 0; i < 1000; ++i)
+            router->addSuppression (randomKey (g));
+        expect (router->addSuppression (key), "not expired");
+        expect (router->getFlags (key) == 0);
+    }
+
+    void
+    run ()
+    {
+        testFlags ();
+        testPeers ();
+        testExpiration ();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// Measures throughput of the relay path under concurrent load
+class HashRouter_timing_test : public HashRouter_test
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    void
+    do_timing (int threads, std::size_t messages)
+    {
+        std::unique_ptr <IHashRouter> router (
+            IHashRouter::New (IHashRouter::getDefaultHoldTime (),
+                get_seconds_clock ()));
+
+        // Each message is received from several peers, then relayed
+        int const peersPerMessage = 8;
+
+        auto const start = clock_type::now ();
+
+        std::vector <beast::unit_test::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back (*this, [&, t]
+            {
+                std::size_t const count = messages / threads;
+                for (int p = 0; p < peersPerMessage; ++p)
+                {
+                    // Every thread sees the same messages from its peers
+                    beast::xor_shift_engine g (1);
+                    for (std::size_t i = 0; i < count; ++i)
+                        router->addSuppressionPeer (randomKey (g),
+                            t * peersPerMessage + p + 1);
+                }
+
+                beast::xor_shift_engine g (1);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    std::set <IHashRouter::PeerShortID> peers;
+                    router->swapSet (randomKey (g), peers, SF_RELAYED);
+                }
+            });
+        }
+
+        for (auto& w : workers)
+            w.join ();
+
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::milliseconds> (clock_type::now () - start);
+        std::size_t const ops = (messages / threads) * threads *
+            (peersPerMessage + 1);
+
+        std::stringstream ss;
+        ss << threads << " threads: " << ops << " ops in " <<
+            elapsed.count () << "ms, " << static_cast <std::uint64_t> (
+                ops * 1000.0 / std::max <std::int64_t> (elapsed.count (), 1)) <<
+            " ops/s";
+        log << ss.str ();
+    }
+
+    void
+    run () override
+    {
+        std::size_t const messages = 200000;
+        for (int threads = 1; threads <= 16; threads *= 2)
+            do_timing (threads, messages);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HashRouter,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouter_timing,app,ripple);
+
+} // ripple
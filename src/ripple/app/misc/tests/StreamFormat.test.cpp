@@ -0,0 +1,347 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/StreamFormat.h>
+#include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/json/to_string.h>
+#include <ripple/net/StreamMessage.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/test/jtx.h>
+#include <beast/http/rfc2616.h>
+#include <beast/unit_test/suite.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+namespace test {
+
+class StreamFormatTestBase : public beast::unit_test::suite
+{
+public:
+    static
+    std::vector<jtx::Account>
+    setup (jtx::Env& env, jtx::Account const& gw, std::size_t n)
+    {
+        using namespace jtx;
+        auto const USD = gw["USD"];
+        env.fund (XRP (1000000), gw);
+
+        std::vector<Account> accounts;
+        accounts.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            accounts.emplace_back ("sf" + std::to_string (i));
+            env.fund (XRP (1000000), accounts.back ());
+            env.trust (USD (1000000), accounts.back ());
+            env (pay (gw, accounts.back (), USD (100000)));
+        }
+        return accounts;
+    }
+
+    // Closes a ledger of payments and offers, like the transaction
+    // stream of a busy server. One in four is an offer that is not self
+    // funded, so its JSON includes the owner's balance.
+    Ledger::pointer
+    closeLedger (jtx::Env& env, jtx::Account const& gw,
+        std::vector<jtx::Account> const& accounts, std::size_t txs)
+    {
+        using namespace jtx;
+        auto const USD = gw["USD"];
+
+        env.ledger = std::make_shared<Ledger> (false, *env.ledger);
+
+        // The Env applies to an open ledger, whose map holds no
+        // metadata, so apply the way a closing ledger does. One
+        // engine numbers the transactions within the ledger.
+        TransactionEngine engine (env.ledger, tx_enable_test);
+        for (std::size_t i = 0; i < txs; ++i)
+        {
+            auto const& from = accounts[i % accounts.size ()];
+            auto const& to = accounts[(i + 1) % accounts.size ()];
+            auto const jt = (i % 4 == 0)
+                ? env.jt (offer (from, XRP (10), USD (1)))
+                : env.jt (pay (from, to, XRP (1)));
+            STTx const stx (parse (jt.jv));
+            expect (engine.applyTransaction (
+                stx, tapNONE).first == tesSUCCESS);
+        }
+
+        auto const closed = env.ledger;
+        closed->setClosed ();
+        closed->getHash ();
+
+        env.ledger = std::make_shared<Ledger> (false, *closed);
+        return closed;
+    }
+};
+
+class StreamFormat_test : public StreamFormatTestBase
+{
+public:
+    void
+    testTransaction ()
+    {
+        testcase ("transaction");
+
+        using namespace jtx;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 4);
+        auto const ledger = closeLedger (env, gw, accounts, 8);
+        auto const al = AcceptedLedger::makeAcceptedLedger (ledger);
+
+        for (auto const& entry : al->getMap ())
+        {
+            auto const& alTx = *entry.second;
+            auto const blob = transactionBinary (alTx, true, ledger);
+
+            SerialIter sit (blob.data (), blob.size ());
+            expect (sit.get8 () == bmtTRANSACTION);
+            expect (sit.get8 () == (bmfVALIDATED | bmfMETA));
+            expect (sit.get32 () == ledger->getLedgerSeq ());
+            expect (sit.get32 () == ledger->getCloseTimeNC ());
+            expect (sit.get256 () == ledger->getHash ());
+            expect (static_cast <TER> (sit.get32 ()) == alTx.getResult ());
+
+            auto const txBlob = sit.getVL ();
+            SerialIter txSit (txBlob.data (), txBlob.size ());
+            STTx const txn (txSit);
+            expect (txn.getTransactionID () == alTx.getTransactionID ());
+
+            auto const metaBlob = sit.getVL ();
+            TransactionMetaSet const meta (
+                txn.getTransactionID (), ledger->getLedgerSeq (), metaBlob);
+            expect (meta.getIndex () == alTx.getIndex ());
+            expect (meta.getJson (0) == alTx.getMeta ()->getJson (0));
+            expect (sit.empty ());
+
+            auto const json = transactionJson (alTx, true, ledger);
+            expect (json[jss::type] == "transaction");
+            expect (json[jss::validated].asBool ());
+            expect (json[jss::meta] == alTx.getMeta ()->getJson (0));
+            expect (json[jss::engine_result_code] == alTx.getResult ());
+        }
+    }
+
+    void
+    testProposed ()
+    {
+        testcase ("proposed");
+
+        using namespace jtx;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 2);
+        auto const ledger = closeLedger (env, gw, accounts, 1);
+        auto const al = AcceptedLedger::makeAcceptedLedger (ledger);
+        auto const txn = al->getTxn (0);
+        expect (txn != nullptr);
+        if (! txn)
+            return;
+
+        AcceptedLedgerTx const alTx (ledger, txn->getTxn (), tesSUCCESS);
+        auto const blob = transactionBinary (alTx, false, ledger);
+
+        SerialIter sit (blob.data (), blob.size ());
+        expect (sit.get8 () == bmtTRANSACTION);
+        expect (sit.get8 () == 0);
+        expect (sit.get32 () == ledger->getLedgerSeq ());
+        expect (sit.get32 () == 0);
+        expect (static_cast <TER> (sit.get32 ()) == tesSUCCESS);
+        expect (sit.getVL () == txn->getTxn ()->getSerializer ().peekData ());
+        expect (sit.empty ());
+
+        auto const json = transactionJson (alTx, false, ledger);
+        expect (! json[jss::validated].asBool ());
+        expect (! json.isMember (jss::meta));
+        expect (json[jss::ledger_current_index] == ledger->getLedgerSeq ());
+    }
+
+    void
+    testLedgerClosed ()
+    {
+        testcase ("ledgerClosed");
+
+        using namespace jtx;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 2);
+        auto const ledger = closeLedger (env, gw, accounts, 3);
+
+        auto const blob = ledgerClosedBinary (ledger, 3, "1-5");
+        auto const json = ledgerClosedJson (ledger, 3, "1-5");
+
+        SerialIter sit (blob.data (), blob.size ());
+        expect (sit.get8 () == bmtLEDGER_CLOSED);
+        expect (sit.get32 () == json[jss::ledger_index].asUInt ());
+        expect (to_string (sit.get256 ()) == json[jss::ledger_hash].asString ());
+        expect (sit.get32 () == json[jss::ledger_time].asUInt ());
+        expect (sit.get32 () == json[jss::fee_ref].asUInt ());
+        expect (sit.get64 () == json[jss::fee_base].asUInt ());
+        expect (sit.get64 () == json[jss::reserve_base].asUInt ());
+        expect (sit.get64 () == json[jss::reserve_inc].asUInt ());
+        expect (sit.get32 () == json[jss::txn_count].asUInt ());
+        auto const validated = sit.getVL ();
+        expect (std::string (validated.begin (), validated.end ()) ==
+            json[jss::validated_ledgers].asString ());
+        expect (sit.empty ());
+
+        // Not yet synced
+        expect (! ledgerClosedJson (ledger, 3, "").isMember (
+            jss::validated_ledgers));
+    }
+
+    void
+    testServerStatus ()
+    {
+        testcase ("serverStatus");
+
+        auto const blob = serverStatusBinary ("full", 256, 512);
+        SerialIter sit (blob.data (), blob.size ());
+        expect (sit.get8 () == bmtSERVER_STATUS);
+        expect (sit.get32 () == 256);
+        expect (sit.get32 () == 512);
+        auto const status = sit.getVL ();
+        expect (std::string (status.begin (), status.end ()) == "full");
+        expect (sit.empty ());
+
+        auto const json = serverStatusJson ("full", 256, 512);
+        expect (json[jss::type] == "serverStatus");
+        expect (json[jss::server_status] == "full");
+        expect (json[jss::load_factor] == 512);
+    }
+
+    void
+    testStreamMessage ()
+    {
+        testcase ("StreamMessage");
+
+        int jsonBuilt = 0;
+        int binaryBuilt = 0;
+        StreamMessage message (
+            [&] { ++jsonBuilt; return serverStatusJson ("full", 256, 256); },
+            [&] { ++binaryBuilt; return serverStatusBinary ("full", 256, 256); });
+
+        // Each form is built once, and only when asked for
+        expect (message.getBinary () == message.getBinary ());
+        expect (jsonBuilt == 0 && binaryBuilt == 1);
+        expect (message.getText () ==
+            to_string (serverStatusJson ("full", 256, 256)));
+        expect (message.getJson ()[jss::load_base] == 256);
+        expect (jsonBuilt == 1 && binaryBuilt == 1);
+    }
+
+    void
+    run () override
+    {
+        testTransaction ();
+        testProposed ();
+        testLedgerClosed ();
+        testServerStatus ();
+        testStreamMessage ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StreamFormat,app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Times the work publishing does for each transaction of a ledger, in
+// each format: rendering the JSON and writing it as text, or building
+// the binary message.
+//
+// Arguments: txs=<transactions per ledger>,ledgers=<ledgers to time>
+//
+class StreamFormat_timing_test : public StreamFormatTestBase
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    void
+    run () override
+    {
+        std::size_t txs = 2000;
+        std::size_t ledgers = 3;
+        for (auto const& kv : beast::rfc2616::split (
+            arg ().begin (), arg ().end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                continue;
+            auto const key = kv.substr (0, pos);
+            auto const value = kv.substr (pos + 1);
+            if (key == "txs")
+                txs = std::stoul (value);
+            else if (key == "ledgers")
+                ledgers = std::stoul (value);
+        }
+
+        using namespace jtx;
+        using namespace std::chrono;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const accounts = setup (env, gw, 50);
+
+        log << txs << " transactions per ledger";
+
+        for (std::size_t n = 0; n < ledgers; ++n)
+        {
+            auto const ledger = closeLedger (env, gw, accounts, txs);
+            auto const al = AcceptedLedger::makeAcceptedLedger (ledger);
+
+            std::size_t jsonBytes = 0;
+            auto start = clock_type::now ();
+            for (auto const& entry : al->getMap ())
+                jsonBytes += to_string (
+                    transactionJson (*entry.second, true, ledger)).size ();
+            auto const json = duration_cast<microseconds> (
+                clock_type::now () - start);
+
+            std::size_t binaryBytes = 0;
+            start = clock_type::now ();
+            for (auto const& entry : al->getMap ())
+                binaryBytes += transactionBinary (
+                    *entry.second, true, ledger).size ();
+            auto const binary = duration_cast<microseconds> (
+                clock_type::now () - start);
+
+            expect (jsonBytes > binaryBytes);
+
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision (2) <<
+                "ledger " << ledger->getLedgerSeq () << ":" <<
+                " json " << std::setw (8) <<
+                    double (json.count ()) / txs << " us/tx " <<
+                    std::setw (5) << jsonBytes / txs << " bytes/tx," <<
+                " binary " << std::setw (8) <<
+                    double (binary.count ()) / txs << " us/tx " <<
+                    std::setw (5) << binaryBytes / txs << " bytes/tx";
+            log << ss.str ();
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(StreamFormat_timing,app,ripple);
+
+} // test
+} // ripple
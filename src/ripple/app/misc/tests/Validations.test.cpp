@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/Validations.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/RippleAddress.h>
+#include <beast/unit_test/suite.h>
+#include <beast/cxx14/memory.h>  // <memory>
+#include <limits>
+
+namespace ripple {
+
+class Validations_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::unique_ptr <DatabaseCon>
+    makeLedgerDB ()
+    {
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        return std::make_unique <DatabaseCon> (setup, "ledger.db",
+            LedgerDBInit, LedgerDBCount);
+    }
+
+    static
+    int
+    count (DatabaseCon& con, std::string const& sql)
+    {
+        auto db = con.checkoutDb ();
+        int n = 0;
+        *db << sql, soci::into (n);
+        return n;
+    }
+
+    // Unsigned validations for consecutive sign times
+    static
+    ValidationVector
+    makeValidations (std::uint32_t firstTime, std::size_t n)
+    {
+        auto const node = RippleAddress::createNodePublic (
+            RippleAddress::createSeedGeneric ("validator"));
+        ValidationVector v;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            uint256 const hash (firstTime + i);
+            v.push_back (std::make_shared <STValidation> (
+                hash, firstTime + i, node, true));
+        }
+        return v;
+    }
+
+    void
+    testSave ()
+    {
+        testcase ("save");
+
+        auto ledgerDB = makeLedgerDB ();
+        auto const vals = makeValidations (100, 10);
+        saveValidations (*ledgerDB, vals,
+            std::numeric_limits <std::uint32_t>::max ());
+        expect (count (*ledgerDB,
+            "SELECT COUNT(*) FROM Validations;") == 10);
+
+        auto db = ledgerDB->checkoutDb ();
+        std::string hash;
+        std::string key;
+        std::uint32_t time;
+        soci::blob raw (*db);
+        soci::statement st = (db->prepare <<
+            "SELECT LedgerHash, NodePubKey, SignTime, RawData "
+            "FROM Validations ORDER BY SignTime;",
+            soci::into (hash), soci::into (key), soci::into (time),
+            soci::into (raw));
+        st.execute ();
+        std::size_t i = 0;
+        while (st.fetch ())
+        {
+            auto const& val = vals[i];
+            expect (hash == to_string (val->getLedgerHash ()));
+            expect (key == val->getSignerPublic ().humanNodePublic ());
+            expect (time == val->getSignTime ());
+            Serializer s;
+            val->add (s);
+            Blob b;
+            convert (raw, b);
+            expect (b == s.peekData ());
+            ++i;
+        }
+        expect (i == vals.size ());
+    }
+
+    void
+    testKeep ()
+    {
+        testcase ("keep");
+
+        auto ledgerDB = makeLedgerDB ();
+        saveValidations (*ledgerDB, makeValidations (100, 10), 15);
+        expect (count (*ledgerDB,
+            "SELECT COUNT(*) FROM Validations;") == 10);
+
+        // Only the most recently written rows remain
+        saveValidations (*ledgerDB, makeValidations (200, 10), 15);
+        expect (count (*ledgerDB,
+            "SELECT COUNT(*) FROM Validations;") == 15);
+        expect (count (*ledgerDB,
+            "SELECT MIN(SignTime) FROM Validations;") == 105);
+
+        saveValidations (*ledgerDB, makeValidations (300, 3), 2);
+        expect (count (*ledgerDB,
+            "SELECT COUNT(*) FROM Validations;") == 2);
+        expect (count (*ledgerDB,
+            "SELECT MIN(SignTime) FROM Validations;") == 301);
+    }
+
+    void
+    run () override
+    {
+        testSave ();
+        testKeep ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Validations,app,ripple);
+
+}
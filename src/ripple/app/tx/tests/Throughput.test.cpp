@@ -0,0 +1,361 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/test/jtx.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/STTx.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// Counting allocations replaces the global operator new for the whole
+// binary, so it is only compiled into builds made for measuring.
+#ifndef TX_THROUGHPUT_COUNT_ALLOCATIONS
+#define TX_THROUGHPUT_COUNT_ALLOCATIONS 0
+#endif
+
+#if TX_THROUGHPUT_COUNT_ALLOCATIONS
+
+static std::atomic<std::size_t> txThroughputAllocations (0);
+
+void*
+operator new (std::size_t size)
+{
+    ++txThroughputAllocations;
+    if (void* p = std::malloc (size ? size : 1))
+        return p;
+    throw std::bad_alloc ();
+}
+
+void
+operator delete (void* p) noexcept
+{
+    std::free (p);
+}
+
+#endif
+
+namespace ripple {
+namespace test {
+
+// Measures the transaction engine on reproducible jtx workloads.
+//
+// Each workload is set up in its own Env, then its transactions are
+// signed and serialized up front. The timed pass deserializes, checks
+// the signature of, and applies each one to the open ledger.
+//
+// The engine computes metadata inside applyTransaction and releases
+// its view before returning, so the apply column includes metadata.
+//
+class Throughput_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const txCount = 1000;
+
+    struct Totals
+    {
+        std::size_t txs = 0;
+        std::size_t failed = 0;
+        std::size_t allocations = 0;
+        clock_type::duration deserialize {};
+        clock_type::duration checkSign {};
+        clock_type::duration apply {};
+    };
+
+    static
+    std::size_t
+    allocations ()
+    {
+#if TX_THROUGHPUT_COUNT_ALLOCATIONS
+        return txThroughputAllocations.load ();
+#else
+        return 0;
+#endif
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts (std::string const& prefix, std::size_t n)
+    {
+        std::vector<jtx::Account> v;
+        v.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+            v.emplace_back (prefix + std::to_string (i));
+        return v;
+    }
+
+    // Sign and serialize, tracking sequence numbers ourselves since
+    // nothing is applied until the timed pass
+    class Batch
+    {
+    private:
+        jtx::Env& env_;
+        std::map<ripple::Account, std::uint32_t> seqs_;
+
+    public:
+        std::vector<Blob> txs;
+
+        explicit
+        Batch (jtx::Env& env)
+            : env_ (env)
+        {
+        }
+
+        template <class... FN>
+        void
+        add (jtx::Account const& account,
+            Json::Value const& jv, FN const&... fN)
+        {
+            auto iter = seqs_.find (account.id ());
+            if (iter == seqs_.end ())
+                iter = seqs_.emplace (account.id (),
+                    env_.seq (account)).first;
+            auto const jt = env_.jt (jv, jtx::seq (iter->second++), fN...);
+            STTx const stx (jtx::parse (jt.jv));
+            Serializer s;
+            stx.add (s);
+            txs.push_back (std::move (s.modData ()));
+        }
+    };
+
+    std::vector<Blob>
+    xrpPayments (jtx::Env& env)
+    {
+        using namespace jtx;
+        auto const accounts = makeAccounts ("xrp", 50);
+        for (auto const& a : accounts)
+            env.fund (XRP (100000), a);
+
+        Batch batch (env);
+        for (std::size_t i = 0; i < txCount; ++i)
+        {
+            auto const& from = accounts[i % accounts.size ()];
+            auto const& to = accounts[(i * 7 + 1) % accounts.size ()];
+            if (from.id () != to.id ())
+                batch.add (from, pay (from, to, XRP (10)));
+        }
+        return std::move (batch.txs);
+    }
+
+    std::vector<Blob>
+    iouPayments (jtx::Env& env)
+    {
+        using namespace jtx;
+        Account const gw ("gateway");
+        auto const USD = gw["USD"];
+        auto const accounts = makeAccounts ("iou", 50);
+        env.fund (XRP (100000), gw);
+        for (auto const& a : accounts)
+        {
+            env.fund (XRP (100000), a);
+            env.trust (USD (1000000), a);
+            env (pay (gw, a, USD (10000)));
+        }
+
+        Batch batch (env);
+        for (std::size_t i = 0; i < txCount; ++i)
+        {
+            auto const& from = accounts[i % accounts.size ()];
+            auto const& to = accounts[(i * 7 + 1) % accounts.size ()];
+            if (from.id () != to.id ())
+                batch.add (from, pay (from, to, USD (1)));
+        }
+        return std::move (batch.txs);
+    }
+
+    // Takers each consume about two offers from a book of 1200
+    // offers spread over 60 qualities.
+    std::vector<Blob>
+    offerCrossing (jtx::Env& env)
+    {
+        using namespace jtx;
+        Account const gw ("gateway");
+        auto const USD = gw["USD"];
+        auto const makers = makeAccounts ("maker", 20);
+        auto const takers = makeAccounts ("taker", 50);
+        env.fund (XRP (100000), gw);
+        for (auto const& m : makers)
+        {
+            env.fund (XRP (100000), m);
+            env.trust (USD (1000000), m);
+            env (pay (gw, m, USD (100000)));
+            for (int k = 0; k < 60; ++k)
+                env (offer (m, XRP (100 + k), USD (100)));
+        }
+        for (auto const& t : takers)
+        {
+            env.fund (XRP (1000000), t);
+            env.trust (USD (1000000), t);
+        }
+
+        Batch batch (env);
+        for (std::size_t i = 0; i < txCount / 2; ++i)
+        {
+            auto const& taker = takers[i % takers.size ()];
+            batch.add (taker, offer (taker, USD (200), XRP (400)));
+        }
+        return std::move (batch.txs);
+    }
+
+    // Payments from XRP to USD which need the books of two
+    // gateways, with paths found once and reused.
+    std::vector<Blob>
+    multiPath (jtx::Env& env)
+    {
+        using namespace jtx;
+        Account const gw1 ("gateway1");
+        Account const gw2 ("gateway2");
+        Account const bob ("bob");
+        auto const makers = makeAccounts ("mm", 10);
+        auto const senders = makeAccounts ("sender", 20);
+        env.fund (XRP (100000), gw1, gw2, bob);
+        env.trust (gw1["USD"] (1000000), bob);
+        env.trust (gw2["USD"] (1000000), bob);
+        for (auto const& m : makers)
+        {
+            env.fund (XRP (100000), m);
+            env.trust (gw1["USD"] (1000000), m);
+            env.trust (gw2["USD"] (1000000), m);
+            env (pay (gw1, m, gw1["USD"] (10000)));
+            env (pay (gw2, m, gw2["USD"] (10000)));
+            for (int k = 0; k < 50; ++k)
+            {
+                env (offer (m, XRP (10 + k), gw1["USD"] (10)));
+                env (offer (m, XRP (10 + k), gw2["USD"] (10)));
+            }
+        }
+        for (auto const& s : senders)
+            env.fund (XRP (1000000), s);
+
+        auto const found = env.jt (pay (senders[0], bob,
+            any (bob["USD"] (15))), paths (XRP), sendmax (XRP (100)));
+
+        Batch batch (env);
+        for (std::size_t i = 0; i < txCount / 2; ++i)
+        {
+            auto const& from = senders[i % senders.size ()];
+            auto jv = pay (from, bob, any (bob["USD"] (15)));
+            jv[jss::Paths] = found.jv[jss::Paths];
+            batch.add (from, jv, sendmax (XRP (100)));
+        }
+        return std::move (batch.txs);
+    }
+
+    Totals
+    measure (jtx::Env& env, std::vector<Blob> const& txs)
+    {
+        Totals t;
+        for (auto const& blob : txs)
+        {
+            auto const a0 = allocations ();
+            auto const t0 = clock_type::now ();
+
+            SerialIter sit (Slice (blob.data (), blob.size ()));
+            STTx const stx (sit);
+            auto const t1 = clock_type::now ();
+
+            bool const signedOk = stx.checkSign ();
+            auto const t2 = clock_type::now ();
+
+            TransactionEngine engine (env.ledger, tx_enable_test);
+            auto const result = engine.applyTransaction (
+                stx, tapOPEN_LEDGER | tapNO_CHECK_SIGN);
+            auto const t3 = clock_type::now ();
+            t.allocations += allocations () - a0;
+
+            ++t.txs;
+            if (! signedOk || result.first != tesSUCCESS)
+                ++t.failed;
+            t.deserialize += t1 - t0;
+            t.checkSign += t2 - t1;
+            t.apply += t3 - t2;
+        }
+        return t;
+    }
+
+    void
+    report (std::string const& name, Totals const& t)
+    {
+        using namespace std::chrono;
+        auto const n = std::max<std::size_t> (t.txs, 1);
+        auto const us = [n](clock_type::duration d)
+        {
+            return duration_cast<duration<double, std::micro>> (d).count () / n;
+        };
+        auto const total = t.deserialize + t.checkSign + t.apply;
+        std::stringstream ss;
+        ss << std::left << std::setw (10) << name << std::right <<
+            std::setw (6) << t.txs <<
+            std::setw (6) << t.failed <<
+            std::fixed << std::setprecision (0) <<
+            std::setw (9) << t.txs / duration<double> (total).count () <<
+            std::setprecision (1) <<
+            std::setw (9) << us (t.deserialize) <<
+            std::setw (9) << us (t.checkSign) <<
+            std::setw (9) << us (t.apply);
+        if (TX_THROUGHPUT_COUNT_ALLOCATIONS)
+            ss << std::setw (9) << double (t.allocations) / n;
+        else
+            ss << std::setw (9) << "-";
+        log << ss.str ();
+    }
+
+    template <class Build>
+    void
+    run (std::string const& name, Build build)
+    {
+        jtx::Env env (*this);
+        auto const txs = (this->*build) (env);
+        auto const t = measure (env, txs);
+        report (name, t);
+        expect (t.failed == 0, name + ": transactions failed");
+    }
+
+    void
+    run () override
+    {
+        // Hack to silence logging
+        deprecatedLogs ().severity (
+            beast::Journal::Severity::kNone);
+
+        log << "workload     txs  fail     tx/s   deser us  sign us" <<
+            " apply us allocs/tx";
+        run ("xrp", &Throughput_test::xrpPayments);
+        run ("iou", &Throughput_test::iouPayments);
+        run ("offers", &Throughput_test::offerCrossing);
+        run ("multipath", &Throughput_test::multiPath);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Throughput,tx,ripple);
+
+} // test
+} // ripple
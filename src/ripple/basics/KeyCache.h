@@ -20,6 +20,7 @@
 #ifndef RIPPLE_BASICS_KEYCACHE_H_INCLUDED
 #define RIPPLE_BASICS_KEYCACHE_H_INCLUDED
 
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <beast/chrono/abstract_clock.h>
@@ -38,7 +39,7 @@ namespace ripple {
 // VFALCO TODO Figure out how to pass through the allocator
 template <
     class Key,
-    class Hash = hardened_hash <>,
+    class Hash = flat_hash <Key>,
     class KeyEqual = std::equal_to <Key>,
     //class Allocator = std::allocator <std::pair <Key const, Entry>>,
     class Mutex = std::mutex
@@ -80,7 +81,7 @@ private:
         clock_type::time_point last_access;
     };
 
-    using map_type = hardened_hash_map <key_type, Entry, Hash, KeyEqual>;
+    using map_type = flat_hash_map <key_type, Entry, Hash, KeyEqual>;
     using iterator = typename map_type::iterator;
     using lock_guard = std::lock_guard <Mutex>;
 
@@ -156,6 +157,16 @@ public:
         m_map.clear ();
     }
 
+    /** Return the number of entries and the hit and miss counts. */
+    void getStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) const
+    {
+        lock_guard lock (m_mutex);
+        size = m_map.size ();
+        hits = m_stats.hits;
+        misses = m_stats.misses;
+    }
+
     void setTargetSize (size_type s)
     {
         lock_guard lock (m_mutex);
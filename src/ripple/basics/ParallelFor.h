@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_PARALLELFOR_H_INCLUDED
+#define RIPPLE_BASICS_PARALLELFOR_H_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/** A persistent set of threads that help callers run independent loops.
+
+    A caller of parallel_for always works through the loop itself. Idle
+    threads of the pool join in, taking one index at a time, so a loop
+    never waits for a pool thread that is busy elsewhere and a pool
+    thread may itself call parallel_for.
+*/
+class ParallelPool
+{
+public:
+    /** Create a pool with the given number of helper threads. */
+    explicit
+    ParallelPool (std::size_t threads);
+
+    ~ParallelPool ();
+
+    ParallelPool (ParallelPool const&) = delete;
+    ParallelPool& operator= (ParallelPool const&) = delete;
+
+    /** The pool shared by the server.
+        It has one thread fewer than the machine has cores, so on a
+        single core every loop runs on its caller.
+    */
+    static
+    ParallelPool&
+    instance ();
+
+    std::size_t
+    size () const
+    {
+        return threads_.size ();
+    }
+
+    /** Call `f` for each index in [0, count).
+
+        Fewer than twice `grain` indexes are run on the calling thread
+        alone, and at most one helper is used for each `grain` indexes.
+
+        If `f` throws, the first exception is rethrown once every index
+        has been visited.
+    */
+    void
+    parallel_for (std::size_t count, std::size_t grain,
+        std::function <void (std::size_t)> const& f);
+
+private:
+    struct Loop;
+
+    void
+    run ();
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque <std::shared_ptr <Loop>> queue_;
+    bool stop_ = false;
+    std::vector <std::thread> threads_;
+};
+
+/** Call `f` for each index in [0, count) using the shared pool.
+    @see ParallelPool::parallel_for
+*/
+inline
+void
+parallel_for (std::size_t count, std::size_t grain,
+    std::function <void (std::size_t)> const& f)
+{
+    ParallelPool::instance ().parallel_for (count, grain, f);
+}
+
+} // ripple
+
+#endif
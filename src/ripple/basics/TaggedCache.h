@@ -20,6 +20,7 @@
 #ifndef RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 #define RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <beast/chrono/abstract_clock.h>
@@ -50,7 +51,7 @@ struct TaggedCacheLog;
 template <
     class Key,
     class T,
-    class Hash = hardened_hash <>,
+    class Hash = flat_hash <Key>,
     class KeyEqual = std::equal_to <Key>,
     //class Allocator = std::allocator <std::pair <Key const, Entry>>,
     class Mutex = std::recursive_mutex
@@ -106,17 +107,16 @@ public:
         lock_guard lock (m_mutex);
         m_target_size = s;
 
-        if (s > 0)
-            m_cache.rehash (static_cast<std::size_t> ((s + (s >> 2)) / m_cache.max_load_factor () + 1));
-
         if (m_journal.debug) m_journal.debug <<
             m_name << " target size set to " << s;
     }
 
+    /** Return the target age in seconds, as passed to setTargetAge. */
     clock_type::rep getTargetAge () const
     {
         lock_guard lock (m_mutex);
-        return m_target_age.count();
+        return std::chrono::duration_cast <std::chrono::seconds> (
+            m_target_age).count();
     }
 
     void setTargetAge (clock_type::rep s)
@@ -146,6 +146,16 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    /** Return the number of cached entries and the hit and miss counts. */
+    void getStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) const
+    {
+        lock_guard lock (m_mutex);
+        size = m_cache_count;
+        hits = m_hits;
+        misses = m_misses;
+    }
+
     void clearStats ()
     {
         lock_guard lock (m_mutex);
@@ -542,7 +552,7 @@ private:
         void touch (clock_type::time_point const& now) { last_access = now; }
     };
 
-    using cache_type = hardened_hash_map <key_type, Entry, Hash, KeyEqual>;
+    using cache_type = flat_hash_map <key_type, Entry, Hash, KeyEqual>;
     using cache_iterator = typename cache_type::iterator;
 
     beast::Journal m_journal;
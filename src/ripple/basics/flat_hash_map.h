@@ -0,0 +1,790 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_FLAT_HASH_MAP_H_INCLUDED
+#define RIPPLE_BASICS_FLAT_HASH_MAP_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/hardened_hash.h>
+#include <beast/utility/static_initializer.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ripple {
+
+/** Hashes base_uint keys by mixing their words with a per-process secret.
+
+    Most base_uint keys are SHA-512Half digests, which are already
+    uniformly distributed, so running them through xxhash as
+    hardened_hash does buys nothing. Every word still takes part, so
+    keys that are only partly random, like book directory indexes,
+    spread out too. The secret keeps peers from predicting which keys
+    collide.
+*/
+class hardened_uint_hash
+{
+private:
+    static
+    detail::seed_pair const&
+    init_seed_pair()
+    {
+        static beast::static_initializer <detail::seed_pair,
+            hardened_uint_hash> const p (
+                detail::make_seed_pair<>());
+        return *p;
+    }
+
+    static
+    std::uint64_t
+    mix (std::uint64_t h) noexcept
+    {
+        h *= 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+public:
+    using result_type = std::size_t;
+
+    template <std::size_t Bits, class Tag>
+    result_type
+    operator()(base_uint <Bits, Tag> const& key) const noexcept
+    {
+        auto const& seed = init_seed_pair();
+        auto const p = key.data();
+        std::uint64_t h = seed.first;
+
+        std::size_t i = 0;
+        for (; i + 8 <= key.bytes; i += 8)
+        {
+            std::uint64_t w;
+            std::memcpy (&w, p + i, sizeof(w));
+            h = mix (h ^ w);
+        }
+        if (i < key.bytes)
+        {
+            std::uint32_t w;
+            std::memcpy (&w, p + i, sizeof(w));
+            h = mix (h ^ w);
+        }
+
+        return static_cast<result_type> (mix (h ^ seed.second));
+    }
+};
+
+namespace detail {
+
+template <class Key>
+struct flat_hash_selector
+{
+    using type = hardened_hash<>;
+};
+
+template <std::size_t Bits, class Tag>
+struct flat_hash_selector <base_uint <Bits, Tag>>
+{
+    using type = hardened_uint_hash;
+};
+
+} // detail
+
+/** The default hash of a flat_hash_map.
+
+    hardened_uint_hash for base_uint keys, otherwise hardened_hash.
+*/
+template <class Key>
+using flat_hash = typename detail::flat_hash_selector<Key>::type;
+
+//------------------------------------------------------------------------------
+
+/** An unordered map that stores its elements in one flat array.
+
+    Lookups probe linearly from the slot the hash picks. A parallel
+    array holds one control byte per slot: zero if the slot is empty,
+    otherwise seven bits of the element's hash. Probing reads the
+    control bytes, which are contiguous, and compares keys only when
+    those bits match. Erasing shifts later elements of the run back,
+    so there are no tombstones and lookups stay short under churn.
+
+    Differences from std::unordered_map:
+
+    - Inserting may move elements, which invalidates every iterator,
+      pointer and reference into the map.
+
+    - Erasing invalidates iterators, pointers and references to the
+      erased element and to elements after it. The iterator returned by
+      erase(iterator) stays valid, so the usual erase loop works, and
+      visits every remaining element exactly once.
+
+    - Iterators obtained from find are valid for dereferencing and
+      erasing. Incrementing one visits the elements after it in
+      iteration order.
+
+    - The elements must be move constructible.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = flat_hash <Key>,
+    class KeyEqual = std::equal_to <Key>,
+    class Allocator = std::allocator <std::pair <Key const, T>>
+>
+class flat_hash_map
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair <Key const, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+
+private:
+    using alloc_traits = std::allocator_traits <Allocator>;
+    using slot_allocator =
+        typename alloc_traits::template rebind_alloc <value_type>;
+    using slot_traits = std::allocator_traits <slot_allocator>;
+    using ctrl_allocator =
+        typename alloc_traits::template rebind_alloc <std::uint8_t>;
+    using ctrl_traits = std::allocator_traits <ctrl_allocator>;
+
+    static size_type const npos = static_cast <size_type> (-1);
+
+    static size_type const minCapacity = 16;
+
+    template <bool IsConst>
+    class basic_iterator
+    {
+    private:
+        friend class flat_hash_map;
+
+        template <bool>
+        friend class basic_iterator;
+
+        using map_type = typename std::conditional <IsConst,
+            flat_hash_map const, flat_hash_map>::type;
+
+        map_type* map_ = nullptr;
+        size_type slot_ = npos;
+
+        // The slot iteration started from, npos if not yet known
+        size_type stop_ = npos;
+
+        basic_iterator (map_type* map, size_type slot, size_type stop)
+            : map_ (map)
+            , slot_ (slot)
+            , stop_ (stop)
+        {
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename flat_hash_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional <IsConst,
+            value_type const*, value_type*>::type;
+        using reference = typename std::conditional <IsConst,
+            value_type const&, value_type&>::type;
+
+        basic_iterator () = default;
+
+        template <bool OtherIsConst, class = typename std::enable_if <
+            IsConst && ! OtherIsConst>::type>
+        basic_iterator (basic_iterator <OtherIsConst> const& other)
+            : map_ (other.map_)
+            , slot_ (other.slot_)
+            , stop_ (other.stop_)
+        {
+        }
+
+        reference
+        operator* () const
+        {
+            return map_->slots_[slot_];
+        }
+
+        pointer
+        operator-> () const
+        {
+            return &map_->slots_[slot_];
+        }
+
+        basic_iterator&
+        operator++ ()
+        {
+            if (stop_ == npos)
+                stop_ = map_->start ();
+            slot_ = map_->next (slot_, stop_);
+            return *this;
+        }
+
+        basic_iterator
+        operator++ (int)
+        {
+            auto const result = *this;
+            ++*this;
+            return result;
+        }
+
+        template <bool OtherIsConst>
+        bool
+        operator== (basic_iterator <OtherIsConst> const& other) const
+        {
+            return slot_ == other.slot_;
+        }
+
+        template <bool OtherIsConst>
+        bool
+        operator!= (basic_iterator <OtherIsConst> const& other) const
+        {
+            return slot_ != other.slot_;
+        }
+    };
+
+public:
+    using iterator = basic_iterator <false>;
+    using const_iterator = basic_iterator <true>;
+
+    flat_hash_map () = default;
+
+    explicit
+    flat_hash_map (size_type n, Hash const& hash = Hash (),
+            KeyEqual const& equal = KeyEqual (),
+                Allocator const& alloc = Allocator ())
+        : hash_ (hash)
+        , equal_ (equal)
+        , slotAlloc_ (alloc)
+        , ctrlAlloc_ (alloc)
+    {
+        reserve (n);
+    }
+
+    flat_hash_map (flat_hash_map const& other)
+        : hash_ (other.hash_)
+        , equal_ (other.equal_)
+        , slotAlloc_ (slot_traits::select_on_container_copy_construction (
+            other.slotAlloc_))
+        , ctrlAlloc_ (ctrl_traits::select_on_container_copy_construction (
+            other.ctrlAlloc_))
+    {
+        reserve (other.size_);
+        for (auto const& v : other)
+            emplace (v);
+    }
+
+    flat_hash_map (flat_hash_map&& other) noexcept
+        : hash_ (std::move (other.hash_))
+        , equal_ (std::move (other.equal_))
+        , slotAlloc_ (std::move (other.slotAlloc_))
+        , ctrlAlloc_ (std::move (other.ctrlAlloc_))
+    {
+        steal (other);
+    }
+
+    flat_hash_map&
+    operator= (flat_hash_map const& other)
+    {
+        if (this != &other)
+        {
+            clear ();
+            reserve (other.size_);
+            for (auto const& v : other)
+                emplace (v);
+        }
+        return *this;
+    }
+
+    flat_hash_map&
+    operator= (flat_hash_map&& other)
+    {
+        if (this != &other)
+        {
+            release ();
+            steal (other);
+        }
+        return *this;
+    }
+
+    ~flat_hash_map ()
+    {
+        release ();
+    }
+
+    allocator_type
+    get_allocator () const
+    {
+        return allocator_type (slotAlloc_);
+    }
+
+    //--------------------------------------------------------------------------
+
+    iterator
+    begin ()
+    {
+        auto const stop = start ();
+        return iterator (this, first (stop), stop);
+    }
+
+    const_iterator
+    begin () const
+    {
+        auto const stop = start ();
+        return const_iterator (this, first (stop), stop);
+    }
+
+    const_iterator
+    cbegin () const
+    {
+        return begin ();
+    }
+
+    iterator
+    end ()
+    {
+        return iterator (this, npos, npos);
+    }
+
+    const_iterator
+    end () const
+    {
+        return const_iterator (this, npos, npos);
+    }
+
+    const_iterator
+    cend () const
+    {
+        return end ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool
+    empty () const
+    {
+        return size_ == 0;
+    }
+
+    size_type
+    size () const
+    {
+        return size_;
+    }
+
+    /** Returns the number of slots. */
+    size_type
+    capacity () const
+    {
+        return capacity_;
+    }
+
+    float
+    load_factor () const
+    {
+        return capacity_ == 0 ? 0.0f :
+            static_cast <float> (size_) / capacity_;
+    }
+
+    /** Make room for n elements without growing. */
+    void
+    reserve (size_type n)
+    {
+        size_type capacity = minCapacity;
+        while (capacity - capacity / 8 < n)
+            capacity *= 2;
+        if (capacity > capacity_)
+            rehash (capacity);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    clear ()
+    {
+        for (size_type i = 0; i < capacity_; ++i)
+        {
+            if (ctrl_[i] != 0)
+            {
+                slot_traits::destroy (slotAlloc_, slots_ + i);
+                ctrl_[i] = 0;
+            }
+        }
+        size_ = 0;
+    }
+
+    template <class... Args>
+    std::pair <iterator, bool>
+    emplace (Args&&... args)
+    {
+        value_type v (std::forward <Args> (args)...);
+        return insert_unique (v.first, [this, &v](value_type* p)
+            {
+                slot_traits::construct (slotAlloc_, p, std::move (v));
+            });
+    }
+
+    std::pair <iterator, bool>
+    insert (value_type const& v)
+    {
+        return insert_unique (v.first, [this, &v](value_type* p)
+            {
+                slot_traits::construct (slotAlloc_, p, v);
+            });
+    }
+
+    template <class P, class = typename std::enable_if <
+        std::is_constructible <value_type, P&&>::value>::type>
+    std::pair <iterator, bool>
+    insert (P&& p)
+    {
+        return emplace (std::forward <P> (p));
+    }
+
+    mapped_type&
+    operator[] (key_type const& key)
+    {
+        return insert_unique (key, [this, &key](value_type* p)
+            {
+                slot_traits::construct (slotAlloc_, p,
+                    std::piecewise_construct, std::forward_as_tuple (key),
+                        std::forward_as_tuple ());
+            }).first->second;
+    }
+
+    mapped_type&
+    at (key_type const& key)
+    {
+        auto const iter = find (key);
+        if (iter == end ())
+            throw std::out_of_range ("flat_hash_map::at");
+        return iter->second;
+    }
+
+    mapped_type const&
+    at (key_type const& key) const
+    {
+        auto const iter = find (key);
+        if (iter == end ())
+            throw std::out_of_range ("flat_hash_map::at");
+        return iter->second;
+    }
+
+    /** Erase an element.
+
+        @return An iterator to the element that followed it.
+    */
+    iterator
+    erase (const_iterator pos)
+    {
+        auto stop = pos.stop_;
+        if (stop == npos)
+            stop = start ();
+        auto const slot = pos.slot_;
+        assert (slot != npos && ctrl_[slot] != 0);
+
+        // A later element may have been shifted into the slot
+        if (erase_slot (slot))
+            return iterator (this, slot, stop);
+        return iterator (this, next (slot, stop), stop);
+    }
+
+    size_type
+    erase (key_type const& key)
+    {
+        auto const slot = lookup (key);
+        if (slot == npos)
+            return 0;
+        erase_slot (slot);
+        return 1;
+    }
+
+    void
+    swap (flat_hash_map& other)
+    {
+        using std::swap;
+        swap (hash_, other.hash_);
+        swap (equal_, other.equal_);
+        swap (slotAlloc_, other.slotAlloc_);
+        swap (ctrlAlloc_, other.ctrlAlloc_);
+        swap (slots_, other.slots_);
+        swap (ctrl_, other.ctrl_);
+        swap (capacity_, other.capacity_);
+        swap (size_, other.size_);
+    }
+
+    //--------------------------------------------------------------------------
+
+    iterator
+    find (key_type const& key)
+    {
+        auto const slot = lookup (key);
+        return iterator (this, slot, npos);
+    }
+
+    const_iterator
+    find (key_type const& key) const
+    {
+        auto const slot = lookup (key);
+        return const_iterator (this, slot, npos);
+    }
+
+    size_type
+    count (key_type const& key) const
+    {
+        return lookup (key) == npos ? 0 : 1;
+    }
+
+private:
+    static
+    std::uint8_t
+    tag (size_type h)
+    {
+        return static_cast <std::uint8_t> (0x80 | (h & 0x7f));
+    }
+
+    size_type
+    home (size_type h) const
+    {
+        return (h >> 7) & (capacity_ - 1);
+    }
+
+    // Returns the slot holding key, or npos
+    size_type
+    lookup (key_type const& key) const
+    {
+        if (size_ == 0)
+            return npos;
+
+        auto const h = hash_ (key);
+        auto const t = tag (h);
+        auto const mask = capacity_ - 1;
+
+        for (auto i = home (h); ctrl_[i] != 0; i = (i + 1) & mask)
+        {
+            if (ctrl_[i] == t && equal_ (slots_[i].first, key))
+                return i;
+        }
+
+        return npos;
+    }
+
+    // Constructs the element with construct if key is not present
+    template <class Construct>
+    std::pair <iterator, bool>
+    insert_unique (key_type const& key, Construct const& construct)
+    {
+        if (capacity_ == 0)
+            rehash (minCapacity);
+
+        auto h = hash_ (key);
+        auto const mask = capacity_ - 1;
+        auto i = home (h);
+
+        for (; ctrl_[i] != 0; i = (i + 1) & mask)
+        {
+            if (ctrl_[i] == tag (h) && equal_ (slots_[i].first, key))
+                return std::make_pair (iterator (this, i, npos), false);
+        }
+
+        // Grow once more than 7/8 of the slots are in use
+        if (size_ + 1 > capacity_ - capacity_ / 8)
+        {
+            rehash (capacity_ * 2);
+            i = home (h);
+            while (ctrl_[i] != 0)
+                i = (i + 1) & (capacity_ - 1);
+        }
+
+        construct (slots_ + i);
+        ctrl_[i] = tag (h);
+        ++size_;
+        return std::make_pair (iterator (this, i, npos), true);
+    }
+
+    // Removes the element in slot, shifting back the elements after it
+    // that were displaced past it. Returns `true` if slot is occupied
+    // again afterwards.
+    bool
+    erase_slot (size_type slot)
+    {
+        auto const mask = capacity_ - 1;
+        auto hole = slot;
+
+        slot_traits::destroy (slotAlloc_, slots_ + hole);
+        ctrl_[hole] = 0;
+        --size_;
+
+        for (auto i = (hole + 1) & mask; ctrl_[i] != 0; i = (i + 1) & mask)
+        {
+            auto const h = home (hash_ (slots_[i].first));
+            if (((i - h) & mask) >= ((i - hole) & mask))
+            {
+                slot_traits::construct (slotAlloc_, slots_ + hole,
+                    std::move (slots_[i]));
+                ctrl_[hole] = ctrl_[i];
+                slot_traits::destroy (slotAlloc_, slots_ + i);
+                ctrl_[i] = 0;
+                hole = i;
+            }
+        }
+
+        return hole != slot;
+    }
+
+    // Iteration starts just after an empty slot, so that no run of
+    // elements wraps around the end of the iteration. Erasing only
+    // moves elements backwards within their run, so while iterating it
+    // never moves an element that was already visited.
+    size_type
+    start () const
+    {
+        if (size_ == 0)
+            return 0;
+        size_type i = 0;
+        while (ctrl_[i] != 0)
+            ++i;
+        return (i + 1) & (capacity_ - 1);
+    }
+
+    size_type
+    first (size_type stop) const
+    {
+        if (size_ == 0)
+            return npos;
+        if (ctrl_[stop] != 0)
+            return stop;
+        return next (stop, stop);
+    }
+
+    // Returns the next occupied slot after slot, or npos at stop
+    size_type
+    next (size_type slot, size_type stop) const
+    {
+        auto const mask = capacity_ - 1;
+        for (auto i = (slot + 1) & mask; i != stop; i = (i + 1) & mask)
+        {
+            if (ctrl_[i] != 0)
+                return i;
+        }
+        return npos;
+    }
+
+    void
+    rehash (size_type capacity)
+    {
+        auto const slots = slot_traits::allocate (slotAlloc_, capacity);
+        std::uint8_t* ctrl;
+        try
+        {
+            ctrl = ctrl_traits::allocate (ctrlAlloc_, capacity);
+        }
+        catch (...)
+        {
+            slot_traits::deallocate (slotAlloc_, slots, capacity);
+            throw;
+        }
+        std::fill (ctrl, ctrl + capacity, std::uint8_t (0));
+
+        auto const oldSlots = slots_;
+        auto const oldCtrl = ctrl_;
+        auto const oldCapacity = capacity_;
+
+        slots_ = slots;
+        ctrl_ = ctrl;
+        capacity_ = capacity;
+
+        auto const mask = capacity_ - 1;
+        for (size_type j = 0; j < oldCapacity; ++j)
+        {
+            if (oldCtrl[j] == 0)
+                continue;
+            auto i = home (hash_ (oldSlots[j].first));
+            while (ctrl_[i] != 0)
+                i = (i + 1) & mask;
+            slot_traits::construct (slotAlloc_, slots_ + i,
+                std::move (oldSlots[j]));
+            ctrl_[i] = oldCtrl[j];
+            slot_traits::destroy (slotAlloc_, oldSlots + j);
+        }
+
+        if (oldCapacity != 0)
+        {
+            slot_traits::deallocate (slotAlloc_, oldSlots, oldCapacity);
+            ctrl_traits::deallocate (ctrlAlloc_, oldCtrl, oldCapacity);
+        }
+    }
+
+    void
+    release ()
+    {
+        if (capacity_ == 0)
+            return;
+        clear ();
+        slot_traits::deallocate (slotAlloc_, slots_, capacity_);
+        ctrl_traits::deallocate (ctrlAlloc_, ctrl_, capacity_);
+        slots_ = nullptr;
+        ctrl_ = nullptr;
+        capacity_ = 0;
+    }
+
+    void
+    steal (flat_hash_map& other)
+    {
+        slots_ = other.slots_;
+        ctrl_ = other.ctrl_;
+        capacity_ = other.capacity_;
+        size_ = other.size_;
+        other.slots_ = nullptr;
+        other.ctrl_ = nullptr;
+        other.capacity_ = 0;
+        other.size_ = 0;
+    }
+
+    Hash hash_;
+    KeyEqual equal_;
+    slot_allocator slotAlloc_;
+    ctrl_allocator ctrlAlloc_;
+    value_type* slots_ = nullptr;
+    std::uint8_t* ctrl_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+};
+
+template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+void
+swap (flat_hash_map <Key, T, Hash, KeyEqual, Allocator>& lhs,
+    flat_hash_map <Key, T, Hash, KeyEqual, Allocator>& rhs)
+{
+    lhs.swap (rhs);
+}
+
+} // ripple
+
+#endif
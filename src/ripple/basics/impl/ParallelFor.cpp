@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/ParallelFor.h>
+#include <ripple/basics/ThreadName.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace ripple {
+
+struct ParallelPool::Loop
+{
+    Loop (std::size_t count_, std::function <void (std::size_t)> const& f_)
+        : count (count_)
+        , f (f_)
+        , next (0)
+    {
+    }
+
+    // Work through indexes until none are left
+    void
+    run ()
+    {
+        std::size_t finished = 0;
+
+        for (std::size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                f (i);
+            }
+            catch (...)
+            {
+                std::lock_guard <std::mutex> lock (mutex);
+                if (! error)
+                    error = std::current_exception ();
+            }
+            ++finished;
+        }
+
+        if (finished != 0)
+        {
+            std::lock_guard <std::mutex> lock (mutex);
+            done += finished;
+            if (done == count)
+                cond.notify_all ();
+        }
+    }
+
+    std::size_t const count;
+
+    // Only called while indexes remain, which the caller waits for
+    std::function <void (std::size_t)> const& f;
+
+    std::atomic <std::size_t> next;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t done = 0;
+    std::exception_ptr error;
+};
+
+ParallelPool::ParallelPool (std::size_t threads)
+{
+    threads_.reserve (threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        threads_.emplace_back (&ParallelPool::run, this);
+}
+
+ParallelPool::~ParallelPool ()
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    cond_.notify_all ();
+
+    for (auto& thread : threads_)
+        thread.join ();
+}
+
+ParallelPool&
+ParallelPool::instance ()
+{
+    static ParallelPool pool (std::max (1u,
+        std::thread::hardware_concurrency ()) - 1);
+    return pool;
+}
+
+void
+ParallelPool::parallel_for (std::size_t count, std::size_t grain,
+    std::function <void (std::size_t)> const& f)
+{
+    grain = std::max <std::size_t> (grain, 1);
+
+    auto const loop = std::make_shared <Loop> (count, f);
+
+    std::size_t const helpers = count < 2 * grain ? 0 :
+        std::min (threads_.size (), count / grain - 1);
+
+    if (helpers != 0)
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            for (std::size_t i = 0; i < helpers; ++i)
+                queue_.push_back (loop);
+        }
+
+        if (helpers == 1)
+            cond_.notify_one ();
+        else
+            cond_.notify_all ();
+    }
+
+    loop->run ();
+
+    {
+        std::unique_lock <std::mutex> lock (loop->mutex);
+        while (loop->done != count)
+            loop->cond.wait (lock);
+    }
+
+    // Helpers that have not started find nothing left and drop the loop
+    if (loop->error)
+        std::rethrow_exception (loop->error);
+}
+
+void
+ParallelPool::run ()
+{
+    setCallingThreadName ("parallel");
+
+    for (;;)
+    {
+        std::shared_ptr <Loop> loop;
+
+        {
+            std::unique_lock <std::mutex> lock (mutex_);
+            while (! stop_ && queue_.empty ())
+                cond_.wait (lock);
+
+            if (stop_)
+                return;
+
+            loop = std::move (queue_.front ());
+            queue_.pop_front ();
+        }
+
+        loop->run ();
+    }
+}
+
+} // ripple
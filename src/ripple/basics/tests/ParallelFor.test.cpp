@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/ParallelFor.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace ripple {
+
+class ParallelFor_test : public beast::unit_test::suite
+{
+public:
+    // Every index is visited exactly once
+    void testVisits (ParallelPool& pool)
+    {
+        for (std::size_t count : { 0, 1, 63, 64, 1000, 10000 })
+        {
+            std::vector <std::atomic <int>> visits (count);
+            for (auto& v : visits)
+                v = 0;
+
+            pool.parallel_for (count, 32,
+                [&](std::size_t i)
+                {
+                    ++visits[i];
+                });
+
+            bool once = true;
+            for (auto const& v : visits)
+                once = once && (v == 1);
+            expect (once, "Each index should be visited once");
+        }
+    }
+
+    void testException (ParallelPool& pool)
+    {
+        std::atomic <std::size_t> visited (0);
+
+        try
+        {
+            pool.parallel_for (1000, 32,
+                [&](std::size_t i)
+                {
+                    ++visited;
+                    if (i % 100 == 7)
+                        throw std::runtime_error ("fail");
+                });
+            fail ("Should throw");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass ();
+        }
+
+        expect (visited == 1000, "Should visit every index");
+    }
+
+    void testNested (ParallelPool& pool)
+    {
+        std::atomic <std::size_t> visited (0);
+
+        pool.parallel_for (8, 1,
+            [&](std::size_t)
+            {
+                pool.parallel_for (100, 10,
+                    [&](std::size_t)
+                    {
+                        ++visited;
+                    });
+            });
+
+        expect (visited == 800, "Should visit every inner index");
+    }
+
+    void run ()
+    {
+        for (std::size_t threads : { 0, 1, 3 })
+        {
+            testcase ("threads " + std::to_string (threads));
+
+            ParallelPool pool (threads);
+            expect (pool.size () == threads);
+
+            testVisits (pool);
+            testException (pool);
+            testNested (pool);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ParallelFor,basics,ripple);
+
+} // ripple
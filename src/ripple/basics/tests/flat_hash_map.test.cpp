@@ -0,0 +1,409 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/flat_hash_map.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <beast/http/rfc2616.h>
+#include <beast/unit_test/suite.h>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class flat_hash_map_test : public beast::unit_test::suite
+{
+public:
+    // Sends every key to one of the last few slots, so that runs are
+    // long and wrap around the end of the table.
+    struct bad_hash
+    {
+        std::size_t
+        operator() (int key) const
+        {
+            return static_cast <std::size_t> (-1) - ((key % 3) << 7);
+        }
+    };
+
+    using int_map = flat_hash_map <int, int, bad_hash>;
+
+    static
+    uint256
+    randomKey (std::mt19937_64& gen)
+    {
+        uint256 key;
+        for (auto p = key.begin (); p != key.end (); p += 8)
+        {
+            auto const w = gen ();
+            std::memcpy (p, &w, 8);
+        }
+        return key;
+    }
+
+    void
+    testBasics ()
+    {
+        testcase ("basics");
+
+        flat_hash_map <std::string, int> m;
+        expect (m.empty () && m.begin () == m.end ());
+        expect (m.find ("one") == m.end ());
+
+        expect (m.emplace ("one", 1).second);
+        expect (! m.emplace ("one", 2).second);
+        expect (m.insert (std::make_pair (std::string ("two"), 2)).second);
+        m["three"] = 3;
+        expect (m.size () == 3);
+        expect (m.at ("one") == 1);
+        expect (m["two"] == 2);
+        expect (m.count ("three") == 1);
+        expect (m.count ("four") == 0);
+
+        expect (m.erase ("two") == 1);
+        expect (m.erase ("two") == 0);
+        expect (m.size () == 2);
+
+        auto iter = m.find ("one");
+        expect (iter != m.end () && iter->second == 1);
+        m.erase (iter);
+        expect (m.find ("one") == m.end ());
+
+        auto copy = m;
+        auto moved = std::move (m);
+        expect (copy.size () == 1 && moved.size () == 1);
+        expect (copy["three"] == 3 && moved["three"] == 3);
+
+        bool threw = false;
+        try
+        {
+            moved.at ("one");
+        }
+        catch (std::out_of_range const&)
+        {
+            threw = true;
+        }
+        expect (threw);
+
+        moved.clear ();
+        expect (moved.empty () && moved.begin () == moved.end ());
+    }
+
+    // Churn against std::map with keys that collide a lot
+    void
+    testChurn ()
+    {
+        testcase ("churn");
+
+        std::mt19937_64 gen (42);
+        int_map m;
+        std::map <int, int> reference;
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            int const key = static_cast <int> (gen () % 300);
+            if (gen () % 3 == 0)
+            {
+                expect (m.erase (key) == reference.erase (key));
+            }
+            else
+            {
+                auto const result = m.emplace (key, i);
+                expect (result.second == reference.emplace (key, i).second);
+            }
+        }
+
+        expect (m.size () == reference.size ());
+        for (auto const& v : reference)
+        {
+            auto const iter = m.find (v.first);
+            expect (iter != m.end () && iter->second == v.second);
+        }
+
+        std::map <int, int> seen;
+        for (auto const& v : m)
+            seen.insert (v);
+        expect (seen == reference);
+    }
+
+    // Erasing while iterating visits every element exactly once
+    void
+    testEraseLoop ()
+    {
+        testcase ("erase loop");
+
+        int_map m;
+        m.reserve (64);
+        for (int i = 0; i < 40; ++i)
+            m.emplace (i, 0);
+
+        std::vector <int> visits (40, 0);
+        for (auto iter = m.begin (); iter != m.end ();)
+        {
+            ++visits[iter->first];
+            if (iter->first % 2 == 0)
+                iter = m.erase (iter);
+            else
+                ++iter;
+        }
+
+        bool once = true;
+        for (auto const v : visits)
+            once = once && v == 1;
+        expect (once);
+        expect (m.size () == 20);
+        for (int i = 0; i < 40; ++i)
+            expect (m.count (i) == (i % 2 == 0 ? 0 : 1));
+    }
+
+    void
+    testUintKeys ()
+    {
+        testcase ("uint256 keys");
+
+        std::mt19937_64 gen (7);
+        flat_hash_map <uint256, std::size_t> m;
+        std::vector <uint256> keys;
+        for (std::size_t i = 0; i < 10000; ++i)
+        {
+            keys.push_back (randomKey (gen));
+            m.emplace (keys.back (), i);
+        }
+        expect (m.size () == keys.size ());
+        expect (m.load_factor () <= 0.875f);
+
+        bool found = true;
+        for (std::size_t i = 0; i < keys.size (); ++i)
+        {
+            auto const iter = m.find (keys[i]);
+            found = found && iter != m.end () && iter->second == i;
+        }
+        expect (found);
+        expect (m.find (randomKey (gen)) == m.end ());
+
+        // Keys that differ only in their last word
+        hardened_uint_hash hash;
+        uint256 a;
+        uint256 b;
+        a.zero ();
+        b.zero ();
+        *(b.end () - 1) = 1;
+        expect (hash (a) != hash (b));
+        expect (hash (a) == hash (uint256 (a)));
+
+        uint160 c;
+        c.zero ();
+        uint160 d (c);
+        *(d.end () - 1) = 1;
+        expect (hash (c) != hash (d));
+    }
+
+    void
+    run () override
+    {
+        testBasics ();
+        testChurn ();
+        testEraseLoop ();
+        testUintKeys ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(flat_hash_map,basics,ripple);
+
+//------------------------------------------------------------------------------
+
+// Compares flat_hash_map with hardened_hash_map for uint256 keys:
+// insert, lookup of present and absent keys, erase, and the memory
+// each entry takes, counted through the allocator. The mapped sizes
+// match a KeyCache entry (8) and a TaggedCache entry (40).
+//
+// Arguments: n=<entries>
+//
+class flat_hash_map_timing_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    template <class T>
+    class counting_allocator
+    {
+    public:
+        using value_type = T;
+
+        std::size_t* bytes;
+
+        explicit counting_allocator (std::size_t* bytes_)
+            : bytes (bytes_)
+        {
+        }
+
+        template <class U>
+        counting_allocator (counting_allocator <U> const& other)
+            : bytes (other.bytes)
+        {
+        }
+
+        T*
+        allocate (std::size_t n)
+        {
+            *bytes += n * sizeof (T);
+            return std::allocator <T> ().allocate (n);
+        }
+
+        void
+        deallocate (T* p, std::size_t n)
+        {
+            *bytes -= n * sizeof (T);
+            std::allocator <T> ().deallocate (p, n);
+        }
+
+        template <class U>
+        bool
+        operator== (counting_allocator <U> const& other) const
+        {
+            return bytes == other.bytes;
+        }
+
+        template <class U>
+        bool
+        operator!= (counting_allocator <U> const& other) const
+        {
+            return bytes != other.bytes;
+        }
+    };
+
+    template <std::size_t Size>
+    using value = std::array <char, Size>;
+
+    template <class Map>
+    void
+    time (std::string const& name, Map& m, std::size_t const& bytes,
+        std::vector <uint256> const& keys, std::vector <uint256> const& absent)
+    {
+        using namespace std::chrono;
+        typename Map::mapped_type v {};
+        std::size_t found = 0;
+
+        auto start = clock_type::now ();
+        for (auto const& key : keys)
+            m.emplace (key, v);
+        auto const insert = clock_type::now () - start;
+        auto const memory = bytes;
+
+        start = clock_type::now ();
+        for (auto const& key : keys)
+            found += m.count (key);
+        auto const hit = clock_type::now () - start;
+
+        start = clock_type::now ();
+        for (auto const& key : absent)
+            found += m.count (key);
+        auto const miss = clock_type::now () - start;
+
+        start = clock_type::now ();
+        for (auto const& key : keys)
+            m.erase (key);
+        auto const erase = clock_type::now () - start;
+
+        expect (found == keys.size () && m.empty ());
+
+        auto const ns = [&keys](clock_type::duration d)
+        {
+            return double (duration_cast <nanoseconds> (d).count ()) /
+                keys.size ();
+        };
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision (1) <<
+            std::setw (24) << std::left << name << std::right <<
+            " insert " << std::setw (6) << ns (insert) << " ns" <<
+            " hit " << std::setw (6) << ns (hit) << " ns" <<
+            " miss " << std::setw (6) << ns (miss) << " ns" <<
+            " erase " << std::setw (6) << ns (erase) << " ns" <<
+            " memory " << std::setw (6) <<
+                double (memory) / keys.size () << " bytes/entry";
+        log << ss.str ();
+    }
+
+    template <std::size_t Size>
+    void
+    compare (std::vector <uint256> const& keys,
+        std::vector <uint256> const& absent)
+    {
+        using V = value <Size>;
+        using A = counting_allocator <std::pair <uint256 const, V>>;
+
+        {
+            std::size_t bytes = 0;
+            hardened_hash_map <uint256, V, hardened_hash <>,
+                std::equal_to <uint256>, A> m (0, hardened_hash <> (),
+                    std::equal_to <uint256> (), A (&bytes));
+            time ("hardened_hash_map<" + std::to_string (Size) + ">",
+                m, bytes, keys, absent);
+        }
+        {
+            std::size_t bytes = 0;
+            flat_hash_map <uint256, V, hardened_uint_hash,
+                std::equal_to <uint256>, A> m (0, hardened_uint_hash (),
+                    std::equal_to <uint256> (), A (&bytes));
+            time ("flat_hash_map<" + std::to_string (Size) + ">",
+                m, bytes, keys, absent);
+        }
+    }
+
+    void
+    run () override
+    {
+        std::size_t n = 1000000;
+        for (auto const& kv : beast::rfc2616::split (
+            arg ().begin (), arg ().end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                continue;
+            if (kv.substr (0, pos) == "n")
+                n = std::stoul (kv.substr (pos + 1));
+        }
+
+        std::mt19937_64 gen (1);
+        std::vector <uint256> keys;
+        std::vector <uint256> absent;
+        keys.reserve (n);
+        absent.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            keys.push_back (flat_hash_map_test::randomKey (gen));
+            absent.push_back (flat_hash_map_test::randomKey (gen));
+        }
+
+        log << n << " uint256 keys";
+        compare <8> (keys, absent);
+        compare <40> (keys, absent);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(flat_hash_map_timing,basics,ripple);
+
+} // ripple
@@ -244,6 +244,7 @@ public:
     // Node storage configuration
     std::uint32_t                      LEDGER_HISTORY;
     std::uint32_t                      FETCH_DEPTH;
+    std::uint32_t                      VALIDATION_HISTORY;     // Validations rows kept, 0 for none.
     int                         NODE_SIZE;
 
     // Client behavior
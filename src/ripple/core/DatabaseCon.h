@@ -82,6 +82,15 @@ public:
         Config::StartUpType startUp = Config::NORMAL;
         bool standAlone = false;
         boost::filesystem::path dataDir;
+
+        /** Returns `true` if the databases are temporary. */
+        bool useTempFiles () const
+        {
+            return standAlone &&
+                startUp != Config::LOAD &&
+                startUp != Config::LOAD_FILE &&
+                startUp != Config::REPLAY;
+        }
     };
 
     DatabaseCon (Setup const& setup,
@@ -105,8 +105,13 @@ public:
     using CancelCallback = std::function <bool(void)>;
 
     // VFALCO TODO try to remove the dependency on LoadMonitor.
+    /** Create a job.
+
+        @param name A label for the job. It is not copied, and must
+                    outlive the job (typically a string literal).
+    */
     Job (JobType type,
-         std::string const& name,
+         char const* name,
          std::uint64_t index,
          LoadMonitor& lm,
          std::function <void (Job&)> const& job,
@@ -126,7 +131,8 @@ public:
 
     void doJob ();
 
-    void rename (std::string const& n);
+    /** Relabel the load measurement of a running job. */
+    void rename (char const* n);
 
     // These comparison operators make the jobs sort in priority order
     // in the job set
@@ -141,7 +147,6 @@ private:
     std::uint64_t               mJobIndex;
     std::function <void (Job&)> mJob;
     LoadEvent::pointer          m_loadEvent;
-    std::string                 mName;
     clock_type::time_point m_queue_time;
 };
 
@@ -43,8 +43,13 @@ public:
     //
     //        TODO Replace with std::function
     //
+    /** Add a job to the queue.
+
+        @param name A label for the job. It is not copied, and must
+                    outlive the job (typically a string literal).
+    */
     virtual void addJob (JobType type,
-        std::string const& name, boost::function <void (Job&)> const& job) = 0;
+        char const* name, boost::function <void (Job&)> const& job) = 0;
 
     // Jobs waiting at this priority
     virtual int getJobCount (JobType t) const = 0;
@@ -63,13 +68,13 @@ public:
     //             since they create the object.
     //
     virtual LoadEvent::pointer getLoadEvent (
-        JobType t, std::string const& name) = 0;
+        JobType t, char const* name) = 0;
 
     // VFALCO TODO Why do we need two versions, one which returns a shared
     //             pointer and the other which returns an autoptr?
     //
     virtual LoadEvent::autoptr getLoadEventAP (
-        JobType t, std::string const& name) = 0;
+        JobType t, char const* name) = 0;
 
     // Add multiple load events
     virtual void addLoadEvents (
@@ -77,9 +82,8 @@ public:
 
     virtual bool isOverloaded () = 0;
 
-    /** Get the Job corresponding to a thread.  If no thread, use the current
-        thread. */
-    virtual Job* getJobForThread (std::thread::id const& id = {}) const = 0;
+    /** Get the Job running on the calling thread, or nullptr if none. */
+    virtual Job* getJobForThread () const = 0;
 
     virtual Json::Value getJson (int c = 0) = 0;
 };
@@ -21,6 +21,8 @@
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
 #include <ripple/core/JobTypeInfo.h>
+#include <deque>
+#include <mutex>
 
 namespace ripple
 {
@@ -37,6 +39,12 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
+    /* Guards the queue and the counts below */
+    mutable std::mutex mutex;
+
+    /* Jobs of this type waiting to run, oldest first */
+    std::deque <Job> queue;
+
     /* The number of jobs waiting */
     int waiting;
 
@@ -73,7 +81,7 @@ public:
     JobTypeData (JobTypeData const& other) = delete;
     JobTypeData& operator= (JobTypeData const& other) = delete;
 
-    std::string name () const
+    std::string const& name () const
     {
         return info.name ();
     }
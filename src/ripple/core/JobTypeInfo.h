@@ -65,7 +65,7 @@ public:
         return m_type;
     }
 
-    std::string name () const
+    std::string const& name () const
     {
         return m_name;
     }
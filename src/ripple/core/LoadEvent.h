@@ -46,19 +46,22 @@ public:
 
 public:
     // VFALCO TODO remove the dependency on LoadMonitor. Is that possible?
+    //
+    // The name is not copied, so it must outlive the event. Every job
+    // makes one, so a string literal is expected.
     LoadEvent (LoadMonitor& monitor,
-               std::string const& name,
+               char const* name,
                bool shouldStart);
 
     ~LoadEvent ();
 
-    std::string const& name () const;
+    char const* name () const;
     double getSecondsWaiting() const;
     double getSecondsRunning() const;
     double getSecondsTotal() const;
 
     // VFALCO TODO rename this to setName () or setLabel ()
-    void reName (std::string const& name);
+    void reName (char const* name);
 
     // Start the measurement. The constructor calls this automatically if
     // shouldStart is true. If the operation is aborted, start() can be
@@ -74,7 +77,7 @@ public:
 private:
     LoadMonitor& m_loadMonitor;
     bool m_isRunning;
-    std::string m_name;
+    char const* m_name;
     // VFALCO TODO Replace these with chrono
     beast::RelativeTime m_timeStopped;
     beast::RelativeTime m_timeStarted;
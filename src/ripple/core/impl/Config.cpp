@@ -32,6 +32,7 @@
 #include <boost/regex.hpp>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 #ifndef DUMP_CONFIG
 #define DUMP_CONFIG 0
@@ -217,6 +218,7 @@ Config::Config ()
 
     LEDGER_HISTORY          = 256;
     FETCH_DEPTH             = 1000000000;
+    VALIDATION_HISTORY      = std::numeric_limits <std::uint32_t>::max ();
 
     // An explanation of these magical values would be nice.
     PATH_SEARCH_OLD         = 7;
@@ -519,6 +521,18 @@ void Config::loadFromString (std::string const& fileContents)
             LEDGER_HISTORY = beast::lexicalCastThrow <std::uint32_t> (strTemp);
     }
 
+    if (getSingleSection (secConfig, SECTION_VALIDATION_HISTORY, strTemp))
+    {
+        boost::to_lower (strTemp);
+
+        if (strTemp == "full")
+            VALIDATION_HISTORY = std::numeric_limits <std::uint32_t>::max ();
+        else if (strTemp == "none")
+            VALIDATION_HISTORY = 0;
+        else
+            VALIDATION_HISTORY = beast::lexicalCastThrow <std::uint32_t> (strTemp);
+    }
+
     if (getSingleSection (secConfig, SECTION_FETCH_DEPTH, strTemp))
     {
         boost::to_lower (strTemp);
@@ -31,12 +31,7 @@ DatabaseCon::DatabaseCon (
     const char* initStrings[],
     int initCount)
 {
-    auto const useTempFiles  // Use temporary files or regular DB files?
-        = setup.standAlone &&
-          setup.startUp != Config::LOAD &&
-          setup.startUp != Config::LOAD_FILE &&
-          setup.startUp != Config::REPLAY;
-    boost::filesystem::path pPath = useTempFiles
+    boost::filesystem::path pPath = setup.useTempFiles ()
         ? "" : (setup.dataDir / strName);
 
     open (session_, "sqlite", pPath.string());
@@ -35,7 +35,7 @@ Job::Job (JobType type, std::uint64_t index)
 }
 
 Job::Job (JobType type,
-          std::string const& name,
+          char const* name,
           std::uint64_t index,
           LoadMonitor& lm,
           std::function <void (Job&)> const& job,
@@ -44,7 +44,6 @@ Job::Job (JobType type,
     , mType (type)
     , mJobIndex (index)
     , mJob (job)
-    , mName (name)
     , m_queue_time (clock_type::now ())
 {
     m_loadEvent = std::make_shared <LoadEvent> (std::ref (lm), name, false);
@@ -76,14 +75,14 @@ bool Job::shouldCancel () const
 void Job::doJob ()
 {
     m_loadEvent->start ();
-    m_loadEvent->reName (mName);
 
     mJob (*this);
 }
 
-void Job::rename (std::string const& newName)
+void Job::rename (char const* newName)
 {
-    mName = newName;
+    if (m_loadEvent)
+        m_loadEvent->reName (newName);
 }
 
 bool Job::operator> (const Job& j) const
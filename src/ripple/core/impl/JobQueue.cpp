@@ -25,34 +25,49 @@
 #include <beast/cxx14/memory.h>
 #include <beast/chrono/chrono_util.h>
 #include <beast/module/core/thread/Workers.h>
+#include <boost/thread/tss.hpp>
+#include <atomic>
 #include <chrono>
 #include <mutex>
-#include <set>
 #include <thread>
+#include <vector>
 
 namespace ripple {
 
+/*  Each dispatchable job type has its own queue and counters, guarded by
+    the mutex in its JobTypeData. Adding, counting and running jobs of one
+    type never contends with another type. A worker looks for the highest
+    priority type that has a waiting job and is below its running limit,
+    so a worker woken for one type may take ("steal") a job of another.
+*/
 class JobQueueImp
     : public JobQueue
     , private beast::Workers::Callback
 {
 public:
-    using JobSet = std::set <Job>;
     using JobDataMap = std::map <JobType, JobTypeData>;
     using ScopedLock = std::lock_guard <std::mutex>;
-    using ThreadIdMap = std::map <std::thread::id, Job*>;
 
     beast::Journal m_journal;
+
+    // Only used to serialize the stop checks
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    JobSet m_jobSet;
+
+    std::atomic <std::uint64_t> m_lastJob;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
-    ThreadIdMap m_threadIds;
+    // The dispatchable job types, highest priority first
+    std::vector <JobTypeData*> m_priority;
+
+    // The total number of waiting jobs
+    std::atomic <int> m_jobCount;
+
+    // The job being run by each worker thread
+    boost::thread_specific_ptr <Job> m_threadJob;
 
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic <int> m_processCount;
 
     beast::Workers m_workers;
     Job::CancelCallback m_cancelCallback;
@@ -70,6 +85,10 @@ public:
         return types;
     }
 
+    static void noCleanup (Job*)
+    {
+    }
+
     //--------------------------------------------------------------------------
     JobQueueImp (beast::insight::Collector::ptr const& collector,
         Stoppable& parent, beast::Journal journal)
@@ -77,6 +96,8 @@ public:
         , m_journal (journal)
         , m_lastJob (0)
         , m_invalidJobData (getJobTypes ().getInvalid (), collector)
+        , m_jobCount (0)
+        , m_threadJob (&JobQueueImp::noCleanup)
         , m_processCount (0)
         , m_workers (*this, "JobQueue", 0)
         , m_cancelCallback (std::bind (&Stoppable::isStopping, this))
@@ -86,20 +107,23 @@ public:
             &JobQueueImp::collect, this));
         job_count = m_collector->make_gauge ("job_count");
 
+        for (auto const& x : getJobTypes ())
         {
-            ScopedLock lock (m_mutex);
+            JobTypeInfo const& jt = x.second;
+
+            // And create dynamic information for all jobs
+            auto const result (m_jobData.emplace (std::piecewise_construct,
+                std::forward_as_tuple (jt.type ()),
+                std::forward_as_tuple (jt, m_collector)));
+            assert (result.second == true);
+            (void) result.second;
+        }
 
-            for (auto const& x : getJobTypes ())
-            {
-                JobTypeInfo const& jt = x.second;
-
-                // And create dynamic information for all jobs
-                auto const result (m_jobData.emplace (std::piecewise_construct,
-                    std::forward_as_tuple (jt.type ()),
-                    std::forward_as_tuple (jt, m_collector)));
-                assert (result.second == true);
-                (void) result.second;
-            }
+        // Later job types have higher priority
+        for (auto iter = m_jobData.rbegin (); iter != m_jobData.rend (); ++iter)
+        {
+            if (! iter->second.info.special ())
+                m_priority.push_back (&iter->second);
         }
     }
 
@@ -111,11 +135,10 @@ public:
 
     void collect ()
     {
-        ScopedLock lock (m_mutex);
-        job_count = m_jobSet.size ();
+        job_count = m_jobCount.load ();
     }
 
-    void addJob (JobType type, std::string const& name,
+    void addJob (JobType type, char const* name,
         boost::function <void (Job&)> const& jobFunc) override
     {
         assert (type != jtINVALID);
@@ -132,24 +155,21 @@ public:
         // do not add jobs to a queue with no threads
         assert (type == jtCLIENT || m_workers.getNumberOfThreads () > 0);
 
-        {
-            // If this goes off it means that a child didn't follow
-            // the Stoppable API rules. A job may only be added if:
-            //
-            //  - The JobQueue has NOT stopped
-            //          AND
-            //      * We are currently processing jobs
-            //          OR
-            //      * We have have pending jobs
-            //          OR
-            //      * Not all children are stopped
-            //
-            ScopedLock lock (m_mutex);
-            assert (! isStopped() && (
-                m_processCount>0 ||
-                ! m_jobSet.empty () ||
-                ! areChildrenStopped()));
-        }
+        // If this goes off it means that a child didn't follow
+        // the Stoppable API rules. A job may only be added if:
+        //
+        //  - The JobQueue has NOT stopped
+        //          AND
+        //      * We are currently processing jobs
+        //          OR
+        //      * We have have pending jobs
+        //          OR
+        //      * Not all children are stopped
+        //
+        assert (! isStopped() && (
+            m_processCount > 0 ||
+            m_jobCount > 0 ||
+            ! areChildrenStopped()));
 
         // Don't even add it to the queue if we're stopping
         // and the job type is marked for skipOnStop.
@@ -161,36 +181,43 @@ public:
             return;
         }
 
-        {
-            ScopedLock lock (m_mutex);
+        Job job (type, name, ++m_lastJob,
+            data.load (), jobFunc, m_cancelCallback);
 
-            std::pair <std::set <Job>::iterator, bool> result (
-                m_jobSet.insert (Job (type, name, ++m_lastJob,
-                    data.load (), jobFunc, m_cancelCallback)));
-            queueJob (*result.first, lock);
+        bool signal;
+        {
+            ScopedLock lock (data.mutex);
+            data.queue.push_back (std::move (job));
+            ++m_jobCount;
+            signal = queueJob (data, lock);
         }
+
+        if (signal)
+            m_workers.addTask ();
     }
 
     int getJobCount (JobType t) const override
     {
-        ScopedLock lock (m_mutex);
-
         JobDataMap::const_iterator c = m_jobData.find (t);
 
-        return (c == m_jobData.end ())
-            ? 0
-            : c->second.waiting;
+        if (c == m_jobData.end ())
+            return 0;
+
+        JobTypeData const& data (c->second);
+        ScopedLock lock (data.mutex);
+        return data.waiting;
     }
 
     int getJobCountTotal (JobType t) const override
     {
-        ScopedLock lock (m_mutex);
-
         JobDataMap::const_iterator c = m_jobData.find (t);
 
-        return (c == m_jobData.end ())
-            ? 0
-            : (c->second.waiting + c->second.running);
+        if (c == m_jobData.end ())
+            return 0;
+
+        JobTypeData const& data (c->second);
+        ScopedLock lock (data.mutex);
+        return data.waiting + data.running;
     }
 
     int getJobCountGE (JobType t) const override
@@ -198,12 +225,12 @@ public:
         // return the number of jobs at this priority level or greater
         int ret = 0;
 
-        ScopedLock lock (m_mutex);
-
-        for (auto const& x : m_jobData)
+        for (auto iter = m_jobData.lower_bound (t);
+            iter != m_jobData.end (); ++iter)
         {
-            if (x.first >= t)
-                ret += x.second.waiting;
+            JobTypeData const& data (iter->second);
+            ScopedLock lock (data.mutex);
+            ret += data.waiting;
         }
 
         return ret;
@@ -238,7 +265,7 @@ public:
     }
 
     LoadEvent::pointer getLoadEvent (
-        JobType t, std::string const& name) override
+        JobType t, char const* name) override
     {
         JobDataMap::iterator iter (m_jobData.find (t));
         assert (iter != m_jobData.end ());
@@ -251,7 +278,7 @@ public:
     }
 
     LoadEvent::autoptr getLoadEventAP (
-        JobType t, std::string const& name) override
+        JobType t, char const* name) override
     {
         JobDataMap::iterator iter (m_jobData.find (t));
         assert (iter != m_jobData.end ());
@@ -294,8 +321,6 @@ public:
 
         Json::Value priorities = Json::arrayValue;
 
-        ScopedLock lock (m_mutex);
-
         for (auto& x : m_jobData)
         {
             assert (x.first != jtINVALID);
@@ -307,8 +332,13 @@ public:
 
             LoadMonitor::Stats stats (data.stats ());
 
-            int waiting (data.waiting);
-            int running (data.running);
+            int waiting;
+            int running;
+            {
+                ScopedLock lock (data.mutex);
+                waiting = data.waiting;
+                running = data.running;
+            }
 
             if ((stats.count != 0) || (waiting != 0) ||
                 (stats.latencyPeak != 0) || (running != 0))
@@ -342,12 +372,9 @@ public:
         return ret;
     }
 
-    Job* getJobForThread (std::thread::id const& id) const override
+    Job* getJobForThread () const override
     {
-        auto tid = (id == std::thread::id()) ? std::this_thread::get_id() : id;
-
-        auto i = m_threadIds.find (tid);
-        return (i == m_threadIds.end()) ? nullptr : i->second;
+        return m_threadJob.get ();
     }
 
 private:
@@ -376,12 +403,12 @@ private:
         //  1. A stop notification was received
         //  2. All Stoppable children have stopped
         //  3. There are no executing calls to processTask
-        //  4. There are no remaining Jobs in the job set
+        //  4. There are no remaining Jobs in the job queues
         //
         if (isStopping() &&
             areChildrenStopped() &&
             (m_processCount == 0) &&
-            m_jobSet.empty())
+            (m_jobCount == 0))
         {
             stopped();
         }
@@ -389,94 +416,82 @@ private:
 
     //--------------------------------------------------------------------------
     //
-    // Signals an added Job for processing.
+    // Accounts for a Job added to the queue of its type.
     //
     // Pre-conditions:
-    //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
-    //  The Job must not have previously been queued.
+    //  The Job was just pushed onto data.queue.
     //
     // Post-conditions:
     //  Count of waiting jobs of that type will be incremented.
-    //  If JobQueue exists, and has at least one thread, Job will eventually run.
+    //  Returns `true` if the caller must signal a task to the Workers.
     //
     // Invariants:
-    //  The calling thread owns the JobLock
+    //  The calling thread owns data.mutex
     //
-    void queueJob (Job const& job, ScopedLock const& lock)
+    bool queueJob (JobTypeData& data, ScopedLock const& lock)
     {
-        JobType const type (job.getType ());
-        assert (type != jtINVALID);
-        assert (m_jobSet.find (job) != m_jobSet.end ());
+        assert (! data.queue.empty ());
 
-        JobTypeData& data (getJobTypeData (type));
+        bool const signal (
+            data.waiting + data.running < data.info.limit ());
 
-        if (data.waiting + data.running < getJobLimit (type))
-        {
-            m_workers.addTask ();
-        }
-        else
+        if (! signal)
         {
             // defer the task until we go below the limit
             //
             ++data.deferred;
         }
         ++data.waiting;
+
+        return signal;
     }
 
     //------------------------------------------------------------------------------
     //
-    // Returns the next Job we should run now.
+    // Takes the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A queued Job whose type is running below its limit.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  The calling thread was signaled a task.
     //
     // Post-conditions:
-    //  job is a valid Job object.
-    //  job is removed from mJobQueue.
-    //  Waiting job count of its type is decremented
-    //  Running job count of its type is incremented
+    //  Returns `false` if no RunnableJob was found. This happens when
+    //  another worker took the job we were signaled for after we passed
+    //  its type. The job that worker was signaled for remains.
+    //  Otherwise job is a valid Job object, removed from the queue of its
+    //  type, waiting job count of its type is decremented and running job
+    //  count of its type is incremented.
     //
     // Invariants:
-    //  The calling thread owns the JobLock
+    //  <none>
     //
-    void getNextJob (Job& job)
+    bool getNextJob (Job& job)
     {
-        assert (! m_jobSet.empty ());
-
-        JobSet::const_iterator iter;
-        for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+        for (JobTypeData* data : m_priority)
         {
-            JobTypeData& data (getJobTypeData (iter->getType ()));
+            ScopedLock lock (data->mutex);
 
-            assert (data.running <= getJobLimit (data.type ()));
+            assert (data->running <= data->info.limit ());
 
             // Run this job if we're running below the limit.
-            if (data.running < getJobLimit (data.type ()))
+            if (! data->queue.empty () &&
+                data->running < data->info.limit ())
             {
-                assert (data.waiting > 0);
-                break;
-            }
-        }
+                assert (data->waiting > 0);
 
-        assert (iter != m_jobSet.end ());
+                job = std::move (data->queue.front ());
+                data->queue.pop_front ();
+                --m_jobCount;
 
-        JobType const type = iter->getType ();
-        JobTypeData& data (getJobTypeData (type));
-
-        assert (type != jtINVALID);
-
-        job = *iter;
-        m_jobSet.erase (iter);
-
-        m_threadIds[std::this_thread::get_id()] = &job;
+                --data->waiting;
+                ++data->running;
+                return true;
+            }
+        }
 
-        --data.waiting;
-        ++data.running;
+        return false;
     }
 
     //------------------------------------------------------------------------------
@@ -484,7 +499,7 @@ private:
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not be queued.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -498,25 +513,28 @@ private:
     {
         JobType const type = job.getType ();
 
-        assert (m_jobSet.find (job) == m_jobSet.end ());
         assert (type != jtINVALID);
 
         JobTypeData& data (getJobTypeData (type));
 
-        // Queue a deferred task if possible
-        if (data.deferred > 0)
+        bool signal (false);
         {
-            assert (data.running + data.waiting >= getJobLimit (type));
+            ScopedLock lock (data.mutex);
 
-            --data.deferred;
-            m_workers.addTask ();
-        }
+            // Queue a deferred task if possible
+            if (data.deferred > 0)
+            {
+                assert (data.running + data.waiting >= getJobLimit (type));
 
-        if (! m_threadIds.erase (std::this_thread::get_id()))
-        {
-            assert (false);
+                --data.deferred;
+                signal = true;
+            }
+
+            --data.running;
         }
-        --data.running;
+
+        if (signal)
+            m_workers.addTask ();
     }
 
     //--------------------------------------------------------------------------
@@ -545,7 +563,7 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must exist in the queues
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -557,11 +575,15 @@ private:
     {
         Job job;
 
+        ++m_processCount;
+        if (! getNextJob (job))
         {
-            ScopedLock lock (m_mutex);
-            getNextJob (job);
-            ++m_processCount;
+            // Hand the signal back and wait on the semaphore again
+            m_workers.addTask ();
+            --m_processCount;
+            return;
         }
+        m_threadJob.reset (&job);
 
         JobTypeData& data (getJobTypeData (job.getType ()));
 
@@ -585,10 +607,13 @@ private:
             m_journal.trace << "Skipping processTask ('" << data.name () << "')";
         }
 
+        m_threadJob.reset ();
+        finishJob (job);
+        --m_processCount;
+
+        if (isStopping ())
         {
             ScopedLock lock (m_mutex);
-            finishJob (job);
-            --m_processCount;
             checkStopped (lock);
         }
 
@@ -629,51 +654,6 @@ private:
         // VFALCO NOTE I wanted to remove all the jobs that are skippable
         //             but then the Workers count of tasks to process
         //             goes wrong.
-
-        /*
-        {
-            ScopedLock lock (m_mutex);
-
-            // Remove all jobs whose type is skipOnStop
-            using JobDataMap = hash_map <JobType, std::size_t>;
-            JobDataMap counts;
-            bool const report (m_journal.debug.active());
-
-            for (JobSet::const_iterator iter (m_jobSet.begin());
-                iter != m_jobSet.end();)
-            {
-                if (skipOnStop (iter->getType()))
-                {
-                    if (report)
-                    {
-                        std::pair <JobDataMap::iterator, bool> result (
-                            counts.insert (std::make_pair (iter->getType(), 1)));
-                        if (! result.second)
-                            ++(result.first->second);
-                    }
-
-                    iter = m_jobSet.erase (iter);
-                }
-                else
-                {
-                    ++iter;
-                }
-            }
-
-            if (report)
-            {
-                beast::Journal::ScopedStream s (m_journal.debug);
-
-                for (JobDataMap::const_iterator iter (counts.begin());
-                    iter != counts.end(); ++iter)
-                {
-                    s << std::endl <<
-                        "Removed " << iter->second <<
-                        " skiponStop jobs of type " << Job::toString (iter->first);
-                }
-            }
-        }
-        */
     }
 
     void onChildrenStopped ()
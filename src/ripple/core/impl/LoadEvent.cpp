@@ -23,7 +23,7 @@
 
 namespace ripple {
 
-LoadEvent::LoadEvent (LoadMonitor& monitor, std::string const& name, bool shouldStart)
+LoadEvent::LoadEvent (LoadMonitor& monitor, char const* name, bool shouldStart)
     : m_loadMonitor (monitor)
     , m_isRunning (false)
     , m_name (name)
@@ -41,7 +41,7 @@ LoadEvent::~LoadEvent ()
         stop ();
 }
 
-std::string const& LoadEvent::name () const
+char const* LoadEvent::name () const
 {
     return m_name;
 }
@@ -61,7 +61,7 @@ double LoadEvent::getSecondsTotal() const
     return m_secondsWaiting + m_secondsRunning;
 }
 
-void LoadEvent::reName (std::string const& name)
+void LoadEvent::reName (char const* name)
 {
     m_name = name;
 }
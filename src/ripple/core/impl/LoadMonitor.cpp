@@ -141,7 +141,7 @@ std::string LoadMonitor::printElapsed (double seconds)
 
 void LoadMonitor::addLoadSample (LoadEvent const& sample)
 {
-    std::string const& name (sample.name());
+    char const* const name (sample.name());
     beast::RelativeTime const latency (sample.getSecondsTotal());
 
     if (latency.inSeconds() > 0.5)
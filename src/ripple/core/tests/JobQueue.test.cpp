@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/core/JobQueue.h>
+#include <beast/insight/NullCollector.h>
+#include <beast/threads/Stoppable.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace ripple {
+
+class JobQueue_test : public beast::unit_test::suite
+{
+public:
+    // Owns a JobQueue and stops it cleanly when done
+    class Harness
+    {
+    public:
+        beast::RootStoppable root;
+        std::unique_ptr <JobQueue> jq;
+
+        explicit
+        Harness (int threads)
+            : root ("JobQueue_test")
+            , jq (make_JobQueue (beast::insight::NullCollector::New (),
+                root, beast::Journal ()))
+        {
+            jq->setThreadCount (threads, false);
+            root.start ();
+        }
+
+        ~Harness ()
+        {
+            root.stop (beast::Journal ());
+        }
+    };
+
+    // Counts down to zero and wakes the waiter
+    class Latch
+    {
+    private:
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        int count_;
+
+    public:
+        explicit
+        Latch (int count)
+            : count_ (count)
+        {
+        }
+
+        void
+        count_down ()
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            if (--count_ == 0)
+                cond_.notify_all ();
+        }
+
+        void
+        wait ()
+        {
+            std::unique_lock <std::mutex> lock (mutex_);
+            cond_.wait (lock, [this] { return count_ == 0; });
+        }
+    };
+
+    void
+    testRunsAll ()
+    {
+        testcase ("runs all jobs");
+
+        int const jobs = 10000;
+        Harness h (4);
+        Latch done (jobs);
+        std::atomic <int> ran (0);
+
+        for (int i = 0; i < jobs; ++i)
+        {
+            JobType const type = (i % 2) ? jtCLIENT : jtTRANSACTION;
+            h.jq->addJob (type, "test", [&] (Job& job)
+            {
+                expect (h.jq->getJobForThread () == &job);
+                ++ran;
+                done.count_down ();
+            });
+        }
+
+        done.wait ();
+        expect (ran == jobs);
+        expect (h.jq->getJobCountGE (jtPACK) == 0);
+    }
+
+    void
+    testLimit ()
+    {
+        testcase ("job type limit");
+
+        // jtPACK is limited to one running job at a time
+        int const jobs = 200;
+        Harness h (8);
+        Latch done (jobs);
+        std::atomic <int> running (0);
+        std::atomic <int> peak (0);
+
+        for (int i = 0; i < jobs; ++i)
+        {
+            h.jq->addJob (jtPACK, "test", [&] (Job&)
+            {
+                int const now = ++running;
+                int prev = peak.load ();
+                while (now > prev && ! peak.compare_exchange_weak (prev, now))
+                    ;
+                std::this_thread::yield ();
+                --running;
+                done.count_down ();
+            });
+        }
+
+        done.wait ();
+        expect (peak == 1, "limit exceeded");
+    }
+
+    void
+    run ()
+    {
+        testRunsAll ();
+        testLimit ();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// Measures job dispatch throughput and enqueue-to-start latency
+class JobQueue_timing_test : public JobQueue_test
+{
+public:
+    using clock_type = Job::clock_type;
+
+    void
+    do_timing (int threads, int jobs)
+    {
+        Harness h (threads);
+        Latch done (jobs);
+        std::atomic <std::uint64_t> latency (0);
+
+        auto const start = clock_type::now ();
+
+        // Spread the jobs over several types so that limits and
+        // priorities are exercised
+        JobType const types[] = {
+            jtCLIENT, jtTRANSACTION, jtVALIDATION_ut, jtPROPOSAL_t };
+
+        for (int i = 0; i < jobs; ++i)
+        {
+            h.jq->addJob (types[i % 4], "timing", [&] (Job& job)
+            {
+                latency += std::chrono::duration_cast <
+                    std::chrono::microseconds> (
+                        clock_type::now () - job.queue_time ()).count ();
+                done.count_down ();
+            });
+        }
+
+        done.wait ();
+
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::microseconds> (clock_type::now () - start);
+
+        std::stringstream ss;
+        ss << std::setw (2) << threads << " threads: " <<
+            static_cast <std::uint64_t> (
+                jobs * 1000000.0 / std::max <std::int64_t> (
+                    elapsed.count (), 1)) << " jobs/s, " <<
+            (latency / jobs) << "us mean enqueue-to-start";
+        log << ss.str ();
+    }
+
+    void
+    run () override
+    {
+        int const jobs = 200000;
+        for (int threads = 1; threads <= 64; threads *= 2)
+            do_timing (threads, jobs);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(JobQueue,ripple_core,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueue_timing,ripple_core,ripple);
+
+} // ripple
@@ -77,7 +77,7 @@ public:
             { return to_char (digit); }
 
         int from_char (char c) const
-            { return m_inverse [c]; }
+            { return m_inverse [static_cast <unsigned char> (c)]; }
 
     private:
         std::string const m_chars;
@@ -87,41 +87,45 @@ public:
     static Alphabet const& getBitcoinAlphabet ();
     static Alphabet const& getRippleAlphabet ();
 
+    /** Payloads up to this size are converted without heap buffers. */
+    static std::size_t const maxStackBytes = 128;
+
+    /** Encode big endian data. */
+    static std::string encodeBigEndian (unsigned char const* begin,
+        unsigned char const* end, Alphabet const& alphabet);
+
+    /** Encode little endian data followed by a zero pad byte. */
     static std::string raw_encode (unsigned char const* begin,
         unsigned char const* end, Alphabet const& alphabet);
 
     static void fourbyte_hash256 (void* out, void const* in, std::size_t bytes);
 
+    /** Encode a version byte and payload followed by their checksum. */
+    static std::string encodeWithCheck (unsigned char version,
+        void const* data, std::size_t size,
+            Alphabet const& alphabet = getRippleAlphabet ());
+
     template <class InputIt>
     static std::string encode (InputIt first, InputIt last,
         Alphabet const& alphabet, bool withCheck)
     {
-        using value_type = typename std::iterator_traits<InputIt>::value_type;
-        std::vector <typename std::remove_const <value_type>::type> v;
         std::size_t const size (std::distance (first, last));
-        if (withCheck)
+        std::array <unsigned char, maxStackBytes + 4> a;
+        Blob v;
+        unsigned char* p = a.data ();
+        if (size > maxStackBytes)
         {
-            v.reserve (size + 1 + 4);
-            v.insert (v.begin(), first, last);
-            unsigned char hash [4];
-            fourbyte_hash256 (hash, &v.front(), v.size());
-            v.resize (0);
-            // Place the hash reversed in the front
-            std::copy (std::reverse_iterator <unsigned char const*> (hash+4),
-                       std::reverse_iterator <unsigned char const*> (hash),
-                       std::back_inserter (v));
+            v.resize (size + 4);
+            p = v.data ();
         }
-        else
+        std::copy (first, last, p);
+        std::size_t n = size;
+        if (withCheck)
         {
-            v.reserve (size + 1);
+            fourbyte_hash256 (p + n, p, n);
+            n += 4;
         }
-        // Append input little endian
-        std::copy (std::reverse_iterator <InputIt> (last),
-                   std::reverse_iterator <InputIt> (first),
-                   std::back_inserter (v));
-        // Pad zero to make the BIGNUM positive
-        v.push_back (0);
-        return raw_encode (&v.front(), &v.back()+1, alphabet);
+        return encodeBigEndian (p, p + n, alphabet);
     }
 
     template <class Container>
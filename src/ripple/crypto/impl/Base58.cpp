@@ -19,11 +19,10 @@
 
 #include <BeastConfig.h>
 #include <ripple/crypto/Base58.h>
-#include <ripple/crypto/CAutoBN_CTX.h>
-#include <ripple/crypto/CBigNum.h>
+#include <ripple/basics/base_uint.h>
 #include <openssl/sha.h>
 #include <algorithm>
-#include <stdexcept>
+#include <cstring>
 #include <string>
 
 // Copyright (c) 2009-2010 Satoshi Nakamoto
@@ -67,93 +66,183 @@ Base58::Alphabet const& Base58::getRippleAlphabet ()
     return alphabet;
 }
 
-std::string Base58::raw_encode (unsigned char const* begin,
+//------------------------------------------------------------------------------
+
+// The conversions below work a byte or a digit at a time on a fixed
+// buffer instead of going through a bignum, so encoding and decoding the
+// short payloads used for keys and accounts never touch the heap apart
+// from the result.
+
+// Converts big endian bytes to base 58 digits, stored most significant
+// first at the end of digits. The buffer must be zero filled and hold at
+// least size * 138 / 100 + 1 digits. Returns the number of digits used.
+static
+std::size_t
+to_base58 (unsigned char const* in, std::size_t size,
+    unsigned char* digits, std::size_t capacity)
+{
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        unsigned int carry = in[i];
+        std::size_t j = 0;
+        for (unsigned char* p = digits + capacity;
+            (carry != 0 || j < length) && p != digits; ++j)
+        {
+            --p;
+            carry += 256 * *p;
+            *p = carry % 58;
+            carry /= 58;
+        }
+        assert (carry == 0);
+        length = j;
+    }
+    return length;
+}
+
+// Converts base 58 characters to big endian bytes, leading zeros
+// included, stored at the start of out. Returns false if a character is
+// not in the alphabet or the result does not fit in capacity bytes.
+static
+bool
+from_base58 (char const* first, char const* last, unsigned char* out,
+    std::size_t capacity, std::size_t& size,
+        Base58::Alphabet const& alphabet)
+{
+    std::size_t zeros = 0;
+    while (first != last && *first == alphabet[0])
+    {
+        ++first;
+        ++zeros;
+    }
+    if (zeros > capacity)
+        return false;
+
+    unsigned char* const begin = out + zeros;
+    unsigned char* const end = out + capacity;
+    std::fill (begin, end, 0);
+
+    std::size_t length = 0;
+    for (; first != last; ++first)
+    {
+        int const digit = alphabet.from_char (*first);
+        if (digit == -1)
+            return false;
+        unsigned int carry = digit;
+        std::size_t j = 0;
+        for (unsigned char* p = end;
+            (carry != 0 || j < length) && p != begin; ++j)
+        {
+            --p;
+            carry += 58 * *p;
+            *p = carry & 0xff;
+            carry >>= 8;
+        }
+        if (carry != 0)
+            return false;
+        length = j;
+    }
+
+    std::fill (out, begin, 0);
+    std::memmove (begin, end - length, length);
+    size = zeros + length;
+    return true;
+}
+
+std::string Base58::encodeBigEndian (unsigned char const* begin,
     unsigned char const* end, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn0 = 0;
+    std::size_t zeros = 0;
+    while (begin != end && *begin == 0)
+    {
+        ++begin;
+        ++zeros;
+    }
 
-    // Convert little endian data to bignum
-    CBigNum bn (begin, end);
     std::size_t const size (std::distance (begin, end));
-
-    // Convert bignum to std::string
-    std::string str;
     // Expected size increase from base58 conversion is approximately 137%
     // use 138% to be safe
-    str.reserve (size * 138 / 100 + 1);
-    CBigNum dv;
-    CBigNum rem;
-
-    while (bn > bn0)
+    std::size_t const capacity = size * 138 / 100 + 1;
+    std::array <unsigned char, maxStackBytes * 138 / 100 + 1 + 6> a;
+    Blob v;
+    unsigned char* digits = a.data ();
+    if (capacity > a.size ())
     {
-        if (!BN_div (&dv, &rem, &bn, &bn58, pctx))
-            throw std::runtime_error ("EncodeBase58 : BN_div failed");
-
-        bn = dv;
-        unsigned int c = rem.getuint ();
-        str += alphabet [c];
+        v.resize (capacity);
+        digits = v.data ();
     }
+    std::fill (digits, digits + capacity, 0);
 
-    for (const unsigned char* p = end-2; p >= begin && *p == 0; p--)
-        str += alphabet [0];
+    std::size_t const length = to_base58 (begin, size, digits, capacity);
 
-    // Convert little endian std::string to big endian
-    std::reverse (str.begin (), str.end ());
+    std::string str;
+    str.reserve (zeros + length);
+    str.assign (zeros, alphabet [0]);
+    for (std::size_t i = capacity - length; i < capacity; ++i)
+        str += alphabet [digits[i]];
     return str;
 }
 
+std::string Base58::raw_encode (unsigned char const* begin,
+    unsigned char const* end, Alphabet const& alphabet)
+{
+    // Drop the zero pad and put the data in big endian order
+    std::size_t const size (std::distance (begin, end) - 1);
+    std::array <unsigned char, maxStackBytes + 4> a;
+    Blob v;
+    unsigned char* p = a.data ();
+    if (size > a.size ())
+    {
+        v.resize (size);
+        p = v.data ();
+    }
+    std::reverse_copy (begin, begin + size, p);
+    return encodeBigEndian (p, p + size, alphabet);
+}
+
+std::string Base58::encodeWithCheck (unsigned char version,
+    void const* data, std::size_t size, Alphabet const& alphabet)
+{
+    std::array <unsigned char, maxStackBytes + 4> a;
+    Blob v;
+    unsigned char* p = a.data ();
+    if (size + 5 > a.size ())
+    {
+        v.resize (size + 5);
+        p = v.data ();
+    }
+    p[0] = version;
+    std::memcpy (p + 1, data, size);
+    fourbyte_hash256 (p + size + 1, p, size + 1);
+    return encodeBigEndian (p, p + size + 5, alphabet);
+}
+
 //------------------------------------------------------------------------------
 
 bool Base58::raw_decode (char const* first, char const* last, void* dest,
     std::size_t size, bool checked, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
+    unsigned char* const out (static_cast <unsigned char*> (dest));
 
-    // Convert big endian string to bignum
-    for (char const* p = first; p != last; ++p)
+    // Decode one byte more than wanted so a longer result is detected
+    std::array <unsigned char, maxStackBytes + 4> a;
+    Blob v;
+    unsigned char* p = a.data ();
+    if (size + 1 > a.size ())
     {
-        int i (alphabet.from_char (*p));
-        if (i == -1)
-            return false;
-        bnChar.setuint ((unsigned int) i);
-
-        int const success (BN_mul (&bn, &bn, &bn58, pctx));
-
-        assert (success);
-        (void) success;
-
-        bn += bnChar;
+        v.resize (size + 1);
+        p = v.data ();
     }
 
-    // Get bignum as little endian data
-    Blob vchTmp = bn.getvch ();
-
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
-
-    char* const out (static_cast <char*> (dest));
-
-    // Count leading zeros
-    int nLeadingZeros = 0;
-    for (char const* p = first; p!=last && *p==alphabet[0]; p++)
-        nLeadingZeros++;
+    std::size_t n;
+    if (! from_base58 (first, last, p, size + 1, n, alphabet))
+        return false;
 
     // Verify that the size is correct
-    if (vchTmp.size() + nLeadingZeros != size)
+    if (n != size)
         return false;
 
-    // Fill the leading zeros
-    memset (out, 0, nLeadingZeros);
-
-    // Copy little endian data to big endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (),
-        out + nLeadingZeros);
+    std::memcpy (out, p, size);
 
     if (checked)
     {
@@ -168,59 +257,44 @@ bool Base58::raw_decode (char const* first, char const* last, void* dest,
 
 bool Base58::decode (const char* psz, Blob& vchRet, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
     vchRet.clear ();
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
 
     while (isspace (*psz))
         psz++;
 
-    // Convert big endian string to bignum
-    for (const char* p = psz; *p; p++)
-    {
-        // VFALCO TODO Make this use the inverse table!
-        //             Or better yet ditch this and call raw_decode
-        //
-        const char* p1 = strchr (alphabet.chars(), *p);
-
-        if (p1 == nullptr)
-        {
-            while (isspace (*p))
-                p++;
-
-            if (*p != '\0')
-                return false;
-
-            break;
-        }
+    // The encoded text runs up to the first character outside the
+    // alphabet, after which only whitespace may follow.
+    char const* last = psz;
+    while (*last && alphabet.from_char (*last) != -1)
+        last++;
 
-        bnChar.setuint (p1 - alphabet.chars());
-
-        if (!BN_mul (&bn, &bn, &bn58, pctx))
-            throw std::runtime_error ("DecodeBase58 : BN_mul failed");
-
-        bn += bnChar;
+    for (char const* p = last; *p; p++)
+    {
+        if (! isspace (*p))
+            return false;
     }
 
-    // Get bignum as big endian data
-    Blob vchTmp = bn.getvch ();
-
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
-
-    // Restore leading zeros
-    int nLeadingZeros = 0;
-
-    for (const char* p = psz; *p == alphabet.chars()[0]; p++)
-        nLeadingZeros++;
+    // Each character contributes at most one byte
+    std::size_t const capacity = last - psz;
+    std::array <unsigned char, maxStackBytes + 4> a;
+    unsigned char* p = a.data ();
+    if (capacity > a.size ())
+    {
+        vchRet.resize (capacity);
+        p = vchRet.data ();
+    }
 
-    vchRet.assign (nLeadingZeros + vchTmp.size (), 0);
+    std::size_t size;
+    if (! from_base58 (psz, last, p, capacity, size, alphabet))
+    {
+        vchRet.clear ();
+        return false;
+    }
 
-    // Convert big endian data to little endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (), vchRet.end () - vchTmp.size ());
+    if (p == a.data ())
+        vchRet.assign (p, p + size);
+    else
+        vchRet.resize (size);
     return true;
 }
 
@@ -74,11 +74,7 @@ bool CBase58Data::SetString (
 
 std::string CBase58Data::ToString () const
 {
-    Blob vch (1, nVersion);
-
-    vch.insert (vch.end (), vchData.begin (), vchData.end ());
-
-    return Base58::encodeWithCheck (vch);
+    return Base58::encodeWithCheck (nVersion, vchData.data (), vchData.size ());
 }
 
 } // ripple
@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/crypto/Base58.h>
+#include <ripple/crypto/CAutoBN_CTX.h>
+#include <ripple/crypto/CBigNum.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+
+// The bignum conversions Base58 used before, kept as a reference for
+// comparing results and speed.
+struct Base58Reference
+{
+    static
+    std::string
+    encode (Blob const& data, Base58::Alphabet const& alphabet)
+    {
+        CAutoBN_CTX pctx;
+        CBigNum bn58 = 58;
+        CBigNum bn0 = 0;
+
+        // Convert big endian data to a positive little endian bignum
+        Blob le (data.rbegin (), data.rend ());
+        le.push_back (0);
+        CBigNum bn (le.data (), le.data () + le.size ());
+
+        std::string str;
+        CBigNum dv;
+        CBigNum rem;
+        while (bn > bn0)
+        {
+            BN_div (&dv, &rem, &bn, &bn58, pctx);
+            bn = dv;
+            str += alphabet [rem.getuint ()];
+        }
+
+        for (auto iter = data.begin (); iter != data.end () && *iter == 0; ++iter)
+            str += alphabet [0];
+
+        std::reverse (str.begin (), str.end ());
+        return str;
+    }
+
+    static
+    bool
+    decode (std::string const& s, Blob& out, Base58::Alphabet const& alphabet)
+    {
+        CAutoBN_CTX pctx;
+        CBigNum bn58 = 58;
+        CBigNum bn = 0;
+        CBigNum bnChar;
+
+        for (auto c : s)
+        {
+            int const i = alphabet.from_char (c);
+            if (i == -1)
+                return false;
+            bnChar.setuint (i);
+            BN_mul (&bn, &bn, &bn58, pctx);
+            bn += bnChar;
+        }
+
+        Blob vchTmp = bn.getvch ();
+        if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
+            vchTmp.erase (vchTmp.end () - 1);
+
+        std::size_t zeros = 0;
+        while (zeros < s.size () && s[zeros] == alphabet[0])
+            ++zeros;
+
+        out.assign (zeros, 0);
+        out.insert (out.end (), vchTmp.rbegin (), vchTmp.rend ());
+        return true;
+    }
+};
+
+class Base58_test : public beast::unit_test::suite
+{
+public:
+    static
+    Blob
+    account (std::string const& hex)
+    {
+        Blob b;
+        for (std::size_t i = 0; i + 1 < hex.size (); i += 2)
+            b.push_back (std::stoul (hex.substr (i, 2), nullptr, 16));
+        return b;
+    }
+
+    void
+    testVectors ()
+    {
+        testcase ("vectors");
+
+        auto const zero = account ("0000000000000000000000000000000000000000");
+        auto const one = account ("0000000000000000000000000000000000000001");
+        auto const genesis = account ("B5F762798A53D543A014CAF8B297CFF8F2F937E8");
+
+        expect (Base58::encodeWithCheck (0, zero.data (), zero.size ()) ==
+            "rrrrrrrrrrrrrrrrrrrrrhoLvTp");
+        expect (Base58::encodeWithCheck (0, one.data (), one.size ()) ==
+            "rrrrrrrrrrrrrrrrrrrrBZbvji");
+        expect (Base58::encodeWithCheck (0, genesis.data (), genesis.size ()) ==
+            "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh");
+
+        Blob v (1, 0);
+        v.insert (v.end (), genesis.begin (), genesis.end ());
+        expect (Base58::encodeWithCheck (v) ==
+            "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh");
+
+        Blob out;
+        expect (Base58::decodeWithCheck ("rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh", out));
+        expect (out == v);
+
+        std::string const s ("rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh");
+        std::array <unsigned char, 25> raw;
+        expect (Base58::raw_decode (s.data (), s.data () + s.size (),
+            raw.data (), raw.size (), true, Base58::getRippleAlphabet ()));
+        expect (std::equal (v.begin (), v.end (), raw.begin ()));
+        expect (! Base58::raw_decode (s.data (), s.data () + s.size (),
+            raw.data (), raw.size () - 1, false, Base58::getRippleAlphabet ()));
+    }
+
+    void
+    testErrors ()
+    {
+        testcase ("errors");
+
+        Blob out;
+        expect (Base58::decode ("  rHb9CJ  ", out));
+        expect (! Base58::decode ("rHb9CJ x", out));
+        expect (! Base58::decode ("rHb0CJ", out));
+        expect (! Base58::decode ("rHb9\xc3\xa9", out));
+        expect (Base58::decode ("", out) && out.empty ());
+
+        // One character off breaks the checksum
+        expect (! Base58::decodeWithCheck ("rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTj", out));
+        expect (out.empty ());
+        expect (! Base58::decodeWithCheck ("rHb", out));
+    }
+
+    void
+    testReference ()
+    {
+        testcase ("reference");
+
+        auto const& alphabet = Base58::getRippleAlphabet ();
+        std::mt19937 g (58);
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::size_t const size = g () % (2 * Base58::maxStackBytes);
+            std::size_t const zeros = g () % 4;
+            Blob data (size);
+            for (std::size_t j = zeros; j < size; ++j)
+                data[j] = static_cast <unsigned char> (g ());
+
+            auto const s = Base58::encodeBigEndian (
+                data.data (), data.data () + data.size (), alphabet);
+            expect (s == Base58Reference::encode (data, alphabet));
+
+            Blob out;
+            expect (Base58::decode (s.c_str (), out, alphabet));
+            expect (out == data);
+            Blob ref;
+            expect (Base58Reference::decode (s, ref, alphabet));
+            expect (ref == data);
+        }
+    }
+
+    void
+    run () override
+    {
+        testVectors ();
+        testErrors ();
+        testReference ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Base58,crypto,ripple);
+
+//------------------------------------------------------------------------------
+
+// Compares the bignum and fixed buffer conversions on account and node
+// public key sized payloads.
+class Base58_timing_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const count = 100000;
+
+    template <class Function>
+    void
+    measure (std::string const& name, Function f)
+    {
+        using namespace std::chrono;
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < count; ++i)
+            f (i);
+        auto const elapsed = clock_type::now () - start;
+        std::stringstream ss;
+        ss << std::left << std::setw (24) << name << std::right <<
+            std::setw (8) << duration_cast <nanoseconds> (
+                elapsed).count () / count << " ns/op";
+        log << ss.str ();
+    }
+
+    void
+    timeSize (std::size_t size)
+    {
+        auto const& alphabet = Base58::getRippleAlphabet ();
+        std::mt19937 g (size);
+        std::vector <Blob> data (1024);
+        std::vector <std::string> text;
+        for (auto& d : data)
+        {
+            // A version byte, the payload and a checksum
+            d.resize (1 + size + 4);
+            for (auto& c : d)
+                c = static_cast <unsigned char> (g ());
+            d[0] = 0;
+            text.push_back (Base58::encodeBigEndian (
+                d.data (), d.data () + d.size (), alphabet));
+        }
+
+        std::size_t bytes = 0;
+        auto const prefix = std::to_string (size) + " bytes ";
+        measure (prefix + "encode bignum", [&](std::size_t i)
+        {
+            bytes += Base58Reference::encode (
+                data[i % data.size ()], alphabet).size ();
+        });
+        measure (prefix + "encode", [&](std::size_t i)
+        {
+            auto const& d = data[i % data.size ()];
+            bytes += Base58::encodeBigEndian (
+                d.data (), d.data () + d.size (), alphabet).size ();
+        });
+        measure (prefix + "decode bignum", [&](std::size_t i)
+        {
+            Blob out;
+            Base58Reference::decode (text[i % text.size ()], out, alphabet);
+            bytes += out.size ();
+        });
+        measure (prefix + "decode", [&](std::size_t i)
+        {
+            std::array <unsigned char, 64> out;
+            auto const& s = text[i % text.size ()];
+            Base58::raw_decode (s.data (), s.data () + s.size (),
+                out.data (), 1 + size + 4, false, alphabet);
+            bytes += out[0];
+        });
+        expect (bytes != 0);
+    }
+
+    void
+    run () override
+    {
+        timeSize (16);
+        timeSize (20);
+        timeSize (33);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Base58_timing,crypto,ripple);
+
+}
@@ -26,6 +26,7 @@
 #include <ripple/resource/Consumer.h>
 #include <ripple/protocol/Book.h>
 #include <beast/threads/Stoppable.h>
+#include <atomic>
 #include <mutex>
 
 namespace ripple {
@@ -119,9 +120,30 @@ public:
     virtual void send (
         Json::Value const& jvObj, std::string const& sObj, bool broadcast);
 
+    /** Send a stream message in the binary format.
+
+        Only called if the subscriber asked for the binary format.
+        Subscribers that cannot carry binary messages ignore it.
+
+        @see StreamFormat.h
+    */
+    virtual void sendBinary (std::string const& blob, bool broadcast);
+
+    /** Set whether stream messages are sent in the binary format.
+
+        Responses and path_find updates are always JSON.
+    */
+    void setBinary (bool binary);
+
+    bool isBinary () const;
+
     std::uint64_t getSeq ();
 
-    void onSendEmpty ();
+    /** Called when the transport has written everything sent to it. */
+    virtual void onSendEmpty ();
+
+    /** Returns the state of the outbound queue, or null if there is none. */
+    virtual Json::Value getSendQueueJson ();
 
     void insertSubAccountInfo (
         RippleAddress addr,
@@ -149,6 +171,7 @@ private:
     hash_set <RippleAddress>      normalSubscriptions_;
     std::shared_ptr <PathRequest> mPathRequest;
     std::uint64_t                 mSeq;
+    std::atomic <bool>            mBinary;
 };
 
 } // ripple
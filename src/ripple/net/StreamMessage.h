@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NET_STREAMMESSAGE_H_INCLUDED
+#define RIPPLE_NET_STREAMMESSAGE_H_INCLUDED
+
+#include <ripple/net/InfoSub.h>
+#include <ripple/json/json_value.h>
+#include <functional>
+#include <string>
+
+namespace ripple {
+
+/** A message published to subscribers in the form each one asked for.
+
+    The JSON and the binary form are each built the first time a
+    subscriber needs them, so a message nobody receives costs nothing
+    and a message only binary subscribers receive is never rendered to
+    JSON.
+
+    This class is not thread safe.
+*/
+class StreamMessage
+{
+public:
+    using JsonBuilder = std::function <Json::Value ()>;
+    using BinaryBuilder = std::function <std::string ()>;
+
+    StreamMessage (JsonBuilder json, BinaryBuilder binary);
+
+    StreamMessage (StreamMessage const&) = delete;
+    StreamMessage& operator= (StreamMessage const&) = delete;
+
+    /** Send the message to a subscriber. */
+    void
+    send (InfoSub& sub, bool broadcast);
+
+    /** Returns the JSON form, building it if needed. */
+    Json::Value const&
+    getJson ();
+
+    /** Returns the JSON form as text, building it if needed. */
+    std::string const&
+    getText ();
+
+    /** Returns the binary form, building it if needed. */
+    std::string const&
+    getBinary ();
+
+private:
+    JsonBuilder makeJson_;
+    BinaryBuilder makeBinary_;
+    bool haveJson_ = false;
+    bool haveText_ = false;
+    bool haveBinary_ = false;
+    Json::Value json_;
+    std::string text_;
+    std::string binary_;
+};
+
+} // ripple
+
+#endif
@@ -46,6 +46,7 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 InfoSub::InfoSub (Source& source, Consumer consumer)
     : m_consumer (consumer)
     , m_source (source)
+    , mBinary (false)
 {
     static std::atomic <int> s_seq_id (0);
     mSeq = ++s_seq_id;
@@ -80,6 +81,20 @@ void InfoSub::send (
     send (jvObj, broadcast);
 }
 
+void InfoSub::sendBinary (std::string const&, bool)
+{
+}
+
+void InfoSub::setBinary (bool binary)
+{
+    mBinary = binary;
+}
+
+bool InfoSub::isBinary () const
+{
+    return mBinary;
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
@@ -89,6 +104,11 @@ void InfoSub::onSendEmpty ()
 {
 }
 
+Json::Value InfoSub::getSendQueueJson ()
+{
+    return Json::Value ();
+}
+
 void InfoSub::insertSubAccountInfo (RippleAddress addr, bool rt)
 {
     ScopedLockType sl (mLock);
@@ -420,6 +420,17 @@ private:
         return jvRequest;
     }
 
+    // ledger_close_profile [<limit>]
+    Json::Value parseLedgerCloseProfile (Json::Value const& jvParams)
+    {
+        Json::Value     jvRequest (Json::objectValue);
+
+        if (jvParams.size ())
+            jvRequest[jss::limit]  = jvParams[0u].asUInt ();
+
+        return jvRequest;
+    }
+
     // sign_for
     Json::Value parseSignFor (Json::Value const& jvParams)
     {
@@ -862,6 +873,7 @@ public:
             {   "json",                 &RPCParser::parseJson,                  2,  2   },
             {   "ledger",               &RPCParser::parseLedger,                0,  2   },
             {   "ledger_accept",        &RPCParser::parseAsIs,                  0,  0   },
+            {   "ledger_close_profile", &RPCParser::parseLedgerCloseProfile,    0,  1   },
             {   "ledger_closed",        &RPCParser::parseAsIs,                  0,  0   },
             {   "ledger_current",       &RPCParser::parseAsIs,                  0,  0   },
     //      {   "ledger_entry",         &RPCParser::parseLedgerEntry,          -1, -1   },
@@ -876,6 +888,7 @@ public:
     //      {   "profile",              &RPCParser::parseProfile,               1,  9   },
             {   "random",               &RPCParser::parseAsIs,                  0,  0   },
             {   "ripple_path_find",     &RPCParser::parseRipplePathFind,        1,  2   },
+            {   "send_queues",          &RPCParser::parseAsIs,                  0,  0   },
             {   "sign",                 &RPCParser::parseSignSubmit,            2,  3   },
 #if RIPPLE_ENABLE_MULTI_SIGN
             {   "sign_for",             &RPCParser::parseSignFor,               4,  4   },
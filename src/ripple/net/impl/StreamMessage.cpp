@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/net/StreamMessage.h>
+#include <ripple/json/to_string.h>
+
+namespace ripple {
+
+StreamMessage::StreamMessage (JsonBuilder json, BinaryBuilder binary)
+    : makeJson_ (std::move (json))
+    , makeBinary_ (std::move (binary))
+{
+}
+
+void
+StreamMessage::send (InfoSub& sub, bool broadcast)
+{
+    if (sub.isBinary ())
+        sub.sendBinary (getBinary (), broadcast);
+    else
+        sub.send (getJson (), getText (), broadcast);
+}
+
+Json::Value const&
+StreamMessage::getJson ()
+{
+    if (! haveJson_)
+    {
+        json_ = makeJson_ ();
+        haveJson_ = true;
+    }
+    return json_;
+}
+
+std::string const&
+StreamMessage::getText ()
+{
+    if (! haveText_)
+    {
+        text_ = to_string (getJson ());
+        haveText_ = true;
+    }
+    return text_;
+}
+
+std::string const&
+StreamMessage::getBinary ()
+{
+    if (! haveBinary_)
+    {
+        binary_ = makeBinary_ ();
+        haveBinary_ = true;
+    }
+    return binary_;
+}
+
+} // ripple
@@ -65,6 +65,17 @@ public:
     */
     virtual Status fetch (void const* key, std::shared_ptr<NodeObject>* pObject) = 0;
 
+    /** Fetch a single object's payload without creating a NodeObject.
+        On success the callback receives the payload decoded in place,
+        usually straight from the backend's own read buffer.
+
+        @note This will be called concurrently.
+        @param key A pointer to the key data.
+        @param f The callback to receive the payload.
+        @return The result of the operation.
+    */
+    virtual Status fetchPayload (void const* key, FetchCallback const& f) = 0;
+
     /** Return `true` if batch fetches are optimized. */
     virtual
     bool
@@ -23,6 +23,7 @@
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/nodestore/Backend.h>
 #include <ripple/basics/TaggedCache.h>
+#include <ripple/json/json_value.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -84,6 +85,36 @@ public:
     */
     virtual bool asyncFetch (uint256 const& hash, std::shared_ptr<NodeObject>& object) = 0;
 
+    /** Read an object in the background, ahead of a fetch.
+        This is a hint from a caller that expects to fetch the object
+        soon, such as a traversal that just loaded the object's parent.
+        The read is scheduled unless the object is cached, there are no
+        async read threads, the read queue is already full, or reads
+        have recently been fast enough that waiting for them costs less
+        than handing them off. A later fetch finds the object in the
+        positive cache.
+
+        @note This can be called concurrently.
+        @param hash The key of the object to read.
+    */
+    virtual void prefetch (uint256 const& hash) = 0;
+
+    /** Fetch an object and pass its payload to a callback.
+        This works like fetch, except that an object read from the backend
+        is handed to the callback straight from the backend's buffer. The
+        object is only kept in the positive cache, which costs a copy, if
+        `cache` is `true`. Callers that keep their own cache of whatever
+        they decode from the payload can skip it.
+
+        @note This can be called concurrently.
+        @param hash The key of the object to retrieve.
+        @param f The callback to receive the payload.
+        @param cache Whether to cache an object read from the backend.
+        @return `true` if the object was found and passed to the callback.
+    */
+    virtual bool fetchPayload (uint256 const& hash,
+        FetchCallback const& f, bool cache) = 0;
+
     /** Wait for all currently pending async reads to complete.
     */
     virtual void waitReads () = 0;
@@ -129,6 +160,10 @@ public:
     /** Get the positive cache hits to total attempts ratio. */
     virtual float getCacheHitRate () = 0;
 
+    /** Get the positive cache size and its hit and miss counts. */
+    virtual void getCacheStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) = 0;
+
     /** Set the maximum number of entries and maximum cache age for both caches.
 
         @param size Number of cache entries (0 = ignore)
@@ -147,6 +182,12 @@ public:
     virtual std::uint32_t getFetchHitCount () const = 0;
     virtual std::uint32_t getStoreSize () const = 0;
     virtual std::uint32_t getFetchSize () const = 0;
+
+    /** Add the read and write statistics to a get_counts report.
+        Databases with more than one storage tier also report how
+        often each tier answered a read.
+    */
+    virtual void getCountsJson (Json::Value& obj) = 0;
 };
 
 }
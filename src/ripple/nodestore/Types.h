@@ -22,6 +22,8 @@
 
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/basics/BasicConfig.h>
+#include <cstddef>
+#include <functional>
 #include <vector>
 
 namespace ripple {
@@ -48,6 +50,13 @@ enum Status
 
 /** A batch of NodeObjects to write at once. */
 using Batch = std::vector <std::shared_ptr<NodeObject>>;
+
+/** Receives the type and payload of a fetched object.
+    The payload is not owned by the callback and is only
+    valid for the duration of the call.
+*/
+using FetchCallback = std::function <
+    void (NodeObjectType type, void const* data, std::size_t size)>;
 }
 }
 
@@ -128,6 +128,17 @@ public:
         return ok;
     }
 
+    Status
+    fetchPayload (void const* key, FetchCallback const& f) override
+    {
+        std::shared_ptr<NodeObject> object;
+        Status const status = fetch (key, &object);
+        if (status == ok)
+            f (object->getType (), object->getData ().data (),
+                object->getData ().size ());
+        return status;
+    }
+
     bool
     canFetchBatch() override
     {
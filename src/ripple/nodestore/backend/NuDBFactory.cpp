@@ -67,6 +67,7 @@ public:
         : journal_ (journal)
         , keyBytes_ (keyBytes)
         , name_ (get<std::string>(keyValues, "path"))
+        , db_ (nodeobject_codec (read_dictionaries (name_)))
         , deletePath_(false)
         , scheduler_ (scheduler)
     {
@@ -148,6 +149,28 @@ public:
         return status;
     }
 
+    Status
+    fetchPayload (void const* key, FetchCallback const& f) override
+    {
+        Status status;
+        if (! db_.fetch (key,
+            [key, &f, &status](void const* data, std::size_t size)
+            {
+                DecodedBlob decoded (key, data, size);
+                if (! decoded.wasOk ())
+                {
+                    status = dataCorrupt;
+                    return;
+                }
+                decoded.visit (f);
+                status = ok;
+            }))
+        {
+            return notFound;
+        }
+        return status;
+    }
+
     bool
     canFetchBatch() override
     {
@@ -208,7 +231,7 @@ public:
         auto const lp = db_.log_path();
         //auto const appnum = db_.appnum();
         db_.close();
-        api::visit (dp,
+        api::visit (dp, db_.codec(),
             [&](
                 void const* key, std::size_t key_bytes,
                 void const* data, std::size_t size)
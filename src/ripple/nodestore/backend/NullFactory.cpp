@@ -53,6 +53,12 @@ public:
         return notFound;
     }
 
+    Status
+    fetchPayload (void const*, FetchCallback const&) override
+    {
+        return notFound;
+    }
+
     bool
     canFetchBatch() override
     {
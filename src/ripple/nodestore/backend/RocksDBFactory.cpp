@@ -221,6 +221,29 @@ public:
     {
         pObject->reset ();
 
+        return fetchDecoded (key,
+            [pObject](DecodedBlob& decoded)
+            {
+                *pObject = decoded.createObject ();
+            });
+    }
+
+    Status
+    fetchPayload (void const* key, FetchCallback const& f) override
+    {
+        return fetchDecoded (key,
+            [&f](DecodedBlob& decoded)
+            {
+                decoded.visit (f);
+            });
+    }
+
+    // Passes the decoded value to the handler, which
+    // must be done with it by the time this returns
+    template <class Handler>
+    Status
+    fetchDecoded (void const* key, Handler&& handler)
+    {
         Status status (ok);
 
         rocksdb::ReadOptions const options;
@@ -236,7 +259,7 @@ public:
 
             if (decoded.wasOk ())
             {
-                *pObject = decoded.createObject ();
+                handler (decoded);
             }
             else
             {
@@ -29,6 +29,7 @@
 #include <ripple/basics/SHA512Half.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/TaggedCache.h>
+#include <ripple/protocol/JsonFields.h>
 #include <beast/threads/Thread.h>
 #include <ripple/nodestore/ScopedMetrics.h>
 #include <chrono>
@@ -48,6 +49,11 @@ private:
     // Persistent key/value storage.
     std::unique_ptr <Backend> m_backend;
 protected:
+    Backend& getBackend ()
+    {
+        return *m_backend;
+    }
+
     // Positive cache
     TaggedCache <uint256, NodeObject> m_cache;
 
@@ -82,6 +88,7 @@ public:
         , m_fetchHitCount (0)
         , m_storeSize (0)
         , m_fetchSize (0)
+        , m_readLatency (0)
     {
         for (int i = 0; i < readThreads; ++i)
             m_readThreads.push_back (std::thread (&DatabaseImp::threadEntry,
@@ -136,6 +143,41 @@ public:
         return false;
     }
 
+    void prefetch (uint256 const& hash) override
+    {
+        // Handing a read to another thread only pays when the
+        // backend is slow enough to keep the caller waiting.
+        if (m_readThreads.empty () || m_readLatency < prefetchLatency)
+            return;
+
+        if (m_cache.refreshIfPresent (hash) ||
+                m_negCache.touch_if_exists (hash))
+            return;
+
+        std::unique_lock <std::mutex> lock (m_readLock);
+        if (m_readSet.size () < prefetchWindow &&
+                m_readSet.insert (hash).second)
+            m_readCondVar.notify_one ();
+    }
+
+    // Keep a moving average of the time the backend takes to read
+    void updateReadLatency (std::chrono::steady_clock::time_point start)
+    {
+        using namespace std::chrono;
+        auto const elapsed = std::min <std::uint64_t> (
+            duration_cast <microseconds> (steady_clock::now() - start).count(),
+            1000000);
+        m_readLatency = static_cast <std::uint32_t> (
+            (m_readLatency * 7 + elapsed) / 8);
+    }
+
+    // Remove a read that has not started yet
+    void cancelRead (uint256 const& hash)
+    {
+        std::unique_lock <std::mutex> lock (m_readLock);
+        m_readSet.erase (hash);
+    }
+
     void waitReads() override
     {
         {
@@ -165,6 +207,69 @@ public:
         return doTimedFetch (hash, false);
     }
 
+    bool fetchPayload (uint256 const& hash,
+        FetchCallback const& f, bool cache) override
+    {
+        ScopedMetrics::incrementThreadFetches ();
+
+        if (cache)
+        {
+            std::shared_ptr<NodeObject> obj = doTimedFetch (hash, false);
+
+            if (obj == nullptr)
+                return false;
+
+            f (obj->getType (), obj->getData ().data (),
+                obj->getData ().size ());
+            return true;
+        }
+
+        FetchReport report;
+        report.isAsync = false;
+        report.wentToDisk = false;
+
+        auto const before = std::chrono::steady_clock::now();
+        bool found = false;
+
+        // The positive cache may still have it from a prefetch or a store
+        std::shared_ptr<NodeObject> obj = m_cache.fetch (hash);
+
+        if (obj == nullptr && ! m_negCache.touch_if_exists (hash))
+        {
+            report.wentToDisk = true;
+
+            cancelRead (hash);
+            auto const start = std::chrono::steady_clock::now();
+            found = fetchPayloadFrom (hash, f);
+            updateReadLatency (start);
+            ++m_fetchTotalCount;
+
+            if (! found)
+            {
+                // Just in case a write occurred
+                obj = m_cache.fetch (hash);
+
+                if (obj == nullptr)
+                    m_negCache.insert (hash);
+            }
+        }
+
+        if (obj != nullptr)
+        {
+            f (obj->getType (), obj->getData ().data (),
+                obj->getData ().size ());
+            found = true;
+        }
+
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before);
+
+        report.wasFound = found;
+        m_scheduler.onFetch (report);
+
+        return found;
+    }
+
     /** Perform a fetch and report the time it took */
     std::shared_ptr<NodeObject> doTimedFetch (uint256 const& hash, bool isAsync)
     {
@@ -203,9 +308,15 @@ public:
         //
         if (obj == nullptr)
         {
+            // An async read would only repeat this one
+            if (! report.isAsync)
+                cancelRead (hash);
+
             // Yes so at last we will try the main database.
             //
+            auto const start = std::chrono::steady_clock::now();
             obj = fetchFrom (hash);
+            updateReadLatency (start);
             ++m_fetchTotalCount;
         }
 
@@ -273,6 +384,48 @@ public:
         return object;
     }
 
+    virtual bool fetchPayloadFrom (uint256 const& hash,
+        FetchCallback const& f)
+    {
+        return fetchPayloadInternal (*m_backend, hash, f);
+    }
+
+    bool fetchPayloadInternal (Backend& backend,
+        uint256 const& hash, FetchCallback const& f)
+    {
+        std::size_t size = 0;
+
+        Status const status = backend.fetchPayload (hash.begin (),
+            [&f, &size](NodeObjectType type, void const* data, std::size_t bytes)
+            {
+                size = bytes;
+                f (type, data, bytes);
+            });
+
+        switch (status)
+        {
+        case ok:
+            ++m_fetchHitCount;
+            m_fetchSize += size;
+            return true;
+
+        case notFound:
+            break;
+
+        case dataCorrupt:
+            if (m_journal.fatal) m_journal.fatal <<
+                "Corrupt NodeObject #" << hash;
+            break;
+
+        default:
+            if (m_journal.warning) m_journal.warning <<
+                "Unknown status=" << status;
+            break;
+        }
+
+        return false;
+    }
+
     //------------------------------------------------------------------------------
 
     void store (NodeObjectType type,
@@ -282,10 +435,10 @@ public:
         storeInternal (type, std::move(data), hash, *m_backend.get());
     }
 
-    void storeInternal (NodeObjectType type,
-                        Blob&& data,
-                        uint256 const& hash,
-                        Backend& backend)
+    std::shared_ptr<NodeObject> storeInternal (NodeObjectType type,
+                                               Blob&& data,
+                                               uint256 const& hash,
+                                               Backend& backend)
     {
         #if RIPPLE_VERIFY_NODEOBJECT_KEYS
         assert (hash == sha512Hash(make_Slice(data)));
@@ -302,6 +455,15 @@ public:
             m_storeSize += object->getData().size();
 
         m_negCache.erase (hash);
+
+        return object;
+    }
+
+    // Count a read answered without going to a backend
+    void countFetchHit (NodeObject const& object)
+    {
+        ++m_fetchHitCount;
+        m_fetchSize += object.getData().size();
     }
 
     //------------------------------------------------------------------------------
@@ -311,6 +473,12 @@ public:
         return m_cache.getHitRate ();
     }
 
+    void getCacheStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) override
+    {
+        m_cache.getStats (size, hits, misses);
+    }
+
     void tune (int size, int age)
     {
         m_cache.setTargetSize (size);
@@ -435,12 +603,24 @@ public:
         return m_fetchSize;
     }
 
+    void getCountsJson (Json::Value& obj) override
+    {
+        obj[jss::node_writes] = getStoreCount();
+        obj[jss::node_reads_total] = getFetchTotalCount();
+        obj[jss::node_reads_hit] = getFetchHitCount();
+        obj[jss::node_written_bytes] = getStoreSize();
+        obj[jss::node_read_bytes] = getFetchSize();
+    }
+
 private:
     std::atomic <std::uint32_t> m_storeCount;
     std::atomic <std::uint32_t> m_fetchTotalCount;
     std::atomic <std::uint32_t> m_fetchHitCount;
     std::atomic <std::uint32_t> m_storeSize;
     std::atomic <std::uint32_t> m_fetchSize;
+
+    // Average backend read time in microseconds
+    std::atomic <std::uint32_t> m_readLatency;
 };
 
 }
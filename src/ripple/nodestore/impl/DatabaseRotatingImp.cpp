@@ -50,6 +50,26 @@ std::shared_ptr<NodeObject> DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 
     return object;
 }
+
+bool DatabaseRotatingImp::fetchPayloadFrom (uint256 const& hash,
+    FetchCallback const& f)
+{
+    Backends b = getBackends();
+    if (fetchPayloadInternal (*b.writableBackend, hash, f))
+        return true;
+
+    // Copying forward from the archive needs a NodeObject anyway
+    std::shared_ptr<NodeObject> object = fetchInternal (*b.archiveBackend, hash);
+    if (!object)
+        return false;
+
+    getWritableBackend()->store (object);
+    m_negCache.erase (hash);
+
+    f (object->getType (), object->getData ().data (),
+        object->getData ().size ());
+    return true;
+}
 }
 
 }
@@ -121,6 +121,9 @@ public:
     }
 
     std::shared_ptr<NodeObject> fetchFrom (uint256 const& hash) override;
+
+    bool fetchPayloadFrom (uint256 const& hash,
+        FetchCallback const& f) override;
     TaggedCache <uint256, NodeObject>& getPositiveCache() override
     {
         return m_cache;
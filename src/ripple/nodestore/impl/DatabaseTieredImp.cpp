@@ -0,0 +1,322 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
+#include <ripple/nodestore/Manager.h>
+#include <beast/cxx14/memory.h> // <memory>
+#include <boost/filesystem/operations.hpp>
+
+namespace ripple {
+namespace NodeStore {
+
+// Generations of the SSD tier live in subdirectories with this prefix
+static char const* const ssdPrefix = "tier.";
+
+static
+double
+hitRate (std::uint64_t hits, std::uint64_t lookups)
+{
+    return lookups == 0 ? 0.0 : static_cast <double> (hits) / lookups;
+}
+
+DatabaseTieredImp::DatabaseTieredImp (std::string const& name,
+                                      Scheduler& scheduler,
+                                      int readThreads,
+                                      std::unique_ptr <Backend> backend,
+                                      Setup const& setup,
+                                      Section const& backendParameters,
+                                      beast::Journal journal)
+    : DatabaseImp (name, scheduler, readThreads, std::move (backend), journal)
+    , scheduler_ (scheduler)
+    , journal_ (journal)
+    , hot_ (setup.hotBytes)
+    , ssdParameters_ (backendParameters)
+    , ssdPath_ (setup.ssdPath)
+    , ssdObjects_ (std::max <std::size_t> (setup.ssdObjects, 2))
+    , ssdWrites_ (0)
+    , ssdLookups_ (0)
+    , ssdHits_ (0)
+    , ssdStored_ (0)
+    , ssdRotations_ (0)
+    , coldLookups_ (0)
+    , coldHits_ (0)
+{
+    if (! hasSsd ())
+        return;
+
+    if (! setup.ssdType.empty ())
+        ssdParameters_.set ("type", setup.ssdType);
+
+    // Whatever a previous run left behind is stale
+    using namespace boost::filesystem;
+    create_directories (ssdPath_);
+    for (directory_iterator iter (ssdPath_), end; iter != end; ++iter)
+    {
+        if (iter->path ().filename ().string ().compare (
+                0, std::strlen (ssdPrefix), ssdPrefix) == 0)
+            remove_all (iter->path ());
+    }
+
+    ssdCurrent_ = makeSsdBackend ();
+    demoter_ = std::make_unique <BatchWriter> (
+        static_cast <BatchWriter::Callback&> (*this), scheduler_);
+}
+
+std::shared_ptr <Backend>
+DatabaseTieredImp::makeSsdBackend ()
+{
+    Section parameters (ssdParameters_);
+    parameters.set ("path", boost::filesystem::unique_path (
+        ssdPath_ / (std::string (ssdPrefix) + "%%%%-%%%%")).string ());
+
+    return make_Backend (parameters, scheduler_, journal_);
+}
+
+void
+DatabaseTieredImp::close ()
+{
+    // Waits for the pending demotions
+    demoter_.reset ();
+
+    {
+        std::lock_guard <std::mutex> lock (ssdMutex_);
+        if (ssdCurrent_)
+            ssdCurrent_->close ();
+        if (ssdPrevious_)
+            ssdPrevious_->close ();
+    }
+
+    DatabaseImp::close ();
+}
+
+void
+DatabaseTieredImp::store (NodeObjectType type,
+                          Blob&& data,
+                          uint256 const& hash)
+{
+    std::shared_ptr<NodeObject> object = storeInternal (
+        type, std::move (data), hash, getBackend ());
+
+    // A new object earns its way to the SSD tier by being read
+    Batch demoted;
+    hot_.insert (object, false, demoted);
+    demote (demoted);
+}
+
+std::shared_ptr<NodeObject>
+DatabaseTieredImp::fetchSsd (uint256 const& hash)
+{
+    if (! hasSsd ())
+        return nullptr;
+
+    std::shared_ptr <Backend> current;
+    std::shared_ptr <Backend> previous;
+    {
+        std::lock_guard <std::mutex> lock (ssdMutex_);
+        current = ssdCurrent_;
+        previous = ssdPrevious_;
+    }
+
+    ++ssdLookups_;
+    std::shared_ptr<NodeObject> object = fetchInternal (*current, hash);
+    if (! object && previous)
+        object = fetchInternal (*previous, hash);
+
+    if (object)
+        ++ssdHits_;
+
+    return object;
+}
+
+std::shared_ptr<NodeObject>
+DatabaseTieredImp::fetchFrom (uint256 const& hash)
+{
+    std::shared_ptr<NodeObject> object = hot_.fetch (hash);
+    if (object)
+    {
+        countFetchHit (*object);
+        return object;
+    }
+
+    Batch demoted;
+    object = fetchSsd (hash);
+    if (object)
+    {
+        hot_.insert (object, true, demoted);
+    }
+    else
+    {
+        ++coldLookups_;
+        object = DatabaseImp::fetchFrom (hash);
+        if (object)
+        {
+            ++coldHits_;
+            hot_.insert (object, false, demoted);
+        }
+    }
+
+    demote (demoted);
+    return object;
+}
+
+bool
+DatabaseTieredImp::fetchPayloadFrom (uint256 const& hash,
+    FetchCallback const& f)
+{
+    std::shared_ptr<NodeObject> object = hot_.fetch (hash);
+    if (object)
+    {
+        countFetchHit (*object);
+    }
+    else if ((object = fetchSsd (hash)))
+    {
+        Batch demoted;
+        hot_.insert (object, true, demoted);
+        demote (demoted);
+    }
+
+    if (object)
+    {
+        f (object->getType (), object->getData ().data (),
+            object->getData ().size ());
+        return true;
+    }
+
+    // The caller asked not to cache, so the cold read is not admitted
+    ++coldLookups_;
+    if (! DatabaseImp::fetchPayloadFrom (hash, f))
+        return false;
+
+    ++coldHits_;
+    return true;
+}
+
+void
+DatabaseTieredImp::demote (Batch const& demoted)
+{
+    if (! demoter_)
+        return;
+
+    for (auto const& object : demoted)
+        demoter_->store (object);
+}
+
+void
+DatabaseTieredImp::writeBatch (Batch const& batch)
+{
+    std::shared_ptr <Backend> current;
+    {
+        std::lock_guard <std::mutex> lock (ssdMutex_);
+        current = ssdCurrent_;
+    }
+
+    current->storeBatch (batch);
+    ssdStored_ += batch.size ();
+
+    if ((ssdWrites_ += batch.size ()) >= ssdObjects_ / 2)
+        rotateSsd ();
+}
+
+void
+DatabaseTieredImp::rotateSsd ()
+{
+    std::shared_ptr <Backend> fresh;
+
+    try
+    {
+        fresh = makeSsdBackend ();
+    }
+    catch (std::exception const& e)
+    {
+        if (journal_.warning) journal_.warning <<
+            "Unable to rotate the SSD tier: " << e.what ();
+        ssdWrites_ = 0;
+        return;
+    }
+
+    std::shared_ptr <Backend> retired;
+    {
+        std::lock_guard <std::mutex> lock (ssdMutex_);
+        retired = std::move (ssdPrevious_);
+        ssdPrevious_ = std::move (ssdCurrent_);
+        ssdCurrent_ = std::move (fresh);
+    }
+
+    ssdWrites_ = 0;
+    ++ssdRotations_;
+
+    // The files go when the last reader lets go of the backend
+    if (retired)
+        retired->setDeletePath ();
+}
+
+void
+DatabaseTieredImp::getCountsJson (Json::Value& obj)
+{
+    DatabaseImp::getCountsJson (obj);
+
+    Json::Value& tiers = obj[jss::node_tiers] = Json::objectValue;
+
+    Json::Value& hot = tiers[jss::hot] = Json::objectValue;
+    hot_.getJson (hot);
+
+    if (hasSsd ())
+    {
+        std::uint64_t const lookups = ssdLookups_;
+        std::uint64_t const hits = ssdHits_;
+
+        Json::Value& ssd = tiers[jss::ssd] = Json::objectValue;
+        ssd[jss::lookups] = static_cast <Json::UInt> (lookups);
+        ssd[jss::hits] = static_cast <Json::UInt> (hits);
+        ssd[jss::hit_rate] = hitRate (hits, lookups);
+        ssd[jss::stored] = static_cast <Json::UInt> (ssdStored_);
+        ssd[jss::rotations] = static_cast <Json::UInt> (ssdRotations_);
+    }
+
+    std::uint64_t const lookups = coldLookups_;
+    std::uint64_t const hits = coldHits_;
+
+    Json::Value& cold = tiers[jss::cold] = Json::objectValue;
+    cold[jss::lookups] = static_cast <Json::UInt> (lookups);
+    cold[jss::hits] = static_cast <Json::UInt> (hits);
+    cold[jss::hit_rate] = hitRate (hits, lookups);
+}
+
+//------------------------------------------------------------------------------
+
+DatabaseTieredImp::Setup
+setup_DatabaseTiered (Section const& section)
+{
+    DatabaseTieredImp::Setup setup;
+
+    std::size_t megabytes = 0;
+    if (get_if_exists (section, "hot_mb", megabytes))
+        setup.hotBytes = megabytes * 1024 * 1024;
+
+    get_if_exists (section, "ssd_path", setup.ssdPath);
+    get_if_exists (section, "ssd_type", setup.ssdType);
+    get_if_exists (section, "ssd_objects", setup.ssdObjects);
+
+    return setup;
+}
+
+}
+}
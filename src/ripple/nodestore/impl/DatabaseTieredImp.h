@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+#define RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+
+#include <ripple/nodestore/impl/BatchWriter.h>
+#include <ripple/nodestore/impl/DatabaseImp.h>
+#include <ripple/nodestore/impl/HotTier.h>
+#include <ripple/basics/BasicConfig.h>
+#include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A database that keeps recently used objects in faster tiers.
+
+    Reads try, in order:
+
+    - The hot tier, a memory budgeted set of decoded objects.
+    - The optional SSD tier, a local backend holding objects the hot
+      tier evicted after they had been read more than once.
+    - The configured backend, which holds every object.
+
+    A hit in the SSD tier promotes the object back to the hot tier.
+    The SSD tier is a cache: it is bounded by writing to a new backend
+    once the current one holds half the configured number of objects,
+    deleting the oldest, and it is emptied when the server starts.
+
+    Demoted objects are written, and the SSD tier rotated, by a task on
+    the Scheduler, so a fetch or store never waits for the SSD tier.
+*/
+class DatabaseTieredImp
+    : public DatabaseImp
+    , private BatchWriter::Callback
+{
+public:
+    struct Setup
+    {
+        // Byte budget of the hot tier, zero to disable tiering
+        std::size_t hotBytes = 0;
+
+        // Directory of the SSD tier, empty to disable it
+        std::string ssdPath;
+
+        // Backend type of the SSD tier, defaults to the [node_db] type
+        std::string ssdType;
+
+        // Objects the SSD tier holds before the oldest are deleted
+        std::size_t ssdObjects = 10000000;
+    };
+
+    DatabaseTieredImp (std::string const& name,
+                       Scheduler& scheduler,
+                       int readThreads,
+                       std::unique_ptr <Backend> backend,
+                       Setup const& setup,
+                       Section const& backendParameters,
+                       beast::Journal journal);
+
+    void
+    close () override;
+
+    void store (NodeObjectType type,
+                Blob&& data,
+                uint256 const& hash) override;
+
+    std::shared_ptr<NodeObject> fetchFrom (uint256 const& hash) override;
+
+    bool fetchPayloadFrom (uint256 const& hash,
+        FetchCallback const& f) override;
+
+    void getCountsJson (Json::Value& obj) override;
+
+private:
+    bool
+    hasSsd () const
+    {
+        return ! ssdPath_.empty ();
+    }
+
+    std::shared_ptr <Backend>
+    makeSsdBackend ();
+
+    std::shared_ptr<NodeObject>
+    fetchSsd (uint256 const& hash);
+
+    void
+    demote (Batch const& demoted);
+
+    void
+    writeBatch (Batch const& batch) override;
+
+    void
+    rotateSsd ();
+
+    Scheduler& scheduler_;
+    beast::Journal journal_;
+
+    HotTier hot_;
+
+    Section ssdParameters_;
+    boost::filesystem::path ssdPath_;
+    std::size_t const ssdObjects_;
+
+    std::mutex ssdMutex_;
+    std::shared_ptr <Backend> ssdCurrent_;
+    std::shared_ptr <Backend> ssdPrevious_;
+    std::unique_ptr <BatchWriter> demoter_;
+
+    // Only touched by the demoter's task
+    std::size_t ssdWrites_;
+
+    std::atomic <std::uint64_t> ssdLookups_;
+    std::atomic <std::uint64_t> ssdHits_;
+    std::atomic <std::uint64_t> ssdStored_;
+    std::atomic <std::uint64_t> ssdRotations_;
+    std::atomic <std::uint64_t> coldLookups_;
+    std::atomic <std::uint64_t> coldHits_;
+};
+
+/** Read the tier settings from the [node_db] section. */
+DatabaseTieredImp::Setup
+setup_DatabaseTiered (Section const& section);
+
+}
+}
+
+#endif
@@ -88,5 +88,13 @@ std::shared_ptr<NodeObject> DecodedBlob::createObject ()
     return object;
 }
 
+void DecodedBlob::visit (FetchCallback const& f) const
+{
+    bassert (m_success);
+
+    if (m_success)
+        f (m_objectType, m_objectData, m_dataBytes);
+}
+
 }
 }
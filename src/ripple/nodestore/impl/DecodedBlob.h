@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_DECODEDBLOB_H_INCLUDED
 
 #include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/Types.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -47,6 +48,9 @@ public:
     /** Create a NodeObject from this data. */
     std::shared_ptr<NodeObject> createObject ();
 
+    /** Pass the type and payload, without copying, to a callback. */
+    void visit (FetchCallback const& f) const;
+
 private:
     bool m_success;
 
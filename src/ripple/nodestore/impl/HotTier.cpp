@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/HotTier.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+namespace NodeStore {
+
+HotTier::HotTier (std::size_t budgetBytes)
+    : budget_ (budgetBytes)
+    , hits_ (0)
+    , misses_ (0)
+    , evicted_ (0)
+    , demoted_ (0)
+{
+}
+
+HotTier::Shard&
+HotTier::getShard (uint256 const& hash)
+{
+    // The key is already a cryptographic hash
+    return shards_[hash.begin ()[0] % hotTierShards];
+}
+
+std::shared_ptr <NodeObject>
+HotTier::fetch (uint256 const& hash)
+{
+    Shard& shard = getShard (hash);
+    std::lock_guard <std::mutex> lock (shard.mutex);
+
+    auto const iter = shard.index.find (hash);
+    if (iter == shard.index.end ())
+    {
+        ++misses_;
+        return nullptr;
+    }
+
+    Slot& slot = shard.ring[iter->second];
+    if (slot.count < hotMaxCount)
+        ++slot.count;
+    slot.used = true;
+    ++hits_;
+    return slot.object;
+}
+
+void
+HotTier::insert (std::shared_ptr <NodeObject> const& object,
+    bool used, Demoted& demoted)
+{
+    std::size_t const need = cost (*object);
+    std::size_t const limit = budget_ / hotTierShards;
+
+    // An object larger than a whole shard would only flush it
+    if (need > limit)
+        return;
+
+    Shard& shard = getShard (object->getHash ());
+    std::lock_guard <std::mutex> lock (shard.mutex);
+
+    auto const iter = shard.index.find (object->getHash ());
+    if (iter != shard.index.end ())
+    {
+        Slot& slot = shard.ring[iter->second];
+        slot.used = slot.used || used;
+        return;
+    }
+
+    while (shard.bytes + need > limit && ! shard.index.empty ())
+        evictOne (shard, demoted);
+
+    std::size_t pos;
+    if (shard.free.empty ())
+    {
+        pos = shard.ring.size ();
+        shard.ring.push_back (Slot ());
+    }
+    else
+    {
+        pos = shard.free.back ();
+        shard.free.pop_back ();
+    }
+
+    Slot& slot = shard.ring[pos];
+    slot.object = object;
+    slot.count = used ? 1 : 0;
+    slot.used = used;
+    shard.index.emplace (object->getHash (), pos);
+    shard.bytes += need;
+}
+
+void
+HotTier::evictOne (Shard& shard, Demoted& demoted)
+{
+    for (;;)
+    {
+        if (shard.hand >= shard.ring.size ())
+            shard.hand = 0;
+
+        Slot& slot = shard.ring[shard.hand];
+
+        if (! slot.object)
+        {
+            ++shard.hand;
+        }
+        else if (slot.count > 0)
+        {
+            --slot.count;
+            ++shard.hand;
+        }
+        else
+        {
+            shard.index.erase (slot.object->getHash ());
+            shard.bytes -= cost (*slot.object);
+            ++evicted_;
+
+            if (slot.used)
+            {
+                demoted.push_back (std::move (slot.object));
+                ++demoted_;
+            }
+
+            slot.object.reset ();
+            shard.free.push_back (shard.hand);
+            ++shard.hand;
+            return;
+        }
+    }
+}
+
+void
+HotTier::setBudget (std::size_t budgetBytes)
+{
+    budget_ = budgetBytes;
+}
+
+std::size_t
+HotTier::size () const
+{
+    std::size_t n = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard <std::mutex> lock (shard.mutex);
+        n += shard.index.size ();
+    }
+    return n;
+}
+
+std::size_t
+HotTier::bytes () const
+{
+    std::size_t n = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard <std::mutex> lock (shard.mutex);
+        n += shard.bytes;
+    }
+    return n;
+}
+
+void
+HotTier::getJson (Json::Value& obj) const
+{
+    std::uint64_t const hits = hits_;
+    std::uint64_t const lookups = hits + misses_;
+
+    obj[jss::objects] = static_cast <Json::UInt> (size ());
+    obj[jss::bytes] = static_cast <Json::UInt> (bytes ());
+    obj[jss::budget] = static_cast <Json::UInt> (budget_);
+    obj[jss::lookups] = static_cast <Json::UInt> (lookups);
+    obj[jss::hits] = static_cast <Json::UInt> (hits);
+    obj[jss::hit_rate] = lookups == 0 ? 0.0 :
+        static_cast <double> (hits) / lookups;
+    obj[jss::evicted] = static_cast <Json::UInt> (evicted_);
+    obj[jss::demoted] = static_cast <Json::UInt> (demoted_);
+}
+
+}
+}
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_HOTTIER_H_INCLUDED
+#define RIPPLE_NODESTORE_HOTTIER_H_INCLUDED
+
+#include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/Types.h>
+#include <ripple/nodestore/impl/Tuning.h>
+#include <ripple/basics/flat_hash_map.h>
+#include <ripple/json/json_value.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A memory budgeted set of decoded node objects.
+
+    The tier sits between the positive cache and the backends. It holds
+    objects as they came out of the backend, so a hit costs neither a read
+    nor a decode, and it is bounded by bytes rather than by entry count.
+
+    Replacement uses the CLOCK algorithm with a small access count per
+    object: each hit raises the count, and the hand lowers it as it passes,
+    so an object must go unused for several sweeps before it is evicted.
+    Objects that were hit at least once while resident are handed back to
+    the caller when evicted so they can be demoted to a slower tier.
+
+    @note All members can be called concurrently.
+*/
+class HotTier
+{
+public:
+    using Demoted = Batch;
+
+    explicit
+    HotTier (std::size_t budgetBytes);
+
+    HotTier (HotTier const&) = delete;
+    HotTier& operator= (HotTier const&) = delete;
+
+    /** Return the object, or nullptr if it is not resident. */
+    std::shared_ptr <NodeObject>
+    fetch (uint256 const& hash);
+
+    /** Add an object, evicting others to stay within the budget.
+
+        @param object The object to add.
+        @param used `true` if the object has already been accessed since
+                    it was read from a backend, which makes it a candidate
+                    for demotion when it is evicted.
+        @param demoted Receives evicted objects worth keeping.
+    */
+    void
+    insert (std::shared_ptr <NodeObject> const& object,
+        bool used, Demoted& demoted);
+
+    /** Change the byte budget.
+        A smaller budget takes effect as objects are inserted.
+    */
+    void
+    setBudget (std::size_t budgetBytes);
+
+    std::size_t
+    getBudget () const
+    {
+        return budget_;
+    }
+
+    std::size_t
+    size () const;
+
+    std::size_t
+    bytes () const;
+
+    void
+    getJson (Json::Value& obj) const;
+
+private:
+    struct Slot
+    {
+        std::shared_ptr <NodeObject> object;
+        std::uint8_t count;
+        bool used;
+    };
+
+    struct Shard
+    {
+        std::mutex mutable mutex;
+        flat_hash_map <uint256, std::size_t> index;
+        std::vector <Slot> ring;
+        std::vector <std::size_t> free;
+        std::size_t hand = 0;
+        std::size_t bytes = 0;
+    };
+
+    static
+    std::size_t
+    cost (NodeObject const& object)
+    {
+        return object.getData ().size () + hotEntryOverhead;
+    }
+
+    Shard&
+    getShard (uint256 const& hash);
+
+    // Advance the hand until one object is evicted. Requires the lock.
+    void
+    evictOne (Shard& shard, Demoted& demoted);
+
+    std::atomic <std::size_t> budget_;
+    std::array <Shard, hotTierShards> shards_;
+
+    std::atomic <std::uint64_t> hits_;
+    std::atomic <std::uint64_t> misses_;
+    std::atomic <std::uint64_t> evicted_;
+    std::atomic <std::uint64_t> demoted_;
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include <ripple/nodestore/impl/ManagerImp.h>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
 #include <ripple/basics/StringUtilities.h>
 #include <beast/utility/ci_char_traits.h>
 #include <beast/cxx14/memory.h> // <memory>
@@ -96,6 +97,12 @@ ManagerImp::make_Database (
     std::unique_ptr <Backend> backend (make_Backend (
         backendParameters, scheduler, journal));
 
+    auto const tiers = setup_DatabaseTiered (backendParameters);
+    if (tiers.hotBytes != 0)
+        return std::make_unique <DatabaseTieredImp> (name, scheduler,
+            readThreads, std::move (backend), tiers, backendParameters,
+                journal);
+
     return std::make_unique <DatabaseImp> (name, scheduler, readThreads,
         std::move (backend), journal);
 }
@@ -33,6 +33,23 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Most reads queued before prefetch hints are dropped
+    ,prefetchWindow = 256
+
+    // Average read time, in microseconds, below which the backend
+    // is treated as being served from memory and prefetch is skipped
+    ,prefetchLatency = 20
+
+    // Bytes charged against the hot tier budget for each object
+    // in addition to its payload
+    ,hotEntryOverhead = 160
+
+    // Number of independently locked partitions of the hot tier
+    ,hotTierShards = 16
+
+    // Highest access count the hot tier keeps for an object
+    ,hotMaxCount = 3
 };
 
 }
@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_CODEC_H_INCLUDED
 
 #include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/impl/dictionary.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <beast/nudb/common.h>
 #include <beast/nudb/detail/field.h>
@@ -29,6 +30,7 @@
 #include <snappy.h>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <utility>
 
 namespace ripple {
@@ -138,12 +140,14 @@ lz4_compress (void const* in,
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = lz4 compressed against a dictionary
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_decompress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        nodeobject_dictionaries const* dicts = nullptr)
 {
     using beast::nudb::codec_error;
     using namespace beast::nudb::detail;
@@ -234,6 +238,33 @@ nodeobject_decompress (void const* in,
         write(os, is(512), 512);
         break;
     }
+    case 4: // lz4 with dictionary
+    {
+        std::size_t version;
+        auto const n0 = read_varint(
+            p, in_size, version);
+        if (n0 == 0)
+            throw codec_error(
+                "nodeobject codec: short dictionary object");
+        auto const n1 = read_varint(
+            p + n0, in_size - n0, result.second);
+        if (n1 == 0)
+            throw codec_error(
+                "nodeobject codec: short dictionary object");
+        if (! dicts || version == 0 ||
+                version > dicts->size())
+            throw codec_error(
+                "nodeobject codec: missing dictionary=" +
+                    std::to_string(version));
+        void* const out = bf(result.second);
+        result.first = out;
+        if (! (*dicts)[version - 1]->decompress(
+                p + n0 + n1, in_size - n0 - n1,
+                    out, result.second))
+            throw codec_error(
+                "nodeobject codec: dictionary decompress");
+        break;
+    }
     default:
         throw codec_error(
             "nodeobject codec: bad type=" +
@@ -259,12 +290,14 @@ zero32()
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_compress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        nodeobject_dictionaries const* dicts = nullptr)
 {
     using beast::nudb::codec_error;
     using namespace beast::nudb::detail;
 
-    std::size_t type = 1;
+    std::size_t type =
+        (dicts && ! dicts->empty()) ? 4 : 1;
     // Check for inner node
     if (in_size == 525)
     {
@@ -365,6 +398,29 @@ nodeobject_compress (void const* in,
         result.second = vn + lzr.second;
         break;
     }
+    case 4: // lz4 with dictionary
+    {
+        // The newest dictionary compresses new objects
+        auto const& dict = *dicts->back();
+        auto const vv = size_varint(
+            std::size_t(dict.version()));
+        auto const vs = size_varint(in_size);
+        auto const out_max =
+            LZ4_compressBound(in_size);
+        std::uint8_t* p = reinterpret_cast<
+            std::uint8_t*>(bf(vn + vv + vs + out_max));
+        result.first = p;
+        std::memcpy(p, vi.data(), vn);
+        write_varint(p + vn, dict.version());
+        write_varint(p + vn + vv, in_size);
+        auto const out_size = dict.compress(in, in_size,
+            p + vn + vv + vs, out_max);
+        if (out_size == 0)
+            throw codec_error(
+                "nodeobject codec: dictionary compress");
+        result.second = vn + vv + vs + out_size;
+        break;
+    }
     default:
         throw std::logic_error(
             "nodeobject codec: unknown=" +
@@ -476,10 +532,20 @@ public:
 
 class nodeobject_codec
 {
+private:
+    std::shared_ptr<nodeobject_dictionaries const> dicts_;
+
 public:
-    template <class... Args>
+    nodeobject_codec() = default;
+
+    /** Compress leaves against the newest of the dictionaries.
+
+        Objects compressed against any of them can be decompressed.
+    */
     explicit
-    nodeobject_codec(Args&&... args)
+    nodeobject_codec(nodeobject_dictionaries dicts)
+        : dicts_ (std::make_shared<
+            nodeobject_dictionaries>(std::move(dicts)))
     {
     }
 
@@ -495,7 +561,7 @@ public:
         std::size_t in_size, BufferFactory&& bf) const
     {
         return detail::nodeobject_decompress(
-            in, in_size, bf);
+            in, in_size, bf, dicts_.get());
     }
 
     template <class BufferFactory>
@@ -504,7 +570,7 @@ public:
         std::size_t in_size, BufferFactory&& bf) const
     {
         return detail::nodeobject_compress(
-            in, in_size, bf);
+            in, in_size, bf, dicts_.get());
     }
 };
 
@@ -0,0 +1,308 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/dictionary.h>
+#include <beast/hash/xxhasher.h>
+#include <beast/nudb/detail/field.h>
+#include <beast/nudb/detail/stream.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ripple {
+namespace NodeStore {
+
+nodeobject_dictionary::nodeobject_dictionary (std::uint32_t version,
+        void const* data, std::size_t size)
+    : version_ (version)
+    , data_ (static_cast<std::uint8_t const*>(data),
+        static_cast<std::uint8_t const*>(data) + size)
+{
+    if (version_ == 0)
+        throw std::logic_error (
+            "nodestore: dictionary version zero");
+    if (data_.empty() || data_.size() > maxSize)
+        throw std::logic_error (
+            "nodestore: bad dictionary size");
+    LZ4_resetStream (&stream_);
+    LZ4_loadDict (&stream_,
+        reinterpret_cast<char const*>(data_.data()), data_.size());
+}
+
+std::size_t
+nodeobject_dictionary::compress (void const* in, std::size_t in_size,
+    void* out, std::size_t out_max) const
+{
+    // Compressing updates the stream, so work on a copy of the
+    // preloaded one instead of hashing the dictionary again.
+    LZ4_stream_t stream = stream_;
+    auto const n = LZ4_compress_fast_continue (&stream,
+        reinterpret_cast<char const*>(in),
+            reinterpret_cast<char*>(out), in_size, out_max, 1);
+    return n > 0 ? n : 0;
+}
+
+bool
+nodeobject_dictionary::decompress (void const* in, std::size_t in_size,
+    void* out, std::size_t out_size) const
+{
+    auto const n = LZ4_decompress_safe_usingDict (
+        reinterpret_cast<char const*>(in),
+            reinterpret_cast<char*>(out), in_size, out_size,
+                reinterpret_cast<char const*>(data_.data()), data_.size());
+    return n >= 0 && static_cast<std::size_t>(n) == out_size;
+}
+
+//------------------------------------------------------------------------------
+
+/*
+    Dictionary file layout, integers big endian:
+
+    char[8]     Type        The characters "nodedict"
+    uint16      Format      Holds 1
+    uint32      Version     Matches the file name
+    uint32      Size        Bytes of dictionary data
+    uint64      Checksum    xxhash of the dictionary data
+    [Size]      Data
+*/
+
+static char const dictionaryType[8] =
+    { 'n', 'o', 'd', 'e', 'd', 'i', 'c', 't' };
+
+static std::uint16_t const dictionaryFormat = 1;
+
+static std::size_t const dictionaryHeaderSize = 8 + 2 + 4 + 4 + 8;
+
+static
+boost::filesystem::path
+dictionary_path (boost::filesystem::path const& folder,
+    std::uint32_t version)
+{
+    return folder / ("nudb.dict." + std::to_string (version));
+}
+
+static
+std::uint64_t
+dictionary_checksum (Blob const& data)
+{
+    beast::xxhasher h;
+    h (data.data(), data.size());
+    return static_cast<std::size_t>(h);
+}
+
+nodeobject_dictionaries
+read_dictionaries (boost::filesystem::path const& folder)
+{
+    using namespace beast::nudb::detail;
+
+    nodeobject_dictionaries result;
+    for (std::uint32_t version = 1;; ++version)
+    {
+        auto const path = dictionary_path (folder, version);
+        if (! boost::filesystem::exists (path))
+            break;
+        auto const bad = [&path](char const* what)
+        {
+            return std::runtime_error ("nodestore: " +
+                path.string() + ": " + what);
+        };
+
+        std::ifstream file (path.string(), std::ios::in | std::ios::binary);
+        std::array<std::uint8_t, dictionaryHeaderSize> header;
+        if (! file.read (reinterpret_cast<char*>(header.data()),
+                header.size()))
+            throw bad ("short dictionary header");
+        istream is (header.data(), header.size());
+        std::uint16_t format;
+        std::uint32_t fileVersion;
+        std::uint32_t size;
+        std::uint64_t checksum;
+        if (std::memcmp (is(8), dictionaryType, 8) != 0)
+            throw bad ("not a dictionary");
+        read<std::uint16_t>(is, format);
+        read<std::uint32_t>(is, fileVersion);
+        read<std::uint32_t>(is, size);
+        read<std::uint64_t>(is, checksum);
+        if (format != dictionaryFormat)
+            throw bad ("unknown dictionary format");
+        if (fileVersion != version)
+            throw bad ("dictionary version mismatch");
+        if (size == 0 || size > nodeobject_dictionary::maxSize)
+            throw bad ("bad dictionary size");
+
+        Blob data (size);
+        if (! file.read (reinterpret_cast<char*>(data.data()), size))
+            throw bad ("short dictionary");
+        if (dictionary_checksum (data) != checksum)
+            throw bad ("dictionary checksum mismatch");
+
+        result.push_back (std::make_shared<nodeobject_dictionary>(
+            version, data.data(), data.size()));
+    }
+    return result;
+}
+
+std::uint32_t
+write_dictionary (boost::filesystem::path const& folder,
+    void const* data, std::size_t size)
+{
+    using namespace beast::nudb::detail;
+
+    if (size == 0 || size > nodeobject_dictionary::maxSize)
+        throw std::logic_error (
+            "nodestore: bad dictionary size");
+    Blob const blob (static_cast<std::uint8_t const*>(data),
+        static_cast<std::uint8_t const*>(data) + size);
+
+    boost::filesystem::create_directories (folder);
+    std::uint32_t const version =
+        read_dictionaries (folder).size() + 1;
+    auto const path = dictionary_path (folder, version);
+
+    std::array<std::uint8_t, dictionaryHeaderSize> header;
+    ostream os (header.data(), header.size());
+    std::memcpy (os.data(8), dictionaryType, 8);
+    write<std::uint16_t>(os, dictionaryFormat);
+    write<std::uint32_t>(os, version);
+    write<std::uint32_t>(os, static_cast<std::uint32_t>(size));
+    write<std::uint64_t>(os, dictionary_checksum (blob));
+
+    // Write under a temporary name so a partial file is never read
+    auto const temp = path.string() + ".tmp";
+    {
+        std::ofstream file (temp,
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write (reinterpret_cast<char const*>(header.data()),
+            header.size());
+        file.write (reinterpret_cast<char const*>(blob.data()),
+            blob.size());
+        if (! file.flush())
+            throw std::runtime_error ("nodestore: " + temp +
+                ": write failed");
+    }
+    boost::filesystem::rename (temp, path);
+    return version;
+}
+
+//------------------------------------------------------------------------------
+
+Blob
+train_dictionary (std::vector<Blob> const& samples,
+    std::size_t max_size)
+{
+    std::size_t const k = 8;            // bytes per substring
+    std::size_t const segment = 64;     // bytes per dictionary segment
+
+    max_size = std::min (max_size, nodeobject_dictionary::maxSize);
+
+    auto const gram = [](std::uint8_t const* p)
+    {
+        std::uint64_t v;
+        std::memcpy (&v, p, sizeof(v));
+        return v;
+    };
+
+    // The number of samples each substring appears in
+    std::unordered_map<std::uint64_t, std::uint32_t> freq;
+    {
+        std::unordered_set<std::uint64_t> seen;
+        for (auto const& s : samples)
+        {
+            seen.clear();
+            for (std::size_t i = 0; i + k <= s.size(); ++i)
+            {
+                auto const g = gram (&s[i]);
+                if (seen.insert (g).second)
+                    ++freq[g];
+            }
+        }
+    }
+
+    // A substring found in only one sample helps no other object
+    auto const score = [&freq](std::uint64_t g) -> std::uint64_t
+    {
+        auto const iter = freq.find (g);
+        if (iter == freq.end() || iter->second < 2)
+            return 0;
+        return iter->second - 1;
+    };
+
+    std::size_t const epochs = std::max<std::size_t> (1,
+        std::min (samples.size(), max_size / segment));
+
+    Blob dict;
+    dict.reserve (max_size);
+    bool progress = true;
+    while (progress && dict.size() < max_size)
+    {
+        progress = false;
+        for (std::size_t e = 0; e < epochs && dict.size() < max_size; ++e)
+        {
+            std::size_t const first = e * samples.size() / epochs;
+            std::size_t const last = (e + 1) * samples.size() / epochs;
+
+            // Find the best window in this epoch's samples
+            std::uint64_t best = 0;
+            std::uint8_t const* bestData = nullptr;
+            std::size_t bestSize = 0;
+            for (std::size_t i = first; i < last; ++i)
+            {
+                auto const& s = samples[i];
+                if (s.size() < k)
+                    continue;
+                std::size_t const len = std::min (segment, s.size());
+                std::uint64_t sum = 0;
+                for (std::size_t j = 0; j + k <= len; ++j)
+                    sum += score (gram (&s[j]));
+                for (std::size_t off = 0;; ++off)
+                {
+                    if (sum > best)
+                    {
+                        best = sum;
+                        bestData = &s[off];
+                        bestSize = len;
+                    }
+                    if (off + len >= s.size())
+                        break;
+                    sum -= score (gram (&s[off]));
+                    sum += score (gram (&s[off + len - k + 1]));
+                }
+            }
+            if (best == 0)
+                continue;
+
+            std::size_t const n = std::min (bestSize, max_size - dict.size());
+            dict.insert (dict.end(), bestData, bestData + n);
+            for (std::size_t j = 0; j + k <= bestSize; ++j)
+                freq[gram (bestData + j)] = 0;
+            progress = true;
+        }
+    }
+    return dict;
+}
+
+}
+}
@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_DICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_DICTIONARY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <lz4/lib/lz4.h>
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A dictionary used to compress NodeStore leaf objects.
+
+    Leaves are small and repetitive across objects (field headers,
+    account IDs, currency codes) but not within one, so LZ4 alone
+    finds little to remove. Compressing each leaf against a dictionary
+    trained from a sample of the store recovers that redundancy.
+
+    Every object compressed with a dictionary records its version,
+    so a dictionary must be kept for as long as the database is.
+*/
+class nodeobject_dictionary
+{
+private:
+    std::uint32_t version_;
+    Blob data_;
+    LZ4_stream_t stream_;   // data_ preloaded, copied for each object
+
+public:
+    /** The largest dictionary LZ4 can reference. */
+    static std::size_t const maxSize = 64 * 1024;
+
+    nodeobject_dictionary (std::uint32_t version,
+        void const* data, std::size_t size);
+
+    nodeobject_dictionary (nodeobject_dictionary const&) = delete;
+    nodeobject_dictionary& operator= (nodeobject_dictionary const&) = delete;
+
+    std::uint32_t
+    version() const
+    {
+        return version_;
+    }
+
+    Blob const&
+    data() const
+    {
+        return data_;
+    }
+
+    /** Compress against the dictionary.
+
+        @param out_max At least LZ4_compressBound(in_size) bytes.
+        @return The compressed size, or zero on failure.
+    */
+    std::size_t
+    compress (void const* in, std::size_t in_size,
+        void* out, std::size_t out_max) const;
+
+    /** Decompress exactly out_size bytes.
+
+        @return `false` if the input is not a valid encoding.
+    */
+    bool
+    decompress (void const* in, std::size_t in_size,
+        void* out, std::size_t out_size) const;
+};
+
+/** Dictionaries of a database, version N at index N-1. */
+using nodeobject_dictionaries =
+    std::vector<std::shared_ptr<nodeobject_dictionary const>>;
+
+/** Read the dictionaries stored next to a NuDB database.
+
+    Dictionary version N is kept in the file "nudb.dict.N" in the
+    database folder. Versions are read in order until one is missing.
+
+    Throws:
+        std::runtime_error if a dictionary file is corrupt.
+*/
+nodeobject_dictionaries
+read_dictionaries (boost::filesystem::path const& folder);
+
+/** Store a dictionary next to a NuDB database.
+
+    The dictionary becomes the next version, and is used to compress
+    new objects the next time the database is opened.
+
+    @return The version assigned to the dictionary.
+*/
+std::uint32_t
+write_dictionary (boost::filesystem::path const& folder,
+    void const* data, std::size_t size);
+
+/** Build a dictionary from a sample of leaf objects.
+
+    The samples are split into one group per dictionary segment. Each
+    group contributes the 64 byte run whose 8 byte substrings appear in
+    the most other samples, and the substrings taken are then ignored
+    so later segments cover something new.
+*/
+Blob
+train_dictionary (std::vector<Blob> const& samples,
+    std::size_t max_size);
+
+}
+}
+
+#endif
@@ -180,6 +180,36 @@ public:
         }
     }
 
+    // Rebuild a batch from the payloads a backend hands out in place
+    void fetchPayloadsOfBatch (Backend& backend, Batch* pCopy, Batch const& batch)
+    {
+        pCopy->clear ();
+        pCopy->reserve (batch.size ());
+
+        for (int i = 0; i < batch.size (); ++i)
+        {
+            uint256 const& hash = batch [i]->getHash ();
+            std::shared_ptr<NodeObject> object;
+
+            Status const status = backend.fetchPayload (hash.cbegin (),
+                [&](NodeObjectType type, void const* data, std::size_t size)
+                {
+                    auto const p = static_cast <std::uint8_t const*> (data);
+                    object = NodeObject::createObject (
+                        type, Blob (p, p + size), hash);
+                });
+
+            expect (status == ok, "Should be ok");
+
+            if (status == ok)
+            {
+                expect (object != nullptr, "Should not be null");
+
+                pCopy->push_back (object);
+            }
+        }
+    }
+
     void fetchMissing(Backend& backend, Batch const& batch)
     {
         for (int i = 0; i < batch.size (); ++i)
@@ -224,6 +254,29 @@ public:
                 pCopy->push_back (object);
         }
     }
+
+    // Same as fetchCopyOfBatch, but through Database::fetchPayload
+    static void fetchPayloadsOfBatch (Database& db,
+                                      Batch* pCopy,
+                                      Batch const& batch,
+                                      bool cache)
+    {
+        pCopy->clear ();
+        pCopy->reserve (batch.size ());
+
+        for (int i = 0; i < batch.size (); ++i)
+        {
+            uint256 const& hash = batch [i]->getHash ();
+
+            db.fetchPayload (hash,
+                [&](NodeObjectType type, void const* data, std::size_t size)
+                {
+                    auto const p = static_cast <std::uint8_t const*> (data);
+                    pCopy->push_back (NodeObject::createObject (
+                        type, Blob (p, p + size), hash));
+                }, cache);
+        }
+    }
 };
 
 }
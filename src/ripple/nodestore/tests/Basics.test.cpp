@@ -21,8 +21,12 @@
 #include <ripple/nodestore/tests/Base.test.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/codec.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/nudb/detail/buffer.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -77,6 +81,124 @@ public:
         }
     }
 
+    // Leaves which share structure, the way ledger entries do
+    static std::vector<Blob> createLeaves (int count, std::int64_t seedValue)
+    {
+        beast::Random r (seedValue);
+        std::vector<Blob> leaves;
+        for (int i = 0; i < count; ++i)
+        {
+            Blob leaf (9 + 4 + 120 + 32);
+            leaf[8] = hotACCOUNT_NODE;
+            std::uint32_t const prefix = HashPrefix::leafNode;
+            for (int j = 0; j < 4; ++j)
+                leaf[9 + j] = static_cast<std::uint8_t>(prefix >> (24 - 8 * j));
+            for (int j = 0; j < 120; ++j)
+                leaf[13 + j] = static_cast<std::uint8_t>((j % 11) * 7);
+            r.fillBitsRandomly (&leaf[13 + 20], 20);
+            r.fillBitsRandomly (&leaf[13 + 120], 32);
+            leaves.push_back (std::move (leaf));
+        }
+        return leaves;
+    }
+
+    // Compress then decompress, returning the compressed size
+    std::size_t roundTrip (nodeobject_codec const& codec, Blob const& blob)
+    {
+        beast::nudb::detail::buffer cb;
+        beast::nudb::detail::buffer db;
+        auto const compressed = codec.compress (blob.data (), blob.size (), cb);
+        auto const result = codec.decompress (
+            compressed.first, compressed.second, db);
+        auto const p = static_cast<std::uint8_t const*>(result.first);
+        expect (Blob (p, p + result.second) == blob, "Should round trip");
+        return compressed.second;
+    }
+
+    // Checks dictionary training, storage and the dictionary codec
+    void testDictionary (std::int64_t const seedValue)
+    {
+        testcase ("dictionary");
+
+        auto const leaves = createLeaves (numObjectsToTest, seedValue);
+        std::vector<Blob> const samples (
+            leaves.begin (), leaves.begin () + leaves.size () / 2);
+
+        Blob const dict = train_dictionary (samples, 4096);
+        expect (! dict.empty () && dict.size () <= 4096, "Bad dictionary size");
+
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+        boost::filesystem::path const folder (
+            node_db.getFullPathName ().toStdString ());
+        expect (read_dictionaries (folder).empty (), "Should be empty");
+        expect (write_dictionary (folder, dict.data (), dict.size ()) == 1,
+            "Should be version 1");
+        auto const first = read_dictionaries (folder);
+        expect (write_dictionary (folder, dict.data (), dict.size () / 2) == 2,
+            "Should be version 2");
+        auto const both = read_dictionaries (folder);
+        expect (both.size () == 2, "Should have two versions");
+        expect (both[0]->data () == dict, "Should be the stored dictionary");
+
+        nodeobject_codec const plain;
+        nodeobject_codec const codec (both);
+        std::size_t plainBytes = 0;
+        std::size_t dictBytes = 0;
+        for (std::size_t i = samples.size (); i < leaves.size (); ++i)
+        {
+            plainBytes += roundTrip (plain, leaves[i]);
+            dictBytes += roundTrip (codec, leaves[i]);
+        }
+        expect (dictBytes < plainBytes, "Dictionary should help");
+
+        // Inner nodes keep their own encoding
+        Blob inner (525);
+        std::uint32_t const prefix = HashPrefix::innerNode;
+        for (int j = 0; j < 4; ++j)
+            inner[9 + j] = static_cast<std::uint8_t>(prefix >> (24 - 8 * j));
+        inner[13 + 32] = 1;
+        expect (roundTrip (codec, inner) == 1 + 2 + 32, "Should be compact");
+
+        // Objects need the dictionary version they were written with
+        beast::nudb::detail::buffer cb;
+        beast::nudb::detail::buffer db;
+        auto const compressed = codec.compress (
+            leaves.back ().data (), leaves.back ().size (), cb);
+        for (auto const& other : { nodeobject_codec (), nodeobject_codec (first) })
+        {
+            try
+            {
+                other.decompress (compressed.first, compressed.second, db);
+                fail ("Should throw");
+            }
+            catch (beast::nudb::codec_error const&)
+            {
+                pass ();
+            }
+        }
+
+        // A NuDB backend picks up the dictionaries in its folder
+        DummyScheduler scheduler;
+        beast::Journal j;
+        Section params;
+        params.set ("type", "nudb");
+        params.set ("path", folder.string ());
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+        {
+            auto backend = Manager::instance ().make_Backend (
+                params, scheduler, j);
+            storeBatch (*backend, batch);
+        }
+        {
+            auto backend = Manager::instance ().make_Backend (
+                params, scheduler, j);
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+    }
+
     void run ()
     {
         std::int64_t const seedValue = 50;
@@ -84,6 +206,8 @@ public:
         testBatches (seedValue);
 
         testBlobs (seedValue);
+
+        testDictionary (seedValue);
     }
 };
 
@@ -130,6 +130,13 @@ public:
                 fetchCopyOfBatch (*db, &copy, batch);
                 expect (areBatchesEqual (batch, copy), "Should be equal");
             }
+
+            {
+                // Read the payloads through the cache
+                Batch copy;
+                fetchPayloadsOfBatch (*db, &copy, batch, true);
+                expect (areBatchesEqual (batch, copy), "Should be equal");
+            }
         }
 
         if (testPersistence)
@@ -139,8 +146,12 @@ public:
                 std::unique_ptr <Database> db = Manager::instance().make_Database (
                     "test", scheduler, j, 2, nodeParams);
 
-                // Read it back in
+                // Read the payloads straight from the backend
                 Batch copy;
+                fetchPayloadsOfBatch (*db, &copy, batch, false);
+                expect (areBatchesEqual (batch, copy), "Should be equal");
+
+                // Read it back in
                 fetchCopyOfBatch (*db, &copy, batch);
 
                 // Canonicalize the source and destination batches
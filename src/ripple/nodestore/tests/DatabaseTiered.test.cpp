@@ -0,0 +1,323 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/tests/Base.test.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+
+namespace ripple {
+namespace NodeStore {
+
+class DatabaseTiered_test : public TestBase
+{
+public:
+    // Holds scheduled tasks until they are run
+    class DeferredScheduler : public Scheduler
+    {
+    public:
+        void scheduleTask (Task& task) override
+        {
+            tasks_.push_back (&task);
+        }
+
+        void onFetch (FetchReport const&) override
+        {
+        }
+
+        void onBatchWrite (BatchWriteReport const&) override
+        {
+        }
+
+        std::size_t runTasks ()
+        {
+            std::vector <Task*> tasks;
+            tasks.swap (tasks_);
+            for (auto task : tasks)
+                task->performScheduledTask ();
+            return tasks.size ();
+        }
+
+    private:
+        std::vector <Task*> tasks_;
+    };
+
+    void testHotTier (std::int64_t const seedValue)
+    {
+        testcase ("hot tier");
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        std::size_t const budget = 256 * 1024;
+        HotTier hot (budget);
+        Batch demoted;
+
+        for (auto const& object : batch)
+            hot.insert (object, false, demoted);
+
+        expect (hot.bytes () <= budget, "Should stay within budget");
+        expect (hot.size () > 0 && hot.size () < batch.size (),
+            "Should hold some objects");
+        expect (demoted.empty (), "Unused objects should not be demoted");
+
+        // Objects read while resident survive a pass of the hand
+        std::size_t resident = 0;
+        for (auto const& object : batch)
+        {
+            auto const found = hot.fetch (object->getHash ());
+            if (found)
+            {
+                expect (found == object, "Should be the same object");
+                ++resident;
+            }
+        }
+        expect (resident == hot.size (), "Should find every resident object");
+
+        for (auto const& object : batch)
+            hot.insert (object, false, demoted);
+
+        expect (! demoted.empty (), "Used objects should be demoted");
+        for (auto const& object : demoted)
+            expect (object != nullptr, "Should not be null");
+
+        Batch extra;
+        createPredictableBatch (extra, 1, seedValue + 1);
+
+        hot.setBudget (0);
+        hot.insert (extra.front (), true, demoted);
+        expect (hot.fetch (extra.front ()->getHash ()) == nullptr,
+            "Should not admit objects over budget");
+    }
+
+    void testTiers (bool withSsd, std::int64_t const seedValue)
+    {
+        testcase (withSsd ? "hot, ssd and cold tiers" : "hot and cold tiers");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+        beast::UnitTestUtilities::TempDirectory ssd_db ("ssd_db");
+
+        Section params;
+        params.set ("type", "memory");
+        params.set ("path", node_db.getFullPathName ().toStdString ());
+
+        DatabaseTieredImp::Setup setup;
+        setup.hotBytes = 256 * 1024;
+        if (withSsd)
+        {
+            setup.ssdPath = ssd_db.getFullPathName ().toStdString ();
+            setup.ssdObjects = 400;
+        }
+
+        DatabaseTieredImp db ("test", scheduler, 0,
+            Manager::instance().make_Backend (params, scheduler, j),
+                setup, params, j);
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+        storeBatch (db, batch);
+
+        // Each object is read twice in a row, so it is used while in the
+        // hot tier and is demoted when evicted. The second pass finds
+        // demoted objects in the SSD tier.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            Batch copy;
+            for (auto const& object : batch)
+            {
+                db.fetchFrom (object->getHash ());
+                auto const found = db.fetchFrom (object->getHash ());
+                if (found)
+                    copy.push_back (found);
+            }
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+
+        {
+            Batch copy;
+            for (auto const& object : batch)
+            {
+                uint256 const& hash = object->getHash ();
+                db.fetchPayloadFrom (hash,
+                    [&](NodeObjectType type, void const* data, std::size_t size)
+                    {
+                        auto const p = static_cast <std::uint8_t const*> (data);
+                        copy.push_back (NodeObject::createObject (
+                            type, Blob (p, p + size), hash));
+                    });
+            }
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+
+        // A small working set stays in the hot tier
+        int const workingSet = 20;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (int i = 0; i < workingSet; ++i)
+                expect (db.fetchFrom (batch[i]->getHash ()) != nullptr,
+                    "Should be found");
+        }
+
+        uint256 missing;
+        missing.begin ()[0] = 1;
+        expect (db.fetchFrom (missing) == nullptr, "Should not be found");
+
+        Json::Value counts (Json::objectValue);
+        db.getCountsJson (counts);
+        expect (counts.isMember (jss::node_reads_hit), "Should have totals");
+
+        Json::Value const& tiers = counts[jss::node_tiers];
+        Json::Value const& hot = tiers[jss::hot];
+        Json::Value const& cold = tiers[jss::cold];
+
+        expect (hot[jss::bytes].asUInt () <= setup.hotBytes,
+            "Hot tier should stay within budget");
+        expect (hot[jss::hits].asUInt () > 0, "Hot tier should hit");
+        expect (cold[jss::lookups].asUInt () ==
+            cold[jss::hits].asUInt () + 1, "Only one cold miss");
+
+        std::uint32_t served = hot[jss::hits].asUInt () +
+            cold[jss::hits].asUInt ();
+
+        if (withSsd)
+        {
+            Json::Value const& ssd = tiers[jss::ssd];
+            expect (ssd[jss::stored].asUInt () > 0, "Should demote");
+            expect (ssd[jss::hits].asUInt () > 0, "SSD tier should hit");
+            expect (ssd[jss::rotations].asUInt () > 0, "Should rotate");
+            served += ssd[jss::hits].asUInt ();
+        }
+        else
+        {
+            expect (! tiers.isMember (jss::ssd), "Should have no SSD tier");
+        }
+
+        expect (served == 5 * batch.size () + 2 * workingSet,
+            "Every read should be counted");
+    }
+
+    void testDeferredDemotion (std::int64_t const seedValue)
+    {
+        testcase ("deferred demotion");
+
+        DeferredScheduler scheduler;
+        beast::Journal j;
+
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+        beast::UnitTestUtilities::TempDirectory ssd_db ("ssd_db");
+
+        Section params;
+        params.set ("type", "memory");
+        params.set ("path", node_db.getFullPathName ().toStdString ());
+
+        DatabaseTieredImp::Setup setup;
+        setup.hotBytes = 256 * 1024;
+        setup.ssdPath = ssd_db.getFullPathName ().toStdString ();
+        setup.ssdObjects = 400;
+
+        DatabaseTieredImp db ("test", scheduler, 0,
+            Manager::instance().make_Backend (params, scheduler, j),
+                setup, params, j);
+
+        auto const ssdCounts = [&db]()
+        {
+            Json::Value counts (Json::objectValue);
+            db.getCountsJson (counts);
+            return counts[jss::node_tiers][jss::ssd];
+        };
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+        storeBatch (db, batch);
+
+        expect (scheduler.runTasks () == 0,
+            "Objects that were never read should not be demoted");
+
+        for (auto const& object : batch)
+        {
+            db.fetchFrom (object->getHash ());
+            db.fetchFrom (object->getHash ());
+        }
+
+        expect (ssdCounts ()[jss::stored].asUInt () == 0,
+            "Fetches should not write to the SSD tier");
+        expect (scheduler.runTasks () == 1, "Should schedule one write");
+
+        Json::Value const ssd = ssdCounts ();
+        expect (ssd[jss::stored].asUInt () > 0, "Should demote");
+        expect (ssd[jss::rotations].asUInt () > 0, "Should rotate");
+
+        db.close ();
+    }
+
+    void testSelection ()
+    {
+        testcase ("selection");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+
+        Section params;
+        params.set ("type", "memory");
+        params.set ("path", node_db.getFullPathName ().toStdString ());
+
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, j, 0, params);
+            Json::Value counts (Json::objectValue);
+            db->getCountsJson (counts);
+            expect (! counts.isMember (jss::node_tiers), "Should not be tiered");
+        }
+
+        params.set ("hot_mb", "1");
+
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, j, 0, params);
+            Json::Value counts (Json::objectValue);
+            db->getCountsJson (counts);
+            expect (counts[jss::node_tiers][jss::hot][jss::budget].asUInt () ==
+                1024 * 1024, "Should be tiered");
+        }
+    }
+
+    void run ()
+    {
+        std::int64_t const seedValue = 50;
+
+        testHotTier (seedValue);
+        testTiers (false, seedValue);
+        testTiers (true, seedValue);
+        testDeferredDemotion (seedValue);
+        testSelection ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(DatabaseTiered,NodeStore,ripple);
+
+}
+}
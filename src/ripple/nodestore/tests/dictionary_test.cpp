@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/nodestore/impl/dictionary.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <beast/hash/xxhasher.h>
+#include <beast/nudb/api.h>
+#include <beast/nudb/detail/buffer.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+namespace NodeStore {
+
+// Trains a leaf dictionary from a NuDB database and reports the
+// compression ratio and decode speed it would give.
+//
+class dictionary_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    bool
+    is_inner (std::uint8_t const* p, std::size_t size)
+    {
+        if (size != 525)
+            return false;
+        std::uint32_t prefix = 0;
+        for (int i = 0; i < 4; ++i)
+            prefix = (prefix << 8) | p[9 + i];
+        return prefix == HashPrefix::innerNode;
+    }
+
+    struct result
+    {
+        std::size_t raw = 0;
+        std::size_t compressed = 0;
+        double rate = 0;    // decoded bytes per second
+    };
+
+    // Encode every leaf, then decode them all for at least a second
+    static
+    result
+    measure (nodeobject_codec const& codec,
+        std::vector<Blob> const& leaves)
+    {
+        result r;
+        beast::nudb::detail::buffer buf;
+        std::vector<Blob> encoded;
+        encoded.reserve (leaves.size());
+        for (auto const& leaf : leaves)
+        {
+            auto const c = codec.compress (
+                leaf.data(), leaf.size(), buf);
+            auto const p = static_cast<std::uint8_t const*>(c.first);
+            encoded.emplace_back (p, p + c.second);
+            r.raw += leaf.size();
+            r.compressed += c.second;
+        }
+
+        std::size_t decoded = 0;
+        auto const start = clock_type::now();
+        auto elapsed = clock_type::duration::zero();
+        do
+        {
+            for (auto const& e : encoded)
+                decoded += codec.decompress (
+                    e.data(), e.size(), buf).second;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed < std::chrono::seconds(1));
+        r.rate = decoded / std::chrono::duration<double>(elapsed).count();
+        return r;
+    }
+
+    void
+    report (std::string const& name, result const& r)
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(12) << name << std::right <<
+            std::fixed << std::setprecision(2) <<
+            std::setw(8) << (r.compressed ?
+                double(r.raw) / r.compressed : 0) << " " <<
+            std::setprecision(0) <<
+            std::setw(10) << r.rate / (1024 * 1024);
+        log << ss.str();
+    }
+
+    void
+    run() override
+    {
+        testcase(abort_on_fail) << arg();
+
+        pass();
+        auto const args = parse_args(arg());
+        bool usage = args.empty();
+
+        if (! usage &&
+            args.find("path") == args.end())
+        {
+            log <<
+                "Missing parameter: path";
+            usage = true;
+        }
+
+        if (usage)
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=path=<path>[,samples=<n>][,size=<bytes>][,write=1]\n" <<
+                "path:    NuDB database folder, holding nudb.dat\n" <<
+                "samples: Leaves to train from, and as many to test (20000)\n" <<
+                "size:    Dictionary size in bytes, 64KB at most (16384)\n" <<
+                "write:   Store the dictionary as the database's next version\n" <<
+                "The server must not be running on the database.";
+            return;
+        }
+
+        auto const folder = boost::filesystem::path (args.at("path"));
+        std::size_t const samples = args.count("samples") ?
+            std::stoull(args.at("samples")) : 20000;
+        std::size_t const size = args.count("size") ?
+            std::stoull(args.at("size")) : 16384;
+        bool const write = args.count("write") &&
+            args.at("write") != "0";
+
+        auto const dicts = read_dictionaries (folder);
+        nodeobject_codec const current (dicts);
+
+        // Reservoir sample of leaves, alternating train and test
+        std::vector<Blob> sample;
+        std::size_t objects = 0;
+        std::size_t seen = 0;
+        std::mt19937_64 gen;
+        using api = beast::nudb::api<
+            beast::xxhasher, nodeobject_codec>;
+        api::visit ((folder / "nudb.dat").string(), current,
+            [&](void const*, std::size_t,
+                void const* data, std::size_t bytes)
+            {
+                ++objects;
+                auto const p = static_cast<std::uint8_t const*>(data);
+                if (is_inner (p, bytes))
+                    return true;
+                if (sample.size() < 2 * samples)
+                {
+                    sample.emplace_back (p, p + bytes);
+                }
+                else
+                {
+                    auto const i = std::uniform_int_distribution<
+                        std::size_t>(0, seen)(gen);
+                    if (i < sample.size())
+                        sample[i].assign (p, p + bytes);
+                }
+                ++seen;
+                return true;
+            });
+
+        std::vector<Blob> train;
+        std::vector<Blob> test;
+        for (std::size_t i = 0; i < sample.size(); ++i)
+            (i % 2 ? test : train).push_back (std::move (sample[i]));
+
+        auto const start = clock_type::now();
+        Blob const dict = train_dictionary (train, size);
+        log <<
+            "objects:    " << objects << " (" << seen << " leaves)\n"
+            "samples:    " << train.size() << " train, " <<
+                test.size() << " test\n"
+            "dictionary: " << dict.size() << " bytes in " <<
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    clock_type::now() - start).count() << "ms\n"
+            "existing:   " << dicts.size() << " versions";
+        if (dict.empty() || test.empty())
+        {
+            log << "Not enough leaves to train a dictionary";
+            return;
+        }
+
+        auto candidate = dicts;
+        candidate.push_back (std::make_shared<nodeobject_dictionary>(
+            dicts.size() + 1, dict.data(), dict.size()));
+
+        log << "codec          ratio  MB/s decode";
+        report ("lz4", measure (nodeobject_codec(), test));
+        report ("dictionary", measure (
+            nodeobject_codec (std::move (candidate)), test));
+
+        if (write)
+        {
+            auto const version = write_dictionary (
+                folder, dict.data(), dict.size());
+            log <<
+                "Wrote dictionary version " << version <<
+                ", used for new objects when the database is next opened";
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(dictionary,NodeStore,ripple);
+
+}
+}
@@ -28,6 +28,7 @@
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/impl/PeerImp.h>
 #include <ripple/overlay/impl/TMHello.h>
+#include <ripple/overlay/impl/Tuning.h>
 #include <ripple/peerfinder/make_Manager.h>
 #include <ripple/protocol/STExchange.h>
 #include <beast/ByteOrder.h>
@@ -884,7 +885,7 @@ void
 OverlayImpl::relay (protocol::TMProposeSet& m,
     uint256 const& uid)
 {
-    if (m.has_hops() && m.hops() >= maxTTL)
+    if (m.has_hops() && m.hops() >= Tuning::maxTTL)
         return;
     std::set<Peer::id_t> skip;
     if (! getApp().getHashRouter().swapSet (
@@ -905,7 +906,7 @@ void
 OverlayImpl::relay (protocol::TMValidation& m,
     uint256 const& uid)
 {
-    if (m.has_hops() && m.hops() >= maxTTL)
+    if (m.has_hops() && m.hops() >= Tuning::maxTTL)
         return;
     std::set<Peer::id_t> skip;
     if (! getApp().getHashRouter().swapSet (
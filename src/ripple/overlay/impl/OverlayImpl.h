@@ -48,11 +48,6 @@ namespace ripple {
 class PeerImp;
 class BasicConfig;
 
-enum
-{
-    maxTTL = 2
-};
-
 class OverlayImpl : public Overlay
 {
 public:
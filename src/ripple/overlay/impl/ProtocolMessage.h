@@ -36,7 +36,7 @@ namespace ripple {
 
 /** Returns the name of a protocol message given its type. */
 template <class = void>
-std::string
+char const*
 protocolMessageName (int type)
 {
     switch (type)
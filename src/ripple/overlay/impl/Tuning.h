@@ -52,6 +52,10 @@ enum
 
     /** How often we check connections (seconds) */
     checkSeconds        =   10,
+
+    /** How many hops proposals and validations may travel
+        before they are no longer relayed */
+    maxTTL              =    2,
 };
 
 } // Tuning
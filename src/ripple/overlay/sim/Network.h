@@ -0,0 +1,502 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SIM_NETWORK_H_INCLUDED
+#define RIPPLE_OVERLAY_SIM_NETWORK_H_INCLUDED
+
+#include <ripple/app/misc/IHashRouter.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/overlay/Message.h>
+#include <ripple/overlay/impl/Tuning.h>
+#include <ripple/overlay/sim/Scheduler.h>
+#include <beast/chrono/abstract_clock.h>
+#include <beast/cxx14/memory.h> // <memory>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace OverlaySim {
+
+/** The kinds of message the simulation relays. */
+enum class Kind
+{
+    transaction,
+    proposal,
+    validation
+};
+
+std::size_t const kindCount = 3;
+
+/** Describes the network and the load placed on it. */
+struct Params
+{
+    std::size_t nodes = 200;
+
+    // Outbound connections each node opens to random other nodes
+    std::size_t outPeers = 10;
+
+    // Nodes that propose and validate every ledger
+    std::size_t validators = 30;
+
+    std::size_t ledgers = 10;
+    std::chrono::milliseconds ledgerInterval {4000};
+
+    // Positions each validator announces per ledger
+    std::size_t proposalsPerLedger = 2;
+
+    // Transactions submitted per second across the whole network
+    double txRate = 20;
+
+    std::size_t txBytes = 200;
+    std::size_t validationBytes = 220;
+
+    // One way link latency is picked uniformly from this range
+    std::chrono::microseconds minLatency {10000};
+    std::chrono::microseconds maxLatency {150000};
+
+    // Bytes per second in each direction of a link
+    std::uint64_t bandwidth = 1250000;
+
+    // Time to check a new message before relaying it
+    std::chrono::microseconds processing {200};
+
+    // Proposals and validations carry a hop count and stop after maxTTL
+    bool expire = false;
+
+    std::uint32_t seed = 42;
+};
+
+/** Counts the messages of one kind a node sent and received. */
+struct Traffic
+{
+    std::uint64_t sent = 0;
+    std::uint64_t bytesSent = 0;
+    std::uint64_t received = 0;
+    std::uint64_t bytesReceived = 0;
+
+    // Received messages the node's HashRouter had already seen
+    std::uint64_t duplicates = 0;
+};
+
+/** A simulated overlay network.
+
+    Every node has its own HashRouter, whose entries expire in simulated
+    time, and relays messages by the rules PeerImp and OverlayImpl apply:
+    a message already known to the router is dropped, a new one is
+    checked and then sent to every peer that is not known to have it. Messages are the real protocol messages, so
+    their sizes are the sizes seen on the wire.
+
+    Links deliver messages in order after a transmission delay set by
+    the link's bandwidth and the messages queued ahead, plus a fixed
+    latency.
+*/
+class Network
+{
+public:
+    using duration = Scheduler::duration;
+
+    explicit
+    Network (Params const& params)
+        : params_ (params)
+        , rng_ (params.seed)
+        , clock_ (scheduler_)
+        , nodes_ (params.nodes)
+    {
+        for (auto& node : nodes_)
+            node.router.reset (IHashRouter::New (
+                IHashRouter::getDefaultHoldTime (), clock_));
+
+        std::uniform_int_distribution <std::int64_t> latency (
+            params_.minLatency.count (), params_.maxLatency.count ());
+        std::uniform_int_distribution <std::size_t> pick (
+            0, params_.nodes - 1);
+        auto const outPeers = std::min (params_.outPeers,
+            params_.nodes - 1);
+        for (std::size_t i = 0; i < params_.nodes; ++i)
+        {
+            while (nodes_[i].outbound < outPeers)
+            {
+                auto const j = pick (rng_);
+                if (j == i || connected (i, j))
+                    continue;
+                connect (i, j, duration (latency (rng_)));
+                ++nodes_[i].outbound;
+            }
+        }
+    }
+
+    Params const&
+    params () const
+    {
+        return params_;
+    }
+
+    /** Returns the number of connections between nodes. */
+    std::size_t
+    links () const
+    {
+        return channels_.size () / 2;
+    }
+
+    /** Submit transactions and run consensus rounds until every
+        message has been delivered.
+
+        @return The number of events the simulation ran.
+    */
+    std::size_t
+    run ()
+    {
+        auto const length = duration (params_.ledgerInterval) *
+            params_.ledgers;
+
+        std::vector <std::size_t> validators (params_.nodes);
+        for (std::size_t i = 0; i < validators.size (); ++i)
+            validators[i] = i;
+        std::shuffle (validators.begin (), validators.end (), rng_);
+        validators.resize (std::min (params_.validators, params_.nodes));
+
+        std::uniform_int_distribution <std::size_t> pick (
+            0, params_.nodes - 1);
+        if (params_.txRate > 0)
+        {
+            std::exponential_distribution <double> gap (params_.txRate);
+            auto t = duration (0);
+            for (;;)
+            {
+                t += duration (static_cast <std::int64_t> (
+                    gap (rng_) * 1000000));
+                if (t >= length)
+                    break;
+                auto const node = pick (rng_);
+                scheduler_.at (t, [this, node]
+                {
+                    originate (node, makeTransaction ());
+                });
+            }
+        }
+
+        // Validators announce their positions through the round and
+        // validate at its end, each a little out of step with the rest.
+        std::uniform_int_distribution <std::int64_t> jitter (0, 100000);
+        auto const steps = params_.proposalsPerLedger + 1;
+        auto const step = duration (params_.ledgerInterval) / steps;
+        for (std::size_t ledger = 0; ledger < params_.ledgers; ++ledger)
+        {
+            auto const start = duration (params_.ledgerInterval) * ledger;
+            for (auto const node : validators)
+            {
+                for (std::size_t seq = 0; seq < steps; ++seq)
+                {
+                    auto const when = start + step * seq +
+                        duration (jitter (rng_));
+                    bool const validation = seq + 1 == steps;
+                    scheduler_.at (when, [this, node, seq, validation]
+                    {
+                        originate (node, validation ?
+                            makeValidation () : makeProposal (seq));
+                    });
+                }
+            }
+        }
+
+        return scheduler_.run ();
+    }
+
+    /** Returns what a node sent and received of one kind of message. */
+    Traffic const&
+    traffic (std::size_t node, Kind kind) const
+    {
+        return nodes_[node].traffic[index (kind)];
+    }
+
+    /** Returns the number of messages of a kind that were created. */
+    std::size_t
+    created (Kind kind) const
+    {
+        return created_[index (kind)];
+    }
+
+    /** Returns, for every time a node first received a message of a
+        kind, how long after its creation that was.
+    */
+    std::vector <duration> const&
+    latencies (Kind kind) const
+    {
+        return latencies_[index (kind)];
+    }
+
+private:
+    // Something created once and relayed through the network
+    struct Item
+    {
+        Kind kind;
+        uint256 id;
+        std::shared_ptr <Message> message;
+        duration created;
+    };
+
+    // One direction of a link
+    struct Channel
+    {
+        duration latency;
+        duration busyUntil;
+    };
+
+    // Lets each HashRouter expire its entries in simulated time
+    class Clock : public IHashRouter::clock_type
+    {
+    public:
+        explicit
+        Clock (Scheduler const& scheduler)
+            : scheduler_ (scheduler)
+        {
+        }
+
+        time_point
+        now () const override
+        {
+            return time_point (std::chrono::duration_cast <duration> (
+                scheduler_.now ()));
+        }
+
+    private:
+        Scheduler const& scheduler_;
+    };
+
+    struct Peer
+    {
+        std::size_t node;
+        std::size_t channel;
+    };
+
+    struct Node
+    {
+        std::unique_ptr <IHashRouter> router;
+        std::vector <Peer> peers;
+        std::size_t outbound = 0;
+        std::array <Traffic, kindCount> traffic;
+    };
+
+    static
+    std::size_t
+    index (Kind kind)
+    {
+        return static_cast <std::size_t> (kind);
+    }
+
+    // A node's HashRouter knows each peer by this ID
+    static
+    IHashRouter::PeerShortID
+    peerID (std::size_t node)
+    {
+        return static_cast <IHashRouter::PeerShortID> (node + 1);
+    }
+
+    bool
+    connected (std::size_t a, std::size_t b) const
+    {
+        for (auto const& peer : nodes_[a].peers)
+            if (peer.node == b)
+                return true;
+        return false;
+    }
+
+    void
+    connect (std::size_t a, std::size_t b, duration latency)
+    {
+        nodes_[a].peers.push_back ({b, channels_.size ()});
+        channels_.push_back ({latency, duration (0)});
+        nodes_[b].peers.push_back ({a, channels_.size ()});
+        channels_.push_back ({latency, duration (0)});
+    }
+
+    std::string
+    randomBytes (std::size_t size)
+    {
+        std::string s (size, 0);
+        for (auto& c : s)
+            c = static_cast <char> (rng_ ());
+        return s;
+    }
+
+    uint256
+    randomID ()
+    {
+        uint256 id;
+        for (auto& c : id)
+            c = static_cast <unsigned char> (rng_ ());
+        return id;
+    }
+
+    std::shared_ptr <Item>
+    makeItem (Kind kind, std::shared_ptr <Message> message)
+    {
+        ++created_[index (kind)];
+        auto item = std::make_shared <Item> ();
+        item->kind = kind;
+        item->id = randomID ();
+        item->message = std::move (message);
+        item->created = scheduler_.now ();
+        return item;
+    }
+
+    std::shared_ptr <Item>
+    makeTransaction ()
+    {
+        protocol::TMTransaction m;
+        m.set_rawtransaction (randomBytes (params_.txBytes));
+        m.set_status (protocol::tsCURRENT);
+        m.set_receivetimestamp (0);
+        return makeItem (Kind::transaction, std::make_shared <Message> (
+            m, protocol::mtTRANSACTION));
+    }
+
+    std::shared_ptr <Item>
+    makeProposal (std::uint32_t seq)
+    {
+        protocol::TMProposeSet m;
+        m.set_proposeseq (seq);
+        m.set_currenttxhash (randomBytes (32));
+        m.set_nodepubkey (randomBytes (33));
+        m.set_closetime (0);
+        m.set_signature (randomBytes (72));
+        m.set_previousledger (randomBytes (32));
+        if (params_.expire)
+            m.set_hops (0);
+        return makeItem (Kind::proposal, std::make_shared <Message> (
+            m, protocol::mtPROPOSE_LEDGER));
+    }
+
+    std::shared_ptr <Item>
+    makeValidation ()
+    {
+        protocol::TMValidation m;
+        m.set_validation (randomBytes (params_.validationBytes));
+        if (params_.expire)
+            m.set_hops (0);
+        return makeItem (Kind::validation, std::make_shared <Message> (
+            m, protocol::mtVALIDATION));
+    }
+
+    void
+    send (std::size_t from, Peer const& peer,
+        std::shared_ptr <Item> const& item, std::uint32_t hops)
+    {
+        auto& channel = channels_[peer.channel];
+        auto const size = item->message->getBuffer ().size ();
+        auto const start = std::max (scheduler_.now (), channel.busyUntil);
+        channel.busyUntil = start + duration (static_cast <std::int64_t> (
+            size * 1000000 / params_.bandwidth));
+
+        auto& t = nodes_[from].traffic[index (item->kind)];
+        ++t.sent;
+        t.bytesSent += size;
+
+        auto const to = peer.node;
+        scheduler_.at (channel.busyUntil + channel.latency,
+            [this, to, from, item, hops]
+            {
+                receive (to, from, item, hops);
+            });
+    }
+
+    void
+    originate (std::size_t node, std::shared_ptr <Item> const& item)
+    {
+        // NetworkOPs relays a new transaction like any other
+        if (item->kind == Kind::transaction)
+            return relay (node, item, 0);
+
+        // LedgerConsensus remembers its own proposals and validations
+        // and sends them to every peer
+        nodes_[node].router->addSuppression (item->id);
+        for (auto const& peer : nodes_[node].peers)
+            send (node, peer, item, 0);
+    }
+
+    void
+    receive (std::size_t node, std::size_t from,
+        std::shared_ptr <Item> const& item, std::uint32_t hops)
+    {
+        auto& n = nodes_[node];
+        auto& t = n.traffic[index (item->kind)];
+        ++t.received;
+        t.bytesReceived += item->message->getBuffer ().size ();
+
+        // PeerImp drops whatever the router has seen before
+        int flags;
+        if (! n.router->addSuppressionPeer (item->id, peerID (from), flags))
+        {
+            ++t.duplicates;
+            return;
+        }
+
+        latencies_[index (item->kind)].push_back (
+            scheduler_.now () - item->created);
+
+        // PeerImp counts the hops of proposals and validations
+        if (params_.expire && item->kind != Kind::transaction)
+            ++hops;
+
+        scheduler_.after (params_.processing, [this, node, item, hops]
+        {
+            relay (node, item, hops);
+        });
+    }
+
+    void
+    relay (std::size_t node, std::shared_ptr <Item> const& item,
+        std::uint32_t hops)
+    {
+        // OverlayImpl::relay lets proposals and validations expire
+        if (params_.expire && item->kind != Kind::transaction &&
+                hops >= Tuning::maxTTL)
+            return;
+
+        std::set <IHashRouter::PeerShortID> skip;
+        if (! nodes_[node].router->swapSet (item->id, skip, SF_RELAYED))
+            return;
+
+        for (auto const& peer : nodes_[node].peers)
+        {
+            if (skip.find (peerID (peer.node)) == skip.end ())
+                send (node, peer, item, hops);
+        }
+    }
+
+    Params params_;
+    std::mt19937 rng_;
+    Scheduler scheduler_;
+    Clock clock_;
+    std::vector <Node> nodes_;
+    std::vector <Channel> channels_;
+    std::array <std::size_t, kindCount> created_ {{}};
+    std::array <std::vector <duration>, kindCount> latencies_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SIM_SCHEDULER_H_INCLUDED
+#define RIPPLE_OVERLAY_SIM_SCHEDULER_H_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ripple {
+namespace OverlaySim {
+
+/** Runs functions in simulated time order.
+
+    Time only moves when an event runs, so a simulation runs as fast as
+    its events can be processed. Events scheduled for the same time run
+    in the order they were scheduled.
+*/
+class Scheduler
+{
+public:
+    using duration = std::chrono::microseconds;
+
+    /** Returns the simulated time since the start. */
+    duration
+    now () const
+    {
+        return now_;
+    }
+
+    /** Call f at the given time, which must not be in the past. */
+    template <class Function>
+    void
+    at (duration when, Function&& f)
+    {
+        queue_.push_back ({std::max (when, now_), seq_++,
+            std::forward <Function> (f)});
+        std::push_heap (queue_.begin (), queue_.end (), Later ());
+    }
+
+    /** Call f once delay has passed. */
+    template <class Function>
+    void
+    after (duration delay, Function&& f)
+    {
+        at (now_ + delay, std::forward <Function> (f));
+    }
+
+    /** Run events until none remain.
+        @return The number of events run.
+    */
+    std::size_t
+    run ()
+    {
+        std::size_t n = 0;
+        while (! queue_.empty ())
+        {
+            std::pop_heap (queue_.begin (), queue_.end (), Later ());
+            Event e = std::move (queue_.back ());
+            queue_.pop_back ();
+            now_ = e.when;
+            e.f ();
+            ++n;
+        }
+        return n;
+    }
+
+private:
+    struct Event
+    {
+        duration when;
+        std::uint64_t seq;
+        std::function <void ()> f;
+    };
+
+    // Orders the heap so the earliest event is on top
+    struct Later
+    {
+        bool
+        operator() (Event const& lhs, Event const& rhs) const
+        {
+            if (lhs.when != rhs.when)
+                return lhs.when > rhs.when;
+            return lhs.seq > rhs.seq;
+        }
+    };
+
+    duration now_ {0};
+    std::uint64_t seq_ = 0;
+    std::vector <Event> queue_;
+};
+
+}
+}
+
+#endif
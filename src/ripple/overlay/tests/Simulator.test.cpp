@@ -0,0 +1,254 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/overlay/sim/Network.h>
+#include <beast/http/rfc2616.h>
+#include <beast/module/core/text/LexicalCast.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace ripple {
+namespace OverlaySim {
+
+// Runs the overlay simulator and reports the relay load per node and
+// ledger, how many of the received messages were duplicates, and how
+// long messages took to reach the other nodes.
+//
+class Simulator_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    // <key> ['=' <value>] separated by commas
+    static
+    std::map <std::string, std::string>
+    parse_args (std::string const& s)
+    {
+        std::map <std::string, std::string> map;
+        for (auto const& kv : beast::rfc2616::split (s.begin (), s.end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                map[kv];
+            else
+                map[kv.substr (0, pos)] = kv.substr (pos + 1);
+        }
+        return map;
+    }
+
+    static
+    char const*
+    name (Kind kind)
+    {
+        switch (kind)
+        {
+        case Kind::transaction: return "transaction";
+        case Kind::proposal:    return "proposal";
+        case Kind::validation:  return "validation";
+        }
+        return "";
+    }
+
+    void
+    reportTraffic (Network const& net)
+    {
+        auto const& params = net.params ();
+        double const perLedger = std::max <std::size_t> (params.ledgers, 1);
+
+        log <<
+            "kind           msgs/node  KB/node  max KB  dup %  amplification\n"
+            "               (sent and received per ledger)";
+
+        Traffic all;
+        double maxAll = 0;
+        std::vector <double> nodeAll (params.nodes);
+        for (std::size_t k = 0; k < kindCount; ++k)
+        {
+            auto const kind = static_cast <Kind> (k);
+            Traffic sum;
+            double maxBytes = 0;
+            for (std::size_t i = 0; i < params.nodes; ++i)
+            {
+                auto const& t = net.traffic (i, kind);
+                sum.sent += t.sent;
+                sum.bytesSent += t.bytesSent;
+                sum.received += t.received;
+                sum.bytesReceived += t.bytesReceived;
+                sum.duplicates += t.duplicates;
+                double const bytes = t.bytesSent + t.bytesReceived;
+                maxBytes = std::max (maxBytes, bytes);
+                nodeAll[i] += bytes;
+            }
+            all.sent += sum.sent;
+            all.bytesSent += sum.bytesSent;
+            all.received += sum.received;
+            all.bytesReceived += sum.bytesReceived;
+            all.duplicates += sum.duplicates;
+
+            report (name (kind), sum, maxBytes, params.nodes, perLedger);
+        }
+        for (auto const bytes : nodeAll)
+            maxAll = std::max (maxAll, bytes);
+        report ("all", all, maxAll, params.nodes, perLedger);
+    }
+
+    void
+    report (std::string const& label, Traffic const& t, double maxBytes,
+        std::size_t nodes, double perLedger)
+    {
+        double const n = nodes * perLedger;
+        auto const useful = t.received - t.duplicates;
+        std::stringstream ss;
+        ss << std::left << std::setw (14) << label << std::right <<
+            std::fixed << std::setprecision (0) <<
+            std::setw (10) << (t.sent + t.received) / n <<
+            std::setw (9) << (t.bytesSent + t.bytesReceived) / n / 1024 <<
+            std::setw (8) << maxBytes / perLedger / 1024 <<
+            std::setprecision (1) <<
+            std::setw (7) << (t.received ?
+                100.0 * t.duplicates / t.received : 0) <<
+            std::setprecision (2) <<
+            std::setw (15) << (useful ? double (t.received) / useful : 0);
+        log << ss.str ();
+    }
+
+    void
+    reportLatency (Network const& net)
+    {
+        using namespace std::chrono;
+        auto const& params = net.params ();
+
+        log <<
+            "kind           p50 ms   p90 ms   p99 ms   max ms  reached %";
+        for (std::size_t k = 0; k < kindCount; ++k)
+        {
+            auto const kind = static_cast <Kind> (k);
+            auto v = net.latencies (kind);
+            std::sort (v.begin (), v.end ());
+            auto const at = [&](double q)
+            {
+                if (v.empty ())
+                    return 0.0;
+                auto const i = std::min (v.size () - 1,
+                    static_cast <std::size_t> (q * v.size ()));
+                return duration_cast <microseconds> (
+                    v[i]).count () / 1000.0;
+            };
+            auto const possible = double (net.created (kind)) *
+                (params.nodes - 1);
+            std::stringstream ss;
+            ss << std::left << std::setw (14) << name (kind) << std::right <<
+                std::fixed << std::setprecision (1) <<
+                std::setw (7) << at (0.5) <<
+                std::setw (9) << at (0.9) <<
+                std::setw (9) << at (0.99) <<
+                std::setw (9) << at (1.0) <<
+                std::setw (11) << (possible > 0 ?
+                    100.0 * v.size () / possible : 0);
+            log << ss.str ();
+        }
+    }
+
+    void
+    run () override
+    {
+        auto const args = parse_args (arg ());
+        if (args.count ("help"))
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=[nodes=<n>][,peers=<n>][,validators=<n>]"
+                    "[,ledgers=<n>][,tps=<n>][,latency=<min ms>-<max ms>]"
+                    "[,bandwidth=<KB/s>][,expire=1][,seed=<n>]\n" <<
+                "nodes:      Nodes in the network (200)\n" <<
+                "peers:      Outbound connections per node (10)\n" <<
+                "validators: Nodes proposing and validating (30)\n" <<
+                "ledgers:    Consensus rounds, 4 seconds each (10)\n" <<
+                "tps:        Transactions submitted per second (20)\n" <<
+                "latency:    Range of one way link latency (10-150)\n" <<
+                "bandwidth:  Per link, in each direction (1220)\n" <<
+                "expire:     Stop proposals and validations after maxTTL hops\n" <<
+                "seed:       Random seed for the topology and load (42)";
+            pass ();
+            return;
+        }
+
+        Params params;
+        auto const get = [&](char const* key, std::size_t& value)
+        {
+            if (args.count (key))
+                value = beast::lexicalCastThrow <std::size_t> (args.at (key));
+        };
+        get ("nodes", params.nodes);
+        get ("peers", params.outPeers);
+        get ("validators", params.validators);
+        get ("ledgers", params.ledgers);
+        if (args.count ("tps"))
+            params.txRate = std::stod (args.at ("tps"));
+        if (args.count ("latency"))
+        {
+            auto const& s = args.at ("latency");
+            auto const dash = s.find ('-');
+            params.minLatency = std::chrono::milliseconds (
+                std::stoul (s.substr (0, dash)));
+            params.maxLatency = dash == std::string::npos ?
+                params.minLatency : std::chrono::milliseconds (
+                    std::stoul (s.substr (dash + 1)));
+        }
+        if (args.count ("bandwidth"))
+            params.bandwidth = 1024 * std::stoull (args.at ("bandwidth"));
+        if (args.count ("expire"))
+            params.expire = args.at ("expire") != "0";
+        if (args.count ("seed"))
+            params.seed = std::stoul (args.at ("seed"));
+
+        if (params.nodes < 2 || params.bandwidth == 0)
+        {
+            fail ("need at least two nodes and some bandwidth");
+            return;
+        }
+
+        Network net (params);
+        auto const start = clock_type::now ();
+        auto const events = net.run ();
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::milliseconds> (clock_type::now () - start);
+
+        log <<
+            params.nodes << " nodes, " << net.links () << " links, " <<
+            std::min (params.validators, params.nodes) << " validators, " <<
+            params.ledgers << " ledgers, " <<
+            net.created (Kind::transaction) << " transactions, expire " <<
+            (params.expire ? "on" : "off") << ", " <<
+            events << " events in " << elapsed.count () << " ms";
+        reportTraffic (net);
+        reportLatency (net);
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Simulator,overlay,ripple);
+
+}
+}
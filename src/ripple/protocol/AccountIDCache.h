@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_ACCOUNTIDCACHE_H_INCLUDED
+#define RIPPLE_PROTOCOL_ACCOUNTIDCACHE_H_INCLUDED
+
+#include <ripple/protocol/UintTypes.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Caches the base58 text of accounts.
+
+    Rendering ledger entries and transactions as JSON converts the same
+    few accounts over and over. The cache is a fixed size, direct mapped
+    table: every account has exactly one slot and a newcomer replaces
+    whatever was there, so the table never grows and a hit costs one
+    lookup under the lock.
+*/
+class AccountIDCache
+{
+public:
+    AccountIDCache (AccountIDCache const&) = delete;
+    AccountIDCache& operator= (AccountIDCache const&) = delete;
+
+    /** Create a cache with room for capacity accounts.
+        A capacity of zero disables caching.
+    */
+    explicit
+    AccountIDCache (std::size_t capacity);
+
+    /** Return the base58 text of the account. */
+    std::string
+    toBase58 (Account const& id) const;
+
+    /** Discard every cached conversion. */
+    void
+    clear ();
+
+private:
+    struct Slot
+    {
+        Account id;
+        std::string text;
+    };
+
+    std::mutex mutable mutex_;
+    std::vector <Slot> mutable slots_;
+};
+
+/** Returns the process-wide cache used when rendering JSON. */
+AccountIDCache&
+getAccountIDCache ();
+
+} // ripple
+
+#endif
@@ -44,6 +44,10 @@ JSS ( LimitAmount );                // field.
 JSS ( OfferSequence );              // field.
 JSS ( Paths );                      // in/out: TransactionSign
 JSS ( TransferRate );               // in: TransferRate
+JSS ( coalesced );                  // out: SendQueue
+JSS ( compressed_bytes );           // out: PermessageDeflate
+JSS ( compressed_messages );        // out: PermessageDeflate
+JSS ( dropped );                    // out: SendQueue
 JSS ( historical_perminute );       // historical_perminute
 JSS ( SLE_hit_rate );               // out: GetCounts
 JSS ( SendMax );                    // in: TransactionSign
@@ -73,6 +77,7 @@ JSS ( accounts );                   // in: LedgerEntry, Subscribe,
                                     // out: WalletAccounts
 JSS ( accounts_proposed );          // in: Subscribe, Unsubscribe
 JSS ( action );                     // out: LedgerEntrySet
+JSS ( adaptive );                   // out: GetCounts
 JSS ( address );                    // out: PeerImp
 JSS ( affected );                   // out: AcceptedLedgerTx
 JSS ( age );                        // out: UniqueNodeList, NetworkOPs
@@ -86,12 +91,17 @@ JSS ( base_fee );                   // out: NetworkOPs
 JSS ( base_fee_xrp );               // out: NetworkOPs
 JSS ( bids );                       // out: Subscribe
 JSS ( binary );                     // in: AccountTX, LedgerEntry,
-                                    //     AccountTxOld, Tx LedgerData
+                                    //     AccountTxOld, Tx LedgerData,
+                                    //     Subscribe
 JSS ( books );                      // in: Subscribe, Unsubscribe
 JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
+JSS ( budget );                     // out: GetCounts
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bytes );                      // out: GetCounts
+JSS ( cache_budget );               // out: GetCounts
+JSS ( caches );                     // out: GetCounts
 JSS ( can_delete );                 // out: CanDelete
 JSS ( check_nodes );                // in: LedgerCleaner
 JSS ( clear );                      // in/out: FetchInfo
@@ -106,6 +116,7 @@ JSS ( closed );                     // out: NetworkOPs, LedgerToJson,
 JSS ( closed_ledger );              // out: NetworkOPs
 JSS ( cluster );                    // out: UniqueNodeList, PeerImp
 JSS ( code );                       // out: errors
+JSS ( cold );                       // out: GetCounts
 JSS ( command );                    // in: RPCHandler
 JSS ( comment );                    // in: UnlAdd
 JSS ( complete );                   // out: NetworkOPs, InboundLedger
@@ -124,6 +135,7 @@ JSS ( dbKBTotal );                  // out: getCounts
 JSS ( dbKBTransaction );            // out: getCounts
 JSS ( debug_signing );              // in: TransactionSign
 JSS ( delivered_amount );           // out: addPaymentDeliveredAmount
+JSS ( demoted );                    // out: GetCounts
 JSS ( deprecated );                 // out: WalletSeed
 JSS ( descending );                 // in: AccountTx*
 JSS ( destination_account );        // in: PathRequest, RipplePathFind
@@ -137,10 +149,13 @@ JSS ( enabled );                    // out: AmendmentTable
 JSS ( engine_result );              // out: NetworkOPs, TransactionSign, Submit
 JSS ( engine_result_code );         // out: NetworkOPs, TransactionSign, Submit
 JSS ( engine_result_message );      // out: NetworkOPs, TransactionSign, Submit
+JSS ( entries );                    // out: GetCounts
+JSS ( entry_bytes );                // out: GetCounts
 JSS ( error );                      // out: error
 JSS ( error_code );                 // out: error
 JSS ( error_exception );            // out: Submit
 JSS ( error_message );              // out: error
+JSS ( evicted );                    // out: GetCounts
 JSS ( expand );                     // in: handler/Ledger
 JSS ( fail_hard );                  // in: Sign, Submit
 JSS ( failed );                     // out: InboundLedger
@@ -150,6 +165,7 @@ JSS ( fee_base );                   // out: NetworkOPs
 JSS ( fee_mult_max );               // in: TransactionSign
 JSS ( fee_ref );                    // out: NetworkOPs
 JSS ( fetch_pack );                 // out: NetworkOPs
+JSS ( fetch_pack_store );           // out: GetCounts
 JSS ( first );                      // out: rpc/Version
 JSS ( fix_txns );                   // in: LedgerCleaner
 JSS ( flags );                      // out: paths/Node, AccountOffers
@@ -165,11 +181,15 @@ JSS ( hash );                       // out: NetworkOPs, InboundLedger,
 JSS ( have_header );                // out: InboundLedger
 JSS ( have_state );                 // out: InboundLedger
 JSS ( have_transactions );          // out: InboundLedger
+JSS ( hit_rate );                   // out: GetCounts
+JSS ( hits );                       // out: GetCounts
 JSS ( hostid );                     // out: NetworkOPs
+JSS ( hot );                        // out: GetCounts
 JSS ( id );                         // websocket.
 JSS ( ident );                      // in: AccountCurrencies, AccountInfo,
                                     //     OwnerInfo
 JSS ( inLedger );                   // out: tx/Transaction
+JSS ( in_flight );                  // out: SendQueue
 JSS ( inbound );                    // out: PeerImp
 JSS ( index );                      // in: LedgerEntry; out: PathState,
                                     //     STLedgerEntry, LedgerEntry,
@@ -184,6 +204,7 @@ JSS ( issuer );                     // in: RipplePathFind, Subscribe,
                                     // out: paths/Node, STPathSet, STAmount
 JSS ( key );                        // out: WalletSeed
 JSS ( key_type );                   // in/out: WalletPropose, TransactionSign
+JSS ( largest_queued_bytes );       // out: NetworkOPs
 JSS ( latency );                    // out: PeerImp
 JSS ( last );                       // out: RPCVersion
 JSS ( last_close );                 // out: NetworkOPs
@@ -205,10 +226,12 @@ JSS ( ledger_index_min );           // in, out: AccountTx*
 JSS ( ledger_max );                 // in, out: AccountTx*
 JSS ( ledger_min );                 // in, out: AccountTx*
 JSS ( ledger_time );                // out: NetworkOPs
+JSS ( ledgers );                    // out: LedgerCloseProfile
 JSS ( levels );                     // LogLevels
 JSS ( limit );                      // in/out: AccountTx*, AccountOffers,
                                     //         AccountLines, AccountObjects
-                                    // in: LedgerData, BookOffers
+                                    // in: LedgerData, BookOffers,
+                                    //     LedgerCloseProfile
 JSS ( limit_peer );                 // out: AccountLines
 JSS ( lines );                      // out: AccountLines
 JSS ( load );                       // out: NetworkOPs, PeerImp
@@ -220,6 +243,7 @@ JSS ( load_factor_net );            // out: NetworkOPs
 JSS ( load_fee );                   // out: LoadFeeTrackImp
 JSS ( local );                      // out: resource/Logic.h
 JSS ( local_txs );                  // out: GetCounts
+JSS ( lookups );                    // out: GetCounts
 JSS ( marker );                     // in/out: AccountTx, AccountOffers,
                                     //         AccountLines, AccountObjects,
                                     //         LedgerData
@@ -235,6 +259,7 @@ JSS ( metadata );                   // out: TransactionEntry
 JSS ( method );                     // RPC
 JSS ( min_count );                  // in: GetCounts
 JSS ( min_ledger );                 // in: LedgerCleaner
+JSS ( misses );                     // out: GetCounts
 JSS ( missingCommand );             // error
 JSS ( name );                       // out: AmendmentTableImpl, PeerImp
 JSS ( needed_state_hashes );        // out: InboundLedger
@@ -249,9 +274,12 @@ JSS ( node_hit_rate );              // out: GetCounts
 JSS ( node_read_bytes );            // out: GetCounts
 JSS ( node_reads_hit );             // out: GetCounts
 JSS ( node_reads_total );           // out: GetCounts
+JSS ( node_tiers );                 // out: GetCounts
 JSS ( node_writes );                // out: GetCounts
 JSS ( node_written_bytes );         // out: GetCounts
 JSS ( nodes );                      // out: LedgerEntrySet, PathState
+JSS ( nodes_flushed );              // out: LedgerCloseProfile
+JSS ( objects );                    // out: GetCounts
 JSS ( offer );                      // in: LedgerEntry
 JSS ( offers );                     // out: NetworkOPs, AccountOffers, Subscribe
 JSS ( offline );                    // in: TransactionSign
@@ -267,11 +295,15 @@ JSS ( password );                   // in: Subscribe
 JSS ( paths );                      // in: RipplePathFind
 JSS ( paths_canonical );            // out: RipplePathFind
 JSS ( paths_computed );             // out: PathRequest, RipplePathFind
+JSS ( peak_bytes );                 // out: SendQueue
 JSS ( peer );                       // in: AccountLines
+                                    // out: SendQueues
 JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: LedgerProposal
 JSS ( peer_index );                 // in/out: AccountLines
 JSS ( peers );                      // out: InboundLedger, handlers/Peers
+JSS ( permessage_deflate );         // out: SendQueues
+JSS ( phases );                     // out: LedgerCloseProfile
 JSS ( port );                       // in: Connect
 JSS ( previous_ledger );            // out: LedgerPropose
 JSS ( proof );                      // in: BookOffers
@@ -286,8 +318,11 @@ JSS ( published_ledger );           // out: NetworkOPs
 JSS ( quality );                    // out: NetworkOPs
 JSS ( quality_in );                 // out: AccountLines
 JSS ( quality_out );                // out: AccountLines
+JSS ( queued_bytes );               // out: SendQueue, NetworkOPs
+JSS ( queued_messages );            // out: SendQueue
 JSS ( random );                     // out: Random
 JSS ( raw_meta );                   // out: AcceptedLedgerTx
+JSS ( rebalances );                 // out: GetCounts
 JSS ( receive_currencies );         // out: AccountCurrencies
 JSS ( regular_seed );               // in/out: LedgerEntry
 JSS ( remote );                     // out: Logic.h
@@ -300,6 +335,7 @@ JSS ( response );                   // websocket
 JSS ( result );                     // RPC
 JSS ( ripple_lines );               // out: NetworkOPs
 JSS ( ripple_state );               // in: LedgerEntr
+JSS ( rotations );                  // out: GetCounts
 JSS ( rt_accounts );                // in: Subscribe, Unsubscribe
 JSS ( sanity );                     // out: PeerImp
 JSS ( search_depth );               // in: RipplePathFind
@@ -308,6 +344,8 @@ JSS ( secret );                     // in: TransactionSign, WalletSeed,
 JSS ( seed );                       // in: WalletAccounts, out: WalletSeed
 JSS ( seed_hex );                   // in: WalletPropose, TransactionSign
 JSS ( send_currencies );            // out: AccountCurrencies
+JSS ( send_queues );                // out: NetworkOPs, SendQueues
+JSS ( sent );                       // out: SendQueue
 JSS ( seq );                        // in: LedgerEntry;
                                     // out: NetworkOPs, RPCSub, AccountOffers
 JSS ( seqNum );                     // out: LedgerToJson
@@ -318,16 +356,21 @@ JSS ( snapshot );                   // in: Subscribe
 JSS ( source_account );             // in: PathRequest, RipplePathFind
 JSS ( source_amount );              // in: PathRequest, RipplePathFind
 JSS ( source_currencies );          // in: PathRequest, RipplePathFind
+JSS ( ssd );                        // out: GetCounts
 JSS ( stand_alone );                // out: NetworkOPs
 JSS ( start );                      // in: TxHistory
 JSS ( state );                      // out: Logic.h, ServerState, LedgerData
 JSS ( state_now );                  // in: Subscribe
 JSS ( status );                     // error
 JSS ( stop );                       // in: LedgerCleaner
+JSS ( stored );                     // out: GetCounts
 JSS ( streams );                    // in: Subscribe, Unsubscribe
 JSS ( strict );                     // in: AccountCurrencies, AccountInfo
 JSS ( sub_index );                  // in: LedgerEntry
 JSS ( subcommand );                 // in: PathFind
+JSS ( subscriber );                 // out: SendQueues
+JSS ( subscribers );                // out: NetworkOPs
+JSS ( subscribers_notified );       // out: LedgerCloseProfile
 JSS ( success );                    // rpc
 JSS ( supported );                  // out: AmendmentTableImpl
 JSS ( system_time_offset );         // out: NetworkOPs
@@ -336,6 +379,8 @@ JSS ( taker_gets );                 // in: Subscribe, Unsubscribe, BookOffers
 JSS ( taker_gets_funded );          // out: NetworkOPs
 JSS ( taker_pays );                 // in: Subscribe, Unsubscribe, BookOffers
 JSS ( taker_pays_funded );          // out: NetworkOPs
+JSS ( target_age );                 // out: GetCounts
+JSS ( target_size );                // out: GetCounts
 JSS ( threshold );                  // in: Blacklist
 JSS ( timeouts );                   // out: InboundLedger
 JSS ( totalCoins );                 // out: LedgerToJson
@@ -346,6 +391,7 @@ JSS ( transaction );                // in: Tx
 JSS ( transaction_hash );           // out: LedgerProposal, LedgerToJson
 JSS ( transactions );               // out: LedgerToJson,
                                     // in: AccountTx*, Unsubscribe
+JSS ( transactions_applied );       // out: LedgerCloseProfile
 JSS ( treenode_cache_size );        // out: GetCounts
 JSS ( treenode_track_size );        // out: GetCounts
 JSS ( tx );                         // out: STTx, AccountTx*
@@ -362,6 +408,7 @@ JSS ( type );                       // in: AccountObjects
                                     // out: NetworkOPs, LedgerEntrySet
                                     //      paths/Node.cpp, OverlayImpl, Logic
 JSS ( type_hex );                   // out: STPathSet
+JSS ( uncompressed_bytes );         // out: PermessageDeflate
 JSS ( unl );                        // out: UnlList
 JSS ( uptime );                     // out: GetCounts
 JSS ( url );                        // in/out: Subscribe, Unsubscribe
@@ -76,16 +76,8 @@ RipplePublicKey::to_string() const
 {
     // The expanded form of the key is:
     //  <type> <key> <checksum>
-    std::array <std::uint8_t, 1 + 33 + 4> e;
-    e[0] = 28; // node public key type
-    std::copy (data_.begin(), data_.end(), e.begin() + 1);
-    Base58::fourbyte_hash256 (&*(e.begin() + 34), e.data(), 34);
-    // Convert key + checksum to little endian with an extra pad byte
-    std::array <std::uint8_t, 4 + 33 + 1 + 1> le;
-    std::reverse_copy (e.begin(), e.end(), le.begin());
-    le.back() = 0; // make BIGNUM positive
-    return Base58::raw_encode (le.data(),
-        le.data() + le.size(), Base58::getRippleAlphabet());
+    return Base58::encodeWithCheck (28, // node public key type
+        data_.data(), data_.size());
 }
 
 inline
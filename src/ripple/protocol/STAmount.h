@@ -361,6 +361,20 @@ STAmount
 divRound (STAmount const& v1, STAmount const& v2,
     Issue const& issue, bool roundUp);
 
+namespace detail {
+
+/** Returns (multiplier * multiplicand + addend) / divisor, rounded down.
+
+    The intermediate value is 128 bits wide so it never overflows. A
+    quotient too large for 64 bits saturates to the largest value, which
+    is what the OpenSSL bignum code this replaces returned.
+*/
+std::uint64_t
+muldiv (std::uint64_t multiplier, std::uint64_t multiplicand,
+    std::uint64_t addend, std::uint64_t divisor);
+
+} // detail
+
 // Someone is offering X for Y, what is the rate?
 // Rate: smaller is better, the taker wants the most out: in/out
 // VFALCO TODO Return a Quality object
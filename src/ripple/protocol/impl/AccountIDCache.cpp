@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/protocol/AccountIDCache.h>
+#include <cstdint>
+#include <cstring>
+
+namespace ripple {
+
+AccountIDCache::AccountIDCache (std::size_t capacity)
+    : slots_ (capacity)
+{
+}
+
+std::string
+AccountIDCache::toBase58 (Account const& id) const
+{
+    if (slots_.empty ())
+        return to_string (id);
+
+    // Accounts are hash outputs, so any of their bits will do as an index
+    std::uint32_t h;
+    std::memcpy (&h, id.data (), sizeof (h));
+    auto const index = h % slots_.size ();
+
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        auto const& slot = slots_[index];
+        if (! slot.text.empty () && slot.id == id)
+            return slot.text;
+    }
+
+    auto text = to_string (id);
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto& slot = slots_[index];
+    slot.id = id;
+    slot.text = text;
+    return text;
+}
+
+void
+AccountIDCache::clear ()
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    for (auto& slot : slots_)
+    {
+        slot.id.zero ();
+        slot.text.clear ();
+    }
+}
+
+AccountIDCache&
+getAccountIDCache ()
+{
+    static AccountIDCache cache (128000);
+    return cache;
+}
+
+} // ripple
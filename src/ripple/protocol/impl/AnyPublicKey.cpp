@@ -93,12 +93,7 @@ AnyPublicKeySlice::verify (
 std::string
 toString (AnyPublicKey const& pk)
 {
-    Blob buffer;
-    buffer.reserve (1 + pk.size ());
-    buffer.push_back (VER_NODE_PUBLIC);
-    auto const data = pk.data ();
-    buffer.insert (buffer.end (), data, data + pk.size ());
-    return Base58::encodeWithCheck (buffer);
+    return Base58::encodeWithCheck (VER_NODE_PUBLIC, pk.data (), pk.size ());
 }
 
 } // ripple
@@ -26,6 +26,7 @@
 #include <ripple/crypto/GenerateDeterministicKey.h>
 #include <ripple/crypto/RandomNumbers.h>
 #include <ripple/crypto/RFC1751.h>
+#include <ripple/protocol/AccountIDCache.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/RippleAddress.h>
 #include <ripple/protocol/Serializer.h>
@@ -348,18 +349,9 @@ Account RippleAddress::getAccountID () const
     }
 }
 
-using StaticLockType = std::mutex;
-using StaticScopedLockType = std::lock_guard <StaticLockType>;
-
-static StaticLockType s_lock;
-static hash_map <Blob, std::string> rncMapOld, rncMapNew;
-
 void RippleAddress::clearCache ()
 {
-    StaticScopedLockType sl (s_lock);
-
-    rncMapOld.clear ();
-    rncMapNew.clear ();
+    getAccountIDCache ().clear ();
 }
 
 std::string RippleAddress::humanAccountID () const
@@ -370,44 +362,7 @@ std::string RippleAddress::humanAccountID () const
         throw std::runtime_error ("unset source - humanAccountID");
 
     case VER_ACCOUNT_ID:
-    {
-        std::string ret;
-
-        {
-            StaticScopedLockType sl (s_lock);
-
-            auto it = rncMapNew.find (vchData);
-
-            if (it != rncMapNew.end ())
-            {
-                // Found in new map, nothing to do
-                ret = it->second;
-            }
-            else
-            {
-                it = rncMapOld.find (vchData);
-
-                if (it != rncMapOld.end ())
-                {
-                    ret = it->second;
-                    rncMapOld.erase (it);
-                }
-                else
-                    ret = ToString ();
-
-                if (rncMapNew.size () >= 128000)
-                {
-                    rncMapOld = std::move (rncMapNew);
-                    rncMapNew.clear ();
-                    rncMapNew.reserve (128000);
-                }
-
-                rncMapNew[vchData] = ret;
-            }
-        }
-
-        return ret;
-    }
+        return getAccountIDCache ().toBase58 (getAccountID ());
 
     case VER_ACCOUNT_PUBLIC:
     {
@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/AccountIDCache.h>
 
 namespace ripple {
 
@@ -30,13 +31,11 @@ STAccount::STAccount (SerialIter& sit, SField const& name)
 std::string STAccount::getText () const
 {
     Account u;
-    RippleAddress a;
 
     if (!getValueH160 (u))
         return STBlob::getText ();
 
-    a.setAccountID (u);
-    return a.humanAccountID ();
+    return getAccountIDCache ().toBase58 (u);
 }
 
 STAccount*
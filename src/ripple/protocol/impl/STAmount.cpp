@@ -20,7 +20,6 @@
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/JsonFields.h>
-#include <ripple/crypto/CBigNum.h>
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/UintTypes.h>
@@ -30,6 +29,7 @@
 #include <beast/cxx14/iterator.h> // <iterator>
 #include <beast/cxx14/memory.h> // <memory>
 #include <iostream>
+#include <limits>
 
 namespace ripple {
 
@@ -914,6 +914,64 @@ operator- (STAmount const& value)
 //
 //------------------------------------------------------------------------------
 
+namespace detail {
+
+std::uint64_t
+muldiv (std::uint64_t multiplier, std::uint64_t multiplicand,
+    std::uint64_t addend, std::uint64_t divisor)
+{
+    assert (divisor != 0);
+
+#if defined (__SIZEOF_INT128__)
+    using uint128_t = unsigned __int128;
+
+    uint128_t const v =
+        uint128_t (multiplier) * multiplicand + addend;
+
+    if ((v >> 64) >= divisor)
+        return std::numeric_limits <std::uint64_t>::max ();
+
+    return static_cast <std::uint64_t> (v / divisor);
+#else
+    // Form the 128-bit product from 32-bit halves
+    std::uint64_t const mask = 0xffffffff;
+    std::uint64_t const ll = (multiplier & mask) * (multiplicand & mask);
+    std::uint64_t const lh = (multiplier & mask) * (multiplicand >> 32);
+    std::uint64_t const hl = (multiplier >> 32) * (multiplicand & mask);
+    std::uint64_t const hh = (multiplier >> 32) * (multiplicand >> 32);
+    std::uint64_t const mid = (ll >> 32) + (lh & mask) + (hl & mask);
+
+    std::uint64_t lo = (mid << 32) | (ll & mask);
+    std::uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    lo += addend;
+    if (lo < addend)
+        ++hi;
+
+    if (hi >= divisor)
+        return std::numeric_limits <std::uint64_t>::max ();
+
+    // Shift-subtract long division. hi < divisor holds throughout,
+    // so the quotient fits in 64 bits.
+    std::uint64_t quotient = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        bool const carry = (hi >> 63) != 0;
+        hi = (hi << 1) | (lo >> 63);
+        lo <<= 1;
+        quotient <<= 1;
+        if (carry || hi >= divisor)
+        {
+            hi -= divisor;
+            quotient |= 1;
+        }
+    }
+    return quotient;
+#endif
+}
+
+} // detail
+
 STAmount
 divide (STAmount const& num, STAmount const& den, Issue const& issue)
 {
@@ -948,20 +1006,11 @@ divide (STAmount const& num, STAmount const& den, Issue const& issue)
     }
 
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) ||
-            (BN_mul_word64 (&v, tenTo17) != 1) ||
-            (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
     // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
+    auto const v = detail::muldiv (numVal, tenTo17, 0, denVal);
 
     // TODO(tom): where do 5 and 17 come from?
-    return STAmount (issue, v.getuint64 () + 5,
+    return STAmount (issue, v + 5,
                      numOffset - denOffset - 17,
                      num.negative() != den.negative());
 }
@@ -1012,21 +1061,11 @@ multiply (STAmount const& v1, STAmount const& v2, Issue const& issue)
     }
 
     // Compute (numerator * denominator) / 10^14 with rounding
-    // 10^16 <= result <= 10^18
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, value1) != 1) ||
-            (BN_mul_word64 (&v, value2) != 1) ||
-            (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
     // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
+    auto const v = detail::muldiv (value1, value2, 0, tenTo14);
 
     // TODO(tom): where do 7 and 14 come from?
-    return STAmount (issue, v.getuint64 () + 7,
+    return STAmount (issue, v + 7,
         offset1 + offset2 + 14, v1.negative() != v2.negative());
 }
 
@@ -1121,22 +1160,10 @@ mulRound (STAmount const& v1, STAmount const& v2,
 
     bool resultNegative = v1.negative() != v2.negative();
     // Compute (numerator * denominator) / 10^14 with rounding
-    // 10^16 <= result <= 10^18
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, value1) != 1) || (BN_mul_word64 (&v, value2) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // rounding down is automatic when we divide
-        BN_add_word64 (&v, tenTo14m1);
-
-    if  (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
     // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
-    std::uint64_t amount = v.getuint64 ();
+    // Rounding down is automatic when we divide
+    std::uint64_t amount = detail::muldiv (value1, value2,
+        (resultNegative != roundUp) ? tenTo14m1 : 0, tenTo14);
     int offset = offset1 + offset2 + 14;
     canonicalizeRound (
         isXRP (issue), amount, offset, resultNegative != roundUp);
@@ -1173,21 +1200,10 @@ divRound (STAmount const& num, STAmount const& den,
 
     bool resultNegative = num.negative() != den.negative();
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) || (BN_mul_word64 (&v, tenTo17) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // Rounding down is automatic when we divide
-        BN_add_word64 (&v, denVal - 1);
-
-    if (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
     // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
-    std::uint64_t amount = v.getuint64 ();
+    // Rounding down is automatic when we divide
+    std::uint64_t amount = detail::muldiv (numVal, tenTo17,
+        (resultNegative != roundUp) ? denVal - 1 : 0, denVal);
     int offset = numOffset - denOffset - 17;
     canonicalizeRound (
         isXRP (issue), amount, offset, resultNegative != roundUp);
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/crypto/Base58.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/protocol/RippleAddress.h>
@@ -28,7 +29,8 @@ namespace ripple {
 
 std::string to_string(Account const& account)
 {
-    return RippleAddress::createAccountID (account).humanAccountID ();
+    return Base58::encodeWithCheck (VER_ACCOUNT_ID,
+        account.data (), account.size ());
 }
 
 std::string to_string(Currency const& currency)
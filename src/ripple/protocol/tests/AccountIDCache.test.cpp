@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/protocol/AccountIDCache.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class AccountIDCache_test : public beast::unit_test::suite
+{
+public:
+    void
+    run () override
+    {
+        Account const zero;
+        Account const one (1);
+        auto const zeroText = to_string (zero);
+        auto const oneText = to_string (one);
+        expect (zeroText == "rrrrrrrrrrrrrrrrrrrrrhoLvTp");
+        expect (oneText == "rrrrrrrrrrrrrrrrrrrrBZbvji");
+
+        // Both accounts land in the only slot and evict each other
+        AccountIDCache single (1);
+        for (int i = 0; i < 3; ++i)
+        {
+            expect (single.toBase58 (zero) == zeroText);
+            expect (single.toBase58 (one) == oneText);
+        }
+        single.clear ();
+        expect (single.toBase58 (one) == oneText);
+
+        AccountIDCache disabled (0);
+        expect (disabled.toBase58 (one) == oneText);
+        disabled.clear ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountIDCache,protocol,ripple);
+
+}
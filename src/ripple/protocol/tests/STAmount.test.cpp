@@ -22,9 +22,36 @@
 #include <ripple/crypto/CBigNum.h>
 #include <ripple/protocol/STAmount.h>
 #include <beast/unit_test/suite.h>
+#include <chrono>
+#include <random>
+#include <vector>
 
 namespace ripple {
 
+namespace detail {
+
+// How multiply, divide, mulRound and divRound used to compute
+// (a * b + c) / d before switching to native 128-bit arithmetic
+static
+std::uint64_t
+bignumMuldiv (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    CBigNum v;
+
+    if ((BN_add_word64 (&v, a) != 1) ||
+            (BN_mul_word64 (&v, b) != 1) ||
+            (BN_add_word64 (&v, c) != 1) ||
+            (BN_div_word64 (&v, d) == ((std::uint64_t) - 1)))
+    {
+        throw std::runtime_error ("internal bn error");
+    }
+
+    return v.getuint64 ();
+}
+
+} // detail
+
 class STAmount_test : public beast::unit_test::suite
 {
 public:
@@ -569,6 +596,95 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void testMuldiv ()
+    {
+        testcase ("muldiv");
+
+        using detail::muldiv;
+        using detail::bignumMuldiv;
+
+        auto check = [this](std::uint64_t a, std::uint64_t b,
+            std::uint64_t c, std::uint64_t d)
+        {
+            auto const expected = bignumMuldiv (a, b, c, d);
+            auto const actual = muldiv (a, b, c, d);
+            if (actual == expected)
+                return true;
+            log <<
+                "(" << a << " * " << b << " + " << c << ") / " << d <<
+                " = " << actual << " not " << expected;
+            fail ("muldiv does not match bignum");
+            return false;
+        };
+
+        std::uint64_t const tenTo14 = 100000000000000ull;
+        std::uint64_t const tenTo17 = tenTo14 * 1000;
+        std::uint64_t const max = std::numeric_limits <std::uint64_t>::max ();
+
+        // Every combination of boundary values
+        std::vector <std::uint64_t> const edges ({
+            0, 1, 2, 9, 10, tenTo14 - 1, tenTo14, tenTo14 + 1,
+            STAmount::cMinValue - 1, STAmount::cMinValue,
+            STAmount::cMaxValue, STAmount::cMaxValue + 1,
+            STAmount::cMaxNativeN, STAmount::cMaxNative, tenTo17,
+            0xffffffffull, 0x100000000ull,
+            0x7fffffffffffffffull, 0x8000000000000000ull, max - 1, max});
+
+        bool ok = true;
+        for (auto const a : edges)
+            for (auto const b : edges)
+                for (auto const c : edges)
+                    for (auto const d : edges)
+                        if (d != 0 && ok)
+                            ok = check (a, b, c, d);
+        if (ok)
+            pass ();
+
+        // The operand ranges the STAmount arithmetic produces
+        std::mt19937_64 gen (5489);
+        std::uniform_int_distribution <std::uint64_t> mantissa (
+            STAmount::cMinValue, STAmount::cMaxNativeN);
+        std::uniform_int_distribution <std::uint64_t> iou (
+            STAmount::cMinValue, STAmount::cMaxValue);
+        std::uniform_int_distribution <std::uint64_t> any;
+
+        for (int i = 0; ok && i < 250000; ++i)
+        {
+            auto const a = mantissa (gen);
+            auto const b = mantissa (gen);
+            ok = check (a, b, 0, tenTo14) &&
+                check (a, b, tenTo14 - 1, tenTo14) &&
+                check (a, tenTo17, 0, b) &&
+                check (a, tenTo17, b - 1, b) &&
+                check (any (gen), any (gen), any (gen), any (gen) | 1);
+        }
+        if (ok)
+            pass ();
+
+        // Whole operations, against the formulas they used with bignums
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto const m1 = iou (gen);
+            auto const m2 = iou (gen);
+            STAmount const v1 (noIssue (), m1, -20, false);
+            STAmount const v2 (noIssue (), m2, 5, true);
+
+            expect (multiply (v1, v2, noIssue ()) == STAmount (noIssue (),
+                bignumMuldiv (m1, m2, 0, tenTo14) + 7, -15 + 14, true));
+            expect (divide (v1, v2, noIssue ()) == STAmount (noIssue (),
+                bignumMuldiv (m1, tenTo17, 0, m2) + 5, -25 - 17, true));
+            // Rounding a negative result up truncates
+            expect (mulRound (v1, v2, noIssue (), true) ==
+                STAmount (noIssue (), bignumMuldiv (
+                    m1, m2, 0, tenTo14), -15 + 14, true));
+            expect (divRound (v1, v2, noIssue (), true) ==
+                STAmount (noIssue (), bignumMuldiv (
+                    m1, tenTo17, 0, m2), -25 - 17, true));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void run ()
     {
         testSetValue ();
@@ -577,9 +693,93 @@ public:
         testArithmetic ();
         testUnderflow ();
         testRounding ();
+        testMuldiv ();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(STAmount,ripple_data,ripple);
 
+//------------------------------------------------------------------------------
+
+class STAmount_timing_test : public beast::unit_test::suite
+{
+public:
+    template <class Op>
+    void
+    timeOp (char const* name, std::vector <STAmount> const& amounts, Op&& op)
+    {
+        using clock_type = std::chrono::steady_clock;
+        int const passes = 20;
+
+        // Keep the optimizer from discarding the results
+        std::uint64_t sum = 0;
+        auto const start = clock_type::now ();
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (std::size_t i = 1; i < amounts.size (); ++i)
+                sum += op (amounts[i - 1], amounts[i]).mantissa ();
+        }
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::nanoseconds> (clock_type::now () - start);
+
+        log <<
+            name << ": " <<
+            elapsed.count () / (passes * (amounts.size () - 1)) <<
+            "ns per call (" << (sum & 1) << ")";
+    }
+
+    void
+    run ()
+    {
+        std::mt19937_64 gen (5489);
+        std::uniform_int_distribution <std::uint64_t> mantissa (
+            STAmount::cMinValue, STAmount::cMaxValue);
+        std::uniform_int_distribution <int> exponent (-10, 10);
+
+        std::vector <STAmount> amounts;
+        for (int i = 0; i < 50000; ++i)
+            amounts.emplace_back (noIssue (),
+                mantissa (gen), exponent (gen), false);
+
+        timeOp ("multiply", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return multiply (a, b, noIssue ());
+            });
+        timeOp ("divide", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return divide (a, b, noIssue ());
+            });
+        timeOp ("mulRound", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return mulRound (a, b, noIssue (), true);
+            });
+        timeOp ("divRound", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return divRound (a, b, noIssue (), true);
+            });
+
+        // The product step alone, old and new
+        timeOp ("bignum (a * b) / 10^14", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return STAmount (noIssue (), detail::bignumMuldiv (
+                    a.mantissa (), b.mantissa (), 0, 100000000000000ull));
+            });
+        timeOp ("muldiv (a * b) / 10^14", amounts,
+            [](STAmount const& a, STAmount const& b)
+            {
+                return STAmount (noIssue (), detail::muldiv (
+                    a.mantissa (), b.mantissa (), 0, 100000000000000ull));
+            });
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STAmount_timing,ripple_data,ripple);
+
 } // ripple
@@ -102,6 +102,7 @@ struct Entry
     clock_type::rep whenExpires;
 };
 
+inline
 std::ostream& operator<< (std::ostream& os, Entry const& v)
 {
     os << v.to_string();
@@ -104,9 +104,9 @@ struct YieldStrategy
 YieldStrategy makeYieldStrategy (Section const&);
 
 /** Return a continuation that runs a Callback on a Job Queue with a given
-    name and JobType. */
+    name and JobType. The name must outlive the continuation. */
 Continuation callbackOnJobQueue (
-    JobQueue&, std::string const& jobName, JobType);
+    JobQueue&, char const* jobName, JobType);
 
 /** Return a Callback that will suspend and then run a continuation. */
 inline
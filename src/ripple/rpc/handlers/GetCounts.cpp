@@ -21,6 +21,8 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/misc/CacheBudget.h>
+#include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/UptimeTimer.h>
 #include <ripple/nodestore/Database.h>
 
@@ -80,6 +82,8 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::fullbelow_size] = static_cast<int>(app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = app.family().treecache().getCacheSize();
     ret[jss::treenode_track_size] = app.family().treecache().getTrackSize();
+    ret[jss::fetch_pack_store] = app.getOPs().getFetchPackStoreJson ();
+    ret[jss::cache_budget] = app.getCacheBudget ().getJson ();
 
     std::string uptime;
     int s = UptimeTimer::getInstance ().getElapsedSeconds ();
@@ -90,11 +94,7 @@ Json::Value doGetCounts (RPC::Context& context)
     textTime (uptime, s, "second", 1);
     ret[jss::uptime] = uptime;
 
-    ret[jss::node_writes] = app.getNodeStore().getStoreCount();
-    ret[jss::node_reads_total] = app.getNodeStore().getFetchTotalCount();
-    ret[jss::node_reads_hit] = app.getNodeStore().getFetchHitCount();
-    ret[jss::node_written_bytes] = app.getNodeStore().getStoreSize();
-    ret[jss::node_read_bytes] = app.getNodeStore().getFetchSize();
+    app.getNodeStore().getCountsJson (ret);
 
     return ret;
 }
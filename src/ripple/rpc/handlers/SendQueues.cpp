@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/websocket/PermessageDeflate.h>
+
+namespace ripple {
+
+// {
+// }
+//
+// Reports the outbound queue of each websocket subscriber, largest first,
+// and how much permessage-deflate has saved.
+Json::Value doSendQueues (RPC::Context& context)
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::send_queues] = context.netOps.getSendQueues ();
+    ret[jss::permessage_deflate] = websocket::PermessageDeflate::getJson ();
+    return ret;
+}
+
+} // ripple
@@ -38,6 +38,16 @@ Json::Value doSubscribe (RPC::Context& context)
         return rpcError (rpcINVALID_PARAMS);
     }
 
+    if (context.params.isMember (jss::binary) &&
+        context.params.isMember (jss::url))
+    {
+        // Only a websocket can carry binary messages.
+        WriteLog (lsINFO, RPCHandler)
+            << "doSubscribe: binary requires a websocket";
+
+        return rpcError (rpcINVALID_PARAMS);
+    }
+
     if (context.params.isMember (jss::url))
     {
         if (context.role != Role::ADMIN)
@@ -87,6 +97,10 @@ Json::Value doSubscribe (RPC::Context& context)
         ispSub  = context.infoSub;
     }
 
+    // Applies to every stream of the connection
+    if (context.params.isMember (jss::binary))
+        ispSub->setBinary (context.params[jss::binary].asBool ());
+
     if (!context.params.isMember (jss::streams))
     {
     }
@@ -115,6 +115,7 @@ HandlerTable HANDLERS({
     {   "fetch_info",           byRef (&doFetchInfo),           Role::ADMIN,   NO_CONDITION     },
     {   "ledger_accept",        byRef (&doLedgerAccept),        Role::ADMIN,   NEEDS_CURRENT_LEDGER  },
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),       Role::ADMIN,   NEEDS_NETWORK_CONNECTION  },
+    {   "ledger_close_profile", byRef (&doLedgerCloseProfile),  Role::ADMIN,   NO_CONDITION     },
     {   "ledger_closed",        byRef (&doLedgerClosed),        Role::USER,  NO_CONDITION   },
     {   "ledger_current",       byRef (&doLedgerCurrent),       Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "ledger_data",          byRef (&doLedgerData),          Role::USER,  NO_CONDITION  },
@@ -132,6 +133,7 @@ HandlerTable HANDLERS({
 //      {   "profile",              byRef (&doProfile),             Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "random",               byRef (&doRandom),              Role::USER,  NO_CONDITION     },
     {   "ripple_path_find",     byRef (&doRipplePathFind),      Role::USER,  NO_CONDITION  },
+    {   "send_queues",          byRef (&doSendQueues),          Role::ADMIN,   NO_CONDITION     },
     {   "sign",                 byRef (&doSign),                Role::USER,  NO_CONDITION     },
 #if RIPPLE_ENABLE_MULTI_SIGN
     {   "sign_for",             byRef (&doSignFor),             Role::USER,    NO_CONDITION     },
@@ -178,12 +178,11 @@ error_code_i fillHandler (Context& context,
 
 template <class Object, class Method>
 Status callMethod (
-    Context& context, Method method, std::string const& name, Object& result)
+    Context& context, Method method, char const* name, Object& result)
 {
     try
     {
-        auto v = getApp().getJobQueue().getLoadEventAP(
-            jtGENERIC, "cmd:" + name);
+        auto v = getApp().getJobQueue().getLoadEventAP(jtGENERIC, name);
         return method (context, result);
     }
     catch (std::exception& e)
@@ -200,7 +199,7 @@ Status callMethod (
 
 template <class Method, class Object>
 void getResult (
-    Context& context, Method method, Object& object, std::string const& name)
+    Context& context, Method method, Object& object, char const* name)
 {
     auto&& result = Json::addObject (object, jss::result);
     if (auto status = callMethod (context, method, name, result))
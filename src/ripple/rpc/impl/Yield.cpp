@@ -81,7 +81,7 @@ YieldStrategy makeYieldStrategy (Section const& s)
 }
 
 Continuation callbackOnJobQueue (
-    JobQueue& jobQueue, std::string const& name, JobType jobType)
+    JobQueue& jobQueue, char const* name, JobType jobType)
 {
     return Continuation ([name, jobType, &jobQueue] (Callback const& cb) {
         jobQueue.addJob (jobType, name, [cb] (Job&) { cb(); });
@@ -23,6 +23,7 @@
 #include <beast/net/IPEndpoint.h>
 #include <beast/utility/ci_char_traits.h>
 #include <boost/asio/ip/address.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <set>
@@ -50,6 +51,18 @@ struct Port
     std::string ssl_chain;
     std::shared_ptr<boost::asio::ssl::context> context;
 
+    // Bytes a websocket client may have waiting before it is too slow
+    std::size_t send_queue_limit = 4 * 1024 * 1024;
+
+    // What to do with a slow websocket client: "close" or "drop"
+    std::string slow_consumer = "close";
+
+    // Whether websocket clients may negotiate permessage-deflate
+    bool permessage_deflate = false;
+
+    // Smallest websocket message that is compressed
+    std::size_t compress_threshold = 1024;
+
     // Returns `true` if any websocket protocols are specified
     template <class = void>
     bool
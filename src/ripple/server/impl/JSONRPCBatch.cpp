@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/server/impl/JSONRPCBatch.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/resource/Fees.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+std::pair <int, std::string>
+processBatch (Json::Value const& batch, std::size_t concurrency,
+    Resource::Consumer& usage, BatchHandler const& handler,
+        BatchPost const& post)
+{
+    if (! batch.isArray () || batch.size () == 0)
+        return {400, "Unable to parse request"};
+
+    if (batch.size () > maxBatchEntries)
+        return {400, "Batch is too large"};
+
+    struct State
+    {
+        std::atomic <std::size_t> next {0};
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::size_t done = 0;
+    };
+
+    auto const count = batch.size ();
+    auto state = std::make_shared <State> ();
+    std::vector <std::string> replies (count);
+
+    // Claims and runs entries until none are left. Helpers that start
+    // after the last entry was claimed return without touching the batch.
+    auto run = [state, count, &batch, &replies, &usage, &handler] ()
+    {
+        for (;;)
+        {
+            auto const i = state->next++;
+            if (i >= count)
+                return;
+
+            auto const& entry = batch[static_cast <Json::UInt> (i)];
+            std::pair <int, std::string> reply;
+            try
+            {
+                reply = handler (entry);
+            }
+            catch (std::exception const& e)
+            {
+                reply = {500, e.what ()};
+            }
+
+            if (reply.first == 200)
+            {
+                replies[i] = std::move (reply.second);
+            }
+            else
+            {
+                usage.charge (Resource::feeInvalidRPC);
+
+                auto const code =
+                    reply.first == 403 ? rpcFORBIDDEN :
+                    reply.first == 503 ? rpcSLOW_DOWN :
+                    reply.first == 500 ? rpcINTERNAL :
+                    rpcINVALID_PARAMS;
+                Json::Value result = RPC::make_error (code, reply.second);
+                result[jss::status] = jss::error;
+                result[jss::request] = entry;
+                Json::Value wrapped (Json::objectValue);
+                wrapped[jss::result] = std::move (result);
+                replies[i] = to_string (wrapped);
+            }
+
+            std::lock_guard <std::mutex> lock (state->mutex);
+            if (++state->done == count)
+                state->cond.notify_all ();
+        }
+    };
+
+    auto const helpers = std::min <std::size_t> (
+        count, std::max <std::size_t> (concurrency, 1)) - 1;
+    for (std::size_t i = 0; i < helpers; ++i)
+        post (run);
+
+    run ();
+
+    {
+        std::unique_lock <std::mutex> lock (state->mutex);
+        state->cond.wait (lock, [&] { return state->done == count; });
+    }
+
+    std::size_t size = 2 + count;
+    for (auto const& reply : replies)
+        size += reply.size ();
+
+    std::string response;
+    response.reserve (size);
+    response += '[';
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (i != 0)
+            response += ',';
+        response += replies[i];
+    }
+    response += ']';
+    return {200, std::move (response)};
+}
+
+} // ripple
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+#ifndef RIPPLE_SERVER_JSONRPCBATCH_H_INCLUDED
+#define RIPPLE_SERVER_JSONRPCBATCH_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/resource/Consumer.h>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace ripple {
+
+/** The most request objects a JSON-RPC batch may hold. */
+std::size_t const maxBatchEntries = 256;
+
+/** Executes one request object of a batch.
+
+    @return The HTTP status and, on success, the serialized reply.
+            Otherwise the reason the request was rejected.
+*/
+using BatchHandler = std::function <
+    std::pair <int, std::string> (Json::Value const& entry)>;
+
+/** Runs a function on some other thread. */
+using BatchPost = std::function <void (std::function <void ()>)>;
+
+/** Execute a JSON-RPC batch, an array of request objects.
+
+    The entries are claimed in order by the caller and by up to
+    `concurrency - 1` helpers started through `post`. The caller therefore
+    only waits for entries that are already running, never for a helper
+    that has not started.
+
+    An entry that the handler rejects produces an error reply in its slot
+    instead of failing the batch, and is charged to `usage` as an invalid
+    request. Entries the handler accepts are expected to charge their own
+    fee.
+
+    The whole reply is built before it is returned, because every HTTP
+    reply the server sends carries a Content-Length.
+
+    @return 400 if the batch is empty or holds more than maxBatchEntries
+            entries, otherwise 200 and the replies in request order as a
+            single JSON array.
+*/
+std::pair <int, std::string>
+processBatch (Json::Value const& batch, std::size_t concurrency,
+    Resource::Consumer& usage, BatchHandler const& handler,
+        BatchPost const& post);
+
+} // ripple
+
+#endif
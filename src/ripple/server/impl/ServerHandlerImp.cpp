@@ -22,6 +22,7 @@
 #include <ripple/json/json_reader.h>
 #include <ripple/server/JsonWriter.h>
 #include <ripple/server/make_ServerHandler.h>
+#include <ripple/server/impl/JSONRPCBatch.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
 #include <ripple/server/impl/ServerHandlerImp.h>
 #include <ripple/basics/Log.h>
@@ -256,13 +257,74 @@ ServerHandlerImp::processRequest (
         if ((request.size () > 1000000) ||
             ! reader.parse (request, jsonRPC) ||
             jsonRPC.isNull () ||
-            ! jsonRPC.isObject ())
+            ! (jsonRPC.isObject () || jsonRPC.isArray ()))
         {
             HTTPReply (400, "Unable to parse request", output);
             return;
         }
     }
 
+    std::pair <int, std::string> reply;
+    if (jsonRPC.isArray ())
+    {
+        // Rejected entries are charged here, the others by processJsonRPC
+        Resource::Consumer usage;
+        if (requestRole (Role::GUEST, port, Json::objectValue,
+                remoteIPAddress) == Role::ADMIN)
+            usage = m_resourceManager.newAdminEndpoint (
+                remoteIPAddress.to_string ());
+        else
+            usage = m_resourceManager.newInboundEndpoint (remoteIPAddress);
+
+        reply = processBatch (jsonRPC, maxBatchConcurrency, usage,
+            [&] (Json::Value const& entry)
+            {
+                // Entries run without a coroutine, each on its own job
+                return processJsonRPC (
+                    port, entry, remoteIPAddress, Suspend ());
+            },
+            [this] (std::function <void ()> f)
+            {
+                m_jobQueue.addJob (
+                    jtCLIENT, "RPC-Batch", [f] (Job&) { f (); });
+            });
+    }
+    else
+    {
+        reply = processJsonRPC (port, jsonRPC, remoteIPAddress, suspend);
+    }
+
+    if (reply.first != 200)
+    {
+        HTTPReply (reply.first, reply.second, output);
+        return;
+    }
+
+    auto& response = reply.second;
+    response += '\n';
+
+    if (m_journal.debug.active())
+    {
+        static const int maxSize = 10000;
+        if (response.size() <= maxSize)
+            m_journal.debug << "Reply: " << response;
+        else
+            m_journal.debug << "Reply: " << response.substr (0, maxSize);
+    }
+
+    HTTPReply (200, response, output);
+}
+
+std::pair <int, std::string>
+ServerHandlerImp::processJsonRPC (
+    HTTP::Port const& port,
+    Json::Value const& jsonRPC,
+    beast::IP::Endpoint const& remoteIPAddress,
+    Suspend const& suspend)
+{
+    if (! jsonRPC.isObject ())
+        return {400, "Unable to parse request"};
+
     // Parse id now so errors from here on will have the id
     //
     // VFALCO NOTE Except that "id" isn't included in the following errors.
@@ -271,21 +333,17 @@ ServerHandlerImp::processRequest (
 
     Json::Value const& method = jsonRPC ["method"];
 
-    if (method.isNull ()) {
-        HTTPReply (400, "Null method", output);
-        return;
-    }
+    if (method.isNull ())
+        return {400, "Null method"};
 
-    if (!method.isString ()) {
-        HTTPReply (400, "method is not string", output);
-        return;
-    }
+    if (!method.isString ())
+        return {400, "method is not string"};
 
     /* ---------------------------------------------------------------------- */
     auto role = Role::FORBID;
     auto required = RPC::roleRequired(id.asString());
 
-    if (jsonRPC.isObject() && jsonRPC.isMember("params") &&
+    if (jsonRPC.isMember("params") &&
             jsonRPC["params"].isArray() && jsonRPC["params"].size() > 0 &&
                 jsonRPC["params"][Json::UInt(0)].isObject())
     {
@@ -307,15 +365,13 @@ ServerHandlerImp::processRequest (
 
     if (usage.disconnect ())
     {
-        HTTPReply (503, "Server is overloaded", output);
-        return;
+        return {503, "Server is overloaded"};
     }
 
     std::string strMethod = method.asString ();
     if (strMethod.empty())
     {
-        HTTPReply (400, "method is empty", output);
-        return;
+        return {400, "method is empty"};
     }
 
     // Extract request parameters from the request Json as `params`.
@@ -331,16 +387,14 @@ ServerHandlerImp::processRequest (
 
     else if (!params.isArray () || params.size() != 1)
     {
-        HTTPReply (400, "params unparseable", output);
-        return;
+        return {400, "params unparseable"};
     }
     else
     {
         params = std::move (params[0u]);
         if (!params.isObject())
         {
-            HTTPReply (400, "params unparseable", output);
-            return;
+            return {400, "params unparseable"};
         }
     }
 
@@ -351,8 +405,7 @@ ServerHandlerImp::processRequest (
         // VFALCO TODO Needs implementing
         // FIXME Needs implementing
         // XXX This needs rate limiting to prevent brute forcing password.
-        HTTPReply (403, "Forbidden", output);
-        return;
+        return {403, "Forbidden"};
     }
 
     Resource::Charge loadType = Resource::feeReferenceRPC;
@@ -366,8 +419,8 @@ ServerHandlerImp::processRequest (
 
     auto const start (std::chrono::high_resolution_clock::now ());
     RPC::Context context {
-        params, loadType, m_networkOPs, role, nullptr,
-                std::move (suspend), std::move (yield)};
+        params, loadType, m_networkOPs, role, nullptr, suspend,
+                RPC::suspendForContinuation (suspend, m_continuation)};
     std::string response;
 
     if (setup_.yieldStrategy.streaming == RPC::YieldStrategy::Streaming::yes)
@@ -407,19 +460,8 @@ ServerHandlerImp::processRequest (
     rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
         response.size ()));
 
-    response += '\n';
     usage.charge (loadType);
-
-    if (m_journal.debug.active())
-    {
-        static const int maxSize = 10000;
-        if (response.size() <= maxSize)
-            m_journal.debug << "Reply: " << response;
-        else
-            m_journal.debug << "Reply: " << response.substr (0, maxSize);
-    }
-
-    HTTPReply (200, response, output);
+    return {200, std::move (response)};
 }
 
 //------------------------------------------------------------------------------
@@ -510,10 +552,14 @@ struct ParsedPort
     std::string ssl_key;
     std::string ssl_cert;
     std::string ssl_chain;
+    std::string slow_consumer;
 
     boost::optional<boost::asio::ip::address> ip;
     boost::optional<std::uint16_t> port;
     boost::optional<std::vector<beast::IP::Address>> admin_ip;
+    boost::optional<std::size_t> send_queue_limit;
+    boost::optional<bool> permessage_deflate;
+    boost::optional<std::size_t> compress_threshold;
 };
 
 void
@@ -608,6 +654,59 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
     set(port.ssl_key, "ssl_key", section);
     set(port.ssl_cert, "ssl_cert", section);
     set(port.ssl_chain, "ssl_chain", section);
+
+    {
+        auto const result = section.find("send_queue_limit");
+        if (result.second)
+        {
+            try
+            {
+                port.send_queue_limit = std::stoul(result.first);
+            }
+            catch(...)
+            {
+                log << "Invalid value '" << result.first <<
+                    "' for key 'send_queue_limit' in [" << section.name() << "]\n";
+                throw std::exception();
+            }
+        }
+    }
+
+    set(port.slow_consumer, "slow_consumer", section);
+
+    {
+        auto const result = section.find("permessage_deflate");
+        if (result.second)
+        {
+            if (result.first == "1" || result.first == "true")
+                port.permessage_deflate = true;
+            else if (result.first == "0" || result.first == "false")
+                port.permessage_deflate = false;
+            else
+            {
+                log << "Invalid value '" << result.first <<
+                    "' for key 'permessage_deflate' in [" << section.name() << "]\n";
+                throw std::exception();
+            }
+        }
+    }
+
+    {
+        auto const result = section.find("compress_threshold");
+        if (result.second)
+        {
+            try
+            {
+                port.compress_threshold = std::stoul(result.first);
+            }
+            catch(...)
+            {
+                log << "Invalid value '" << result.first <<
+                    "' for key 'compress_threshold' in [" << section.name() << "]\n";
+                throw std::exception();
+            }
+        }
+    }
 }
 
 HTTP::Port
@@ -660,6 +759,33 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_cert = parsed.ssl_cert;
     p.ssl_chain = parsed.ssl_chain;
 
+    if (parsed.send_queue_limit)
+    {
+        if (*parsed.send_queue_limit == 0)
+        {
+            log << "Value '0' for key 'send_queue_limit' in [" <<
+                p.name << "] is invalid\n";
+            throw std::exception();
+        }
+        p.send_queue_limit = *parsed.send_queue_limit;
+    }
+
+    if (! parsed.slow_consumer.empty())
+    {
+        if (parsed.slow_consumer != "close" && parsed.slow_consumer != "drop")
+        {
+            log << "Invalid value '" << parsed.slow_consumer <<
+                "' for key 'slow_consumer' in [" << p.name << "]\n";
+            throw std::exception();
+        }
+        p.slow_consumer = parsed.slow_consumer;
+    }
+
+    if (parsed.permessage_deflate)
+        p.permessage_deflate = *parsed.permessage_deflate;
+    if (parsed.compress_threshold)
+        p.compress_threshold = *parsed.compress_threshold;
+
     return p;
 }
 
@@ -58,6 +58,8 @@ private:
     using Output = Json::Output;
     using Suspend = RPC::Suspend;
 
+    static std::size_t const maxBatchConcurrency = 8;
+
     void
     setup (Setup const& setup, beast::Journal journal) override;
 
@@ -114,6 +116,17 @@ private:
     processRequest (HTTP::Port const& port, std::string const& request,
         beast::IP::Endpoint const& remoteIPAddress, Output&&, Suspend const&);
 
+    /** Execute one JSON-RPC request object.
+
+        Each request is charged to the endpoint separately.
+
+        @return The HTTP status and, on success, the serialized reply.
+                Otherwise the reason the request was rejected.
+    */
+    std::pair <int, std::string>
+    processJsonRPC (HTTP::Port const& port, Json::Value const& jsonRPC,
+        beast::IP::Endpoint const& remoteIPAddress, Suspend const&);
+
     //
     // PropertyStream
     //
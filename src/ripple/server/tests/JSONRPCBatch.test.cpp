@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/server/impl/JSONRPCBatch.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/resource/impl/Entry.h>
+#include <ripple/resource/impl/Logic.h>
+#include <beast/chrono/manual_clock.h>
+#include <beast/unit_test/suite.h>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class JSONRPCBatch_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = beast::manual_clock <std::chrono::steady_clock>;
+
+    // Runs helpers on threads that are joined when the batch is done
+    class Helpers
+    {
+    public:
+        ~Helpers ()
+        {
+            join ();
+        }
+
+        BatchPost
+        post ()
+        {
+            return [this] (std::function <void ()> f)
+            {
+                threads_.emplace_back (std::move (f));
+            };
+        }
+
+        std::size_t
+        join ()
+        {
+            for (auto& thread : threads_)
+                thread.join ();
+            auto const n = threads_.size ();
+            threads_.clear ();
+            return n;
+        }
+
+    private:
+        std::vector <std::thread> threads_;
+    };
+
+    static
+    Json::Value
+    request (int id)
+    {
+        Json::Value entry (Json::objectValue);
+        entry[jss::method] = "ping";
+        entry[jss::id] = id;
+        return entry;
+    }
+
+    // Accepts entries that name a method and charges them, like the
+    // server's handler does, and rejects the others the way it would.
+    static
+    BatchHandler
+    makeHandler (Resource::Consumer& usage)
+    {
+        return [&usage] (Json::Value const& entry)
+            -> std::pair <int, std::string>
+        {
+            if (! entry.isObject () || ! entry.isMember (jss::method))
+                return {400, "Null method"};
+            if (entry[jss::method] == "forbidden")
+                return {403, "Forbidden"};
+            if (entry[jss::method] == "throw")
+                throw std::runtime_error ("thrown");
+
+            usage.charge (Resource::feeReferenceRPC);
+
+            Json::Value result (Json::objectValue);
+            result[jss::status] = jss::success;
+            result[jss::id] = entry[jss::id];
+            Json::Value reply (Json::objectValue);
+            reply[jss::result] = std::move (result);
+            return {200, to_string (reply)};
+        };
+    }
+
+    void
+    expectError (Json::Value const& reply, Json::Value const& entry,
+        error_code_i code)
+    {
+        Json::Value const& result = reply[jss::result];
+        expect (result[jss::status] == jss::error, "Should be an error");
+        expect (result[jss::error] ==
+            RPC::get_error_info (code).token, "Wrong error");
+        expect (result.isMember (jss::error_message), "Should explain");
+        expect (result[jss::request] == entry, "Should echo the entry");
+    }
+
+    void
+    testMixed ()
+    {
+        testcase ("mixed batch");
+
+        clock_type clock;
+        Resource::Logic logic (
+            beast::insight::NullCollector::New (), clock, beast::Journal ());
+        auto usage = logic.newInboundEndpoint (beast::IP::Endpoint (
+            beast::IP::AddressV4 (207, 127, 82, 1)));
+        auto expected = logic.newInboundEndpoint (beast::IP::Endpoint (
+            beast::IP::AddressV4 (207, 127, 82, 2)));
+
+        int const count = 40;
+        Json::Value batch (Json::arrayValue);
+        for (int i = 0; i < count; ++i)
+        {
+            switch (i % 5)
+            {
+            case 1:
+                batch.append (Json::Value (i));
+                expected.charge (Resource::feeInvalidRPC);
+                break;
+            case 2:
+            {
+                Json::Value entry (Json::objectValue);
+                entry[jss::method] = "forbidden";
+                batch.append (entry);
+                expected.charge (Resource::feeInvalidRPC);
+                break;
+            }
+            case 3:
+            {
+                Json::Value entry (Json::objectValue);
+                entry[jss::method] = "throw";
+                batch.append (entry);
+                expected.charge (Resource::feeInvalidRPC);
+                break;
+            }
+            default:
+                batch.append (request (i));
+                expected.charge (Resource::feeReferenceRPC);
+                break;
+            }
+        }
+
+        Helpers helpers;
+        auto const reply = processBatch (
+            batch, 4, usage, makeHandler (usage), helpers.post ());
+        expect (helpers.join () == 3, "Should start three helpers");
+
+        expect (reply.first == 200, "Should accept the batch");
+
+        Json::Value replies;
+        if (! expect (Json::Reader ().parse (reply.second, replies) &&
+                replies.isArray () && replies.size () == count,
+                    "Should reply to every entry"))
+            return;
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto const& entry = batch[i];
+            auto const& each = replies[i];
+            switch (i % 5)
+            {
+            case 1:
+                expectError (each, entry, rpcINVALID_PARAMS);
+                break;
+            case 2:
+                expectError (each, entry, rpcFORBIDDEN);
+                break;
+            case 3:
+                expectError (each, entry, rpcINTERNAL);
+                break;
+            default:
+                expect (each[jss::result][jss::status] == jss::success,
+                    "Should succeed");
+                expect (each[jss::result][jss::id] == i,
+                    "Should be in request order");
+                break;
+            }
+        }
+
+        expect (usage.balance () > 0 &&
+            usage.balance () == expected.balance (),
+                "Should charge each entry");
+    }
+
+    void
+    testRejected ()
+    {
+        testcase ("rejected batches");
+
+        clock_type clock;
+        Resource::Logic logic (
+            beast::insight::NullCollector::New (), clock, beast::Journal ());
+        auto usage = logic.newInboundEndpoint (beast::IP::Endpoint (
+            beast::IP::AddressV4 (207, 127, 82, 1)));
+
+        std::size_t handled = 0;
+        BatchHandler handler = [&handled] (Json::Value const&)
+        {
+            ++handled;
+            return std::make_pair (200, std::string ("{}"));
+        };
+
+        Helpers helpers;
+        expect (processBatch (Json::Value (Json::arrayValue), 4, usage,
+            handler, helpers.post ()).first == 400,
+                "Should reject an empty batch");
+
+        Json::Value batch (Json::arrayValue);
+        for (std::size_t i = 0; i <= maxBatchEntries; ++i)
+            batch.append (request (static_cast <int> (i)));
+        expect (processBatch (batch, 4, usage, handler,
+            helpers.post ()).first == 400,
+                "Should reject a batch over the limit");
+
+        expect (handled == 0, "Should not run any entry");
+        expect (helpers.join () == 0, "Should not start helpers");
+        expect (usage.balance () == 0, "Should not charge");
+
+        batch.resize (maxBatchEntries);
+        expect (processBatch (batch, 1, usage, handler,
+            helpers.post ()).first == 200,
+                "Should accept a batch at the limit");
+        expect (handled == maxBatchEntries, "Should run every entry");
+        expect (helpers.join () == 0, "Should run on the caller");
+    }
+
+    void
+    run ()
+    {
+        testMixed ();
+        testRejected ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(JSONRPCBatch,server,ripple);
+
+} // ripple
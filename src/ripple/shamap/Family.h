@@ -57,6 +57,14 @@ public:
     NodeStore::Database const&
     db() const = 0;
 
+    /** Whether nodes read from db() are also kept in its cache.
+        The tree node cache already holds every node read, so this
+        is only useful if the same objects are fetched some other way.
+    */
+    virtual
+    bool
+    cache_objects() const = 0;
+
     virtual
     void
     missing_node (std::uint32_t refNum) = 0;
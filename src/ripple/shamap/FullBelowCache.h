@@ -83,6 +83,16 @@ public:
         return m_cache.size ();
     }
 
+    /** Return the number of elements and the hit and miss counts.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    void getStats (std::size_t& size,
+        std::uint64_t& hits, std::uint64_t& misses) const
+    {
+        m_cache.getStats (size, hits, misses);
+    }
+
     /** Remove expired cache items.
         Thread safety:
             Safe to call from any thread.
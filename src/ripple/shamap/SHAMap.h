@@ -174,6 +174,23 @@ public:
     SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID, Blob const& rawNode,
                                 SHAMapSyncFilter * filter);
 
+    /** Deserialize and hash a batch of nodes received from a peer.
+
+        This reads no map state and needs no lock, so large batches are
+        spread across all cores. Data that cannot be parsed yields a null
+        node, which addRootNode and addKnownNode reject as invalid.
+    */
+    static std::vector<std::shared_ptr<SHAMapTreeNode>> makeNodes (
+        std::vector<Blob> const& rawNodes, SHANodeFormat format);
+
+    /** Link a node made by makeNodes into the tree. */
+    /** @{ */
+    SHAMapAddNode addRootNode (uint256 const& hash,
+        std::shared_ptr<SHAMapTreeNode> node, SHAMapSyncFilter * filter);
+    SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID,
+        std::shared_ptr<SHAMapTreeNode> node, SHAMapSyncFilter * filter);
+    /** @} */
+
     // status functions
     void setImmutable ();
     bool isSynching () const;
@@ -224,6 +241,12 @@ private:
     std::shared_ptr<SHAMapTreeNode> checkFilter (uint256 const& hash, SHAMapNodeID const& id,
         SHAMapSyncFilter* filter) const;
 
+    /** Start reading the children of an inner node that are not in memory.
+        Traversals call this as they reach an inner node, so the reads
+        overlap with the work done on the node's earlier siblings.
+    */
+    void prefetchChildren (SHAMapTreeNode* node) const;
+
     /** Update hashes up to the root */
     void dirtyUp (SharedPtrNodeStack& stack,
                   uint256 const& target, std::shared_ptr<SHAMapTreeNode> terminal);
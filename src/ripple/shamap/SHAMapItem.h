@@ -40,6 +40,7 @@ public:
     explicit SHAMapItem (uint256 const& tag);
     SHAMapItem (uint256 const& tag, Blob const & data);
     SHAMapItem (uint256 const& tag, Serializer const& s);
+    SHAMapItem (uint256 const& tag, void const* data, std::size_t size);
 
     Slice slice() const;
 
@@ -72,6 +72,8 @@ public:
     SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item, TNType type, std::uint32_t seq);
     SHAMapTreeNode (Blob const & data, std::uint32_t seq,
                     SHANodeFormat format, uint256 const& hash, bool hashValid);
+    SHAMapTreeNode (Slice const& data, std::uint32_t seq,
+                    SHANodeFormat format, uint256 const& hash, bool hashValid);
 
     void addRaw (Serializer&, SHANodeFormat format);
     uint256 const& getNodeHash () const;
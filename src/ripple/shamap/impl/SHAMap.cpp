@@ -174,21 +174,36 @@ SHAMap::fetchNodeFromDB (uint256 const& hash) const
 
     if (backed_)
     {
-        std::shared_ptr<NodeObject> obj = f_.db().fetch (hash);
-        if (obj)
-        {
-            try
+        bool valid = true;
+
+        // Decode straight from the fetched payload
+        bool const found = f_.db().fetchPayload (hash,
+            [&](NodeObjectType, void const* data, std::size_t size)
             {
-                node = std::make_shared <SHAMapTreeNode> (obj->getData(),
-                    0, snfPREFIX, hash, true);
-                canonicalize (hash, node);
-            }
-            catch (...)
+                try
+                {
+                    if (size == 0)
+                        throw std::runtime_error ("empty node");
+
+                    node = std::make_shared <SHAMapTreeNode> (
+                        Slice (data, size), 0, snfPREFIX, hash, true);
+                }
+                catch (...)
+                {
+                    valid = false;
+                }
+            }, f_.cache_objects ());
+
+        if (found)
+        {
+            if (! valid)
             {
                 if (journal_.warning) journal_.warning <<
                     "Invalid DB node " << hash;
                 return std::shared_ptr<SHAMapTreeNode> ();
             }
+
+            canonicalize (hash, node);
         }
         else if (ledgerSeq_ != 0)
         {
@@ -271,6 +286,22 @@ std::shared_ptr<SHAMapTreeNode> SHAMap::fetchNode (uint256 const& hash) const
     return node;
 }
 
+void SHAMap::prefetchChildren (SHAMapTreeNode* node) const
+{
+    if (!backed_ || !node->isInner ())
+        return;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (node->isEmptyBranch (branch) || node->getChildPointer (branch))
+            continue;
+
+        uint256 const& hash = node->getChildHash (branch);
+        if (!f_.treecache ().refreshIfPresent (hash))
+            f_.db ().prefetch (hash);
+    }
+}
+
 SHAMapTreeNode* SHAMap::descendThrow (SHAMapTreeNode* parent, int branch) const
 {
     SHAMapTreeNode* ret = descend (parent, branch);
@@ -233,6 +233,7 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
     {
         std::shared_ptr<SHAMapTreeNode> node = std::move (nodeStack.top());
         nodeStack.pop ();
+        prefetchChildren (node.get ());
 
         for (int i = 0; i < 16; ++i)
         {
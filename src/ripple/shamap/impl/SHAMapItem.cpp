@@ -36,6 +36,12 @@ SHAMapItem::SHAMapItem (uint256 const& tag, const Serializer& data)
 {
 }
 
+SHAMapItem::SHAMapItem (uint256 const& tag, void const* data, std::size_t size)
+    : mTag (tag)
+    , mData (data, size)
+{
+}
+
 // VFALCO This function appears not to be called
 void SHAMapItem::dump (beast::Journal journal)
 {
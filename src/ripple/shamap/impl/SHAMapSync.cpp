@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/basics/ParallelFor.h>
 #include <beast/unit_test/suite.h>
 
 namespace ripple {
@@ -64,6 +65,8 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) c
     std::shared_ptr<SHAMapTreeNode> node = root_;
     int pos = 0;
 
+    prefetchChildren (node.get ());
+
     while (1)
     {
         while (pos < 16)
@@ -92,6 +95,8 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) c
                     // descend to the child's first position
                     node = child;
                     pos = 0;
+
+                    prefetchChildren (node.get ());
                 }
             }
             else
@@ -398,6 +403,21 @@ bool SHAMap::getRootNode (Serializer& s, SHANodeFormat format) const
     return true;
 }
 
+// Returns null if the data cannot be parsed
+static std::shared_ptr<SHAMapTreeNode>
+makeNode (Blob const& rawNode, SHANodeFormat format)
+{
+    try
+    {
+        return std::make_shared<SHAMapTreeNode> (rawNode, 0,
+            format, uZero, false);
+    }
+    catch (std::exception const&)
+    {
+        return nullptr;
+    }
+}
+
 SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode,
     SHANodeFormat format, SHAMapSyncFilter* filter)
 {
@@ -451,10 +471,22 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
         return SHAMapAddNode::duplicate ();
     }
 
+    return addRootNode (hash, makeNode (rootNode, format), filter);
+}
+
+SHAMapAddNode SHAMap::addRootNode (uint256 const& hash,
+    std::shared_ptr<SHAMapTreeNode> node, SHAMapSyncFilter* filter)
+{
+    // we already have a root_ node
+    if (root_->getNodeHash ().isNonZero ())
+    {
+        if (journal_.trace) journal_.trace <<
+            "got root node, already have one";
+        assert (root_->getNodeHash () == hash);
+        return SHAMapAddNode::duplicate ();
+    }
+
     assert (seq_ >= 1);
-    std::shared_ptr<SHAMapTreeNode> node =
-        std::make_shared<SHAMapTreeNode> (rootNode, 0,
-                                          format, uZero, false);
 
     if (!node || node->getNodeHash () != hash)
         return SHAMapAddNode::invalid ();
@@ -478,9 +510,43 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
     return SHAMapAddNode::useful ();
 }
 
+// Each thread helping to make a batch gets at least this many nodes
+static std::size_t const nodesPerThread = 32;
+
+std::vector<std::shared_ptr<SHAMapTreeNode>>
+SHAMap::makeNodes (std::vector<Blob> const& rawNodes, SHANodeFormat format)
+{
+    // Parsing and hashing each node is independent of the others and of
+    // the map, so only the linking in addKnownNode has to be serial.
+    std::vector<std::shared_ptr<SHAMapTreeNode>> nodes (rawNodes.size ());
+
+    parallel_for (rawNodes.size (), nodesPerThread,
+        [&](std::size_t i)
+        {
+            nodes[i] = makeNode (rawNodes[i], format);
+        });
+
+    return nodes;
+}
+
 SHAMapAddNode
 SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
                       SHAMapSyncFilter* filter)
+{
+    if (!isSynching ())
+    {
+        if (journal_.trace) journal_.trace <<
+            "AddKnownNode while not synching";
+        return SHAMapAddNode::duplicate ();
+    }
+
+    return addKnownNode (node, makeNode (rawNode, snfWIRE), filter);
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode (const SHAMapNodeID& node,
+                      std::shared_ptr<SHAMapTreeNode> newNode,
+                      SHAMapSyncFilter* filter)
 {
     // return value: true=okay, false=error
     assert (!node.isRoot ());
@@ -531,8 +597,12 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
                 return SHAMapAddNode::invalid ();
             }
 
-            auto newNode = std::make_shared<SHAMapTreeNode>(rawNode, 0, snfWIRE,
-                                                            uZero, false);
+            if (!newNode)
+            {
+                if (journal_.warning) journal_.warning <<
+                    "Malformed node received";
+                return SHAMapAddNode::invalid ();
+            }
 
             if (!newNode->isInBounds (iNodeID))
             {
@@ -757,6 +827,7 @@ void SHAMap::visitDifferences (SHAMap* have, std::function <bool (SHAMapTreeNode
             return;
 
         // 2) push non-matching child inner nodes
+        prefetchChildren (node);
         for (int i = 0; i < 16; ++i)
         {
             if (!node->isEmptyBranch (i))
@@ -73,9 +73,35 @@ SHAMapTreeNode::SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item,
     updateHash ();
 }
 
+static
+Slice
+nodeSlice (Blob const& rawNode)
+{
+    if (rawNode.empty ())
+    {
+#ifdef BEAST_DEBUG
+        deprecatedLogs().journal("SHAMapTreeNode").fatal <<
+            "Node is empty";
+        assert (false);
+#endif
+        throw std::runtime_error ("invalid node: empty");
+    }
+
+    return make_Slice (rawNode);
+}
+
 SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                                 std::uint32_t seq, SHANodeFormat format,
                                 uint256 const& hash, bool hashValid)
+    : SHAMapTreeNode (nodeSlice (rawNode), seq, format, hash, hashValid)
+{
+}
+
+// The node is decoded in place: inner node hashes are read straight
+// from rawNode, and a leaf's data is copied only once, into its item.
+SHAMapTreeNode::SHAMapTreeNode (Slice const& rawNode,
+                                std::uint32_t seq, SHANodeFormat format,
+                                uint256 const& hash, bool hashValid)
     : mSeq (seq)
     , mType (tnERROR)
     , mIsBranch (0)
@@ -83,19 +109,9 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 {
     if (format == snfWIRE)
     {
-        if (rawNode.empty ())
-        {
-#ifdef BEAST_DEBUG
-            deprecatedLogs().journal("SHAMapTreeNode").fatal <<
-                "Wire format node is empty";
-            assert (false);
-#endif
-            throw std::runtime_error ("invalid node AW type");
-        }
-
-        Serializer s (rawNode.data(), rawNode.size() - 1);
-        int type = rawNode.back ();
-        int len = s.getLength ();
+        std::uint8_t const* const data = rawNode.data ();
+        int type = data[rawNode.size () - 1];
+        int len = rawNode.size () - 1;
 
         if ((type < 0) || (type > 4))
         {
@@ -112,8 +128,8 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             // transaction
             mItem = std::make_shared<SHAMapItem>(
                 sha512Half(HashPrefix::transactionID,
-                    Slice(s.data(), s.size())),
-                        s.peekData());
+                    Slice(data, len)),
+                        data, len);
             mType = tnTRANSACTION_NM;
         }
         else if (type == 1)
@@ -122,13 +138,12 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (len < (256 / 8))
                 throw std::runtime_error ("short AS node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            len -= (256 / 8);
+            uint256 const u = uint256::fromVoid (data + len);
 
             if (u.isZero ()) throw std::runtime_error ("invalid AS node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, data, len);
             mType = tnACCOUNT_STATE;
         }
         else if (type == 2)
@@ -139,7 +154,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mHashes[i] = uint256::fromVoid (data + (i * 32));
 
                 if (mHashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
@@ -152,12 +167,11 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             // compressed inner
             for (int i = 0; i < (len / 33); ++i)
             {
-                int pos;
-                s.get8 (pos, 32 + (i * 33));
+                int pos = data[32 + (i * 33)];
 
                 if ((pos < 0) || (pos >= 16)) throw std::runtime_error ("invalid CI node");
 
-                s.get256 (mHashes[pos], i * 33);
+                mHashes[pos] = uint256::fromVoid (data + (i * 33));
 
                 if (mHashes[pos].isNonZero ())
                     mIsBranch |= (1 << pos);
@@ -171,14 +185,13 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (len < (256 / 8))
                 throw std::runtime_error ("short TM node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            len -= (256 / 8);
+            uint256 const u = uint256::fromVoid (data + len);
 
             if (u.isZero ())
                 throw std::runtime_error ("invalid TM node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, data, len);
             mType = tnTRANSACTION_MD;
         }
     }
@@ -191,30 +204,30 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             throw std::runtime_error ("invalid P node");
         }
 
-        std::uint32_t prefix = rawNode[0];
+        std::uint8_t const* const data = rawNode.data () + 4;
+        int len = rawNode.size () - 4;
+
+        std::uint32_t prefix = rawNode.data ()[0];
         prefix <<= 8;
-        prefix |= rawNode[1];
+        prefix |= rawNode.data ()[1];
         prefix <<= 8;
-        prefix |= rawNode[2];
+        prefix |= rawNode.data ()[2];
         prefix <<= 8;
-        prefix |= rawNode[3];
-        Serializer s (rawNode.data() + 4, rawNode.size() - 4);
+        prefix |= rawNode.data ()[3];
 
         if (prefix == HashPrefix::transactionID)
         {
             mItem = std::make_shared<SHAMapItem>(
-                sha512Half(make_Slice(rawNode)),
-                    s.peekData ());
+                sha512Half(rawNode), data, len);
             mType = tnTRANSACTION_NM;
         }
         else if (prefix == HashPrefix::leafNode)
         {
-            if (s.getLength () < 32)
+            if (len < 32)
                 throw std::runtime_error ("short PLN node");
 
-            uint256 u;
-            s.get256 (u, s.getLength () - 32);
-            s.chop (32);
+            len -= 32;
+            uint256 const u = uint256::fromVoid (data + len);
 
             if (u.isZero ())
             {
@@ -222,17 +235,17 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                 throw std::runtime_error ("invalid PLN node");
             }
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, data, len);
             mType = tnACCOUNT_STATE;
         }
         else if (prefix == HashPrefix::innerNode)
         {
-            if (s.getLength () != 512)
+            if (len != 512)
                 throw std::runtime_error ("invalid PIN node");
 
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mHashes[i] = uint256::fromVoid (data + (i * 32));
 
                 if (mHashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
@@ -243,13 +256,12 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         else if (prefix == HashPrefix::txNode)
         {
             // transaction with metadata
-            if (s.getLength () < 32)
+            if (len < 32)
                 throw std::runtime_error ("short TXN node");
 
-            uint256 txID;
-            s.get256 (txID, s.getLength () - 32);
-            s.chop (32);
-            mItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+            len -= 32;
+            uint256 const txID = uint256::fromVoid (data + len);
+            mItem = std::make_shared<SHAMapItem> (txID, data, len);
             mType = tnTRANSACTION_MD;
         }
         else
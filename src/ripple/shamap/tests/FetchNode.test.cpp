@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMapTreeNode.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/SHA512Half.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+// Compares decoding SHAMap nodes from a NodeObject copy with decoding
+// them in place from the backend's buffer.
+//
+// Bytes copied counts what leaves the backend buffer on the way to a
+// tree node. Heap blocks are counted from the objects each path builds:
+// a NodeObject and its Blob, the tree node, and a leaf's item and data.
+class FetchNode_timing_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const nodeCount = 50000;
+
+    struct Totals
+    {
+        std::size_t nodes = 0;
+        std::size_t bytes = 0;
+        std::size_t blocks = 0;
+        clock_type::duration elapsed {};
+    };
+
+    template <class Generator>
+    static
+    uint256
+    randomHash (Generator& g)
+    {
+        uint256 h;
+        std::uint8_t* p = h.begin ();
+        for (int i = 0; i < h.size (); ++i)
+            p[i] = static_cast <std::uint8_t> (g ());
+        return h;
+    }
+
+    // Two in five nodes are inner nodes, the rest account state leaves
+    template <class Generator>
+    static
+    Blob
+    makeNode (Generator& g, std::size_t i)
+    {
+        Serializer s;
+        if (i % 5 < 2)
+        {
+            s.add32 (HashPrefix::innerNode);
+            for (int branch = 0; branch < 16; ++branch)
+                s.add256 ((g () % 4 == 0) ? uint256 () : randomHash (g));
+        }
+        else
+        {
+            s.add32 (HashPrefix::leafNode);
+            Blob data (100 + g () % 200);
+            for (auto& b : data)
+                b = static_cast <std::uint8_t> (g ());
+            s.addRaw (data);
+            s.add256 (randomHash (g));
+        }
+        return std::move (s.modData ());
+    }
+
+    static
+    void
+    count (Totals& t, SHAMapTreeNode const& node)
+    {
+        ++t.nodes;
+        ++t.blocks;
+        if (node.isLeaf ())
+        {
+            t.bytes += node.peekItem ()->size ();
+            t.blocks += 2;
+        }
+    }
+
+    // The NodeObject path: copy out of the backend, then decode
+    static
+    void
+    fetchObjects (NodeStore::Database& db,
+        std::vector <uint256> const& hashes, Totals& t)
+    {
+        for (auto const& hash : hashes)
+        {
+            auto const object = db.fetch (hash);
+            if (! object)
+                continue;
+            SHAMapTreeNode node (object->getData (), 0, snfPREFIX, hash, true);
+            t.bytes += object->getData ().size ();
+            t.blocks += 2;
+            count (t, node);
+        }
+    }
+
+    // The in place path: decode straight from the backend's buffer
+    static
+    void
+    fetchPayloads (NodeStore::Database& db,
+        std::vector <uint256> const& hashes, Totals& t)
+    {
+        for (auto const& hash : hashes)
+        {
+            db.fetchPayload (hash,
+                [&](NodeObjectType, void const* data, std::size_t size)
+                {
+                    SHAMapTreeNode node (Slice (data, size),
+                        0, snfPREFIX, hash, true);
+                    count (t, node);
+                }, false);
+        }
+    }
+
+    template <class Fetch>
+    Totals
+    measure (Section const& params,
+        std::vector <uint256> const& hashes, Fetch fetch)
+    {
+        NodeStore::DummyScheduler scheduler;
+        beast::Journal j;
+
+        // A fresh database, so every fetch reaches the backend
+        auto db = NodeStore::Manager::instance ().make_Database (
+            "test", scheduler, j, 0, params);
+
+        Totals t;
+        auto const start = clock_type::now ();
+        fetch (*db, hashes, t);
+        t.elapsed = clock_type::now () - start;
+        return t;
+    }
+
+    void
+    report (std::string const& name, Totals const& t)
+    {
+        using namespace std::chrono;
+        auto const n = std::max <std::size_t> (t.nodes, 1);
+        std::stringstream ss;
+        ss << std::left << std::setw (12) << name << std::right <<
+            std::setw (8) << t.nodes << " nodes " <<
+            std::setw (8) << duration_cast <nanoseconds> (
+                t.elapsed).count () / n << " ns/fetch " <<
+            std::setw (8) << t.bytes / n << " bytes/fetch " <<
+            std::fixed << std::setprecision (2) <<
+            std::setw (6) << double (t.blocks) / n << " blocks/fetch";
+        log << ss.str ();
+    }
+
+    void
+    run () override
+    {
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+        Section params;
+        params.set ("type", "nudb");
+        params.set ("path", node_db.getFullPathName ().toStdString ());
+
+        std::vector <uint256> hashes;
+        hashes.reserve (nodeCount);
+        {
+            NodeStore::DummyScheduler scheduler;
+            beast::Journal j;
+            auto db = NodeStore::Manager::instance ().make_Database (
+                "test", scheduler, j, 0, params);
+
+            std::mt19937 g (1234);
+            for (std::size_t i = 0; i < nodeCount; ++i)
+            {
+                Blob node = makeNode (g, i);
+                auto const hash = sha512Half (Slice (node.data (), node.size ()));
+                db->store (hotACCOUNT_NODE, std::move (node), hash);
+                hashes.push_back (hash);
+            }
+            std::shuffle (hashes.begin (), hashes.end (), g);
+        }
+
+        auto const objects = measure (params, hashes, &fetchObjects);
+        auto const payloads = measure (params, hashes, &fetchPayloads);
+        report ("NodeObject", objects);
+        report ("in place", payloads);
+        expect (objects.nodes == hashes.size ());
+        expect (payloads.nodes == hashes.size ());
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(FetchNode_timing,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
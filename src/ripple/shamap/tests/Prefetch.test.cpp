@@ -0,0 +1,483 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/tests/common.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/SHA512Half.h>
+#include <ripple/unity/rocksdb.h>
+#include <ripple/nodestore/Factory.h>
+#include <beast/http/rfc2616.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+struct PrefetchTestBase : beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Counts
+    {
+        std::size_t nodes = 0;
+        std::size_t leaves = 0;
+    };
+
+    static
+    Section
+    makeParams (std::string const& type, std::string const& path)
+    {
+        Section params;
+        params.set ("type", type);
+        params.set ("path", path);
+        return params;
+    }
+
+    // Builds a state map of random items and writes it to the database
+    static
+    uint256
+    buildMap (TestFamily& f, std::size_t items, std::size_t& nodes)
+    {
+        std::mt19937 g (1234);
+        std::uniform_int_distribution <int> byte (0, 255);
+        SHAMap map (SHAMapType::STATE, f, beast::Journal ());
+
+        Blob data (100);
+        for (std::size_t i = 0; i < items; ++i)
+        {
+            for (auto& b : data)
+                b = static_cast <std::uint8_t> (byte (g));
+            SHAMapItem item (sha512Half (make_Slice (data)), data);
+            map.addItem (item, false, false);
+        }
+
+        nodes = map.flushDirty (hotACCOUNT_NODE, 1);
+        return map.getHash ();
+    }
+
+    // Opens the map in a family whose caches start out empty
+    static
+    std::shared_ptr <SHAMap>
+    openMap (TestFamily& f, uint256 const& hash)
+    {
+        auto map = std::make_shared <SHAMap> (
+            SHAMapType::STATE, f, beast::Journal ());
+        if (! map->fetchRoot (hash, nullptr))
+            return nullptr;
+        return map;
+    }
+
+    static
+    Counts
+    visit (SHAMap const& map)
+    {
+        Counts c;
+        map.visitNodes (
+            [&c](SHAMapTreeNode& node)
+            {
+                ++c.nodes;
+                if (! node.isInner ())
+                    ++c.leaves;
+                return false;
+            });
+        return c;
+    }
+
+    static
+    Counts
+    fetchPack (SHAMap const& map)
+    {
+        Counts c;
+        map.getFetchPack (nullptr, true, std::numeric_limits <int>::max (),
+            [&c](uint256 const&, Blob const&)
+            {
+                ++c.nodes;
+            });
+        return c;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A backend that takes a fixed time to answer every fetch.
+
+    This stands in for the device: with the operating system's page
+    cache warm, a real backend answers too quickly to show what
+    overlapping reads is worth.
+*/
+class SlowBackend : public NodeStore::Backend
+{
+public:
+    SlowBackend (std::unique_ptr <NodeStore::Backend> backend,
+            std::chrono::microseconds latency)
+        : backend_ (std::move (backend))
+        , latency_ (latency)
+    {
+    }
+
+    std::string getName () override
+    {
+        return backend_->getName ();
+    }
+
+    void close () override
+    {
+        backend_->close ();
+    }
+
+    NodeStore::Status fetch (void const* key,
+        std::shared_ptr <NodeObject>* pObject) override
+    {
+        if (latency_.count () != 0)
+            std::this_thread::sleep_for (latency_);
+        return backend_->fetch (key, pObject);
+    }
+
+    NodeStore::Status fetchPayload (void const* key,
+        NodeStore::FetchCallback const& f) override
+    {
+        if (latency_.count () != 0)
+            std::this_thread::sleep_for (latency_);
+        return backend_->fetchPayload (key, f);
+    }
+
+    bool canFetchBatch () override
+    {
+        return false;
+    }
+
+    std::vector <std::shared_ptr <NodeObject>>
+    fetchBatch (std::size_t n, void const* const* keys) override
+    {
+        throw std::runtime_error ("pure virtual called");
+    }
+
+    void store (std::shared_ptr <NodeObject> const& object) override
+    {
+        backend_->store (object);
+    }
+
+    void storeBatch (NodeStore::Batch const& batch) override
+    {
+        backend_->storeBatch (batch);
+    }
+
+    void for_each (
+        std::function <void (std::shared_ptr <NodeObject>)> f) override
+    {
+        backend_->for_each (f);
+    }
+
+    int getWriteLoad () override
+    {
+        return backend_->getWriteLoad ();
+    }
+
+    void setDeletePath () override
+    {
+        backend_->setDeletePath ();
+    }
+
+    void verify () override
+    {
+        backend_->verify ();
+    }
+
+private:
+    std::unique_ptr <NodeStore::Backend> backend_;
+    std::chrono::microseconds latency_;
+};
+
+/** Creates a SlowBackend around the backend named by "backend". */
+class SlowFactory : public NodeStore::Factory
+{
+public:
+    SlowFactory ()
+    {
+        NodeStore::Manager::instance ().insert (*this);
+    }
+
+    ~SlowFactory ()
+    {
+        NodeStore::Manager::instance ().erase (*this);
+    }
+
+    std::string getName () const override
+    {
+        return "slow";
+    }
+
+    std::unique_ptr <NodeStore::Backend>
+    createInstance (std::size_t, Section const& params,
+        NodeStore::Scheduler& scheduler, beast::Journal journal) override
+    {
+        Section inner (params);
+        inner.set ("type", get <std::string> (params, "backend"));
+        return std::make_unique <SlowBackend> (
+            NodeStore::Manager::instance ().make_Backend (
+                inner, scheduler, journal),
+            std::chrono::microseconds (get <int> (params, "latency")));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class Prefetch_test : public PrefetchTestBase
+{
+public:
+    void
+    testDatabase ()
+    {
+        testcase ("database");
+
+        NodeStore::DummyScheduler scheduler;
+        beast::Journal j;
+        SlowFactory slowFactory;
+
+        auto const fast = makeParams ("memory", "Prefetch_test_db");
+        auto slow = fast;
+        slow.set ("type", "slow");
+        slow.set ("backend", "memory");
+        slow.set ("latency", "1000");
+
+        std::vector <uint256> hashes;
+        {
+            auto db = NodeStore::Manager::instance ().make_Database (
+                "test", scheduler, j, 0, fast);
+            for (std::uint8_t i = 0; i < 3; ++i)
+            {
+                Blob data (100, i);
+                hashes.push_back (sha512Half (make_Slice (data)));
+                db->store (hotACCOUNT_NODE, std::move (data), hashes.back ());
+            }
+        }
+
+        // Without read threads nothing can do the read
+        {
+            auto db = NodeStore::Manager::instance ().make_Database (
+                "test", scheduler, j, 0, slow);
+            expect (db->fetch (hashes[0]) != nullptr);
+            db->prefetch (hashes[1]);
+            expect (db->getFetchTotalCount () == 1);
+        }
+
+        // Reads from memory are not worth handing off
+        {
+            auto db = NodeStore::Manager::instance ().make_Database (
+                "test", scheduler, j, 1, fast);
+            expect (db->fetch (hashes[0]) != nullptr);
+            db->prefetch (hashes[1]);
+            db->waitReads ();
+            expect (db->getFetchTotalCount () == 1);
+        }
+
+        auto db = NodeStore::Manager::instance ().make_Database (
+            "test", scheduler, j, 1, slow);
+
+        // Nothing is known about the backend until it has been read
+        db->prefetch (hashes[1]);
+        expect (db->getFetchTotalCount () == 0);
+
+        expect (db->fetch (hashes[0]) != nullptr);
+        db->prefetch (hashes[1]);
+        db->waitReads ();
+
+        // The read thread may still be finishing the read
+        for (int i = 0; i < 1000 && db->getFetchTotalCount () == 1; ++i)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        expect (db->getFetchTotalCount () == 2);
+
+        // Now it comes from the cache
+        expect (db->fetch (hashes[1]) != nullptr);
+        db->prefetch (hashes[1]);
+        expect (db->getFetchTotalCount () == 2);
+    }
+
+    void
+    testTraversal ()
+    {
+        testcase ("traversal");
+
+        std::size_t const items = 2000;
+        beast::Journal j;
+        SlowFactory slowFactory;
+
+        auto const fast = makeParams ("memory", "Prefetch_test_map");
+        auto slow = fast;
+        slow.set ("type", "slow");
+        slow.set ("backend", "memory");
+        slow.set ("latency", "50");
+
+        std::size_t nodes = 0;
+        uint256 hash;
+        {
+            TestFamily f (fast, 0, j);
+            hash = buildMap (f, items, nodes);
+        }
+        expect (nodes > items);
+
+        // With no read threads, and with prefetching
+        std::vector <std::pair <Section, int>> const configs = {
+            { fast, 0 }, { slow, 2 } };
+        for (auto const& config : configs)
+        {
+            TestFamily f (config.first, config.second, j);
+
+            auto map = openMap (f, hash);
+            expect (map != nullptr);
+            if (! map)
+                continue;
+
+            auto const c = visit (*map);
+            expect (c.nodes == nodes);
+            expect (c.leaves == items);
+
+            std::vector <SHAMapMissingNode> missing;
+            openMap (f, hash)->walkMap (missing, 32);
+            expect (missing.empty ());
+
+            expect (fetchPack (*openMap (f, hash)).nodes == nodes);
+        }
+    }
+
+    void
+    run () override
+    {
+        testDatabase ();
+        testTraversal ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Prefetch,shamap,ripple);
+
+//------------------------------------------------------------------------------
+
+/** Times full traversals of a map that is not in memory.
+
+    Every traversal starts with empty tree node and NodeStore caches.
+    Running with no read threads shows the cost without prefetching.
+    The operating system's page cache is not dropped, so the disk
+    itself is only represented by the optional fixed fetch latency.
+
+    Arguments (--unittest-arg), separated by commas:
+
+        items=<count>       Number of items in the map (default 100000)
+        latency=<micros>    Time added to every backend fetch (default 0)
+*/
+class Prefetch_timing_test : public PrefetchTestBase
+{
+public:
+    template <class Traversal>
+    void
+    measure (std::string const& name, Section const& params,
+        uint256 const& hash, std::size_t nodes, Traversal traverse)
+    {
+        beast::Journal j;
+        std::stringstream ss;
+        ss << std::left << std::setw (12) << name << std::right;
+
+        for (int readThreads : { 0, 1, 4 })
+        {
+            TestFamily f (params, readThreads, j);
+            auto map = openMap (f, hash);
+            expect (map != nullptr);
+            if (! map)
+                return;
+
+            auto const start = clock_type::now ();
+            auto const c = traverse (*map);
+            auto const elapsed = clock_type::now () - start;
+            expect (c.nodes == nodes);
+
+            using namespace std::chrono;
+            ss << std::setw (8) << duration_cast <milliseconds> (
+                elapsed).count () << " ms";
+        }
+
+        log << ss.str ();
+    }
+
+    void
+    run () override
+    {
+        std::size_t items = 100000;
+        int latency = 0;
+        for (auto const& kv : beast::rfc2616::split (
+            arg ().begin (), arg ().end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                continue;
+            auto const key = kv.substr (0, pos);
+            auto const value = kv.substr (pos + 1);
+            if (key == "items")
+                items = std::stoul (value);
+            else if (key == "latency")
+                latency = std::stoi (value);
+        }
+
+        std::vector <std::string> types = { "nudb" };
+    #if RIPPLE_ROCKSDB_AVAILABLE
+        types.push_back ("rocksdb");
+    #endif
+
+        SlowFactory slowFactory;
+
+        for (auto const& type : types)
+        {
+            beast::UnitTestUtilities::TempDirectory dir ("prefetch_db");
+            auto const params = makeParams (
+                type, dir.getFullPathName ().toStdString ());
+
+            std::size_t nodes = 0;
+            uint256 hash;
+            {
+                TestFamily f (params, 0, beast::Journal ());
+                hash = buildMap (f, items, nodes);
+            }
+
+            auto slow = params;
+            slow.set ("type", "slow");
+            slow.set ("backend", type);
+            slow.set ("latency", std::to_string (latency));
+
+            log << type << ": " << items << " items, " << nodes <<
+                " nodes, " << latency << "us latency, " <<
+                "read threads 0 / 1 / 4";
+            measure ("visitNodes", slow, hash, nodes, &visit);
+            measure ("fetchPack", slow, hash, nodes, &fetchPack);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Prefetch_timing,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
@@ -91,13 +91,10 @@ public:
         return true;
     }
 
-    void run ()
+    // When batched, nodes go through makeNodes before they are linked
+    void testSync (bool batched)
     {
-        unsigned int seed;
-
-        // VFALCO DEPRECATED Should use C++11
-        RAND_pseudo_bytes (reinterpret_cast<unsigned char*> (&seed), sizeof (seed));
-        srand (seed);
+        testcase (batched ? "batched" : "single");
 
         beast::Journal const j;                            // debug journal
 
@@ -178,6 +175,10 @@ public:
                 pass ();
             }
 
+            std::vector<std::shared_ptr<SHAMapTreeNode>> made;
+            if (batched)
+                made = SHAMap::makeNodes (gotNodes, snfWIRE);
+
             for (nodeIDIterator = gotNodeIDs.begin (), rawNodeIterator = gotNodes.begin ();
                     nodeIDIterator != gotNodeIDs.end (); ++nodeIDIterator, ++rawNodeIterator)
             {
@@ -186,7 +187,13 @@ public:
                 bytes += rawNodeIterator->size ();
 #endif
 
-                if (!destination.addKnownNode (*nodeIDIterator, *rawNodeIterator, nullptr).isGood ())
+                SHAMapAddNode const san = batched
+                    ? destination.addKnownNode (*nodeIDIterator,
+                        made[nodeIDIterator - gotNodeIDs.begin ()], nullptr)
+                    : destination.addKnownNode (*nodeIDIterator,
+                        *rawNodeIterator, nullptr);
+
+                if (!san.isGood ())
                 {
                     fail ("AddKnownNode");
                 }
@@ -222,6 +229,72 @@ public:
             passes << " passes, " << nodes << " nodes";
 #endif
     }
+
+    void testMalformed ()
+    {
+        testcase ("malformed");
+
+        beast::Journal const j;
+        TestFamily f(j);
+        SHAMap source (SHAMapType::FREE, f, j);
+        SHAMap destination (SHAMapType::FREE, f, j);
+
+        for (int i = 0; i < 100; ++i)
+            source.addItem (*makeRandomAS (), false, false);
+        source.setImmutable ();
+
+        // Computes the inner node hashes before the nodes are serialized
+        uint256 const hash = source.getHash ();
+
+        std::vector<SHAMapNodeID> nodeIDs;
+        std::vector<Blob> rawNodes;
+        expect (source.getNodeFat (SHAMapNodeID (), nodeIDs, rawNodes,
+            false, 1));
+        expect (rawNodes.size () > 1);
+
+        // A root that does not match the expected hash
+        auto made = SHAMap::makeNodes (rawNodes, snfWIRE);
+        expect (destination.addRootNode (
+            hash, made[1], nullptr).isInvalid ());
+
+        destination.setSynching ();
+        expect (destination.addRootNode (
+            hash, made[0], nullptr).isGood ());
+
+        // Unparseable data becomes a null node
+        std::vector<Blob> junk (rawNodes.begin () + 1, rawNodes.end ());
+        junk[0] = Blob (3, 0xff);
+        // A parseable node whose hash does not match its parent
+        junk[1][0] ^= 0x01;
+        made = SHAMap::makeNodes (junk, snfWIRE);
+        expect (! made[0]);
+        expect (made[1] != nullptr);
+        expect (destination.addKnownNode (
+            nodeIDs[1], made[0], nullptr).isInvalid ());
+        expect (destination.addKnownNode (
+            nodeIDs[2], made[1], nullptr).isInvalid ());
+        expect (destination.addKnownNode (
+            nodeIDs[1], junk[0], nullptr).isInvalid ());
+
+        // The genuine nodes still link
+        made = SHAMap::makeNodes (rawNodes, snfWIRE);
+        for (std::size_t i = 1; i < made.size (); ++i)
+            expect (destination.addKnownNode (
+                nodeIDs[i], made[i], nullptr).isGood ());
+    }
+
+    void run ()
+    {
+        unsigned int seed;
+
+        // VFALCO DEPRECATED Should use C++11
+        RAND_pseudo_bytes (reinterpret_cast<unsigned char*> (&seed), sizeof (seed));
+        srand (seed);
+
+        testSync (false);
+        testSync (true);
+        testMalformed ();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(sync,shamap,ripple);
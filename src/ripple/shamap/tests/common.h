@@ -58,6 +58,15 @@ public:
             "test", scheduler_, j, 1, testSection);
     }
 
+    /** Create a family backed by the described database. */
+    TestFamily (Section const& params, int readThreads, beast::Journal j)
+        : treecache_ ("TreeNodeCache", 65536, 60, clock_, j)
+        , fullbelow_ ("full_below", clock_)
+    {
+        db_ = NodeStore::Manager::instance ().make_Database (
+            "test", scheduler_, j, readThreads, params);
+    }
+
     beast::manual_clock <std::chrono::steady_clock>
     clock()
     {
@@ -100,6 +109,12 @@ public:
         return *db_;
     }
 
+    bool
+    cache_objects() const override
+    {
+        return false;
+    }
+
     void
     missing_node (std::uint32_t refNum) override
     {
@@ -167,8 +167,12 @@ struct XRP_t
     PrettyAmount
     operator()(T v) const
     {
-        return { v *
-            dropsPerXRP<T>::value };
+        // Widen first, so large amounts don't overflow
+        using TOut = std::conditional_t<
+            std::is_signed<T>::value,
+                std::int64_t, std::uint64_t>;
+        return { static_cast<TOut>(v) *
+            dropsPerXRP<TOut>::value };
     }
     
     PrettyAmount
@@ -38,11 +38,20 @@
 #include <ripple/app/ledger/impl/InboundLedger.cpp>
 #include <ripple/app/ledger/impl/InboundLedgers.cpp>
 #include <ripple/app/ledger/impl/LedgerCleaner.cpp>
+#include <ripple/app/ledger/impl/LedgerCloseProfiler.cpp>
 #include <ripple/app/ledger/impl/LedgerConsensus.cpp>
 #include <ripple/app/ledger/impl/LedgerFees.cpp>
+#include <ripple/app/ledger/impl/LedgerHashIndex.cpp>
 #include <ripple/app/ledger/impl/LedgerMaster.cpp>
+#include <ripple/app/ledger/impl/LedgerSQLWriter.cpp>
 #include <ripple/app/ledger/impl/LedgerTiming.cpp>
 
 #include <ripple/app/ledger/tests/common_ledger.cpp>
+#include <ripple/app/ledger/tests/AcceptedLedger.test.cpp>
 #include <ripple/app/ledger/tests/DeferredCredits.test.cpp>
+#include <ripple/app/ledger/tests/LedgerCloseProfiler.test.cpp>
+#include <ripple/app/ledger/tests/LedgerConsensus.test.cpp>
+#include <ripple/app/ledger/tests/LedgerEntrySet.test.cpp>
+#include <ripple/app/ledger/tests/LedgerHashIndex.test.cpp>
 #include <ripple/app/ledger/tests/Ledger_test.cpp>
+#include <ripple/app/ledger/tests/LedgerSQLWriter.test.cpp>
@@ -21,11 +21,14 @@
 
 #include <ripple/app/misc/AccountState.cpp>
 #include <ripple/app/misc/AmendmentTableImpl.cpp>
+#include <ripple/app/misc/CacheBudget.cpp>
 #include <ripple/app/misc/CanonicalTXSet.cpp>
 #include <ripple/app/misc/FeeVoteImpl.cpp>
+#include <ripple/app/misc/FetchPackStore.cpp>
 #include <ripple/app/misc/HashRouter.cpp>
 #include <ripple/app/misc/NetworkOPs.cpp>
 #include <ripple/app/misc/SHAMapStoreImp.cpp>
+#include <ripple/app/misc/StreamFormat.cpp>
 #include <ripple/app/misc/UniqueNodeList.cpp>
 #include <ripple/app/misc/Validations.cpp>
 
@@ -33,3 +36,8 @@
 
 #include <ripple/app/misc/tests/AccountTxPaging.test.cpp>
 #include <ripple/app/misc/tests/AmendmentTable.test.cpp>
+#include <ripple/app/misc/tests/CacheBudget.test.cpp>
+#include <ripple/app/misc/tests/FetchPackStore.test.cpp>
+#include <ripple/app/misc/tests/HashRouter.test.cpp>
+#include <ripple/app/misc/tests/StreamFormat.test.cpp>
+#include <ripple/app/misc/tests/Validations.test.cpp>
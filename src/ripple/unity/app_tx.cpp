@@ -47,3 +47,4 @@
 #include <ripple/app/tx/tests/MultiSign.test.cpp>
 #include <ripple/app/tx/tests/OfferStream.test.cpp>
 #include <ripple/app/tx/tests/Taker.test.cpp>
+#include <ripple/app/tx/tests/Throughput.test.cpp>
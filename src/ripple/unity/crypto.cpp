@@ -34,6 +34,7 @@
 #include <ripple/crypto/impl/RandomNumbers.cpp>
 #include <ripple/crypto/impl/RFC1751.cpp>
 
+#include <ripple/crypto/tests/Base58.test.cpp>
 #include <ripple/crypto/tests/CKey.test.cpp>
 #include <ripple/crypto/tests/ECDSACanonical.test.cpp>
 
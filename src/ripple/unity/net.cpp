@@ -28,3 +28,4 @@
 #include <ripple/net/impl/RPCErr.cpp>
 #include <ripple/net/impl/RPCSub.cpp>
 #include <ripple/net/impl/SNTPClient.cpp>
+#include <ripple/net/impl/StreamMessage.cpp>
@@ -30,9 +30,12 @@
 #include <ripple/nodestore/impl/BatchWriter.cpp>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.cpp>
+#include <ripple/nodestore/impl/DatabaseTieredImp.cpp>
 #include <ripple/nodestore/impl/DummyScheduler.cpp>
 #include <ripple/nodestore/impl/DecodedBlob.cpp>
+#include <ripple/nodestore/impl/dictionary.cpp>
 #include <ripple/nodestore/impl/EncodedBlob.cpp>
+#include <ripple/nodestore/impl/HotTier.cpp>
 #include <ripple/nodestore/impl/ManagerImp.cpp>
 #include <ripple/nodestore/impl/NodeObject.cpp>
 #include <ripple/nodestore/impl/ScopedMetrics.cpp>
@@ -40,6 +43,8 @@
 #include <ripple/nodestore/tests/Backend.test.cpp>
 #include <ripple/nodestore/tests/Basics.test.cpp>
 #include <ripple/nodestore/tests/Database.test.cpp>
+#include <ripple/nodestore/tests/DatabaseTiered.test.cpp>
 #include <ripple/nodestore/tests/import_test.cpp>
+#include <ripple/nodestore/tests/dictionary_test.cpp>
 #include <ripple/nodestore/tests/Timing.test.cpp>
 
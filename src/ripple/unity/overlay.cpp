@@ -29,6 +29,7 @@
 
 #include <ripple/overlay/tests/manifest_test.cpp>
 #include <ripple/overlay/tests/short_read.test.cpp>
+#include <ripple/overlay/tests/Simulator.test.cpp>
 #include <ripple/overlay/tests/TMHello.test.cpp>
 
 #if DOXYGEN
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/protocol/impl/AccountIDCache.cpp>
 
 #include <ripple/protocol/impl/AnyPublicKey.cpp>
 #include <ripple/protocol/impl/AnySecretKey.cpp>
@@ -54,6 +55,7 @@
 #include <ripple/protocol/impl/STVector256.cpp>
 
 
+#include <ripple/protocol/tests/AccountIDCache.test.cpp>
 #include <ripple/protocol/tests/BuildInfo.test.cpp>
 #include <ripple/protocol/tests/InnerObjectFormats.test.cpp>
 #include <ripple/protocol/tests/Issue.test.cpp>
@@ -54,6 +54,7 @@
 #include <ripple/rpc/handlers/Ledger.cpp>
 #include <ripple/rpc/handlers/LedgerAccept.cpp>
 #include <ripple/rpc/handlers/LedgerCleaner.cpp>
+#include <ripple/rpc/handlers/LedgerCloseProfile.cpp>
 #include <ripple/rpc/handlers/LedgerClosed.cpp>
 #include <ripple/rpc/handlers/LedgerCurrent.cpp>
 #include <ripple/rpc/handlers/LedgerData.cpp>
@@ -70,6 +71,7 @@
 #include <ripple/rpc/handlers/Print.cpp>
 #include <ripple/rpc/handlers/Random.cpp>
 #include <ripple/rpc/handlers/RipplePathFind.cpp>
+#include <ripple/rpc/handlers/SendQueues.cpp>
 #include <ripple/rpc/handlers/ServerInfo.cpp>
 #include <ripple/rpc/handlers/ServerState.cpp>
 #include <ripple/rpc/handlers/Sign.cpp>
@@ -23,8 +23,10 @@
 #include <BeastConfig.h>
 
 #include <ripple/server/impl/Door.cpp>
+#include <ripple/server/impl/JSONRPCBatch.cpp>
 #include <ripple/server/impl/JSONRPCUtil.cpp>
 #include <ripple/server/impl/Role.cpp>
 #include <ripple/server/impl/ServerImpl.cpp>
 #include <ripple/server/impl/ServerHandlerImp.cpp>
+#include <ripple/server/tests/JSONRPCBatch.test.cpp>
 #include <ripple/server/tests/Server.test.cpp>
@@ -25,6 +25,8 @@
 #include <ripple/shamap/impl/SHAMapNodeID.cpp>
 #include <ripple/shamap/impl/SHAMapSync.cpp>
 #include <ripple/shamap/impl/SHAMapTreeNode.cpp>
+#include <ripple/shamap/tests/FetchNode.test.cpp>
 #include <ripple/shamap/tests/FetchPack.test.cpp>
+#include <ripple/shamap/tests/Prefetch.test.cpp>
 #include <ripple/shamap/tests/SHAMap.test.cpp>
 #include <ripple/shamap/tests/SHAMapSync.test.cpp>
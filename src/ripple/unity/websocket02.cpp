@@ -42,6 +42,10 @@
 #include <ripple/websocket/WebSocket02.cpp>
 #include <ripple/websocket/MakeServer.cpp>
 #include <ripple/websocket/LogWebsockets.cpp>
+#include <ripple/websocket/PermessageDeflate.cpp>
+#include <ripple/websocket/SendQueue.cpp>
+#include <ripple/websocket/tests/PermessageDeflate.test.cpp>
+#include <ripple/websocket/tests/SendQueue.test.cpp>
 
 // Must come last to prevent compilation errors.
 #include <websocketpp_02/src/md5/md5.c>
@@ -27,3 +27,4 @@
 #define _WEBSOCKETPP_CPP11_STL_
 
 #include <ripple/websocket/WebSocket04.cpp>
+#include <ripple/websocket/tests/Config04.test.cpp>
@@ -146,20 +146,20 @@ class job_executor
 private:
     struct impl
     {
-        impl (JobQueue& ex_, JobType type_, std::string const& name_)
+        impl (JobQueue& ex_, JobType type_, char const* name_)
             : ex(ex_), type(type_), name(name_)
         {
         }
 
         JobQueue& ex;
         JobType type;
-        std::string name;
+        char const* name;
     };
 
     std::shared_ptr<impl> impl_;
 
 public:
-    job_executor (JobType type, std::string const& name,
+    job_executor (JobType type, char const* name,
             JobQueue& ex)
         : impl_(std::make_shared<impl>(ex, type, name))
     {
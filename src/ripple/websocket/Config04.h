@@ -23,8 +23,10 @@
 
 #include <ripple/websocket/AutoSocket.h>
 #include <ripple/websocket/Logger.h>
+#include <ripple/websocket/PermessageDeflate.h>
 
 #include <websocketpp/config/core.hpp>
+#include <websocketpp/extensions/extension.hpp>
 #include <websocketpp/server.hpp>
 #include <websocketpp/transport/asio/endpoint.hpp>
 
@@ -36,6 +38,57 @@ namespace websocket {
 
 using ConfigBase04 = websocketpp::config::core;
 
+/** Adapts PermessageDeflate to the websocketpp extension interface. */
+template <class Config>
+class PermessageDeflate04
+{
+public:
+    using err_str_pair = std::pair <websocketpp::lib::error_code, std::string>;
+
+    err_str_pair
+    negotiate (websocketpp::http::attribute_list const& params)
+    {
+        err_str_pair result;
+        if (! deflate_.negotiate (params, result.second))
+            result.first = websocketpp::extensions::error::make_error_code (
+                websocketpp::extensions::error::general);
+        return result;
+    }
+
+    bool
+    is_implemented () const
+    {
+        return true;
+    }
+
+    bool
+    is_enabled () const
+    {
+        return deflate_.enabled ();
+    }
+
+    websocketpp::lib::error_code
+    compress (std::string const& in, std::string& out)
+    {
+        if (deflate_.compress (in, out))
+            return {};
+        return websocketpp::extensions::error::make_error_code (
+            websocketpp::extensions::error::general);
+    }
+
+    websocketpp::lib::error_code
+    decompress (std::uint8_t const* in, std::size_t size, std::string& out)
+    {
+        if (deflate_.decompress (in, size, out))
+            return {};
+        return websocketpp::extensions::error::make_error_code (
+            websocketpp::extensions::error::general);
+    }
+
+private:
+    PermessageDeflate deflate_;
+};
+
 struct Config04 : ConfigBase04 {
     using base = ConfigBase04;
     using type = Config04;
@@ -53,6 +106,9 @@ struct Config04 : ConfigBase04 {
 
     using rng_type = base::rng_type;
 
+    using permessage_deflate_type =
+        PermessageDeflate04 <base::permessage_deflate_config>;
+
     struct transport_config : public base::transport_config {
         using concurrency_type = type::concurrency_type;
         using alog_type        = type::alog_type;
@@ -22,6 +22,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/StreamFormat.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
@@ -37,10 +38,12 @@
 #include <ripple/json/to_string.h>
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/server/Role.h>
+#include <ripple/websocket/SendQueue.h>
 #include <ripple/websocket/WebSocket.h>
 
 #include <boost/asio.hpp>
 #include <beast/asio/placeholders.h>
+#include <algorithm>
 #include <memory>
 
 namespace ripple {
@@ -81,7 +84,25 @@ public:
         // Just discards the reference
     }
 
-    void send (Json::Value const& jvObj, bool broadcast);
+    void send (Json::Value const& jvObj, bool broadcast) override;
+
+    void send (Json::Value const& jvObj, std::string const& sObj,
+        bool broadcast) override;
+
+    void sendBinary (std::string const& blob, bool broadcast) override;
+
+    /** Queue a serialized message and send what the socket has room for.
+
+        @param key Replaces a waiting message with the same key, if not
+                   empty.
+        @param binary `true` to send a BINARY message instead of TEXT.
+    */
+    void enqueue (std::string message, std::string const& key, bool broadcast,
+        bool binary = false);
+
+    void onSendEmpty () override;
+
+    Json::Value getSendQueueJson () override;
 
     void disconnect ();
     static void handle_disconnect(weak_connection_ptr c);
@@ -100,6 +121,14 @@ public:
     void setPingTimer ();
 
 private:
+    static SendQueue::Setup setupSendQueue (HTTP::Port const& port);
+
+    // Returns the key of a stream message that supersedes earlier ones
+    static std::string coalesceKey (Json::Value const& jvObj);
+    static std::string coalesceKey (std::string const& blob);
+
+    void pump ();
+
     HTTP::Port const& m_port;
     Resource::Manager& m_resourceManager;
     Resource::Consumer m_usage;
@@ -117,6 +146,11 @@ private:
 
     handler_type& m_handler;
     weak_connection_ptr m_connection;
+
+    std::mutex m_sendMutex;
+    SendQueue m_sendQueue;
+    bool m_pumping = false;
+    bool m_tooSlow = false;
 };
 
 template <class WebSocket>
@@ -138,7 +172,54 @@ ConnectionImpl <WebSocket>::ConnectionImpl (
         , m_pingTimer (io_service)
         , m_handler (handler)
         , m_connection (cpConnection)
+        , m_sendQueue (setupSendQueue (m_port))
+{
+}
+
+template <class WebSocket>
+SendQueue::Setup ConnectionImpl <WebSocket>::setupSendQueue (
+    HTTP::Port const& port)
 {
+    SendQueue::Setup setup;
+    setup.limit = port.send_queue_limit;
+    setup.window = std::min (setup.window, setup.limit);
+    parsePolicy (port.slow_consumer, setup.policy);
+    return setup;
+}
+
+template <class WebSocket>
+std::string ConnectionImpl <WebSocket>::coalesceKey (Json::Value const& jvObj)
+{
+    if (! jvObj.isObject () || ! jvObj.isMember (jss::type))
+        return {};
+
+    // A client only cares about the latest of these
+    auto const type = jvObj[jss::type].asString ();
+    if (type == "ledgerClosed" || type == "serverStatus" ||
+            type == "path_find")
+        return type;
+
+    return {};
+}
+
+template <class WebSocket>
+std::string ConnectionImpl <WebSocket>::coalesceKey (std::string const& blob)
+{
+    if (blob.empty ())
+        return {};
+
+    // Shares keys with the JSON form, a client only gets one of them
+    switch (static_cast <std::uint8_t> (blob[0]))
+    {
+    case bmtLEDGER_CLOSED:
+        return "ledgerClosed";
+    case bmtSERVER_STATUS:
+        return "serverStatus";
+    default:
+        break;
+    }
+
+    return {};
 }
 
 template <class WebSocket>
@@ -327,10 +408,117 @@ void ConnectionImpl <WebSocket>::send (Json::Value const& jvObj, bool broadcast)
 {
     WriteLog (lsWARNING, ConnectionImpl)
             << "WebSocket: sending '" << to_string (jvObj);
+    enqueue (to_string (jvObj), coalesceKey (jvObj), broadcast);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::send (
+    Json::Value const& jvObj, std::string const& sObj, bool broadcast)
+{
+    enqueue (sObj, coalesceKey (jvObj), broadcast);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::sendBinary (
+    std::string const& blob, bool broadcast)
+{
+    enqueue (blob, coalesceKey (blob), broadcast, true);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::enqueue (
+    std::string message, std::string const& key, bool broadcast, bool binary)
+{
     connection_ptr ptr = m_connection.lock ();
 
+    if (! ptr)
+        return;
+
+    {
+        ScopedLockType sl (m_sendMutex);
+
+        if (m_tooSlow)
+            return;
+
+        if (m_sendQueue.push (std::move (message), key, broadcast, binary))
+            ptr.reset ();
+        else
+            m_tooSlow = true;
+    }
+
     if (ptr)
-        m_handler.send (ptr, jvObj, broadcast);
+    {
+        WriteLog (lsINFO, ConnectionImpl) <<
+            "WebSocket: closing slow client " << m_remoteAddress;
+        WebSocket::closeTooSlowClient (*ptr, handler_type::crTooSlow);
+        return;
+    }
+
+    pump ();
+}
+
+// Hands queued messages to the socket. Only one thread pumps at a time,
+// and it never holds m_sendMutex while calling into the socket, which
+// may call back into onSendEmpty.
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::pump ()
+{
+    connection_ptr ptr = m_connection.lock ();
+
+    if (! ptr)
+        return;
+
+    {
+        ScopedLockType sl (m_sendMutex);
+
+        if (m_pumping)
+            return;
+
+        m_pumping = true;
+    }
+
+    for (;;)
+    {
+        std::vector <SendQueue::Message> messages;
+        {
+            ScopedLockType sl (m_sendMutex);
+
+            if (! m_tooSlow)
+                messages = m_sendQueue.take ();
+
+            if (messages.empty ())
+            {
+                m_pumping = false;
+                return;
+            }
+        }
+
+        for (auto const& message : messages)
+            m_handler.send (ptr, message.data, true, message.binary);
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::onSendEmpty ()
+{
+    {
+        ScopedLockType sl (m_sendMutex);
+        m_sendQueue.onSendEmpty ();
+    }
+
+    pump ();
+}
+
+template <class WebSocket>
+Json::Value ConnectionImpl <WebSocket>::getSendQueueJson ()
+{
+    Json::Value ret;
+    {
+        ScopedLockType sl (m_sendMutex);
+        ret = m_sendQueue.getJson ();
+    }
+    ret[jss::peer] = m_remoteAddress.to_string ();
+    return ret;
 }
 
 template <class WebSocket>
@@ -24,6 +24,7 @@
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/impl/Handler.h>
 #include <ripple/server/Port.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/websocket/Connection.h>
@@ -124,14 +125,21 @@ public:
     }
 
     void send (connection_ptr const& cpClient, std::string const& strMessage,
-               bool broadcast)
+               bool broadcast, bool binary = false)
     {
         try
         {
-            WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
-                    << "Ws:: Sending '" << strMessage << "'";
-
-            cpClient->send (strMessage);
+            if (binary)
+                WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
+                        << "Ws:: Sending " << strMessage.size () <<
+                            " binary bytes";
+            else
+                WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
+                        << "Ws:: Sending '" << strMessage << "'";
+
+            WebSocket::send (*cpClient, strMessage, binary,
+                port ().permessage_deflate &&
+                    strMessage.size () >= port ().compress_threshold);
         }
         catch (...)
         {
@@ -400,7 +408,7 @@ public:
             jvResult[jss::error]   = "wsTextRequired";
             // We only accept text messages.
 
-            send (cpClient, jvResult, false);
+            conn->enqueue (to_string (jvResult), {}, false);
         }
         else if (!jrReader.parse (mpMessage->get_payload (), jvRequest) ||
                  jvRequest.isNull () || !jvRequest.isObject ())
@@ -411,7 +419,7 @@ public:
             jvResult[jss::error]   = "jsonInvalid";    // Received invalid json.
             jvResult[jss::value]   = mpMessage->get_payload ();
 
-            send (cpClient, jvResult, false);
+            conn->enqueue (to_string (jvResult), {}, false);
         }
         else
         {
@@ -419,7 +427,11 @@ public:
             {
                 Json::Value& jCmd = jvRequest[jss::command];
                 if (jCmd.isString())
-                    job.rename (std::string ("WSClient::") + jCmd.asString());
+                {
+                    // Load events keep the label, so use the static name
+                    if (auto handler = RPC::getHandler (jCmd.asString ()))
+                        job.rename (handler->name_);
+                }
             }
 
             auto const start (std::chrono::high_resolution_clock::now ());
@@ -431,7 +443,7 @@ public:
             ++rpc_requests_;
             rpc_size_.notify (static_cast <beast::insight::Event::value_type>
                 (buffer.size ()));
-            send (cpClient, buffer, false);
+            conn->enqueue (buffer, {}, false);
         }
 
         return true;
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/websocket/PermessageDeflate.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace ripple {
+namespace websocket {
+
+namespace {
+
+std::atomic <std::uint64_t> compressedMessages (0);
+std::atomic <std::uint64_t> uncompressedBytes (0);
+std::atomic <std::uint64_t> compressedBytes (0);
+
+// Parses a window size parameter, which must be in 8...15
+bool
+parseWindowBits (std::string const& value, int& bits)
+{
+    if (value.empty () || value.size () > 2 ||
+        ! std::all_of (value.begin (), value.end (),
+            [](char c) { return c >= '0' && c <= '9'; }))
+        return false;
+    bits = std::stoi (value);
+    return bits >= 8 && bits <= 15;
+}
+
+} // namespace
+
+PermessageDeflate::PermessageDeflate (int level)
+    : level_ (level)
+{
+    std::memset (&deflate_, 0, sizeof (deflate_));
+    std::memset (&inflate_, 0, sizeof (inflate_));
+}
+
+PermessageDeflate::~PermessageDeflate ()
+{
+    if (deflateReady_)
+        deflateEnd (&deflate_);
+    if (inflateReady_)
+        inflateEnd (&inflate_);
+}
+
+bool
+PermessageDeflate::negotiate (Params const& params, std::string& response)
+{
+    // Only the first acceptable offer is taken
+    if (enabled_)
+        return false;
+
+    bool noContextTakeover = false;
+    int windowBits = 15;
+    bool limitWindow = false;
+
+    for (auto const& param : params)
+    {
+        if (param.first == "server_no_context_takeover")
+        {
+            if (! param.second.empty ())
+                return false;
+            noContextTakeover = true;
+        }
+        else if (param.first == "client_no_context_takeover")
+        {
+            // Our inflater keeps its window either way
+            if (! param.second.empty ())
+                return false;
+        }
+        else if (param.first == "server_max_window_bits")
+        {
+            // zlib cannot produce a stream limited to a 256 byte window
+            if (! parseWindowBits (param.second, windowBits) ||
+                    windowBits < 9)
+                return false;
+            limitWindow = true;
+        }
+        else if (param.first == "client_max_window_bits")
+        {
+            // Our inflater takes any window, so there is nothing to answer
+            int bits;
+            if (! param.second.empty () &&
+                    ! parseWindowBits (param.second, bits))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Negative window sizes select raw deflate, without zlib headers
+    if (deflateInit2 (&deflate_, level_, Z_DEFLATED,
+            -windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    deflateReady_ = true;
+
+    if (inflateInit2 (&inflate_, -15) != Z_OK)
+        return false;
+    inflateReady_ = true;
+
+    response = "permessage-deflate";
+    if (noContextTakeover)
+        response += "; server_no_context_takeover";
+    if (limitWindow)
+        response += "; server_max_window_bits=" + std::to_string (windowBits);
+
+    noContextTakeover_ = noContextTakeover;
+    enabled_ = true;
+    return true;
+}
+
+bool
+PermessageDeflate::compress (std::string const& in, std::string& out)
+{
+    if (! enabled_)
+        return false;
+
+    auto const offset = out.size ();
+    auto const chunk = std::max <std::size_t> (1024, in.size () / 2);
+
+    deflate_.next_in = reinterpret_cast <Bytef*> (
+        const_cast <char*> (in.data ()));
+    deflate_.avail_in = static_cast <uInt> (in.size ());
+
+    do
+    {
+        auto const used = out.size ();
+        out.resize (used + chunk);
+        deflate_.next_out = reinterpret_cast <Bytef*> (&out[used]);
+        deflate_.avail_out = static_cast <uInt> (chunk);
+
+        if (deflate (&deflate_, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+        {
+            // Starting over is always safe: the client's inflater never
+            // needs us to refer back to earlier messages.
+            deflateReset (&deflate_);
+            out.resize (offset);
+            return false;
+        }
+
+        out.resize (used + chunk - deflate_.avail_out);
+    }
+    while (deflate_.avail_out == 0);
+
+    // The flush ends with an empty stored block, which the client adds
+    // back (RFC 7692 section 7.2.1)
+    if (out.size () - offset >= 4 &&
+            out.compare (out.size () - 4, 4, "\x00\x00\xff\xff", 4) == 0)
+        out.resize (out.size () - 4);
+
+    if (noContextTakeover_)
+        deflateReset (&deflate_);
+
+    ++compressedMessages;
+    uncompressedBytes += in.size ();
+    compressedBytes += out.size () - offset;
+    return true;
+}
+
+bool
+PermessageDeflate::decompress (
+    void const* in, std::size_t size, std::string& out)
+{
+    if (! inflateReady_)
+        return false;
+
+    inflate_.next_in = reinterpret_cast <Bytef*> (const_cast <void*> (in));
+    inflate_.avail_in = static_cast <uInt> (size);
+
+    std::size_t const chunk = 4096;
+
+    do
+    {
+        if (out.size () > maxInflated)
+            return false;
+
+        auto const used = out.size ();
+        out.resize (used + chunk);
+        inflate_.next_out = reinterpret_cast <Bytef*> (&out[used]);
+        inflate_.avail_out = static_cast <uInt> (chunk);
+
+        auto const result = inflate (&inflate_, Z_SYNC_FLUSH);
+        out.resize (used + chunk - inflate_.avail_out);
+
+        if (result != Z_OK && result != Z_BUF_ERROR)
+            return false;
+    }
+    while (inflate_.avail_out == 0);
+
+    return true;
+}
+
+Json::Value
+PermessageDeflate::getJson ()
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::compressed_messages] = std::to_string (compressedMessages);
+    ret[jss::uncompressed_bytes] = std::to_string (uncompressedBytes);
+    ret[jss::compressed_bytes] = std::to_string (compressedBytes);
+    return ret;
+}
+
+} // websocket
+} // ripple
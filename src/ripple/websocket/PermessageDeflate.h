@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_WEBSOCKET_PERMESSAGEDEFLATE_H_INCLUDED
+#define RIPPLE_WEBSOCKET_PERMESSAGEDEFLATE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <zlib.h>
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace ripple {
+namespace websocket {
+
+/** The permessage-deflate extension of RFC 7692, server side.
+
+    One instance belongs to one connection. Unless the client asks for
+    server_no_context_takeover, the compressor keeps its state from one
+    message to the next, so repeated field names and account IDs in a
+    stream compress to back references into earlier messages.
+*/
+class PermessageDeflate
+{
+public:
+    using Params = std::map <std::string, std::string>;
+
+    /** Largest inflated message accepted from a client. */
+    static std::size_t const maxInflated = 16 * 1024 * 1024;
+
+    /** The zlib compression level used for connections.
+
+        Level 1 keeps most of the savings on stream JSON for a fraction
+        of the CPU of the zlib default; see PermessageDeflate_timing.
+    */
+    static int const defaultLevel = 1;
+
+    explicit
+    PermessageDeflate (int level = defaultLevel);
+    ~PermessageDeflate ();
+
+    PermessageDeflate (PermessageDeflate const&) = delete;
+    PermessageDeflate& operator= (PermessageDeflate const&) = delete;
+
+    /** Answer a client's offer.
+
+        @param params The parameters of one permessage-deflate offer.
+        @param response Set to the extension to send back, if accepted.
+        @return `true` if the offer was accepted.
+    */
+    bool
+    negotiate (Params const& params, std::string& response);
+
+    /** Returns `true` once an offer was accepted. */
+    bool
+    enabled () const
+    {
+        return enabled_;
+    }
+
+    /** Append the compressed form of a message to `out`.
+
+        @return `false` on error, when the message must be sent
+                uncompressed.
+    */
+    bool
+    compress (std::string const& in, std::string& out);
+
+    /** Append the inflated form of part of a message to `out`.
+
+        The caller ends each message with the bytes 00 00 ff ff.
+    */
+    bool
+    decompress (void const* in, std::size_t size, std::string& out);
+
+    /** Totals for all connections since startup. */
+    static
+    Json::Value
+    getJson ();
+
+private:
+    int const level_;
+    bool enabled_ = false;
+    bool noContextTakeover_ = false;
+    bool deflateReady_ = false;
+    bool inflateReady_ = false;
+    z_stream deflate_;
+    z_stream inflate_;
+};
+
+} // websocket
+} // ripple
+
+#endif
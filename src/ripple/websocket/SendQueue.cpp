@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/websocket/SendQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace ripple {
+namespace websocket {
+
+SendQueue::SendQueue (Setup const& setup)
+    : setup_ (setup)
+{
+}
+
+bool
+SendQueue::push (std::string message, std::string const& key, bool droppable,
+    bool binary)
+{
+    if (! key.empty ())
+    {
+        auto const iter = std::find_if (queue_.begin (), queue_.end (),
+            [&key](Item const& item) { return item.key == key; });
+        if (iter != queue_.end ())
+        {
+            bytes_ -= iter->message.data.size ();
+            queue_.erase (iter);
+            ++coalesced_;
+        }
+    }
+
+    bytes_ += message.size ();
+    queue_.push_back ({{std::move (message), binary}, key, droppable});
+    peak_ = std::max (peak_, bytes_);
+
+    if (bytes_ <= setup_.limit)
+        return true;
+
+    if (setup_.policy == Policy::close)
+        return false;
+
+    // Keep the newest message, even if it alone exceeds the limit
+    for (auto iter = queue_.begin ();
+        bytes_ > setup_.limit && std::next (iter) != queue_.end ();)
+    {
+        if (iter->droppable)
+        {
+            bytes_ -= iter->message.data.size ();
+            iter = queue_.erase (iter);
+            ++dropped_;
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    return true;
+}
+
+std::vector <SendQueue::Message>
+SendQueue::take ()
+{
+    std::vector <Message> result;
+
+    while (! queue_.empty ())
+    {
+        auto const size = queue_.front ().message.data.size ();
+        if (inFlight_ != 0 && inFlight_ + size > setup_.window)
+            break;
+        inFlight_ += size;
+        bytes_ -= size;
+        result.push_back (std::move (queue_.front ().message));
+        queue_.pop_front ();
+    }
+
+    sent_ += result.size ();
+    return result;
+}
+
+void
+SendQueue::onSendEmpty ()
+{
+    inFlight_ = 0;
+}
+
+Json::Value
+SendQueue::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::queued_messages] = static_cast <Json::UInt> (queue_.size ());
+    ret[jss::queued_bytes] = static_cast <Json::UInt> (bytes_);
+    ret[jss::in_flight] = static_cast <Json::UInt> (inFlight_);
+    ret[jss::peak_bytes] = static_cast <Json::UInt> (peak_);
+    ret[jss::sent] = std::to_string (sent_);
+    ret[jss::coalesced] = std::to_string (coalesced_);
+    ret[jss::dropped] = std::to_string (dropped_);
+    return ret;
+}
+
+bool
+parsePolicy (std::string const& name, SendQueue::Policy& policy)
+{
+    if (name == "close")
+        policy = SendQueue::Policy::close;
+    else if (name == "drop")
+        policy = SendQueue::Policy::drop;
+    else
+        return false;
+    return true;
+}
+
+} // websocket
+} // ripple
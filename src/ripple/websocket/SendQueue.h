@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_WEBSOCKET_SENDQUEUE_H_INCLUDED
+#define RIPPLE_WEBSOCKET_SENDQUEUE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace websocket {
+
+/** The outbound messages of one websocket connection.
+
+    Messages wait here until the socket has room for them. At most
+    `window` bytes are handed to the socket until it reports that it
+    has written everything, so a slow client's backlog stays in this
+    queue, where it can be bounded and coalesced.
+
+    A message may have a key. Queueing a message removes any waiting
+    message with the same key, so a client that falls behind gets only
+    the newest ledger close or server status instead of every one.
+
+    When the waiting bytes exceed `limit` the client is too slow. The
+    policy then either drops the oldest stream messages, or reports that
+    the connection should be closed. Responses are never dropped.
+
+    This class is not thread safe.
+*/
+class SendQueue
+{
+public:
+    enum class Policy
+    {
+        close,
+        drop
+    };
+
+    struct Message
+    {
+        std::string data;
+        bool binary;
+    };
+
+    struct Setup
+    {
+        std::size_t limit = 4 * 1024 * 1024;
+        std::size_t window = 256 * 1024;
+        Policy policy = Policy::close;
+    };
+
+    explicit
+    SendQueue (Setup const& setup);
+
+    /** Queue a message.
+
+        @param key Replaces a waiting message with the same key, if
+                   not empty.
+        @param droppable `true` if the slow consumer policy may drop
+                         the message.
+        @param binary `true` if the message is sent as a BINARY message
+                      instead of TEXT.
+        @return `false` if the connection should be closed.
+    */
+    bool
+    push (std::string message, std::string const& key, bool droppable,
+        bool binary = false);
+
+    /** Remove the messages the socket has room for.
+
+        Returns at least one message, if any are waiting, when nothing
+        is in flight.
+    */
+    std::vector <Message>
+    take ();
+
+    /** Called when the socket has written everything handed to it. */
+    void
+    onSendEmpty ();
+
+    /** Returns the number of messages waiting. */
+    std::size_t
+    size () const
+    {
+        return queue_.size ();
+    }
+
+    /** Returns the number of bytes waiting. */
+    std::size_t
+    bytes () const
+    {
+        return bytes_;
+    }
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct Item
+    {
+        Message message;
+        std::string key;
+        bool droppable;
+    };
+
+    Setup const setup_;
+    std::deque <Item> queue_;
+    std::size_t bytes_ = 0;
+    std::size_t inFlight_ = 0;
+    std::size_t peak_ = 0;
+    std::uint64_t sent_ = 0;
+    std::uint64_t coalesced_ = 0;
+    std::uint64_t dropped_ = 0;
+};
+
+/** Parse a slow consumer policy name.
+
+    @return `false` if the name is not "close" or "drop".
+*/
+bool
+parsePolicy (std::string const& name, SendQueue::Policy& policy);
+
+} // websocket
+} // ripple
+
+#endif
@@ -52,6 +52,15 @@ bool WebSocket02::isTextMessage (Message const& message)
     return message.get_opcode () == websocketpp_02::frame::opcode::TEXT;
 }
 
+void WebSocket02::send (
+    Connection& connection, std::string const& message, bool binary, bool)
+{
+    // websocketpp 0.2 does not implement any extensions
+    connection.send (message, binary
+        ? websocketpp_02::frame::opcode::BINARY
+        : websocketpp_02::frame::opcode::TEXT);
+}
+
 using HandlerPtr02 = WebSocket02::HandlerPtr;
 using EndpointPtr02 = WebSocket02::EndpointPtr;
 
@@ -52,6 +52,20 @@ bool WebSocket04::isTextMessage (Message const& message)
     return message.get_opcode () == websocketpp::frame::opcode::text;
 }
 
+void WebSocket04::send (
+    Connection& connection, std::string const& message, bool binary,
+    bool compress)
+{
+    auto msg = connection.get_message (binary
+        ? websocketpp::frame::opcode::binary
+        : websocketpp::frame::opcode::text, message.size ());
+    msg->append_payload (message);
+
+    // Only takes effect if permessage-deflate was negotiated
+    msg->set_compressed (compress);
+    connection.send (msg);
+}
+
 using HandlerPtr04 = WebSocket04::HandlerPtr;
 using EndpointPtr04 = WebSocket04::EndpointPtr;
 
@@ -139,6 +153,19 @@ boost::asio::io_service::strand& WebSocket04::getStrand (Connection& con)
 template <>
 void Server <WebSocket04>::listen()
 {
+    if (! desc_.port.permessage_deflate)
+    {
+        // Decline every extension offer, which leaves all frames
+        // uncompressed.
+        auto endpoint = m_endpoint;
+        m_endpoint->set_validate_handler (
+            [endpoint] (websocketpp::connection_hdl hdl) {
+                if (auto conn = endpoint->get_con_from_hdl (hdl))
+                    conn->remove_header ("Sec-WebSocket-Extensions");
+                return true;
+            });
+    }
+
     m_endpoint->listen (desc_.port.ip, desc_.port.port);
     m_endpoint->start_accept();
     auto c = m_endpoint->get_io_service ().run ();
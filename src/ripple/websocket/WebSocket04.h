@@ -87,6 +87,13 @@ struct WebSocket04
     static
     bool isTextMessage (Message const&);
 
+    /** Send a TEXT or BINARY message, compressed if the connection
+        supports it.
+    */
+    static
+    void send (Connection&, std::string const& message, bool binary,
+        bool compress);
+
     /** Create a new Handler. */
     static
     HandlerPtr makeHandler (ServerDescription const&);
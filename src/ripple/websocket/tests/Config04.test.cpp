@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/websocket/Config04.h>
+#include <beast/unit_test/suite.h>
+#include <websocketpp/processors/hybi13.hpp>
+
+namespace ripple {
+namespace websocket {
+
+// Runs client messages through the websocketpp 0.4 framing with
+// permessage-deflate negotiated.
+class Config04_test : public beast::unit_test::suite
+{
+public:
+    using processor_type = websocketpp::processor::hybi13 <Config04>;
+
+    struct Connection
+    {
+        Config04::con_msg_manager_type::ptr manager;
+        Config04::rng_type rng;
+        processor_type server;
+        processor_type client;
+
+        Connection ()
+            : manager (websocketpp::lib::make_shared <
+                Config04::con_msg_manager_type> ())
+            , server (false, true, manager, rng)
+            , client (false, false, manager, rng)
+        {
+            Config04::request_type request;
+            request.replace_header (
+                "Sec-WebSocket-Extensions", "permessage-deflate");
+            server.negotiate_extensions (request);
+            client.negotiate_extensions (request);
+        }
+    };
+
+    // A final, compressed text frame masked with a zero key
+    static
+    std::string
+    compressedFrame (std::string const& payload)
+    {
+        std::string frame;
+        frame += '\xc1';
+        frame += static_cast <char> (0x80 | payload.size ());
+        frame.append (4, '\0');
+        frame += payload;
+        return frame;
+    }
+
+    // Feeds the frame in small pieces, returning the first error
+    static
+    websocketpp::lib::error_code
+    consume (processor_type& processor, std::string frame)
+    {
+        websocketpp::lib::error_code ec;
+        std::size_t pos = 0;
+        while (pos < frame.size () && ! ec)
+        {
+            auto const n = std::min <std::size_t> (5, frame.size () - pos);
+            auto const used = processor.consume (
+                reinterpret_cast <std::uint8_t*> (&frame[pos]), n, ec);
+            if (used == 0)
+                break;
+            pos += used;
+        }
+        return ec;
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        Connection c;
+        for (int i = 0; i < 3; ++i)
+        {
+            auto in = c.manager->get_message (
+                websocketpp::frame::opcode::text, 10);
+            std::string payload (2000, 'a' + i);
+            in->append_payload (payload);
+            in->set_compressed (true);
+
+            auto out = c.manager->get_message ();
+            expect (! c.client.prepare_data_frame (in, out));
+            auto const ec = consume (c.server,
+                out->get_header () + out->get_payload ());
+            expect (! ec, ec.message ());
+            if (expect (c.server.ready (), "Should be ready"))
+                expect (c.server.get_message ()->get_payload () == payload);
+        }
+    }
+
+    void
+    testCorrupt ()
+    {
+        testcase ("corrupt messages");
+
+        {
+            // Invalid block type
+            Connection c;
+            expect (consume (c.server,
+                compressedFrame ("\xff\xff\xff\xff\xff\xff")),
+                    "Should fail the frame");
+            expect (! c.server.ready (), "Should not deliver");
+        }
+
+        {
+            // A stored block of one byte: the frame inflates but the tail
+            // the sender removed does not match the block's lengths
+            Connection c;
+            expect (consume (c.server,
+                compressedFrame (std::string ("\x00\x01\x00", 3))),
+                    "Should fail the message");
+            expect (! c.server.ready (), "Should not deliver");
+        }
+    }
+
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testCorrupt ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Config04,websocket,ripple);
+
+} // websocket
+} // ripple
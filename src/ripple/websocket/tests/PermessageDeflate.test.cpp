@@ -0,0 +1,444 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/websocket/PermessageDeflate.h>
+#include <ripple/json/to_string.h>
+#include <beast/http/rfc2616.h>
+#include <beast/unit_test/suite.h>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+namespace websocket {
+
+class PermessageDeflateTestBase : public beast::unit_test::suite
+{
+public:
+    // Inflates one message the way a client does
+    static
+    bool
+    inflateMessage (PermessageDeflate& inflater,
+        std::string const& in, std::string& out)
+    {
+        static char const tail[] = {'\x00', '\x00', '\xff', '\xff'};
+        out.clear ();
+        return inflater.decompress (in.data (), in.size (), out) &&
+            inflater.decompress (tail, sizeof (tail), out);
+    }
+
+    // A stream of messages shaped like the validated "transaction"
+    // stream: OfferCreate and Payment transactions with metadata, among
+    // a few hundred accounts.
+    class StreamFactory
+    {
+    public:
+        explicit StreamFactory (std::uint32_t seed)
+            : rng_ (seed)
+        {
+            for (int i = 0; i < 300; ++i)
+                accounts_.push_back ("r" + random (33, base58));
+        }
+
+        std::string
+        next ()
+        {
+            bool const offer = pick (4) != 0;
+            auto const& account = accounts_[pick (accounts_.size ())];
+            auto const& issuer = accounts_[pick (8)];
+
+            Json::Value tx (Json::objectValue);
+            tx["Account"] = account;
+            tx["Fee"] = std::to_string (10 + pick (20));
+            tx["Flags"] = offer ? 524288 : 2147483648u;
+            tx["Sequence"] = static_cast <Json::UInt> (pick (100000));
+            tx["SigningPubKey"] = random (66, hex);
+            tx["TransactionType"] = offer ? "OfferCreate" : "Payment";
+            tx["TxnSignature"] = random (142, hex);
+            tx["date"] = 486000000 + ledger_;
+            tx["hash"] = random (64, hex);
+            if (offer)
+            {
+                tx["TakerGets"] = std::to_string (pick (100000000));
+                tx["TakerPays"] = amount (issuer);
+            }
+            else
+            {
+                tx["Amount"] = amount (issuer);
+                tx["Destination"] = accounts_[pick (accounts_.size ())];
+            }
+
+            Json::Value nodes (Json::arrayValue);
+            nodes.append (modified ("AccountRoot", account, issuer));
+            nodes.append (modified ("RippleState", account, issuer));
+            if (offer)
+            {
+                nodes.append (modified ("Offer", account, issuer));
+                nodes.append (modified ("DirectoryNode", account, issuer));
+            }
+
+            Json::Value meta (Json::objectValue);
+            meta["AffectedNodes"] = nodes;
+            meta["TransactionIndex"] = static_cast <Json::UInt> (pick (200));
+            meta["TransactionResult"] = "tesSUCCESS";
+
+            Json::Value jv (Json::objectValue);
+            jv["engine_result"] = "tesSUCCESS";
+            jv["engine_result_code"] = 0;
+            jv["engine_result_message"] =
+                "The transaction was applied. Only final in a validated ledger.";
+            jv["ledger_hash"] = ledgerHash_;
+            jv["ledger_index"] = ledger_;
+            jv["meta"] = meta;
+            jv["status"] = "closed";
+            jv["transaction"] = tx;
+            jv["type"] = "transaction";
+            jv["validated"] = true;
+
+            if (++count_ % 100 == 0)
+            {
+                ++ledger_;
+                ledgerHash_ = random (64, hex);
+            }
+
+            return to_string (jv);
+        }
+
+    private:
+        static char const* const hex;
+        static char const* const base58;
+
+        std::size_t
+        pick (std::size_t n)
+        {
+            return std::uniform_int_distribution <std::size_t> (0, n - 1) (rng_);
+        }
+
+        std::string
+        random (std::size_t size, char const* alphabet)
+        {
+            auto const n = std::strlen (alphabet);
+            std::string s;
+            for (std::size_t i = 0; i < size; ++i)
+                s += alphabet[pick (n)];
+            return s;
+        }
+
+        Json::Value
+        amount (std::string const& issuer)
+        {
+            static char const* const currencies[] = {"USD", "EUR", "BTC", "CNY"};
+            Json::Value jv (Json::objectValue);
+            jv["currency"] = currencies[pick (4)];
+            jv["issuer"] = issuer;
+            jv["value"] = std::to_string (pick (1000000)) + "." +
+                std::to_string (pick (1000000));
+            return jv;
+        }
+
+        Json::Value
+        modified (char const* type, std::string const& account,
+            std::string const& issuer)
+        {
+            Json::Value fields (Json::objectValue);
+            fields["Account"] = account;
+            fields["Balance"] = amount (issuer);
+            fields["Flags"] = 0;
+            fields["OwnerCount"] = static_cast <Json::UInt> (pick (20));
+            fields["Sequence"] = static_cast <Json::UInt> (pick (100000));
+
+            Json::Value previous (Json::objectValue);
+            previous["Balance"] = amount (issuer);
+
+            Json::Value node (Json::objectValue);
+            node["FinalFields"] = fields;
+            node["LedgerEntryType"] = type;
+            node["LedgerIndex"] = random (64, hex);
+            node["PreviousFields"] = previous;
+            node["PreviousTxnID"] = random (64, hex);
+            node["PreviousTxnLgrSeq"] = static_cast <Json::UInt> (
+                ledger_ - 1 - pick (1000));
+
+            Json::Value jv (Json::objectValue);
+            jv["ModifiedNode"] = node;
+            return jv;
+        }
+
+        std::mt19937 rng_;
+        std::vector <std::string> accounts_;
+        std::uint32_t ledger_ = 14000000;
+        std::string ledgerHash_ = std::string (64, 'A');
+        std::size_t count_ = 0;
+    };
+};
+
+char const* const PermessageDeflateTestBase::StreamFactory::hex =
+    "0123456789ABCDEF";
+char const* const PermessageDeflateTestBase::StreamFactory::base58 =
+    "rpshnaf39wBUDNEGHJKLM4PQRST7VWXYZ2bcdeCg65jkm8oFqi1tuvAxyz";
+
+//------------------------------------------------------------------------------
+
+class PermessageDeflate_test : public PermessageDeflateTestBase
+{
+public:
+    void
+    testNegotiate ()
+    {
+        testcase ("negotiate");
+
+        auto accepts = [](PermessageDeflate::Params const& params,
+            std::string const& expected)
+        {
+            PermessageDeflate d;
+            std::string response;
+            return d.negotiate (params, response) && d.enabled () &&
+                response == expected;
+        };
+
+        auto declines = [](PermessageDeflate::Params const& params)
+        {
+            PermessageDeflate d;
+            std::string response;
+            return ! d.negotiate (params, response) && ! d.enabled ();
+        };
+
+        expect (accepts ({}, "permessage-deflate"));
+        expect (accepts ({{"client_max_window_bits", ""}},
+            "permessage-deflate"));
+        expect (accepts ({{"client_max_window_bits", "10"},
+            {"client_no_context_takeover", ""}}, "permessage-deflate"));
+        expect (accepts ({{"server_no_context_takeover", ""}},
+            "permessage-deflate; server_no_context_takeover"));
+        expect (accepts ({{"server_max_window_bits", "10"}},
+            "permessage-deflate; server_max_window_bits=10"));
+
+        expect (declines ({{"server_max_window_bits", "8"}}));
+        expect (declines ({{"server_max_window_bits", "16"}}));
+        expect (declines ({{"server_max_window_bits", ""}}));
+        expect (declines ({{"server_max_window_bits", "1x"}}));
+        expect (declines ({{"client_max_window_bits", "7"}}));
+        expect (declines ({{"server_no_context_takeover", "1"}}));
+        expect (declines ({{"x-webkit-deflate-frame", ""}}));
+
+        // Only one offer is accepted
+        PermessageDeflate d;
+        std::string response;
+        expect (d.negotiate ({}, response));
+        expect (! d.negotiate ({}, response));
+
+        // Nothing happens before negotiation
+        PermessageDeflate idle;
+        std::string out;
+        expect (! idle.compress ("abc", out));
+        expect (! idle.decompress ("abc", 3, out));
+    }
+
+    // Returns the compressed sizes of the last two messages, which are
+    // the same message twice
+    std::pair <std::size_t, std::size_t>
+    roundTrip (PermessageDeflate::Params const& params)
+    {
+        PermessageDeflate server;
+        PermessageDeflate client;
+        std::string response;
+        expect (server.negotiate (params, response));
+        expect (client.negotiate ({}, response));
+
+        StreamFactory factory (7);
+        std::vector <std::string> messages;
+        messages.push_back ("");
+        for (int i = 0; i < 50; ++i)
+            messages.push_back (factory.next ());
+        messages.push_back (messages.back ());
+
+        std::vector <std::size_t> sizes;
+        for (auto const& message : messages)
+        {
+            std::string compressed;
+            std::string inflated;
+            expect (server.compress (message, compressed));
+            expect (inflateMessage (client, compressed, inflated));
+            expect (inflated == message);
+            sizes.push_back (compressed.size ());
+        }
+
+        return {sizes[sizes.size () - 2], sizes.back ()};
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        // A repeated message is nearly free only with context takeover
+        auto sizes = roundTrip ({});
+        expect (sizes.second < sizes.first / 5,
+            std::to_string (sizes.first) + " " + std::to_string (sizes.second));
+
+        sizes = roundTrip ({{"server_no_context_takeover", ""}});
+        expect (sizes.second == sizes.first);
+
+        // A 512 byte window cannot reach back to the previous message
+        sizes = roundTrip ({{"server_max_window_bits", "9"}});
+        expect (sizes.second > sizes.first / 2);
+    }
+
+    void
+    testFragments ()
+    {
+        testcase ("fragments");
+
+        PermessageDeflate server;
+        PermessageDeflate client;
+        std::string response;
+        expect (server.negotiate ({}, response));
+        expect (client.negotiate ({}, response));
+
+        // Frames arrive in arbitrary pieces
+        StreamFactory factory (11);
+        for (int i = 0; i < 10; ++i)
+        {
+            auto const message = factory.next ();
+            std::string compressed;
+            expect (server.compress (message, compressed));
+
+            std::string inflated;
+            for (std::size_t pos = 0; pos < compressed.size (); pos += 7)
+            {
+                auto const n = std::min <std::size_t> (
+                    7, compressed.size () - pos);
+                expect (client.decompress (
+                    compressed.data () + pos, n, inflated));
+            }
+            expect (client.decompress ("\x00\x00\xff\xff", 4, inflated));
+            expect (inflated == message);
+        }
+
+        // Garbage is rejected
+        PermessageDeflate bad;
+        expect (bad.negotiate ({}, response));
+        std::string out;
+        expect (! bad.decompress ("\xff\xff\xff\xff\xff\xff", 6, out));
+    }
+
+    void
+    run () override
+    {
+        testNegotiate ();
+        testRoundTrip ();
+        testFragments ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PermessageDeflate,websocket,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures what compressing a transaction stream costs and saves.
+// Arguments: msgs=<count>,threshold=<bytes>
+class PermessageDeflate_timing_test : public PermessageDeflateTestBase
+{
+public:
+    void
+    measure (std::vector <std::string> const& messages,
+        std::size_t threshold, int level, bool contextTakeover)
+    {
+        PermessageDeflate d (level);
+        std::string response;
+        PermessageDeflate::Params params;
+        if (! contextTakeover)
+            params["server_no_context_takeover"] = "";
+        expect (d.negotiate (params, response));
+
+        std::size_t in = 0;
+        std::size_t out = 0;
+        std::string compressed;
+        auto const start = std::clock ();
+        for (auto const& message : messages)
+        {
+            in += message.size ();
+            if (message.size () < threshold)
+            {
+                out += message.size ();
+                continue;
+            }
+            compressed.clear ();
+            d.compress (message, compressed);
+            out += compressed.size ();
+        }
+        auto const cpu = 1000.0 * (std::clock () - start) / CLOCKS_PER_SEC;
+        double const saved = (in - out) / (1024.0 * 1024.0);
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision (2) <<
+            "level " << level <<
+            (contextTakeover ? ", shared context: " : ", per message:    ") <<
+            std::setw (8) << in / 1024.0 << " KB -> " <<
+            std::setw (8) << out / 1024.0 << " KB (" <<
+            std::setw (5) << 100.0 * out / in << "%), " <<
+            std::setw (8) << cpu << " ms CPU, " <<
+            std::setw (7) << (saved > 0 ? cpu / saved : 0) <<
+            " ms per MB saved";
+        log << ss.str ();
+    }
+
+    void
+    run () override
+    {
+        std::size_t msgs = 10000;
+        std::size_t threshold = 1024;
+        for (auto const& kv : beast::rfc2616::split (
+            arg ().begin (), arg ().end (), ','))
+        {
+            auto const pos = kv.find ('=');
+            if (pos == std::string::npos)
+                continue;
+            auto const key = kv.substr (0, pos);
+            auto const value = kv.substr (pos + 1);
+            if (key == "msgs")
+                msgs = std::stoul (value);
+            else if (key == "threshold")
+                threshold = std::stoul (value);
+        }
+
+        StreamFactory factory (1);
+        std::vector <std::string> messages;
+        messages.reserve (msgs);
+        for (std::size_t i = 0; i < msgs; ++i)
+            messages.push_back (factory.next ());
+
+        log << msgs << " transaction stream messages, threshold " <<
+            threshold << " bytes";
+        for (auto level : {1, 6, 9})
+        {
+            measure (messages, threshold, level, true);
+            measure (messages, threshold, level, false);
+        }
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(PermessageDeflate_timing,websocket,ripple);
+
+} // websocket
+} // ripple
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/websocket/SendQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+namespace websocket {
+
+class SendQueue_test : public beast::unit_test::suite
+{
+public:
+    static
+    SendQueue::Setup
+    makeSetup (std::size_t limit, std::size_t window,
+        SendQueue::Policy policy)
+    {
+        SendQueue::Setup setup;
+        setup.limit = limit;
+        setup.window = window;
+        setup.policy = policy;
+        return setup;
+    }
+
+    void
+    testWindow ()
+    {
+        testcase ("window");
+
+        SendQueue q (makeSetup (1000, 10, SendQueue::Policy::close));
+        expect (q.take ().empty ());
+
+        expect (q.push ("aaaa", "", true));
+        expect (q.push ("bbbb", "", true));
+        expect (q.push ("cccc", "", true));
+        expect (q.size () == 3);
+        expect (q.bytes () == 12);
+
+        auto sent = q.take ();
+        expect (sent.size () == 2);
+        expect (sent[0].data == "aaaa" && sent[1].data == "bbbb");
+        expect (! sent[0].binary && ! sent[1].binary);
+        expect (q.bytes () == 4);
+
+        // Nothing more until the socket drains
+        expect (q.take ().empty ());
+        q.onSendEmpty ();
+        sent = q.take ();
+        expect (sent.size () == 1 && sent[0].data == "cccc");
+        expect (q.size () == 0 && q.bytes () == 0);
+
+        // A message larger than the window still goes out alone
+        q.onSendEmpty ();
+        expect (q.push (std::string (50, 'x'), "", false));
+        expect (q.push ("y", "", false));
+        sent = q.take ();
+        expect (sent.size () == 1 && sent[0].data.size () == 50);
+        expect (q.take ().empty ());
+        q.onSendEmpty ();
+        expect (q.take ().size () == 1);
+
+        expect (q.getJson ()[jss::sent].asString () == "5");
+    }
+
+    void
+    testCoalesce ()
+    {
+        testcase ("coalesce");
+
+        SendQueue q (makeSetup (1000, 1, SendQueue::Policy::close));
+        expect (q.push ("response", "", false));
+        q.take ();
+
+        expect (q.push ("ledger 1", "ledgerClosed", true));
+        expect (q.push ("tx", "", true));
+        expect (q.push ("ledger 2", "ledgerClosed", true));
+        expect (q.push ("status", "serverStatus", true));
+        expect (q.push ("ledger 3", "ledgerClosed", true));
+        expect (q.size () == 3);
+
+        // The newest update takes the place at the back of the queue
+        std::vector <std::string> order;
+        for (;;)
+        {
+            q.onSendEmpty ();
+            auto const sent = q.take ();
+            if (sent.empty ())
+                break;
+            for (auto const& message : sent)
+                order.push_back (message.data);
+        }
+        expect (order == std::vector <std::string> (
+            {"tx", "status", "ledger 3"}));
+        expect (q.getJson ()[jss::coalesced].asString () == "2");
+
+        // Binary messages coalesce the same way and keep their opcode
+        expect (q.push ("ledger 4", "ledgerClosed", true, true));
+        expect (q.push ("ledger 5", "ledgerClosed", true, true));
+        q.onSendEmpty ();
+        auto const sent = q.take ();
+        expect (sent.size () == 1 && sent[0].data == "ledger 5");
+        expect (sent.size () == 1 && sent[0].binary);
+    }
+
+    void
+    testClose ()
+    {
+        testcase ("close");
+
+        SendQueue q (makeSetup (10, 1, SendQueue::Policy::close));
+        expect (q.push ("12345", "", true));
+        q.take ();
+
+        // In flight bytes do not count against the limit
+        expect (q.push ("1234567890", "", true));
+        expect (! q.push ("1", "", false));
+
+        // Coalescing keeps a client under the limit
+        SendQueue c (makeSetup (10, 1, SendQueue::Policy::close));
+        for (int i = 0; i < 100; ++i)
+            expect (c.push ("12345678", "serverStatus", true));
+        expect (c.size () == 1);
+    }
+
+    void
+    testDrop ()
+    {
+        testcase ("drop");
+
+        SendQueue q (makeSetup (10, 1, SendQueue::Policy::drop));
+        expect (q.push ("aaaa", "", true));
+        expect (q.push ("bbbb", "", false));
+        expect (q.push ("cccc", "", true));
+
+        // The oldest stream message goes, the response stays
+        expect (q.size () == 2);
+        expect (q.bytes () == 8);
+        auto sent = q.take ();
+        expect (sent.size () == 1 && sent[0].data == "bbbb");
+
+        // Responses alone may exceed the limit
+        expect (q.push ("dddddddddddd", "", false));
+        expect (q.size () == 1);
+        q.onSendEmpty ();
+        sent = q.take ();
+        expect (sent.size () == 1 && sent[0].data == "dddddddddddd");
+
+        auto const jv = q.getJson ();
+        expect (jv[jss::dropped].asString () == "2");
+        expect (jv[jss::peak_bytes].asUInt () == 16);
+        expect (jv[jss::queued_bytes].asUInt () == 0);
+        expect (jv[jss::in_flight].asUInt () == 12);
+    }
+
+    void
+    testPolicy ()
+    {
+        testcase ("policy");
+
+        SendQueue::Policy policy = SendQueue::Policy::close;
+        expect (parsePolicy ("drop", policy));
+        expect (policy == SendQueue::Policy::drop);
+        expect (parsePolicy ("close", policy));
+        expect (policy == SendQueue::Policy::close);
+        expect (! parsePolicy ("ignore", policy));
+        expect (policy == SendQueue::Policy::close);
+    }
+
+    void
+    run ()
+    {
+        testWindow ();
+        testCoalesce ();
+        testClose ();
+        testDrop ();
+        testPolicy ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SendQueue,websocket,ripple);
+
+} // websocket
+} // ripple
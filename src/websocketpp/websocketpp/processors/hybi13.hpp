@@ -390,6 +390,11 @@ public:
                             m_msg_manager->get_message(op,m_bytes_needed),
                             frame::get_masking_key(m_basic_header,m_extended_header)
                         );
+
+                        // Ripple: only the first frame of a message carries
+                        // the RSV1 bit for permessage-deflate.
+                        m_data_msg.msg_ptr->set_compressed(
+                            frame::get_rsv1(m_basic_header));
                     } else {
                         // Fetch the underlying payload buffer from the data message we
                         // are writing into.
@@ -431,6 +436,26 @@ public:
                 // If this was the last frame in the message set the ready flag.
                 // Otherwise, reset processor state to read additional frames.
                 if (frame::get_fin(m_basic_header)) {
+                    // Ripple: a compressed message ends with the empty block
+                    // the sender removed (RFC 7692 section 7.2.2).
+                    if (m_current_msg->msg_ptr->get_compressed() &&
+                        m_permessage_deflate.is_enabled())
+                    {
+                        static uint8_t const tail[] = {0x00, 0x00, 0xff, 0xff};
+                        std::string & out = m_current_msg->msg_ptr->get_raw_payload();
+                        size_t offset = out.size();
+
+                        ec = m_permessage_deflate.decompress(tail,sizeof(tail),out);
+                        if (ec) {break;}
+
+                        if (m_current_msg->msg_ptr->get_opcode() == frame::opcode::TEXT &&
+                            !m_current_msg->validator.decode(out.begin()+offset,out.end()))
+                        {
+                            ec = make_error_code(error::invalid_utf8);
+                            break;
+                        }
+                    }
+
                     // ensure that text messages end on a valid UTF8 code point
                     if (frame::get_opcode(m_basic_header) == frame::opcode::TEXT) {
                         if (!m_current_msg->validator.complete()) {
@@ -550,25 +575,33 @@ public:
                           && in->get_compressed();
         bool fin = in->get_fin();
 
+        // Ripple: compress before generating the header, which must carry
+        // the compressed length.
+        if (compressed) {
+            o.clear();
+            if (m_permessage_deflate.compress(i,o)) {
+                compressed = false;
+            }
+        }
+
+        std::size_t const size = compressed ? o.size() : i.size();
+
         // generate header
-        frame::basic_header h(op,i.size(),fin,masked,compressed);
+        frame::basic_header h(op,size,fin,masked,compressed);
 
         if (masked) {
             // Generate masking key.
             key.i = m_rng();
 
-            frame::extended_header e(i.size(),key.i);
+            frame::extended_header e(size,key.i);
             out->set_header(frame::prepare_header(h,e));
         } else {
-            frame::extended_header e(i.size());
+            frame::extended_header e(size);
             out->set_header(frame::prepare_header(h,e));
         }
 
         // prepare payload
         if (compressed) {
-            // compress and store in o after header.
-            m_permessage_deflate.compress(i,o);
-
             // mask in place if necessary
             if (masked) {
                 this->masked_copy(o,o,key);
@@ -728,10 +761,13 @@ protected:
 
         // decompress message if needed.
         if (m_permessage_deflate.is_enabled()
-            && frame::get_rsv1(m_basic_header))
+            && m_current_msg->msg_ptr->get_compressed())
         {
             // Decompress current buffer into the message buffer
-            m_permessage_deflate.decompress(buf,len,out);
+            ec = m_permessage_deflate.decompress(buf,len,out);
+            if (ec) {
+                return 0;
+            }
 
             // get the length of the newly uncompressed output
             offset = out.size() - offset;